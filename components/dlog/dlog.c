@@ -0,0 +1,109 @@
+#include "dlog.h"
+#include "metrics.h"
+#include "rt.h"
+#include "mem.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+// Bounded multi-producer ring, drained by a single task. A producer claims
+// a slot with one CAS on head and publishes it by advancing the slot's lap;
+// when the ring is full the record is dropped (counted in the metrics)
+// rather than waiting. The drain task is only notified when a
+// record lands in an empty ring, so bursts cost one wakeup.
+typedef struct {
+    const dlog_site_t *site;
+    const char *tag;
+    uint32_t t_ms;
+    int32_t args[DLOG_MAX_ARGS];
+} dlog_rec_t;
+
+// A slot's lap is its position with the index bits cleared. Storing the
+// lap instead of the position lets the ring start zeroed.
+typedef struct {
+    atomic_uint lap;        // == lap of position: free, lap + 1: holds a record
+    dlog_rec_t rec;
+} dlog_slot_t;
+
+#define RING_MASK (DLOG_RING_SIZE - 1)
+#define LAP(pos)  ((pos) & ~(unsigned)RING_MASK)
+
+static dlog_slot_t ring[DLOG_RING_SIZE];
+static atomic_uint head = 0;        // next position to claim
+static atomic_uint tail = 0;        // next position to print
+static TaskHandle_t drain_task_handle = NULL;
+
+void dlog_record(const dlog_site_t *site, const char *tag, const int32_t *args) {
+    unsigned pos = atomic_load_explicit(&head, memory_order_relaxed);
+    dlog_slot_t *slot;
+    for (;;) {
+        slot = &ring[pos & RING_MASK];
+        int diff = (int)(atomic_load_explicit(&slot->lap, memory_order_acquire) - LAP(pos));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&head, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            metrics_count(METRIC_LOG_DROPPED);
+            return;
+        } else {
+            pos = atomic_load_explicit(&head, memory_order_relaxed);
+        }
+    }
+
+    slot->rec.site = site;
+    slot->rec.tag = tag;
+    slot->rec.t_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    memcpy(slot->rec.args, args, sizeof(slot->rec.args));
+    atomic_store_explicit(&slot->lap, LAP(pos) + 1, memory_order_seq_cst);
+
+    // Ring was empty: the drain task may be waiting
+    TaskHandle_t task = drain_task_handle;
+    if (task != NULL && atomic_load_explicit(&tail, memory_order_seq_cst) == pos) {
+        xTaskNotifyGive(task);
+    }
+}
+
+static void print_record(const dlog_rec_t *rec) {
+    const dlog_site_t *site = rec->site;
+    if (site->level > esp_log_level_get(rec->tag)) {
+        return;
+    }
+    char line[DLOG_LINE_MAX];
+    // The format only takes integer conversions; unused arguments are ignored
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+    snprintf(line, sizeof(line), site->fmt, rec->args[0], rec->args[1], rec->args[2], rec->args[3]);
+#pragma GCC diagnostic pop
+    esp_log_write(site->level, rec->tag, "%c (%u) %s: %s\n",
+                  site->letter, (unsigned)rec->t_ms, rec->tag, line);
+}
+
+static void dlog_drain_task(void *pvParameters) {
+    mem_task_steady();
+    for (;;) {
+        unsigned pos = atomic_load_explicit(&tail, memory_order_relaxed);
+        dlog_slot_t *slot = &ring[pos & RING_MASK];
+        if (atomic_load_explicit(&slot->lap, memory_order_seq_cst) != LAP(pos) + 1) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        dlog_rec_t rec = slot->rec;
+        atomic_store_explicit(&slot->lap, LAP(pos) + DLOG_RING_SIZE, memory_order_release);
+        atomic_store_explicit(&tail, pos + 1, memory_order_seq_cst);
+        print_record(&rec);
+    }
+}
+
+void dlog_init(void) {
+    TaskHandle_t task = NULL;
+    rt_task_create(dlog_drain_task, "dlog", NULL, RT_TASK_LOG, &task);
+    drain_task_handle = task;
+    metrics_watch_task(task);
+    // Records made before the task existed
+    xTaskNotifyGive(task);
+}
@@ -0,0 +1,59 @@
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+#include "esp_log.h"
+
+// Deferred logging for time-critical tasks. DLOGx() looks like ESP_LOGx()
+// but only stores a small binary record (call site, tag, timestamp, up to
+// DLOG_MAX_ARGS integer arguments) in a lock-free ring; a low-priority task
+// formats and prints it later, so no printf or UART time lands on the
+// caller. Arguments must be integers (no %s, no 64-bit values).
+//
+// Levels above DLOG_LEVEL are compiled out entirely. The runtime log level
+// still applies when the record is printed.
+#ifndef DLOG_LEVEL
+#define DLOG_LEVEL          ESP_LOG_INFO
+#endif
+#define DLOG_RING_SIZE      64      // records, power of two
+#define DLOG_MAX_ARGS       4
+#define DLOG_LINE_MAX       160     // formatted message, longer lines are cut
+
+_Static_assert((DLOG_RING_SIZE & (DLOG_RING_SIZE - 1)) == 0, "DLOG_RING_SIZE must be a power of two");
+
+// One per DLOGx() call site, in flash
+typedef struct {
+    esp_log_level_t level;
+    char letter;
+    const char *fmt;
+} dlog_site_t;
+
+// Start the task that prints the records (call once from app_main). Records
+// made before that are kept and printed when it starts.
+void dlog_init(void);
+
+void dlog_record(const dlog_site_t *site, const char *tag, const int32_t *args);
+
+// Never called: lets the compiler check the format against the arguments
+static inline __attribute__((format(printf, 1, 2))) void dlog_check_format(const char *fmt, ...) {
+    (void)fmt;
+}
+
+#define DLOG_AT(level, letter_, tag, format, ...) do {                                   \
+        if ((level) <= DLOG_LEVEL) {                                                     \
+            static const dlog_site_t site_ = { (level), (letter_), format };             \
+            const int32_t args_[DLOG_MAX_ARGS + 1] = { 0, ##__VA_ARGS__ };               \
+            if (0) {                                                                     \
+                dlog_check_format(format, ##__VA_ARGS__);                                \
+            }                                                                            \
+            dlog_record(&site_, (tag), &args_[1]);                                       \
+        }                                                                                \
+    } while (0)
+
+#define DLOGE(tag, format, ...) DLOG_AT(ESP_LOG_ERROR,   'E', tag, format, ##__VA_ARGS__)
+#define DLOGW(tag, format, ...) DLOG_AT(ESP_LOG_WARN,    'W', tag, format, ##__VA_ARGS__)
+#define DLOGI(tag, format, ...) DLOG_AT(ESP_LOG_INFO,    'I', tag, format, ##__VA_ARGS__)
+#define DLOGD(tag, format, ...) DLOG_AT(ESP_LOG_DEBUG,   'D', tag, format, ##__VA_ARGS__)
+#define DLOGV(tag, format, ...) DLOG_AT(ESP_LOG_VERBOSE, 'V', tag, format, ##__VA_ARGS__)
+
+#endif // DLOG_H
@@ -0,0 +1,92 @@
+#include "dosing.h"
+#include "sensors.h"
+#include "driver/ledc.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+
+static const char *TAG = "DOSING";
+
+#define DOSING_MODE     LEDC_LOW_SPEED_MODE
+#define DOSING_TIMER    LEDC_TIMER_0
+#define DOSING_CHANNEL  LEDC_CHANNEL_0
+
+void dosing_start(void) {
+    ledc_timer_config_t timer = {
+        .speed_mode = DOSING_MODE,
+        .duty_resolution = (ledc_timer_bit_t)DOSING_PWM_BITS,
+        .timer_num = DOSING_TIMER,
+        .freq_hz = DOSING_PWM_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&timer));
+    ledc_channel_config_t channel = {
+        .gpio_num = FERT_PWM_PIN,
+        .speed_mode = DOSING_MODE,
+        .channel = DOSING_CHANNEL,
+        .timer_sel = DOSING_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    ESP_ERROR_CHECK(ledc_channel_config(&channel));
+    ESP_LOGI(TAG, "🧪 Fertilizer pump PWM on GPIO %d (%d Hz)", FERT_PWM_PIN, DOSING_PWM_FREQ_HZ);
+}
+
+void dosing_set_duty(uint16_t permille) {
+    uint32_t duty = (uint32_t)permille * ((1U << DOSING_PWM_BITS) - 1) / 1000;
+    ledc_set_duty(DOSING_MODE, DOSING_CHANNEL, duty);
+    ledc_update_duty(DOSING_MODE, DOSING_CHANNEL);
+}
+
+void IRAM_ATTR dosing_cut_isr(void) {
+    ledc_stop(DOSING_MODE, DOSING_CHANNEL, 0);
+}
+
+// Between the stall duty and full duty the pump's flow is taken as linear,
+// so a drive of 0..1000 permille of full flow maps onto that range
+static uint16_t duty_for(int32_t drive) {
+    return drive > 0 ? (uint16_t)(DOSING_MIN_DUTY + drive * (1000 - DOSING_MIN_DUTY) / 1000) : 0;
+}
+
+// Drive for a flow of want (ul/min) from a pump that gives full (ul/min)
+static int32_t drive_for(int64_t want, int64_t full) {
+    int64_t drive = want * 1000 / (full > 0 ? full : 1);
+    return (int32_t)(drive < 0 ? 0 : (drive > 1000 ? 1000 : drive));
+}
+
+uint16_t dosing_begin(dosing_run_t *run, uint32_t ratio_ml_l, uint32_t water_ml, int64_t now_us) {
+    *run = (dosing_run_t){
+        .ratio_ml_l = ratio_ml_l,
+        .water_base_ml = water_ml,
+        .start_us = now_us,
+        .last_us = now_us,
+    };
+    // ml/L times ml/min is ul/min
+    run->drive = drive_for((int64_t)ratio_ml_l * DOSING_WATER_ML_MIN, (int64_t)DOSING_FULL_ML_MIN * 1000);
+    return duty_for(run->drive);
+}
+
+uint16_t dosing_next(dosing_run_t *run, uint32_t water_ml, uint32_t fert_ml, int64_t now_us) {
+    run->drive_ms += (int64_t)run->drive * ((now_us - run->last_us) / 1000);
+    run->last_us = now_us;
+    int64_t run_ms = (now_us - run->start_us) / 1000;
+    uint32_t water = water_ml > run->water_base_ml ? water_ml - run->water_base_ml : 0;
+
+    // The water's mean flow over the run, and the pump's flow at full drive
+    // from what it delivered for the drive it had
+    int64_t water_ml_min = water && run_ms > 0 ? (int64_t)water * 60000 / run_ms : DOSING_WATER_ML_MIN;
+    int64_t full = (int64_t)DOSING_FULL_ML_MIN * 1000;
+    if (fert_ml >= DOSING_LEARN_ML && run->drive_ms > 0) {
+        full = (int64_t)fert_ml * 1000 * 60000 * 1000 / run->drive_ms;
+    }
+
+    // Follow the water, and make up the volume the mix is off by
+    int64_t behind_ul = (int64_t)run->ratio_ml_l * water - (int64_t)fert_ml * 1000;
+    int64_t want = (int64_t)run->ratio_ml_l * water_ml_min + behind_ul * 60000 / DOSING_CATCHUP_MS;
+    run->drive = drive_for(want, full);
+    return duty_for(run->drive);
+}
+
+uint32_t dosing_ratio_ml_l(const dosing_run_t *run, uint32_t water_ml, uint32_t fert_ml) {
+    uint32_t water = water_ml > run->water_base_ml ? water_ml - run->water_base_ml : 0;
+    return water ? (uint32_t)((uint64_t)fert_ml * 1000 / water) : 0;
+}
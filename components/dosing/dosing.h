@@ -0,0 +1,50 @@
+#ifndef DOSING_H
+#define DOSING_H
+
+#include <stdint.h>
+
+// Proportional fertilizer dosing: instead of a stage of its own after the
+// water, the fertilizer pump runs alongside it, switched by a MOSFET on
+// FERT_PWM_PIN that LEDC drives at the duty keeping its flow a set ratio of
+// the water flow. Both flow meters close the loop: every DOSING_TICK_MS the
+// duty follows the water meter and makes up whatever the fertilizer meter
+// is behind or ahead, so the mix stays even through the run, and the pump's
+// real flow per duty is learned as it goes (wear, tank head).
+#define DOSING_PWM_FREQ_HZ  20000   // above hearing, slow enough for a plain MOSFET driver
+#define DOSING_PWM_BITS     10
+#define DOSING_MIN_DUTY     200     // permille: the pump stalls below this
+#define DOSING_FULL_ML_MIN  500     // fertilizer pump at full duty (first guess, learned per run)
+#define DOSING_WATER_ML_MIN 2000    // water line (first guess, until its meter has counted)
+#define DOSING_LEARN_ML     10      // fertilizer counted before its flow replaces the guess
+#define DOSING_TICK_MS      250
+#define DOSING_CATCHUP_MS   2000    // a volume behind or ahead is made up over this long
+#define DOSING_RATIO_MAX    1000    // ml of fertilizer per litre of water
+#define DOSING_WATER_METER  0       // FLOW_METER_TABLE row of the line the fertilizer joins
+
+// One mixed run, from the first tick to the last
+typedef struct {
+    uint32_t ratio_ml_l;
+    uint32_t water_base_ml;     // the water meter's count when the run began
+    int64_t start_us;
+    int64_t last_us;
+    int32_t drive;              // permille of the pump's full flow since the last tick
+    int64_t drive_ms;           // drive integrated over the run (permille * ms)
+} dosing_run_t;
+
+// LEDC timer and channel on FERT_PWM_PIN, output off (call once, from the
+// owner's task)
+void dosing_start(void);
+// Fertilizer pump duty in permille, 0 = off
+void dosing_set_duty(uint16_t permille);
+// GPIO ISR (tank_watch_start): output low at once, until dosing_set_duty
+void dosing_cut_isr(void);
+
+// A mixed run begins with the water meter at water_ml: the duty to start with
+uint16_t dosing_begin(dosing_run_t *run, uint32_t ratio_ml_l, uint32_t water_ml, int64_t now_us);
+// Duty until the next tick, from both meters' counts (water_ml as passed to
+// dosing_begin, fert_ml since the fertilizer meter's run started)
+uint16_t dosing_next(dosing_run_t *run, uint32_t water_ml, uint32_t fert_ml, int64_t now_us);
+// Fertilizer per litre of water over the run so far
+uint32_t dosing_ratio_ml_l(const dosing_run_t *run, uint32_t water_ml, uint32_t fert_ml);
+
+#endif // DOSING_H
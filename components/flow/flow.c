@@ -0,0 +1,103 @@
+#include "flow.h"
+#include "driver/pulse_cnt.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "dlog.h"
+#include <stdatomic.h>
+
+static const char *TAG = "FLOW";
+
+static const flow_meter_config_t meters[] = FLOW_METER_TABLE;
+#define METER_COUNT ((int)(sizeof(meters) / sizeof(meters[0])))
+_Static_assert(METER_COUNT <= FLOW_METER_MAX, "too many meters in FLOW_METER_TABLE");
+
+static pcnt_unit_handle_t units[FLOW_METER_MAX];
+// The meters' relays for the ISR: the table above is in flash, which the
+// ISR may not touch while a flash write has the cache off
+static DRAM_ATTR uint64_t cut_mask[FLOW_METER_MAX];
+static int targets[FLOW_METER_MAX];    // watch point of the running dose, 0 = none
+static flow_notify_t flow_notify;
+static atomic_uint flow_done;
+
+int flow_meter_count(void) {
+    return METER_COUNT;
+}
+
+const flow_meter_config_t *flow_meter_config(int meter) {
+    return meter >= 0 && meter < METER_COUNT ? &meters[meter] : NULL;
+}
+
+// PCNT ISR: a watch point was reached. The high limit only makes the driver
+// carry the count over; the dose target ends the run.
+static bool IRAM_ATTR on_reach(pcnt_unit_handle_t unit, const pcnt_watch_event_data_t *edata, void *ctx) {
+    int meter = (int)(uintptr_t)ctx;
+    if (targets[meter] == 0 || edata->watch_point_value != targets[meter]) {
+        return false;
+    }
+    relays_write(0, cut_mask[meter]);
+    atomic_fetch_or_explicit(&flow_done, 1U << meter, memory_order_relaxed);
+    return flow_notify();
+}
+
+void flow_start(flow_notify_t notify) {
+    flow_notify = notify;
+    for (int m = 0; m < METER_COUNT; m++) {
+        const flow_meter_config_t *cfg = &meters[m];
+        cut_mask[m] = cfg->relays;
+        pcnt_unit_config_t unit_cfg = {
+            .low_limit = -1,
+            .high_limit = FLOW_PCNT_LIMIT,
+            .flags.accum_count = true,
+        };
+        ESP_ERROR_CHECK(pcnt_new_unit(&unit_cfg, &units[m]));
+        pcnt_glitch_filter_config_t filter = { .max_glitch_ns = FLOW_GLITCH_NS };
+        ESP_ERROR_CHECK(pcnt_unit_set_glitch_filter(units[m], &filter));
+
+        // Count rising edges only; the meter never runs backwards
+        pcnt_chan_config_t chan_cfg = { .edge_gpio_num = cfg->pin, .level_gpio_num = -1 };
+        pcnt_channel_handle_t chan = NULL;
+        ESP_ERROR_CHECK(pcnt_new_channel(units[m], &chan_cfg, &chan));
+        ESP_ERROR_CHECK(pcnt_channel_set_edge_action(chan, PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+                                                     PCNT_CHANNEL_EDGE_ACTION_HOLD));
+
+        ESP_ERROR_CHECK(pcnt_unit_add_watch_point(units[m], FLOW_PCNT_LIMIT));
+        pcnt_event_callbacks_t cbs = { .on_reach = on_reach };
+        ESP_ERROR_CHECK(pcnt_unit_register_event_callbacks(units[m], &cbs, (void *)(uintptr_t)m));
+        ESP_ERROR_CHECK(pcnt_unit_enable(units[m]));
+        ESP_ERROR_CHECK(pcnt_unit_clear_count(units[m]));
+        ESP_ERROR_CHECK(pcnt_unit_start(units[m]));
+        ESP_LOGI(TAG, "💧 Flow meter '%s' on GPIO %d (%u pulses/L)", cfg->name, cfg->pin,
+                 (unsigned)cfg->pulses_per_l);
+    }
+}
+
+// Called from the control task: deferred logging only
+void flow_run_start(int meter, uint32_t target_ml) {
+    if (targets[meter]) {
+        pcnt_unit_remove_watch_point(units[meter], targets[meter]);
+        targets[meter] = 0;
+    }
+    atomic_fetch_and_explicit(&flow_done, ~(1U << meter), memory_order_relaxed);
+    if (target_ml) {
+        uint32_t k = meters[meter].pulses_per_l;
+        uint64_t pulses = ((uint64_t)target_ml * k + 999) / 1000;
+        if (pulses >= FLOW_PCNT_LIMIT) {
+            pulses = FLOW_PCNT_LIMIT - 1;
+            DLOGW(TAG, "Meter %d: dose capped at %u ml", meter, (unsigned)(pulses * 1000 / k));
+        }
+        targets[meter] = (int)pulses;
+        ESP_ERROR_CHECK(pcnt_unit_add_watch_point(units[meter], targets[meter]));
+    }
+    // Also makes a new watch point take effect
+    pcnt_unit_clear_count(units[meter]);
+}
+
+uint32_t flow_run_ml(int meter) {
+    int count = 0;
+    pcnt_unit_get_count(units[meter], &count);
+    return count > 0 ? (uint32_t)((uint64_t)count * 1000 / meters[meter].pulses_per_l) : 0;
+}
+
+uint32_t flow_take_done(void) {
+    return atomic_exchange_explicit(&flow_done, 0, memory_order_relaxed);
+}
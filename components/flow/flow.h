@@ -0,0 +1,51 @@
+#ifndef FLOW_H
+#define FLOW_H
+
+#include "sensors.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Flow meters: a turbine sensor on each pump line whose pulses a PCNT unit
+// counts in hardware, so measuring costs no CPU however fast they come. A
+// run of a meter lasts from the first of its relays switching on to the
+// last switching off. With a target volume, a PCNT watch point fires when
+// the run has passed it: the ISR switches the meter's relays off at once
+// and notifies the owner, the same way a tank switch cuts its pumps.
+#define FLOW_PIN_WATER      GPIO_NUM_32
+#define FLOW_PIN_FERT       GPIO_NUM_33
+
+typedef struct {
+    const char *name;
+    gpio_num_t pin;
+    uint16_t pulses_per_l;      // K factor from the meter's datasheet
+    uint64_t relays;            // relay pins whose flow passes the meter
+} flow_meter_config_t;
+
+// Append rows to add meters (up to FLOW_METER_MAX; the ESP32 has 8 PCNT
+// units). A zone whose relay no meter covers always waters by time.
+#define FLOW_METER_TABLE { \
+    { .name = "water", .pin = FLOW_PIN_WATER, .pulses_per_l = 450, .relays = 1ULL << RELAY_PUMP1 }, \
+    { .name = "fert", .pin = FLOW_PIN_FERT, .pulses_per_l = 2200, .relays = 1ULL << RELAY_PUMP2 }, \
+}
+#define FLOW_METER_MAX      4
+
+#define FLOW_PCNT_LIMIT     30000   // counter high limit; the driver accumulates past it
+#define FLOW_GLITCH_NS      10000   // shorter pulses are noise on the line
+
+// Runs in the PCNT ISR; returns true if it woke a higher-priority task
+typedef bool (*flow_notify_t)(void);
+
+int flow_meter_count(void);
+const flow_meter_config_t *flow_meter_config(int meter);
+
+// Create and start a PCNT unit per meter (call once, from the owner's task)
+void flow_start(flow_notify_t notify);
+// A run of the meter starts: zero its count and, with target_ml > 0, cut
+// its relays once that much has passed (capped at FLOW_PCNT_LIMIT pulses)
+void flow_run_start(int meter, uint32_t target_ml);
+// Volume passed since flow_run_start
+uint32_t flow_run_ml(int meter);
+// Meters (bit per meter) whose target the ISR reached since the last call
+uint32_t flow_take_done(void);
+
+#endif // FLOW_H
@@ -0,0 +1,444 @@
+#include "history.h"
+#include "system_state.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "HISTORY";
+
+// Record encoding, one tag byte then optional fields:
+//   bit 7     F: a flags byte follows
+//   bits 6..3 S: soil delta + 7 (0..14), 15 = zigzag varint follows
+//   bits 2..0 T: 0 = same dt as the previous record, 1..6 = dt in seconds,
+//                7 = varint dt follows
+// A periodic sample with a small soil change is a single byte.
+#define TAG_FLAGS       0x80
+#define SOIL_BIAS       7
+#define SOIL_ESCAPE     15
+#define DT_SAME         0
+#define DT_INLINE_MAX   6
+#define DT_ESCAPE       7
+#define RECORD_MAX      12     // tag + 5-byte dt + 5-byte soil + flags
+
+typedef struct {
+    uint32_t id;            // monotonic block number
+    uint32_t t0;            // first record, stored absolute
+    uint32_t t_last;        // last record, so readers can skip whole blocks
+    uint16_t soil0;
+    uint16_t soil_last;
+    uint8_t flags0;
+    uint8_t flags_last;
+    uint8_t used;           // payload bytes
+    uint8_t count;          // records including the absolute one
+} block_header_t;
+
+#define BLOCK_PAYLOAD (HISTORY_BLOCK_BYTES - sizeof(block_header_t))
+
+typedef struct {
+    block_header_t h;
+    uint8_t data[BLOCK_PAYLOAD];
+} history_block_t;
+
+_Static_assert(sizeof(history_block_t) == HISTORY_BLOCK_BYTES, "block layout");
+_Static_assert(BLOCK_PAYLOAD <= 255, "used/count are 8-bit");
+
+// Each block has its own seqlock so a reader never waits on the writer and
+// only retries the one block it raced with.
+static history_block_t ring[HISTORY_BLOCKS];
+static atomic_uint block_seq[HISTORY_BLOCKS];
+static atomic_uint blocks_started = 0;    // block n lives in ring[n % HISTORY_BLOCKS]
+
+// Writer-only encoder state
+static history_block_t *cur = NULL;
+static unsigned cur_slot;
+static uint32_t last_t, last_dt;
+static int last_soil;
+static uint8_t last_flags;
+static uint32_t next_sample_t;     // soil sample cadence, independent of events
+
+typedef struct {
+    uint32_t t;
+    int soil;
+    uint8_t flags;
+} sample_t;
+
+uint32_t history_now_s(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+/* ------------------------------------------------------------ encoding */
+
+static size_t put_varint(uint8_t *p, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool get_varint(const uint8_t *p, size_t len, size_t *pos, uint32_t *out) {
+    uint32_t v = 0;
+    for (unsigned shift = 0; shift < 35 && *pos < len; shift += 7) {
+        uint8_t b = p[(*pos)++];
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if ((b & 0x80) == 0) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t encode_record(uint8_t *p, uint32_t dt, int soil_delta, uint8_t flags, bool flags_changed) {
+    size_t n = 1;
+    uint8_t tag = flags_changed ? TAG_FLAGS : 0;
+
+    if (soil_delta >= -SOIL_BIAS && soil_delta <= SOIL_BIAS) {
+        tag |= (uint8_t)((soil_delta + SOIL_BIAS) << 3);
+    } else {
+        tag |= SOIL_ESCAPE << 3;
+    }
+    if (dt == last_dt && dt != 0) {
+        tag |= DT_SAME;
+    } else if (dt >= 1 && dt <= DT_INLINE_MAX) {
+        tag |= (uint8_t)dt;
+    } else {
+        tag |= DT_ESCAPE;
+        n += put_varint(p + n, dt);
+    }
+    if (((tag >> 3) & 0x0f) == SOIL_ESCAPE) {
+        uint32_t zz = ((uint32_t)soil_delta << 1) ^ (uint32_t)(soil_delta >> 31);
+        n += put_varint(p + n, zz);
+    }
+    if (flags_changed) {
+        p[n++] = flags;
+    }
+    p[0] = tag;
+    return n;
+}
+
+static void block_write_begin(unsigned slot) {
+    unsigned seq = atomic_load_explicit(&block_seq[slot], memory_order_relaxed);
+    atomic_store_explicit(&block_seq[slot], seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static void block_write_end(unsigned slot) {
+    unsigned seq = atomic_load_explicit(&block_seq[slot], memory_order_relaxed);
+    atomic_store_explicit(&block_seq[slot], seq + 1, memory_order_release);
+}
+
+static void start_block(uint32_t t, int soil, uint8_t flags) {
+    unsigned id = atomic_load_explicit(&blocks_started, memory_order_relaxed);
+    cur_slot = id % HISTORY_BLOCKS;
+    cur = &ring[cur_slot];
+
+    block_write_begin(cur_slot);
+    cur->h = (block_header_t){
+        .id = id,
+        .t0 = t,
+        .t_last = t,
+        .soil0 = (uint16_t)soil,
+        .soil_last = (uint16_t)soil,
+        .flags0 = flags,
+        .flags_last = flags,
+        .used = 0,
+        .count = 1,
+    };
+    block_write_end(cur_slot);
+    atomic_store_explicit(&blocks_started, id + 1, memory_order_release);
+    last_dt = 0;
+}
+
+void history_record(uint32_t t_s, int soil, uint8_t flags) {
+    soil = soil < 0 ? 0 : (soil > 0xffff ? 0xffff : soil);
+    if (cur == NULL) {
+        start_block(t_s, soil, flags);
+    } else {
+        if (t_s < last_t) {
+            t_s = last_t;
+        }
+        uint32_t dt = t_s - last_t;
+        uint8_t rec[RECORD_MAX];
+        size_t n = encode_record(rec, dt, soil - last_soil, flags, flags != last_flags);
+
+        if (cur->h.used + n > BLOCK_PAYLOAD || cur->h.count == UINT8_MAX) {
+            start_block(t_s, soil, flags);
+        } else {
+            block_write_begin(cur_slot);
+            memcpy(cur->data + cur->h.used, rec, n);
+            cur->h.used += (uint8_t)n;
+            cur->h.count++;
+            cur->h.t_last = t_s;
+            cur->h.soil_last = (uint16_t)soil;
+            cur->h.flags_last = flags;
+            block_write_end(cur_slot);
+            last_dt = dt;
+        }
+    }
+    last_t = t_s;
+    last_soil = soil;
+    last_flags = flags;
+}
+
+/* ------------------------------------------------------------ decoding */
+
+// Copy block `id` out of the ring; false if it was overwritten meanwhile
+static bool block_copy(uint32_t id, history_block_t *out) {
+    unsigned slot = id % HISTORY_BLOCKS;
+    for (unsigned spins = 1;; spins++) {
+        unsigned before = atomic_load_explicit(&block_seq[slot], memory_order_acquire);
+        if ((before & 1) == 0) {
+            memcpy(out, &ring[slot], sizeof(*out));
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&block_seq[slot], memory_order_relaxed) == before) {
+                return out->h.id == id;
+            }
+        }
+        // The writer was preempted mid-append: let it finish
+        if (spins % 64 == 0) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+typedef void (*sample_fn_t)(const sample_t *s, void *ctx);
+
+static void decode_block(const history_block_t *b, sample_fn_t fn, void *ctx) {
+    sample_t s = { .t = b->h.t0, .soil = b->h.soil0, .flags = b->h.flags0 };
+    uint32_t prev_dt = 0;
+    size_t pos = 0;
+
+    fn(&s, ctx);
+    while (pos < b->h.used) {
+        uint8_t tag = b->data[pos++];
+        uint32_t dt = tag & 0x07;
+        unsigned soil_code = (tag >> 3) & 0x0f;
+
+        if (dt == DT_SAME) {
+            dt = prev_dt;
+        } else if (dt == DT_ESCAPE && !get_varint(b->data, b->h.used, &pos, &dt)) {
+            return;
+        }
+        if (soil_code == SOIL_ESCAPE) {
+            uint32_t zz;
+            if (!get_varint(b->data, b->h.used, &pos, &zz)) {
+                return;
+            }
+            s.soil += (int)(zz >> 1) ^ -(int)(zz & 1);
+        } else {
+            s.soil += (int)soil_code - SOIL_BIAS;
+        }
+        if (tag & TAG_FLAGS) {
+            if (pos >= b->h.used) {
+                return;
+            }
+            s.flags = b->data[pos++];
+        }
+        s.t += dt;
+        prev_dt = dt;
+        fn(&s, ctx);
+    }
+}
+
+/* --------------------------------------------------------------- query */
+
+typedef struct {
+    uint32_t from, to, step;
+    int points;
+    history_bucket_t *out;
+    uint32_t soil_sum[HISTORY_MAX_POINTS];
+    uint16_t soil_n[HISTORY_MAX_POINTS];
+    uint16_t soil_end[HISTORY_MAX_POINTS];   // last sample, held into empty buckets
+    sample_t prev;
+    bool have_prev;
+    int held;                                // value in effect at `from`
+    bool have_held;
+} query_t;
+
+static void mark_tank(int8_t *v, bool full) {
+    if (!full) {
+        *v = 0;
+    } else if (*v < 0) {
+        *v = 1;
+    }
+}
+
+// Credit [a, b) spent in state `flags` to the buckets it overlaps
+static void query_span(query_t *q, uint32_t a, uint32_t b, uint8_t flags) {
+    a = a < q->from ? q->from : a;
+    b = b > q->to ? q->to : b;
+    while (a < b) {
+        int k = (int)((a - q->from) / q->step);
+        if (k >= q->points) {
+            return;
+        }
+        uint32_t end = q->from + (uint32_t)(k + 1) * q->step;
+        end = end > b ? b : end;
+        history_bucket_t *bk = &q->out[k];
+        if (flags & HISTORY_PUMP1_ON) {
+            bk->pump1_on_s += end - a;
+        }
+        if (flags & HISTORY_PUMP2_ON) {
+            bk->pump2_on_s += end - a;
+        }
+        mark_tank(&bk->water_full, flags & HISTORY_WATER_FULL);
+        mark_tank(&bk->fert_full, flags & HISTORY_FERT_FULL);
+        a = end;
+    }
+}
+
+static void query_sample(const sample_t *s, void *ctx) {
+    query_t *q = ctx;
+    if (q->have_prev) {
+        query_span(q, q->prev.t, s->t, q->prev.flags);
+    }
+    if (s->t < q->from) {
+        q->held = s->soil;
+        q->have_held = true;
+    } else if (s->t < q->to) {
+        int k = (int)((s->t - q->from) / q->step);
+        history_bucket_t *bk = &q->out[k];
+        uint16_t v = (uint16_t)s->soil;
+        if (q->soil_n[k] == 0 || v < bk->soil_min) {
+            bk->soil_min = v;
+        }
+        if (q->soil_n[k] == 0 || v > bk->soil_max) {
+            bk->soil_max = v;
+        }
+        q->soil_sum[k] += v;
+        q->soil_n[k]++;
+        q->soil_end[k] = v;
+    }
+    q->prev = *s;
+    q->have_prev = true;
+}
+
+int history_query(uint32_t from_s, uint32_t to_s, int points,
+                  history_bucket_t *out, uint32_t *step_s) {
+    if (to_s <= from_s || points <= 0) {
+        return 0;
+    }
+    if (points > HISTORY_MAX_POINTS) {
+        points = HISTORY_MAX_POINTS;
+    }
+    query_t q = {
+        .from = from_s,
+        .to = to_s,
+        .step = (to_s - from_s + (uint32_t)points - 1) / (uint32_t)points,
+    };
+    q.points = (int)((to_s - from_s + q.step - 1) / q.step);
+    q.out = out;
+    memset(out, 0, (size_t)q.points * sizeof(*out));
+    for (int k = 0; k < q.points; k++) {
+        out[k].t = from_s + (uint32_t)k * q.step;
+        out[k].water_full = -1;
+        out[k].fert_full = -1;
+    }
+
+    uint32_t end = atomic_load_explicit(&blocks_started, memory_order_acquire);
+    uint32_t first = end > HISTORY_BLOCKS ? end - HISTORY_BLOCKS : 0;
+    history_block_t b;
+    for (uint32_t id = first; id < end; id++) {
+        if (!block_copy(id, &b)) {
+            continue;   // overwritten while we were reading older blocks
+        }
+        if (b.h.t0 >= to_s) {
+            break;
+        }
+        if (b.h.t_last < from_s) {
+            // Entirely before the range: only its last state matters
+            sample_t last = { .t = b.h.t_last, .soil = b.h.soil_last, .flags = b.h.flags_last };
+            q.prev = last;
+            q.have_prev = true;
+            q.held = last.soil;
+            q.have_held = true;
+            continue;
+        }
+        decode_block(&b, query_sample, &q);
+    }
+    if (q.have_prev) {
+        // The last state holds until now
+        uint32_t now = history_now_s();
+        query_span(&q, q.prev.t, now > q.prev.t ? now : q.prev.t, q.prev.flags);
+    }
+
+    for (int k = 0; k < q.points; k++) {
+        if (q.soil_n[k]) {
+            out[k].soil_avg = (uint16_t)(q.soil_sum[k] / q.soil_n[k]);
+            out[k].has_soil = true;
+            q.held = q.soil_end[k];
+            q.have_held = true;
+        } else if (q.have_held) {
+            out[k].soil_min = out[k].soil_max = out[k].soil_avg = (uint16_t)q.held;
+            out[k].has_soil = true;
+        }
+    }
+    *step_s = q.step;
+    return q.points;
+}
+
+void history_get_stats(history_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    uint32_t end = atomic_load_explicit(&blocks_started, memory_order_acquire);
+    uint32_t first = end > HISTORY_BLOCKS ? end - HISTORY_BLOCKS : 0;
+    bool have_oldest = false;
+    block_header_t h;
+    for (uint32_t id = first; id < end; id++) {
+        unsigned slot = id % HISTORY_BLOCKS;
+        unsigned before = atomic_load_explicit(&block_seq[slot], memory_order_acquire);
+        memcpy(&h, &ring[slot].h, sizeof(h));
+        atomic_thread_fence(memory_order_acquire);
+        if ((before & 1) || atomic_load_explicit(&block_seq[slot], memory_order_relaxed) != before ||
+            h.id != id) {
+            continue;   // approximate counters are fine here
+        }
+        if (!have_oldest) {
+            stats->oldest_s = h.t0;
+            have_oldest = true;
+        }
+        stats->records += h.count;
+        stats->bytes_used += h.used;
+    }
+    stats->dropped_blocks = first;
+}
+
+/* -------------------------------------------------------------- source */
+
+static uint8_t state_flags(const system_state_t *st) {
+    return (st->water_tank_full ? HISTORY_WATER_FULL : 0) |
+           (st->fertilizer_tank_full ? HISTORY_FERT_FULL : 0) |
+           (st->pump1_running ? HISTORY_PUMP1_ON : 0) |
+           (st->pump2_running ? HISTORY_PUMP2_ON : 0);
+}
+
+// Runs in the control task right after it publishes, so it is the only writer
+static void on_state_change(uint32_t version, void *ctx) {
+    (void)version;
+    (void)ctx;
+    system_state_t st;
+    system_state_read(&st);
+
+    uint32_t now = history_now_s();
+    uint8_t flags = state_flags(&st);
+    bool sample_due = cur == NULL || (int32_t)(now - next_sample_t) >= 0;
+    if (flags == last_flags && (!sample_due || st.soil_moisture == last_soil)) {
+        return;   // soil is sampled at most once per period; values hold
+    }
+    if (sample_due) {
+        next_sample_t = now + HISTORY_SAMPLE_S;
+    }
+    history_record(now, st.soil_moisture, flags);
+}
+
+void history_init(void) {
+    // The first publish from the control task writes the first record
+    system_state_add_listener(on_state_change, NULL);
+    ESP_LOGI(TAG, "📈 History ready: %d blocks x %d bytes, soil every %d s",
+             HISTORY_BLOCKS, HISTORY_BLOCK_BYTES, HISTORY_SAMPLE_S);
+}
@@ -0,0 +1,62 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// In-RAM trend history of soil moisture, tank levels and pump states.
+//
+// Samples are change-driven: a record is written whenever a tank or pump
+// state changes, and at most every HISTORY_SAMPLE_S for soil moisture.
+// Values hold until the next record. Records are delta/bit-packed into
+// fixed-size blocks; each block starts with absolute values, so the oldest
+// block can be dropped whole when the ring is full.
+#define HISTORY_BLOCKS       64      // ring size: HISTORY_BLOCKS * HISTORY_BLOCK_BYTES
+#define HISTORY_BLOCK_BYTES  128
+#define HISTORY_SAMPLE_S     60      // soil moisture sample period
+#define HISTORY_MAX_POINTS   120     // buckets per query
+
+// State bits stored with every record
+#define HISTORY_WATER_FULL   (1U << 0)
+#define HISTORY_FERT_FULL    (1U << 1)
+#define HISTORY_PUMP1_ON     (1U << 2)
+#define HISTORY_PUMP2_ON     (1U << 3)
+
+// One downsampled bucket [t, t + step)
+typedef struct {
+    uint32_t t;             // bucket start, seconds since boot
+    uint16_t soil_min;
+    uint16_t soil_max;
+    uint16_t soil_avg;
+    bool has_soil;          // false before the first recorded sample
+    uint32_t pump1_on_s;    // seconds each pump ran within the bucket
+    uint32_t pump2_on_s;
+    int8_t water_full;      // 1 full throughout, 0 empty at some point, -1 unknown
+    int8_t fert_full;
+} history_bucket_t;
+
+typedef struct {
+    uint32_t records;       // records currently held
+    uint32_t bytes_used;    // encoded bytes currently held (payload only)
+    uint32_t oldest_s;      // time of the oldest held record
+    uint32_t dropped_blocks;
+} history_stats_t;
+
+// Start recording (subscribes to published state changes)
+void history_init(void);
+
+// Append a sample; called from the state listener, usable directly too.
+// Single writer.
+void history_record(uint32_t t_s, int soil, uint8_t flags);
+
+// Downsample [from_s, to_s) into `points` equal buckets. Lock-free with
+// respect to the writer. Returns the number of buckets filled (0 if the
+// range is empty), the bucket width in *step_s.
+int history_query(uint32_t from_s, uint32_t to_s, int points,
+                  history_bucket_t *out, uint32_t *step_s);
+
+void history_get_stats(history_stats_t *stats);
+uint32_t history_now_s(void);
+
+#endif // HISTORY_H
@@ -1,122 +1,961 @@
 #include "irrigation_control.h"
 #include "esp_log.h"
+#include "esp_attr.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "esp_timer.h"
+#include "power.h"
+#include "schedule.h"
+#include "rt.h"
+#include "metrics.h"
+#include "dlog.h"
+#include "mem.h"
+#include "flow.h"
+#include "dosing.h"
 
 static const char *TAG = "IRRIGATION_CTRL";
 
-// External references to shared state
-extern int current_soil_moisture;
-extern bool current_water_tank_full;
-extern bool current_fertilizer_tank_full;
-extern bool pump1_running;
-extern bool pump2_running;
-extern bool auto_mode;
-extern bool pump1_manual;
-extern bool pump2_manual;
-extern int soil_dry_threshold;
-extern int pump_duration_ms;
-extern int fertilizer_duration_ms;
-extern int check_interval_ms;
+// Control loop states. Every transition is driven by an event, never by a
+// sleep, so commands and deadlines are handled as soon as they arrive.
+typedef enum {
+    IRRIGATION_IDLE,        // waiting for the next periodic check
+    IRRIGATION_WATERING,    // dry zones on until each zone's deadline (fertilizer mixed in)
+    IRRIGATION_SETTLING,    // pause between water and fertilizer
+    IRRIGATION_FERTILIZING, // pump 2 on until the step timer fires
+} irrigation_state_t;
+
+#define SETTLE_MS 1000
+
+static TaskHandle_t irrigation_task_handle = NULL;
+static esp_timer_handle_t check_timer = NULL;   // next periodic check
+static esp_timer_handle_t step_timer = NULL;    // current pump/pause deadline
+static esp_timer_handle_t tank_timer = NULL;    // re-read a tank switch once it settles
+static esp_timer_handle_t mix_timer = NULL;     // trim the fertilizer duty while mixing
+static irrigation_state_t state = IRRIGATION_IDLE;
+static int64_t idle_since_us = 0;
+static int64_t check_due_us = 0;     // when check_timer should fire, 0 = not armed
+static bool sleep_wanted = false;    // last check found nothing to do
+
+// Working copy of the shared state; published after every event
+static system_state_t st;
+
+// Zone table resolved once at start: the relay bit and probe of each zone
+static int zones;
+static uint64_t zone_relay_bit[SYSTEM_MAX_ZONES];
+static uint8_t zone_probe[SYSTEM_MAX_ZONES];
+
+// Flow meters resolved once at start: the relays each one measures, and the
+// meter of each zone and of the fertilizer pump (-1 = none, dosed by time)
+static int meters;
+static uint64_t meter_relays[SYSTEM_MAX_METERS];
+static int8_t zone_meter[SYSTEM_MAX_ZONES];
+static int8_t fert_meter;
+
+// Proportional dosing (st.fert_ratio_ml_l > 0): in a mixed cycle the
+// fertilizer pump runs on PWM while zones on the mixing meter's line water,
+// instead of in a stage of its own after them
+static int8_t mix_meter;            // meter of the line the fertilizer joins, -1 = cannot mix
+static uint16_t mix_zones;          // zones on that line
+static bool cycle_mixed;
+static bool mix_applied;
+static uint16_t mix_duty;           // permille, trimmed every DOSING_TICK_MS
+static uint16_t mix_duty_applied;
+static dosing_run_t mix_run;
+
+// Relay outputs. Handlers only change the wanted masks; apply_outputs()
+// switches everything that changed in one relays_write() per event.
+static uint16_t zones_wanted;
+static bool fert_wanted;
+static uint16_t zones_applied;
+static bool fert_applied;
+static uint64_t relays_applied;     // relay pins left on, for the meters' runs
+
+static uint8_t tanks_settling;      // bit per tank_t: switch moved, its relays held off
+
+static uint16_t zones_auto;                         // zones the running cycle waters
+static int64_t zone_deadline_us[SYSTEM_MAX_ZONES];  // their watering deadlines
+
+// Interval rules that fired while a cycle was past its watering stage; the
+// next check starts them. sched_run_ms overrides a zone's duration (0 = own).
+static uint16_t sched_pending;
+static uint32_t sched_run_ms[SYSTEM_MAX_ZONES];
 
 void control_pump(gpio_num_t relay_pin, bool state) {
     if (state) {
-        gpio_set_level(relay_pin, 0);  // LOW activates relay (active-low)
-        ESP_LOGI(TAG, "Pump ON (GPIO %d)", relay_pin);
+        relays_write(1ULL << relay_pin, 0);  // LOW activates relay (active-low)
+        DLOGI(TAG, "Pump ON (GPIO %d)", relay_pin);
     } else {
-        gpio_set_level(relay_pin, 1);  // HIGH deactivates relay
-        ESP_LOGI(TAG, "Pump OFF (GPIO %d)", relay_pin);
+        relays_write(0, 1ULL << relay_pin);  // HIGH deactivates relay
+        DLOGI(TAG, "Pump OFF (GPIO %d)", relay_pin);
     }
 }
 
 void control_water_alert_led(bool state) {
     gpio_set_level(ALERT_LED_WATER, state ? 1 : 0);
     if (state) {
-        ESP_LOGW(TAG, "🔴 Water Tank LED ON - Tank Empty!");
+        DLOGW(TAG, "🔴 Water Tank LED ON - Tank Empty!");
     } else {
-        ESP_LOGI(TAG, "✓ Water Tank LED OFF");
+        DLOGI(TAG, "✓ Water Tank LED OFF");
     }
 }
 
 void control_fertilizer_alert_led(bool state) {
     gpio_set_level(ALERT_LED_FERT, state ? 1 : 0);
     if (state) {
-        ESP_LOGW(TAG, "🔴 Fertilizer Tank LED ON - Tank Empty!");
+        DLOGW(TAG, "🔴 Fertilizer Tank LED ON - Tank Empty!");
     } else {
-        ESP_LOGI(TAG, "✓ Fertilizer Tank LED OFF");
+        DLOGI(TAG, "✓ Fertilizer Tank LED OFF");
     }
 }
 
-void irrigation_task(void *pvParameters) {
-    ESP_LOGI(TAG, "Irrigation system started");
-    
-    while (1) {
-        // Read soil moisture
-        int soil_moisture = read_soil_moisture();
-        current_soil_moisture = soil_moisture;
-        ESP_LOGI(TAG, "Soil Moisture: %d", soil_moisture);
-        
-        // Read water tank levels
-        int water_level_raw = read_water_level_digital(WATER_LEVEL1);
-        int fertilizer_level_raw = read_water_level_digital(WATER_LEVEL2);
-        
-        bool water_tank_full = water_level_raw;
-        bool fertilizer_tank_full = fertilizer_level_raw;
-        
-        current_water_tank_full = water_tank_full;
-        current_fertilizer_tank_full = fertilizer_tank_full;
-        
-        ESP_LOGI(TAG, "Water Tank [Raw: %d]: %s", water_level_raw, water_tank_full ? "HAS WATER" : "EMPTY");
-        ESP_LOGI(TAG, "Fertilizer Tank [Raw: %d]: %s", fertilizer_level_raw, fertilizer_tank_full ? "HAS LIQUID" : "EMPTY");
-        
-        // Control alert LEDs
-        control_water_alert_led(!water_tank_full);
-        control_fertilizer_alert_led(!fertilizer_tank_full);
-        
-        // Automatic irrigation logic (only if auto mode enabled AND not in manual control)
-        if (auto_mode && !pump1_manual && !pump2_manual) {
-            // Check if soil is dry
-            if (soil_moisture > soil_dry_threshold) {
-                ESP_LOGI(TAG, "Soil is DRY (moisture: %d > %d) - Starting irrigation", soil_moisture, soil_dry_threshold);
-                
-                // Control pump1 (water)
-                if (water_tank_full) {
-                    ESP_LOGI(TAG, "AUTO: Pumping water for %d ms", pump_duration_ms);
-                    control_pump(RELAY_PUMP1, true);
-                    pump1_running = true;
-                    vTaskDelay(pdMS_TO_TICKS(pump_duration_ms));
-                    control_pump(RELAY_PUMP1, false);
-                    pump1_running = false;
-                    
-                    vTaskDelay(pdMS_TO_TICKS(1000));
-                } else {
-                    ESP_LOGW(TAG, "Water tank is EMPTY - cannot irrigate");
-                }
-                
-                // Control pump2 (fertilizer)
-                if (fertilizer_tank_full) {
-                    ESP_LOGI(TAG, "AUTO: Pumping fertilizer for %d ms", fertilizer_duration_ms);
-                    control_pump(RELAY_PUMP2, true);
-                    pump2_running = true;
-                    vTaskDelay(pdMS_TO_TICKS(fertilizer_duration_ms));
-                    control_pump(RELAY_PUMP2, false);
-                    pump2_running = false;
-                } else {
-                    ESP_LOGW(TAG, "Fertilizer tank is EMPTY - skipping");
+void irrigation_init_zones(system_state_t *state) {
+    int n = zone_count();
+    state->zone_count = (uint8_t)(n < SYSTEM_MAX_ZONES ? n : SYSTEM_MAX_ZONES);
+    for (int z = 0; z < state->zone_count; z++) {
+        state->zone_threshold[z] = (uint16_t)state->soil_dry_threshold;
+        state->zone_duration_ms[z] = (uint32_t)state->pump_duration_ms;
+    }
+}
+
+void irrigation_notify(uint32_t events) {
+    TaskHandle_t task = irrigation_task_handle;
+    if (task != NULL) {
+        xTaskNotify(task, events, eSetBits);
+    }
+}
+
+bool irrigation_submit(const system_command_t *cmd) {
+    if (!system_command_post(cmd)) {
+        DLOGW(TAG, "Command mailbox full - command dropped");
+        return false;
+    }
+    irrigation_notify(IRRIGATION_EVT_COMMAND);
+    return true;
+}
+
+bool irrigation_submit_batch(const system_command_t *cmds, unsigned n) {
+    if (!system_command_post_batch(cmds, n)) {
+        DLOGW(TAG, "Command mailbox full - batch of %u dropped", n);
+        return false;
+    }
+    irrigation_notify(IRRIGATION_EVT_COMMAND);
+    return true;
+}
+
+// GPIO ISR context (tank_watch_start); the ISR has already cut the relays
+// and the fertilizer pump's PWM
+static void IRAM_ATTR on_tank_edge(void) {
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(irrigation_task_handle, IRRIGATION_EVT_TANK, eSetBits, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+// PCNT ISR context (flow_start); the ISR has already cut the meter's relays
+static bool IRAM_ATTR on_flow_target(void) {
+    BaseType_t woken = pdFALSE;
+    xTaskNotifyFromISR(irrigation_task_handle, IRRIGATION_EVT_FLOW, eSetBits, &woken);
+    return woken == pdTRUE;
+}
+
+void irrigation_schedule_due(void) {
+    irrigation_notify(IRRIGATION_EVT_SCHEDULE);
+}
+
+static void irrigation_bench_tick(void) {
+    irrigation_notify(IRRIGATION_EVT_BENCH);
+}
+
+static void irrigation_timer_cb(void *arg) {
+    irrigation_notify((uint32_t)(uintptr_t)arg);
+}
+
+static void arm_timer(esp_timer_handle_t timer, int64_t delay_ms) {
+    esp_timer_stop(timer);
+    esp_timer_start_once(timer, delay_ms > 0 ? (uint64_t)delay_ms * 1000 : 1);
+}
+
+static void set_zones(uint16_t mask, bool on) {
+    zones_wanted = on ? (zones_wanted | mask) : (zones_wanted & ~mask);
+}
+
+// Volume to dose on a meter whose run starts now: the sum of the targets of
+// the outputs starting it, or 0 (by time) if any of them runs by time or by
+// hand. Outputs that join a running meter stop with it.
+static uint32_t dose_target_ml(int m, uint16_t zones_started, bool fert_started) {
+    uint32_t ml = 0;
+    for (uint16_t s = zones_started; s; s &= s - 1) {
+        int z = __builtin_ctz(s);
+        if (zone_meter[z] != m) {
+            continue;
+        }
+        if (!(zones_auto & (1U << z)) || st.zone_volume_ml[z] == 0) {
+            return 0;
+        }
+        ml += st.zone_volume_ml[z];
+    }
+    if (fert_started && fert_meter == m) {
+        if (state != IRRIGATION_FERTILIZING || st.fertilizer_volume_ml == 0) {
+            return 0;
+        }
+        ml += st.fertilizer_volume_ml;
+    }
+    return ml;
+}
+
+// Pumps running, by relay pin: the fertilizer pump on PWM counts as its relay
+static uint64_t pumps_running(void) {
+    return relays_applied | (mix_applied ? 1ULL << RELAY_PUMP2 : 0);
+}
+
+// A meter's run starts with the first of its pumps on and ends with the
+// last one off; what it measured in between is published per meter
+static void update_meters(uint64_t pumps_before, uint64_t pumps_now, uint16_t zones_started, bool fert_started) {
+    for (int m = 0; m < meters; m++) {
+        bool was = pumps_before & meter_relays[m];
+        bool now = pumps_now & meter_relays[m];
+        if (now && !was) {
+            uint32_t target = dose_target_ml(m, zones_started, fert_started);
+            flow_run_start(m, target);
+            if (target) {
+                DLOGI(TAG, "💧 Meter %d: dosing %u ml", m + 1, (unsigned)target);
+            }
+        } else if (was && !now) {
+            st.meter_last_ml[m] = flow_run_ml(m);
+            DLOGI(TAG, "💧 Meter %d: %u ml this run", m + 1, (unsigned)st.meter_last_ml[m]);
+        }
+    }
+}
+
+// The meters' runs have started: the first duty comes from the guesses
+static void start_mixing(void) {
+    mix_duty = dosing_begin(&mix_run, st.fert_ratio_ml_l, flow_run_ml(mix_meter), esp_timer_get_time());
+    esp_timer_start_periodic(mix_timer, DOSING_TICK_MS * 1000);
+    DLOGI(TAG, "🧪 Mixing %u ml of fertilizer per litre of water", (unsigned)st.fert_ratio_ml_l);
+}
+
+static void stop_mixing(void) {
+    esp_timer_stop(mix_timer);
+    mix_duty = 0;
+    uint32_t water = flow_run_ml(mix_meter), fert = flow_run_ml(fert_meter);
+    DLOGI(TAG, "🧪 Mixed %u ml of fertilizer into %u ml of water (%u ml/L)", (unsigned)fert,
+          (unsigned)(water - mix_run.water_base_ml), (unsigned)dosing_ratio_ml_l(&mix_run, water, fert));
+}
+
+// Write every relay that changed since the last call in one go and update
+// the outputs in the shared state. Only changed zones are visited. Outputs
+// of a tank whose switch is still settling stay off.
+static void apply_outputs(void) {
+    uint16_t zones_on = (tanks_settling & (1U << TANK_WATER)) ? 0 : zones_wanted;
+    bool fert_on = !(tanks_settling & (1U << TANK_FERT)) && fert_wanted;
+    // A mixed cycle's fertilizer flows while a zone on the mixing line does
+    bool mix_on = cycle_mixed && (zones_on & zones_auto & mix_zones) && st.fertilizer_tank_full &&
+                  !(tanks_settling & (1U << TANK_FERT));
+    uint64_t on_mask = 0, off_mask = 0;
+    for (uint16_t changed = zones_on ^ zones_applied; changed; changed &= changed - 1) {
+        int z = __builtin_ctz(changed);
+        if (zones_on & (1U << z)) {
+            on_mask |= zone_relay_bit[z];
+        } else {
+            off_mask |= zone_relay_bit[z];
+        }
+    }
+    if (zones_on & ~zones_applied) {
+        power_note_pump_on();
+    }
+    if (fert_on != fert_applied) {
+        if (fert_on) {
+            on_mask |= 1ULL << RELAY_PUMP2;
+        } else {
+            off_mask |= 1ULL << RELAY_PUMP2;
+        }
+    }
+    uint64_t pumps_before = pumps_running();
+    if (on_mask | off_mask) {
+        relays_write(on_mask, off_mask);
+        DLOGI(TAG, "Relays: %d ON, %d OFF (zones 0x%04x, fertilizer %d)",
+              __builtin_popcountll(on_mask), __builtin_popcountll(off_mask),
+              zones_on, fert_on);
+        relays_applied = (relays_applied | on_mask) & ~off_mask;
+    }
+    bool mix_started = mix_on && !mix_applied, mix_stopped = !mix_on && mix_applied;
+    mix_applied = mix_on;
+    if (pumps_running() != pumps_before) {
+        update_meters(pumps_before, pumps_running(), zones_on & ~zones_applied, fert_on && !fert_applied);
+    }
+    if (mix_started) {
+        start_mixing();
+    } else if (mix_stopped) {
+        stop_mixing();
+    }
+    if (mix_duty != mix_duty_applied) {
+        dosing_set_duty(mix_duty);
+        mix_duty_applied = mix_duty;
+    }
+    zones_applied = zones_on;
+    fert_applied = fert_on;
+    st.zones_watering = zones_on;
+    st.pump1_running = zones_on != 0;
+    st.pump2_running = fert_on || mix_on;
+}
+
+// The single-bed fields mirror zone 1 for the dashboard, history and NVS
+static void sync_zone1_fields(void) {
+    st.soil_moisture = st.zone_soil[0];
+    st.soil_dry_threshold = st.zone_threshold[0];
+    st.pump_duration_ms = (int)st.zone_duration_ms[0];
+    st.pump1_manual = st.zones_manual != 0;
+}
+
+// Next check is one interval after the last cycle ended, so a new interval
+// from the settings page applies immediately instead of after the old one.
+static void schedule_check(void) {
+    int64_t now = esp_timer_get_time();
+    int64_t delay_ms = st.check_interval_ms - (now - idle_since_us) / 1000;
+    arm_timer(check_timer, delay_ms);
+    check_due_us = now + (delay_ms > 0 ? delay_ms * 1000 : 0);
+}
+
+// How late the periodic check runs after its deadline (timer task, wakeup
+// and whatever the control task was still doing)
+static void note_check_jitter(void) {
+    int64_t late_us = esp_timer_get_time() - check_due_us;
+    if (check_due_us != 0 && late_us >= 0) {
+        metrics_observe(METRIC_LOOP_JITTER, (uint32_t)late_us);
+    }
+    check_due_us = 0;
+}
+
+static void finish_cycle(void) {
+    state = IRRIGATION_IDLE;
+    cycle_mixed = false;
+    idle_since_us = esp_timer_get_time();
+    DLOGI(TAG, "Waiting %d seconds before next check...", st.check_interval_ms / 1000);
+    schedule_check();
+}
+
+static void start_fertilizer_stage(void) {
+    if (st.fertilizer_tank_full) {
+        if (fert_meter >= 0 && st.fertilizer_volume_ml) {
+            DLOGI(TAG, "AUTO: Dosing %u ml of fertilizer (at most %d ms)",
+                  (unsigned)st.fertilizer_volume_ml, st.fertilizer_duration_ms);
+        } else {
+            DLOGI(TAG, "AUTO: Pumping fertilizer for %d ms", st.fertilizer_duration_ms);
+        }
+        fert_wanted = true;
+        state = IRRIGATION_FERTILIZING;
+        arm_timer(step_timer, st.fertilizer_duration_ms);
+    } else {
+        DLOGW(TAG, "Fertilizer tank is EMPTY - skipping");
+        finish_cycle();
+    }
+}
+
+// The step timer always points at the earliest deadline of the zones still on
+static void arm_next_zone_deadline(int64_t now) {
+    int64_t next = INT64_MAX;
+    for (uint16_t m = zones_auto; m; m &= m - 1) {
+        int64_t d = zone_deadline_us[__builtin_ctz(m)];
+        next = d < next ? d : next;
+    }
+    esp_timer_stop(step_timer);
+    esp_timer_start_once(step_timer, next > now ? (uint64_t)(next - now) : 1);
+}
+
+static void clear_scheduled(uint16_t mask) {
+    sched_pending &= ~mask;
+    for (uint16_t m = mask; m; m &= m - 1) {
+        sched_run_ms[__builtin_ctz(m)] = 0;
+    }
+}
+
+// Zones join the watering stage, each with its own deadline (a scheduled
+// run may set the duration); zones already on keep theirs
+static void water_zones(uint16_t mask) {
+    int64_t now = esp_timer_get_time();
+    for (uint16_t m = mask & ~zones_auto; m; m &= m - 1) {
+        int z = __builtin_ctz(m);
+        uint32_t ms = sched_run_ms[z] ? sched_run_ms[z] : st.zone_duration_ms[z];
+        zone_deadline_us[z] = now + (int64_t)ms * 1000;
+    }
+    zones_auto |= mask;
+    set_zones(mask, true);
+    state = IRRIGATION_WATERING;
+    arm_next_zone_deadline(now);
+}
+
+// All dry (or scheduled) zones water at the same time, each for its own
+// duration. With a mixing ratio the fertilizer goes in with the water, so
+// the cycle takes as long as its longest zone.
+static void start_auto_cycle(uint16_t dry) {
+    cycle_mixed = st.fert_ratio_ml_l && mix_meter >= 0;
+    if (st.water_tank_full) {
+        DLOGI(TAG, "AUTO: Watering %d zone(s) (mask 0x%04x)", __builtin_popcount(dry), dry);
+        if (cycle_mixed && !st.fertilizer_tank_full) {
+            DLOGW(TAG, "Fertilizer tank is EMPTY - watering without it");
+        }
+        zones_auto = 0;
+        water_zones(dry);
+    } else if (cycle_mixed) {
+        DLOGW(TAG, "Water tank is EMPTY - cannot irrigate or mix");
+        finish_cycle();
+    } else {
+        DLOGW(TAG, "Water tank is EMPTY - cannot irrigate");
+        start_fertilizer_stage();
+    }
+    clear_scheduled(dry);
+}
+
+// Zones of the watering stage are done; once none is left the stage settles,
+// or a mixed cycle, whose fertilizer went in with the water, ends
+static void zones_done(uint16_t done, int64_t now) {
+    set_zones(done, false);
+    zones_auto &= ~done;
+    if (zones_auto) {
+        arm_next_zone_deadline(now);
+    } else if (cycle_mixed) {
+        esp_timer_stop(step_timer);
+        finish_cycle();
+    } else {
+        state = IRRIGATION_SETTLING;
+        arm_timer(step_timer, SETTLE_MS);
+    }
+}
+
+// A deadline is the whole run for a zone dosed by time, and the limit for
+// one dosed by volume (its meter stopped counting: blocked line or sensor)
+static void on_step_deadline(void) {
+    switch (state) {
+    case IRRIGATION_WATERING: {
+        // Zones that share a deadline switch off together
+        int64_t now = esp_timer_get_time();
+        uint16_t done = 0;
+        for (uint16_t m = zones_auto; m; m &= m - 1) {
+            int z = __builtin_ctz(m);
+            if (zone_deadline_us[z] <= now) {
+                done |= 1U << z;
+                if (zone_meter[z] >= 0 && st.zone_volume_ml[z]) {
+                    DLOGW(TAG, "Zone %d: time limit reached before its %u ml dose", z + 1,
+                          (unsigned)st.zone_volume_ml[z]);
                 }
+            }
+        }
+        zones_done(done, now);
+        break;
+    }
+    case IRRIGATION_SETTLING:
+        start_fertilizer_stage();
+        break;
+    case IRRIGATION_FERTILIZING:
+        if (fert_meter >= 0 && st.fertilizer_volume_ml) {
+            DLOGW(TAG, "Fertilizer: time limit reached before its %u ml dose", (unsigned)st.fertilizer_volume_ml);
+        }
+        fert_wanted = false;
+        finish_cycle();
+        break;
+    case IRRIGATION_IDLE:
+        break;  // stale deadline from an aborted cycle
+    }
+}
+
+// New debounced tank level. An empty tank ends whatever draws from it: the
+// watering stage moves on to fertilizer (a mixed cycle ends), the fertilizer
+// stage ends the cycle, mixing stops and manual outputs switch off. False if
+// the level did not change.
+static bool set_tank_level(tank_t tank, bool full) {
+    bool *level = tank == TANK_WATER ? &st.water_tank_full : &st.fertilizer_tank_full;
+    if (*level == full) {
+        return false;
+    }
+    *level = full;
+    if (full) {
+        return true;
+    }
+    if (tank == TANK_WATER) {
+        if (zones_wanted) {
+            DLOGW(TAG, "Water tank ran EMPTY - zones 0x%04x stopped", zones_wanted);
+        }
+        set_zones(zones_wanted, false);
+        if (state == IRRIGATION_WATERING) {
+            esp_timer_stop(step_timer);
+            zones_auto = 0;
+            if (cycle_mixed) {
+                finish_cycle();     // nothing left to mix the fertilizer into
+            } else {
+                start_fertilizer_stage();
+            }
+        }
+    } else {
+        if (fert_wanted || (cycle_mixed && (zones_auto & mix_zones))) {
+            DLOGW(TAG, "Fertilizer tank ran EMPTY - pump 2 stopped");
+        }
+        fert_wanted = false;
+        if (state == IRRIGATION_FERTILIZING) {
+            esp_timer_stop(step_timer);
+            finish_cycle();
+        }
+    }
+    return true;
+}
+
+// A tank switch moved. On an empty edge the ISR already switched the relays
+// off; here the level is confirmed once the switch has held still for
+// TANK_DEBOUNCE_MS, so a sloshing float does not end a cycle.
+static void on_tank_event(void) {
+    uint32_t cut = tank_take_cuts();
+    if (cut) {
+        DLOGW(TAG, "Tank switch dropped (mask 0x%x) - relays cut", (unsigned)cut);
+    }
+    if (cut & (1U << TANK_FERT)) {
+        // The ISR stopped the PWM as well: zero the duty to match, and let
+        // apply_outputs() restore the mix if the tank turns out still full
+        dosing_set_duty(0);
+        mix_duty_applied = 0;
+    }
+    uint32_t wait_ms = 0;
+    for (int tank = 0; tank < TANK_COUNT; tank++) {
+        bool full;
+        uint32_t settle_ms;
+        if (!tank_level_settled(tank, &full, &settle_ms)) {
+            tanks_settling |= 1U << tank;
+            wait_ms = settle_ms > wait_ms ? settle_ms : wait_ms;
+            continue;
+        }
+        tanks_settling &= ~(1U << tank);
+        if (set_tank_level(tank, full)) {
+            if (tank == TANK_WATER) {
+                control_water_alert_led(!full);
             } else {
-                ESP_LOGI(TAG, "Soil moisture is adequate - no irrigation needed");
+                control_fertilizer_alert_led(!full);
+            }
+        }
+    }
+    if (wait_ms) {
+        arm_timer(tank_timer, wait_ms);
+    }
+}
+
+// A meter passed its dose and the ISR switched its relays off: whatever runs
+// on it is done, as if its deadline had come
+static void on_flow_event(void) {
+    int64_t now = esp_timer_get_time();
+    for (uint32_t reached = flow_take_done(); reached; reached &= reached - 1) {
+        int m = __builtin_ctz(reached);
+        uint16_t on_meter = 0;
+        for (uint16_t w = zones_wanted; w; w &= w - 1) {
+            int z = __builtin_ctz(w);
+            if (zone_meter[z] == m) {
+                on_meter |= 1U << z;
+            }
+        }
+        DLOGI(TAG, "💧 Meter %d reached its dose - zones 0x%04x stopped", m + 1, on_meter);
+        set_zones(on_meter, false);
+        if (state == IRRIGATION_WATERING && (zones_auto & on_meter)) {
+            zones_done(zones_auto & on_meter, now);
+        }
+        if (fert_meter == m && fert_wanted) {
+            fert_wanted = false;
+            if (state == IRRIGATION_FERTILIZING) {
+                esp_timer_stop(step_timer);
+                finish_cycle();
             }
+        }
+    }
+}
+
+// Trim the fertilizer pump to what both meters counted so far
+static void on_mix_tick(void) {
+    if (mix_applied) {
+        mix_duty = dosing_next(&mix_run, flow_run_ml(mix_meter), flow_run_ml(fert_meter), esp_timer_get_time());
+        DLOGD(TAG, "Fertilizer pump at %d permille", mix_duty);
+    }
+}
+
+void irrigation_decide(const system_state_t *st, int zones, uint16_t allowed, uint16_t pending,
+                       irrigation_decision_t *out) {
+    uint16_t dry = 0;
+    for (int z = 0; z < zones; z++) {
+        dry |= (uint16_t)(st->zone_soil[z] > st->zone_threshold[z]) << z;
+    }
+    out->dry = dry;
+    out->water = (dry | pending) & allowed;
+    out->automatic = st->auto_mode && !st->zones_manual && !st->pump2_manual;
+}
+
+static void on_periodic_check(void) {
+    if (state != IRRIGATION_IDLE) {
+        return;
+    }
+
+    // Read every zone's probe and collect the dry ones; schedule windows
+    // and blackouts decide which of them may water now
+    for (int z = 0; z < zones; z++) {
+        int soil = read_soil_moisture_probe(zone_probe[z]);
+        st.zone_soil[z] = (uint16_t)(soil < 0 ? 0 : soil);
+    }
+    uint16_t allowed = schedule_allowed_zones();
+    irrigation_decision_t decision;
+    irrigation_decide(&st, zones, allowed, sched_pending, &decision);
+    if (decision.dry & ~allowed) {
+        DLOGI(TAG, "Zones 0x%04x dry but outside their schedule window", decision.dry & ~allowed);
+    }
+    DLOGI(TAG, "Soil Moisture: %d", st.zone_soil[0]);
+    for (int z = 1; z < zones; z++) {
+        DLOGD(TAG, "Soil Moisture zone %d: %d", z + 1, st.zone_soil[z]);
+    }
+
+    // Read water tank levels
+    int water_level_raw = read_water_level_digital(WATER_LEVEL1);
+    int fertilizer_level_raw = read_water_level_digital(WATER_LEVEL2);
+
+    bool water_tank_full = water_level_raw;
+    bool fertilizer_tank_full = fertilizer_level_raw;
+
+    // Only debounced levels count; a switch that is still settling is left
+    // to on_tank_event()
+    for (int tank = 0; tank < TANK_COUNT; tank++) {
+        bool full;
+        uint32_t settle_ms;
+        if (!(tanks_settling & (1U << tank)) && tank_level_settled(tank, &full, &settle_ms)) {
+            set_tank_level(tank, full);
+        }
+    }
+
+    if (water_tank_full) {
+        DLOGI(TAG, "Water Tank [Raw: %d]: HAS WATER", water_level_raw);
+    } else {
+        DLOGI(TAG, "Water Tank [Raw: %d]: EMPTY", water_level_raw);
+    }
+    if (fertilizer_tank_full) {
+        DLOGI(TAG, "Fertilizer Tank [Raw: %d]: HAS LIQUID", fertilizer_level_raw);
+    } else {
+        DLOGI(TAG, "Fertilizer Tank [Raw: %d]: EMPTY", fertilizer_level_raw);
+    }
+
+    // Alert LEDs follow the debounced levels, like the pumps
+    control_water_alert_led(!st.water_tank_full);
+    control_fertilizer_alert_led(!st.fertilizer_tank_full);
+
+    // Automatic irrigation logic (only if auto mode enabled AND not in manual control)
+    if (decision.automatic) {
+        if (decision.water) {
+            DLOGI(TAG, "Soil is DRY in %d zone(s) (mask 0x%04x) - Starting irrigation",
+                  __builtin_popcount(decision.water), decision.water);
+            start_auto_cycle(decision.water);
+            return;
+        }
+        DLOGI(TAG, "Soil moisture is adequate - no irrigation needed");
+        sleep_wanted = true;
+    } else {
+        clear_scheduled(sched_pending);
+        if (!st.auto_mode) {
+            DLOGI(TAG, "Automatic mode is OFF - manual control only");
+        } else {
+            DLOGI(TAG, "Manual control active (zones:0x%04x P2:%d) - skipping automatic irrigation",
+                  st.zones_manual, st.pump2_manual);
+        }
+    }
+    finish_cycle();
+}
+
+// Interval rules that came due: water now, join the running watering stage,
+// or wait for the next check if the cycle is already past watering
+static void on_schedule(void) {
+    schedule_fired_t fired = { 0 };
+    schedule_poll(&fired);
+    uint16_t runs = fired.zones & schedule_allowed_zones() & (uint16_t)((1U << zones) - 1);
+    if (!runs) {
+        return;
+    }
+    if (!st.auto_mode || st.zones_manual || st.pump2_manual) {
+        DLOGI(TAG, "Scheduled run for zones 0x%04x skipped - manual control", runs);
+        return;
+    }
+    for (uint16_t m = runs; m; m &= m - 1) {
+        int z = __builtin_ctz(m);
+        sched_run_ms[z] = fired.duration_ms[z];
+    }
+    sched_pending |= runs;
+    DLOGI(TAG, "SCHEDULE: zones 0x%04x due", runs);
+    if (state == IRRIGATION_IDLE) {
+        note_check_jitter();
+        esp_timer_stop(check_timer);
+        start_auto_cycle(runs);
+    } else if (state == IRRIGATION_WATERING && st.water_tank_full) {
+        water_zones(runs);
+        clear_scheduled(runs);
+    }
+}
+
+// Benchmark cycle: the sense + actuate path of a real cycle, without
+// changing anything. Probes and tanks are read, and every relay is
+// rewritten with the level it already has.
+static void on_bench_tick(void) {
+    int64_t started = esp_timer_get_time();
+    for (int z = 0; z < zones; z++) {
+        (void)read_soil_moisture_probe(zone_probe[z]);
+    }
+    (void)read_water_level_digital(WATER_LEVEL1);
+    (void)read_water_level_digital(WATER_LEVEL2);
+    uint64_t on_mask = fert_applied ? 1ULL << RELAY_PUMP2 : 0;
+    uint64_t off_mask = fert_applied ? 0 : 1ULL << RELAY_PUMP2;
+    for (int z = 0; z < zones; z++) {
+        if (zones_applied & (1U << z)) {
+            on_mask |= zone_relay_bit[z];
         } else {
-            if (!auto_mode) {
-                ESP_LOGI(TAG, "Automatic mode is OFF - manual control only");
-            } else if (pump1_manual || pump2_manual) {
-                ESP_LOGI(TAG, "Manual control active (P1:%d P2:%d) - skipping automatic irrigation", 
-                         pump1_manual, pump2_manual);
+            off_mask |= zone_relay_bit[z];
+        }
+    }
+    relays_write(on_mask, off_mask);
+    rt_bench_record(started, esp_timer_get_time());
+}
+
+// Latest manual command per output since the last event
+typedef struct {
+    uint16_t zones_on;
+    uint16_t zones_off;
+    int fert;               // -1 none, 0 off, 1 on
+} manual_request_t;
+
+static void request_zone(manual_request_t *req, int zone, bool on) {
+    if (zone < 0 || zone >= zones) {
+        DLOGW(TAG, "Zone %d does not exist - command ignored", zone + 1);
+        return;
+    }
+    uint16_t bit = 1U << zone;
+    // Manual mode stays ON regardless of pump state (ON/OFF)
+    // User must use auto mode toggle to return to automatic control
+    st.zones_manual |= bit;
+    req->zones_on = on ? (req->zones_on | bit) : (req->zones_on & ~bit);
+    req->zones_off = on ? (req->zones_off & ~bit) : (req->zones_off | bit);
+}
+
+static void apply_command(const system_command_t *cmd, manual_request_t *req) {
+    switch (cmd->type) {
+    case SYSTEM_CMD_SET_AUTO:
+        st.auto_mode = cmd->automode.enabled;
+        // When auto mode is enabled, clear manual flags to allow automatic control
+        if (st.auto_mode) {
+            st.zones_manual = 0;
+            st.pump2_manual = false;
+        }
+        break;
+    case SYSTEM_CMD_SET_PUMP:
+        // Pump 1 is zone 1's relay, pump 2 the fertilizer pump
+        if (cmd->pump.pump == 1) {
+            request_zone(req, 0, cmd->pump.on);
+        } else if (cmd->pump.pump == 2) {
+            st.pump2_manual = true;
+            req->fert = cmd->pump.on;
+        }
+        break;
+    case SYSTEM_CMD_SET_ZONE:
+        request_zone(req, cmd->zone.zone, cmd->zone.on);
+        break;
+    case SYSTEM_CMD_SET_SETTINGS: {
+        int first = cmd->settings.zone < 0 ? 0 : cmd->settings.zone;
+        int last = cmd->settings.zone < 0 ? zones - 1 : cmd->settings.zone;
+        for (int z = first; z <= last && z < zones; z++) {
+            st.zone_threshold[z] = (uint16_t)cmd->settings.threshold;
+            st.zone_duration_ms[z] = (uint32_t)cmd->settings.pump_duration_ms;
+            if (cmd->settings.volume_ml >= 0) {
+                st.zone_volume_ml[z] = (uint32_t)cmd->settings.volume_ml;
+            }
+        }
+        st.fertilizer_duration_ms = cmd->settings.fert_duration_ms;
+        st.check_interval_ms = cmd->settings.interval_ms;
+        if (cmd->settings.fert_volume_ml >= 0) {
+            st.fertilizer_volume_ml = (uint32_t)cmd->settings.fert_volume_ml;
+        }
+        if (cmd->settings.fert_ratio_ml_l >= 0) {
+            st.fert_ratio_ml_l = (uint16_t)cmd->settings.fert_ratio_ml_l;
+        }
+        break;
+    }
+    }
+}
+
+static void on_command(void) {
+    manual_request_t req = { .fert = -1 };
+    system_command_t cmd;
+    while (system_command_take(&cmd)) {
+        apply_command(&cmd, &req);
+    }
+
+    // Manual control or auto-off cancels a running automatic cycle at once.
+    // Leave an output alone if a manual command for it is about to be applied.
+    if (state != IRRIGATION_IDLE && (!st.auto_mode || st.zones_manual || st.pump2_manual)) {
+        esp_timer_stop(step_timer);
+        if (state == IRRIGATION_WATERING) {
+            set_zones(zones_auto & ~(req.zones_on | req.zones_off), false);
+        } else if (state == IRRIGATION_FERTILIZING && req.fert < 0) {
+            fert_wanted = false;
+        }
+        zones_auto = 0;
+        DLOGI(TAG, "Automatic cycle cancelled by manual command");
+        finish_cycle();
+    }
+
+    // No manual run from an empty tank
+    if (req.zones_on && !st.water_tank_full) {
+        DLOGW(TAG, "Water tank is EMPTY - zones 0x%04x stay off", req.zones_on);
+        req.zones_on = 0;
+    }
+    if (req.fert > 0 && !st.fertilizer_tank_full) {
+        DLOGW(TAG, "Fertilizer tank is EMPTY - pump 2 stays off");
+        req.fert = -1;
+    }
+
+    set_zones(req.zones_on, true);
+    set_zones(req.zones_off, false);
+    if (req.fert >= 0) {
+        fert_wanted = req.fert;
+    }
+
+    // Settings may have changed the check interval
+    if (state == IRRIGATION_IDLE) {
+        schedule_check();
+    }
+}
+
+// Low-power mode: instead of waking every check interval, sleep until the
+// ULP sees a dry zone or an emptying tank. False if staying awake.
+static bool try_sleep(uint32_t *events) {
+    uint64_t next_rule_us = schedule_next_us();
+    if (state != IRRIGATION_IDLE || zones_wanted || fert_wanted || tanks_settling ||
+        !power_can_sleep() || next_rule_us < 1000000) {
+        return false;
+    }
+    if (xTaskNotifyWait(0, UINT32_MAX, events, 0) == pdTRUE) {
+        return true;    // a command or deadline arrived meanwhile: handle it first
+    }
+    esp_timer_stop(check_timer);
+    check_due_us = 0;
+    rt_wdt_pause();
+    power_sleep(&st, next_rule_us);
+    rt_wdt_resume();
+    // Read the sensors right after waking, and apply rules that came due
+    *events = IRRIGATION_EVT_CHECK | IRRIGATION_EVT_SCHEDULE;
+    return true;
+}
+
+void irrigation_task(void *pvParameters) {
+    ESP_LOGI(TAG, "Irrigation system started");
+
+    const esp_timer_create_args_t check_args = {
+        .callback = irrigation_timer_cb,
+        .arg = (void *)(uintptr_t)IRRIGATION_EVT_CHECK,
+        .name = "irr_check",
+    };
+    const esp_timer_create_args_t step_args = {
+        .callback = irrigation_timer_cb,
+        .arg = (void *)(uintptr_t)IRRIGATION_EVT_STEP,
+        .name = "irr_step",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&check_args, &check_timer));
+    const esp_timer_create_args_t tank_args = {
+        .callback = irrigation_timer_cb,
+        .arg = (void *)(uintptr_t)IRRIGATION_EVT_TANK,
+        .name = "irr_tank",
+    };
+    const esp_timer_create_args_t mix_args = {
+        .callback = irrigation_timer_cb,
+        .arg = (void *)(uintptr_t)IRRIGATION_EVT_MIX,
+        .name = "irr_mix",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&step_args, &step_timer));
+    ESP_ERROR_CHECK(esp_timer_create(&tank_args, &tank_timer));
+    ESP_ERROR_CHECK(esp_timer_create(&mix_args, &mix_timer));
+    system_state_read(&st);
+    if (st.zone_count != zone_count()) {
+        irrigation_init_zones(&st);
+    }
+    zones = st.zone_count;
+    for (int z = 0; z < zones; z++) {
+        zone_relay_bit[z] = 1ULL << zone_config(z)->relay;
+        zone_probe[z] = zone_config(z)->probe;
+    }
+    meters = flow_meter_count() < SYSTEM_MAX_METERS ? flow_meter_count() : SYSTEM_MAX_METERS;
+    st.meter_count = (uint8_t)meters;
+    fert_meter = -1;
+    for (int z = 0; z < zones; z++) {
+        zone_meter[z] = -1;
+    }
+    for (int m = meters - 1; m >= 0; m--) {
+        meter_relays[m] = flow_meter_config(m)->relays;
+        if (meter_relays[m] & (1ULL << RELAY_PUMP2)) {
+            fert_meter = (int8_t)m;
+        }
+        for (int z = 0; z < zones; z++) {
+            if (meter_relays[m] & zone_relay_bit[z]) {
+                zone_meter[z] = (int8_t)m;
+            }
+        }
+    }
+    // The fertilizer is mixed by both meters' counts, so both lines need one
+    bool can_mix = DOSING_WATER_METER < meters && fert_meter >= 0 && fert_meter != DOSING_WATER_METER;
+    mix_meter = can_mix ? DOSING_WATER_METER : -1;
+    mix_zones = 0;
+    for (int z = 0; z < zones; z++) {
+        if (can_mix && zone_meter[z] == mix_meter) {
+            mix_zones |= 1U << z;
+        }
+    }
+    if (!can_mix && st.fert_ratio_ml_l) {
+        ESP_LOGW(TAG, "⚠️ No flow meters to mix by - fertilizer goes after the water");
+    }
+    irrigation_task_handle = xTaskGetCurrentTaskHandle();
+
+    dosing_start();
+    uint64_t tank_relays[TANK_COUNT] = { [TANK_FERT] = 1ULL << RELAY_PUMP2 };
+    for (int z = 0; z < zones; z++) {
+        tank_relays[TANK_WATER] |= zone_relay_bit[z];
+    }
+    const tank_cut_t tank_cuts[TANK_COUNT] = { [TANK_FERT] = dosing_cut_isr };
+    tank_watch_start(tank_relays, tank_cuts, on_tank_edge);
+    flow_start(on_flow_target);
+    rt_bench_init(irrigation_bench_tick);
+    rt_wdt_start();
+    mem_task_steady();
+
+    uint32_t events = IRRIGATION_EVT_CHECK | IRRIGATION_EVT_SCHEDULE;  // first check right away
+    while (1) {
+        rt_wdt_feed();
+        if (events & IRRIGATION_EVT_TANK) {
+            on_tank_event();
+        }
+        if (events & IRRIGATION_EVT_FLOW) {
+            on_flow_event();
+        }
+        if (events & IRRIGATION_EVT_MIX) {
+            on_mix_tick();
+        }
+        if (events & IRRIGATION_EVT_BENCH) {
+            on_bench_tick();
+        }
+        if (events & IRRIGATION_EVT_COMMAND) {
+            on_command();
+        }
+        if (events & IRRIGATION_EVT_STEP) {
+            on_step_deadline();
+        }
+        if (events & IRRIGATION_EVT_SCHEDULE) {
+            on_schedule();
+        }
+        if (events & IRRIGATION_EVT_CHECK) {
+            note_check_jitter();
+            on_periodic_check();
+        }
+        apply_outputs();
+        sync_zone1_fields();
+        system_state_publish(&st);
+        metrics_boot_mark(METRIC_BOOT_CONTROL);
+        bool slept = sleep_wanted && try_sleep(&events);
+        sleep_wanted = false;
+        if (!slept) {
+            // Under the watchdog an idle loop still wakes to feed it
+            while (xTaskNotifyWait(0, UINT32_MAX, &events, rt_wdt_wait_ticks()) != pdTRUE) {
+                rt_wdt_feed();
             }
         }
-        
-        ESP_LOGI(TAG, "Waiting %d seconds before next check...\n", check_interval_ms / 1000);
-        vTaskDelay(pdMS_TO_TICKS(check_interval_ms));
     }
 }
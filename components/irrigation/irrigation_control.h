@@ -2,7 +2,19 @@
 #define IRRIGATION_CONTROL_H
 
 #include "sensors.h"
+#include "system_state.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+// Events that wake irrigation_task (task notification bits)
+#define IRRIGATION_EVT_CHECK    (1U << 0)   // periodic soil/tank check is due
+#define IRRIGATION_EVT_STEP     (1U << 1)   // pump run or pause deadline reached
+#define IRRIGATION_EVT_COMMAND  (1U << 2)   // mode, settings or manual pump/zone command
+#define IRRIGATION_EVT_TANK     (1U << 3)   // tank switch edge, or its debounce elapsed
+#define IRRIGATION_EVT_SCHEDULE (1U << 4)   // a schedule rule edge is due
+#define IRRIGATION_EVT_BENCH    (1U << 5)   // control-loop benchmark tick (rt_bench_start)
+#define IRRIGATION_EVT_FLOW     (1U << 6)   // a flow meter reached its dose, relays cut
+#define IRRIGATION_EVT_MIX      (1U << 7)   // time to trim the fertilizer pump's PWM duty
 
 // Irrigation control functions
 void control_pump(gpio_num_t relay_pin, bool state);
@@ -10,4 +22,29 @@ void control_water_alert_led(bool state);
 void control_fertilizer_alert_led(bool state);
 void irrigation_task(void *pvParameters);
 
+// Fill the zone fields of *state from ZONE_TABLE, every zone starting with
+// the single-bed threshold and pump duration (call before system_state_init)
+void irrigation_init_zones(system_state_t *state);
+
+// The periodic check's automatic-mode decision, from st->zone_soil
+typedef struct {
+    uint16_t dry;           // zones past their threshold
+    uint16_t water;         // dry or with a scheduled run pending, and allowed now
+    bool automatic;         // auto mode on and no manual override: start `water`
+} irrigation_decision_t;
+
+void irrigation_decide(const system_state_t *st, int zones, uint16_t allowed, uint16_t pending,
+                       irrigation_decision_t *out);
+
+// Wake the control task; safe from any task or timer callback
+void irrigation_notify(uint32_t events);
+// schedule_init() callback: wakes the control task with IRRIGATION_EVT_SCHEDULE
+void irrigation_schedule_due(void);
+// Post a command to the control task and wake it; false if the mailbox is full
+bool irrigation_submit(const system_command_t *cmd);
+// Post n commands that the control task applies together, in one pass
+// (nothing is switched between them); false, with none posted, if they do
+// not all fit
+bool irrigation_submit_batch(const system_command_t *cmds, unsigned n);
+
 #endif // IRRIGATION_CONTROL_H
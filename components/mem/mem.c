@@ -0,0 +1,144 @@
+#include "mem.h"
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include <stdatomic.h>
+
+static const char *TAG = "MEM";
+
+typedef struct {
+    atomic_uint allocs;
+    atomic_uint frees;
+    atomic_uint bytes;
+} kind_stats_t;
+
+static atomic_bool armed = false;
+static atomic_uint steady = 0;         // MEM_HEAP_FREE_TASKS bits past their setup
+static atomic_uint in_driver = 0;      // task kind bits inside mem_driver_begin/end
+static kind_stats_t kinds[MEM_KINDS];
+static atomic_uint violations = 0;
+static uint32_t violations_reported = 0;
+static esp_timer_handle_t check_timer;
+
+static inline int current_kind(void) {
+    return (int)rt_task_kind(xTaskGetCurrentTaskHandle());     // RT_TASK_COUNT = other
+}
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+// Called by the heap on every allocation and free, from the allocating task
+void IRAM_ATTR esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps) {
+    if (ptr == NULL || !atomic_load_explicit(&armed, memory_order_relaxed)) {
+        return;
+    }
+    int kind = current_kind();
+    bool heap_free = kind < RT_TASK_COUNT && (MEM_HEAP_FREE_TASKS & (1u << kind));
+    if (heap_free && !(atomic_load_explicit(&steady, memory_order_relaxed) & (1u << kind))) {
+        return;     // still setting up
+    }
+    atomic_fetch_add_explicit(&kinds[kind].allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&kinds[kind].bytes, (uint32_t)size, memory_order_relaxed);
+    if (heap_free && !(atomic_load_explicit(&in_driver, memory_order_relaxed) & (1u << kind))) {
+        atomic_fetch_add_explicit(&violations, 1, memory_order_relaxed);
+    }
+}
+
+void IRAM_ATTR esp_heap_trace_free_hook(void *ptr) {
+    if (ptr == NULL || !atomic_load_explicit(&armed, memory_order_relaxed)) {
+        return;
+    }
+    atomic_fetch_add_explicit(&kinds[current_kind()].frees, 1, memory_order_relaxed);
+}
+#endif
+
+void mem_task_steady(void) {
+    int kind = current_kind();
+    if (kind < RT_TASK_COUNT) {
+        atomic_fetch_or(&steady, 1u << kind);
+    }
+}
+
+void mem_driver_begin(void) {
+    int kind = current_kind();
+    if (kind < RT_TASK_COUNT) {
+        atomic_fetch_or(&in_driver, 1u << kind);
+    }
+}
+
+void mem_driver_end(void) {
+    int kind = current_kind();
+    if (kind < RT_TASK_COUNT) {
+        atomic_fetch_and(&in_driver, ~(1u << kind));
+    }
+}
+
+const char *mem_kind_name(int kind) {
+    return rt_task_kind_name((rt_task_t)kind);
+}
+
+void mem_get_report(mem_report_t *out) {
+    out->armed = atomic_load(&armed);
+    out->static_alloc = RT_STATIC_ALLOC;
+    out->heap_free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    out->heap_min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    out->heap_largest_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    // esp_http_server always takes its task's stack from the heap
+    out->stack_static = 0;
+    out->stack_heap = rt_stack(RT_TASK_HTTPD);
+    for (int i = 0; i < rt_task_count(); i++) {
+        const rt_task_info_t *t = rt_task_info(i);
+        if (t->is_static) {
+            out->stack_static += t->stack;
+        } else {
+            out->stack_heap += t->stack;
+        }
+    }
+    out->violations = atomic_load(&violations);
+    for (int k = 0; k < MEM_KINDS; k++) {
+        out->kinds[k].allocs = atomic_load_explicit(&kinds[k].allocs, memory_order_relaxed);
+        out->kinds[k].frees = atomic_load_explicit(&kinds[k].frees, memory_order_relaxed);
+        out->kinds[k].bytes = atomic_load_explicit(&kinds[k].bytes, memory_order_relaxed);
+    }
+}
+
+static void check_cb(void *arg) {
+    uint32_t now = atomic_load(&violations);
+    if (now == violations_reported) {
+        return;
+    }
+    violations_reported = now;
+    for (int k = 0; k < RT_TASK_COUNT; k++) {
+        uint32_t n = atomic_load_explicit(&kinds[k].allocs, memory_order_relaxed);
+        if ((MEM_HEAP_FREE_TASKS & (1u << k)) && n > 0) {
+            ESP_LOGE(TAG, "❌ %s task allocated %u times (%u bytes) after boot", mem_kind_name(k),
+                     (unsigned)n, (unsigned)atomic_load_explicit(&kinds[k].bytes, memory_order_relaxed));
+        }
+    }
+    // Heap-free build: stop here (the board resets) rather than fragment the heap
+    configASSERT(!MEM_ASSERT_HEAP_FREE);
+}
+
+void mem_boot_done(void) {
+    ESP_LOGI(TAG, "📊 Memory budget (%s stacks):", RT_STATIC_ALLOC ? "static" : "heap");
+    ESP_LOGI(TAG, "   %-16s %-12s %6s %6s  %s", "task", "kind", "stack", "free", "from");
+    for (int i = 0; i < rt_task_count(); i++) {
+        const rt_task_info_t *t = rt_task_info(i);
+        ESP_LOGI(TAG, "   %-16s %-12s %6u %6u  %s", pcTaskGetName(t->handle), rt_task_kind_name(t->kind),
+                 (unsigned)t->stack, (unsigned)uxTaskGetStackHighWaterMark(t->handle),
+                 t->is_static ? "static" : "heap");
+    }
+    ESP_LOGI(TAG, "   %-16s %-12s %6u %6s  %s", "httpd", rt_task_kind_name(RT_TASK_HTTPD),
+             (unsigned)rt_stack(RT_TASK_HTTPD), "-", "heap");
+
+    const esp_timer_create_args_t args = { .callback = check_cb, .name = "mem_check" };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &check_timer));
+    esp_timer_start_periodic(check_timer, (uint64_t)MEM_CHECK_MS * 1000);
+
+    mem_report_t r;
+    mem_get_report(&r);
+    ESP_LOGI(TAG, "📊 Stacks %u B static + %u B heap; heap %u B free, %u B min, %u B largest block",
+             (unsigned)r.stack_static, (unsigned)r.stack_heap, (unsigned)r.heap_free,
+             (unsigned)r.heap_min_free, (unsigned)r.heap_largest_block);
+    atomic_store(&armed, true);
+}
@@ -0,0 +1,60 @@
+#ifndef MEM_H
+#define MEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "rt.h"
+
+// Memory budget: every task's stack (size, high-water mark, static pool or
+// heap), the heap's free/minimum/largest block, and who allocates after
+// boot. The heap hooks (CONFIG_HEAP_USE_HOOKS) count allocations per task
+// kind from mem_boot_done() on; before that the firmware may allocate
+// freely. The control path (control loop, sensing, log printer) sets itself
+// up and then calls mem_task_steady() on entering its loop; from there on it
+// must never allocate: a periodic check logs any allocation it made, and
+// with MEM_ASSERT_HEAP_FREE (the static build) aborts, so a regression
+// fails on the bench instead of slowly fragmenting the heap in the field.
+//
+// Only those three tasks are held to it. httpd and its workers allocate
+// inside esp_http_server and lwIP (sessions, async request copies, pbufs)
+// and the storage task inside NVS; theirs are counted per kind and
+// reported, not asserted.
+#define MEM_HEAP_FREE_TASKS ((1u << RT_TASK_CONTROL) | (1u << RT_TASK_SENSING) | (1u << RT_TASK_LOG))
+#define MEM_CHECK_MS        10000
+#ifndef MEM_ASSERT_HEAP_FREE
+#define MEM_ASSERT_HEAP_FREE RT_STATIC_ALLOC
+#endif
+#define MEM_KINDS           (RT_TASK_COUNT + 1)     // the rt task kinds, then "other"
+
+typedef struct {
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t bytes;             // allocated, not net
+} mem_kind_stats_t;
+
+typedef struct {
+    bool armed;                 // mem_boot_done() has run
+    bool static_alloc;          // RT_STATIC_ALLOC build
+    uint32_t heap_free;
+    uint32_t heap_min_free;
+    uint32_t heap_largest_block;
+    uint32_t stack_static;      // task stack bytes by origin
+    uint32_t stack_heap;
+    uint32_t violations;        // allocations by MEM_HEAP_FREE_TASKS after boot,
+                                // outside mem_driver_begin/end
+    mem_kind_stats_t kinds[MEM_KINDS];     // after boot
+} mem_report_t;
+
+// End of app_main: log the budget and start counting allocations
+void mem_boot_done(void);
+// A MEM_HEAP_FREE_TASKS task is done setting up: it allocates no more
+void mem_task_steady(void);
+// Around driver calls the control path cannot do without (WiFi stopped for
+// light sleep): what they allocate is counted, but is no violation
+void mem_driver_begin(void);
+void mem_driver_end(void);
+void mem_get_report(mem_report_t *out);
+// rt task kind name, "other" for MEM_KINDS - 1
+const char *mem_kind_name(int kind);
+
+#endif // MEM_H
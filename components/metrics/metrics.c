@@ -0,0 +1,129 @@
+#include "metrics.h"
+#include "esp_timer.h"
+#include <stdatomic.h>
+#include <string.h>
+
+typedef struct {
+    atomic_uint count;
+    _Atomic uint64_t sum_us;
+    atomic_uint max_us;
+    atomic_uint buckets[METRICS_BUCKETS];
+} hist_t;
+
+static hist_t hists[METRIC_HIST_COUNT];
+static atomic_uint counters[METRIC_COUNTER_COUNT];
+static _Atomic int64_t boot_us[METRIC_BOOT_COUNT];     // 0 = not reached
+static TaskHandle_t tasks[METRICS_MAX_TASKS];
+static atomic_int task_count = 0;
+
+static const char *const hist_names[METRIC_HIST_COUNT] = {
+    [METRIC_HTTP_ROOT] = "http_root",
+    [METRIC_HTTP_DATA] = "http_data",
+    [METRIC_HTTP_PUMP] = "http_pump",
+    [METRIC_HTTP_AUTO] = "http_auto",
+    [METRIC_HTTP_SETTINGS] = "http_settings",
+    [METRIC_HTTP_BATCH] = "http_batch",
+    [METRIC_HTTP_QUEUE] = "http_queue",
+    [METRIC_LOOP_JITTER] = "loop_jitter",
+    [METRIC_ADC_READ] = "adc_read",
+    [METRIC_SCHEDULE_POLL] = "schedule_poll",
+};
+
+static const char *const counter_names[METRIC_COUNTER_COUNT] = {
+    [METRIC_WIFI_DISCONNECTS] = "wifi_disconnects",
+    [METRIC_WIFI_RECONNECTS] = "wifi_reconnects",
+    [METRIC_LOG_DROPPED] = "log_dropped",
+    [METRIC_HTTP_SHED] = "http_shed",
+    [METRIC_TELEMETRY_SENT] = "telemetry_sent",
+    [METRIC_TELEMETRY_ERRORS] = "telemetry_errors",
+    [METRIC_SCHEDULE_RUNS] = "schedule_runs",
+};
+
+static const char *const boot_names[METRIC_BOOT_COUNT] = {
+    [METRIC_BOOT_CONTROL] = "first_control",
+    [METRIC_BOOT_WIFI] = "wifi",
+    [METRIC_BOOT_HTTP] = "first_http",
+};
+
+static int bucket_of(uint32_t us) {
+    if (us < METRICS_BUCKET0_US) {
+        return 0;
+    }
+    int b = 32 - __builtin_clz(us / METRICS_BUCKET0_US);
+    return b < METRICS_BUCKETS ? b : METRICS_BUCKETS - 1;
+}
+
+void metrics_observe(metric_hist_t hist, uint32_t us) {
+    hist_t *h = &hists[hist];
+    atomic_fetch_add_explicit(&h->buckets[bucket_of(us)], 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->sum_us, us, memory_order_relaxed);
+    atomic_fetch_add_explicit(&h->count, 1, memory_order_relaxed);
+    unsigned max = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+    while (us > max &&
+           !atomic_compare_exchange_weak_explicit(&h->max_us, &max, us,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+void metrics_count(metric_counter_t counter) {
+    atomic_fetch_add_explicit(&counters[counter], 1, memory_order_relaxed);
+}
+
+void metrics_boot_mark(metric_boot_t milestone) {
+    if (atomic_load_explicit(&boot_us[milestone], memory_order_relaxed) != 0) {
+        return;
+    }
+    int64_t expected = 0;
+    int64_t now = esp_timer_get_time();
+    atomic_compare_exchange_strong_explicit(&boot_us[milestone], &expected, now > 0 ? now : 1,
+                                            memory_order_relaxed, memory_order_relaxed);
+}
+
+void metrics_watch_task(TaskHandle_t task) {
+    int n = atomic_load(&task_count);
+    if (task == NULL || n >= METRICS_MAX_TASKS) {
+        return;
+    }
+    // Only called from app_main at startup; the slot is filled before it is counted
+    tasks[n] = task;
+    atomic_store_explicit(&task_count, n + 1, memory_order_release);
+}
+
+const char *metrics_hist_name(metric_hist_t hist) {
+    return hist_names[hist];
+}
+
+const char *metrics_counter_name(metric_counter_t counter) {
+    return counter_names[counter];
+}
+
+void metrics_hist_read(metric_hist_t hist, metrics_hist_snapshot_t *out) {
+    hist_t *h = &hists[hist];
+    for (int b = 0; b < METRICS_BUCKETS; b++) {
+        out->buckets[b] = atomic_load_explicit(&h->buckets[b], memory_order_relaxed);
+    }
+    out->count = atomic_load_explicit(&h->count, memory_order_relaxed);
+    out->sum_us = atomic_load_explicit(&h->sum_us, memory_order_relaxed);
+    out->max_us = atomic_load_explicit(&h->max_us, memory_order_relaxed);
+}
+
+uint32_t metrics_counter(metric_counter_t counter) {
+    return atomic_load_explicit(&counters[counter], memory_order_relaxed);
+}
+
+const char *metrics_boot_name(metric_boot_t milestone) {
+    return boot_names[milestone];
+}
+
+int32_t metrics_boot_ms(metric_boot_t milestone) {
+    int64_t us = atomic_load_explicit(&boot_us[milestone], memory_order_relaxed);
+    return us ? (int32_t)(us / 1000) : -1;
+}
+
+int metrics_task_count(void) {
+    return atomic_load_explicit(&task_count, memory_order_acquire);
+}
+
+TaskHandle_t metrics_task(int index) {
+    return index >= 0 && index < metrics_task_count() ? tasks[index] : NULL;
+}
@@ -0,0 +1,78 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Runtime metrics kept permanently on the hot paths: latency histograms,
+// event counters and the tasks whose stack high-water marks are reported.
+// Recording is a few relaxed atomic adds (no lock, no heap), so any task or
+// handler can call it; readers get a slightly racy but never torn snapshot.
+//
+// Histogram buckets are powers of two: bucket i counts values below
+// METRICS_BUCKET0_US << i, the last bucket everything above.
+#define METRICS_BUCKETS     16      // 64 us .. 1 s, then overflow
+#define METRICS_BUCKET0_US  64
+#define METRICS_MAX_TASKS   8
+
+typedef enum {
+    METRIC_HTTP_ROOT,
+    METRIC_HTTP_DATA,
+    METRIC_HTTP_PUMP,
+    METRIC_HTTP_AUTO,
+    METRIC_HTTP_SETTINGS,
+    METRIC_HTTP_BATCH,
+    METRIC_HTTP_QUEUE,      // request waiting for an HTTP worker
+    METRIC_LOOP_JITTER,     // periodic check: how late it ran after its deadline
+    METRIC_ADC_READ,        // one ADC frame: DMA read + filtering
+    METRIC_SCHEDULE_POLL,   // applying the schedule rules that came due
+    METRIC_HIST_COUNT
+} metric_hist_t;
+
+typedef enum {
+    METRIC_WIFI_DISCONNECTS,
+    METRIC_WIFI_RECONNECTS, // got an IP again after a disconnect
+    METRIC_LOG_DROPPED,     // deferred log records lost to a full ring
+    METRIC_HTTP_SHED,       // requests answered 503: worker queue full
+    METRIC_TELEMETRY_SENT,  // telemetry datagrams sent
+    METRIC_TELEMETRY_ERRORS, // telemetry datagrams the stack refused
+    METRIC_SCHEDULE_RUNS,   // interval rules fired
+    METRIC_COUNTER_COUNT
+} metric_counter_t;
+
+// Boot milestones: time since boot when each first happened
+typedef enum {
+    METRIC_BOOT_CONTROL,    // first control cycle published
+    METRIC_BOOT_WIFI,       // first IP address
+    METRIC_BOOT_HTTP,       // first HTTP response sent
+    METRIC_BOOT_COUNT
+} metric_boot_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t sum_us;
+    uint32_t max_us;
+    uint32_t buckets[METRICS_BUCKETS];
+} metrics_hist_snapshot_t;
+
+void metrics_observe(metric_hist_t hist, uint32_t us);
+void metrics_count(metric_counter_t counter);
+// Only the first call per milestone counts; later ones are one atomic load
+void metrics_boot_mark(metric_boot_t milestone);
+
+// Report this task's stack high-water mark at /api/metrics
+void metrics_watch_task(TaskHandle_t task);
+
+const char *metrics_hist_name(metric_hist_t hist);
+const char *metrics_counter_name(metric_counter_t counter);
+void metrics_hist_read(metric_hist_t hist, metrics_hist_snapshot_t *out);
+uint32_t metrics_counter(metric_counter_t counter);
+const char *metrics_boot_name(metric_boot_t milestone);
+// Milliseconds since boot, -1 = not reached yet
+int32_t metrics_boot_ms(metric_boot_t milestone);
+int metrics_task_count(void);
+TaskHandle_t metrics_task(int index);
+
+#endif // METRICS_H
@@ -0,0 +1,143 @@
+#include "microbench.h"
+#include "soil_filter.h"
+#include "irrigation_control.h"
+#include "state_json.h"
+#include "command_json.h"
+#include "esp_cpu.h"
+#include "esp_log.h"
+#include <string.h>
+
+static const char *TAG = "MICROBENCH";
+
+volatile uint32_t microbench_sink;
+
+/* ------------------------------------------------------- soil filter */
+
+static soil_filter_t bench_filter;
+static uint8_t bench_frame[ADC_FRAME_CONVS * SOC_ADC_DIGI_RESULT_BYTES];
+
+static void filter_setup(void) {
+    adc_channel_t channels[SOIL_PROBE_MAX];
+    int probes = soil_probe_count();
+    for (int p = 0; p < probes; p++) {
+        channels[p] = soil_probe_channel(p);
+    }
+    // 12.8 ms frames: 256 conversions at the ESP32's 20 kHz
+    soil_filter_init(&bench_filter, channels, probes, 12800);
+    // Probes round-robin, a little noise around a damp reading
+    uint32_t x = 1;
+    for (int i = 0; i < ADC_FRAME_CONVS; i++) {
+        adc_digi_output_data_t *d = (adc_digi_output_data_t *)&bench_frame[i * SOC_ADC_DIGI_RESULT_BYTES];
+        x = x * 1103515245 + 12345;
+        memset(d, 0, sizeof(*d));
+        SOIL_ADC_CHANNEL(d) = channels[i % probes];
+        SOIL_ADC_DATA(d) = 2600 + ((x >> 16) & 63);
+    }
+}
+
+static void filter_run(uint32_t iterations) {
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        acc += soil_filter_frame(&bench_filter, bench_frame, sizeof(bench_frame));
+        acc += (uint32_t)soil_filter_value(&bench_filter, 0);
+    }
+    microbench_sink = acc;
+}
+
+/* --------------------------------------------------------- state */
+
+// Every zone in use, a few of them watering or under manual control
+static system_state_t bench_state;
+
+static void state_setup(void) {
+    memset(&bench_state, 0, sizeof(bench_state));
+    bench_state.auto_mode = true;
+    bench_state.soil_dry_threshold = 2800;
+    bench_state.pump_duration_ms = 3000;
+    bench_state.fertilizer_duration_ms = 1500;
+    bench_state.check_interval_ms = 5000;
+    bench_state.water_tank_full = true;
+    bench_state.fertilizer_tank_full = true;
+    bench_state.zone_count = SYSTEM_MAX_ZONES;
+    bench_state.zones_watering = 0x0005;
+    bench_state.zones_manual = 0x0100;
+    for (int z = 0; z < SYSTEM_MAX_ZONES; z++) {
+        bench_state.zone_soil[z] = (uint16_t)(2600 + 25 * z);
+        bench_state.zone_threshold[z] = 2800;
+        bench_state.zone_duration_ms[z] = 3000;
+    }
+    bench_state.soil_moisture = bench_state.zone_soil[0];
+}
+
+static void decide_run(uint32_t iterations) {
+    uint32_t acc = 0;
+    irrigation_decision_t d;
+    for (uint32_t i = 0; i < iterations; i++) {
+        // Move one probe per call so no two decisions are alike
+        bench_state.zone_soil[i % SYSTEM_MAX_ZONES] ^= 0x100;
+        irrigation_decide(&bench_state, SYSTEM_MAX_ZONES, 0xffff, 0, &d);
+        acc += d.water + d.automatic;
+    }
+    microbench_sink = acc;
+}
+
+static void json_run(uint32_t iterations) {
+    static char body[STATE_JSON_MAX];
+    uint32_t acc = 0;
+    for (uint32_t i = 0; i < iterations; i++) {
+        json_writer_t w;
+        json_writer_init(&w, body, sizeof(body));
+        state_json_write(&w, &bench_state, NULL);
+        acc += (uint32_t)json_writer_finish(&w);
+    }
+    microbench_sink = acc;
+}
+
+/* ------------------------------------------------------- commands */
+
+static const char settings_body[] =
+    "{\"threshold\":2700,\"pump_duration\":4000,\"fert_duration\":1500,\"interval\":5000,\"zone\":1}";
+
+static void settings_run(uint32_t iterations) {
+    uint32_t acc = 0;
+    char error[96];
+    for (uint32_t i = 0; i < iterations; i++) {
+        system_command_t cmd;
+        acc += (uint32_t)command_json_parse(settings_body, sizeof(settings_body) - 1,
+                                            COMMAND_JSON_SETTINGS, &cmd, 1, error, sizeof(error));
+        acc += (uint32_t)cmd.settings.threshold;
+    }
+    microbench_sink = acc;
+}
+
+static void no_setup(void) {
+}
+
+static const microbench_case_t cases[] = {
+    { "soil_filter_frame", 10000, filter_setup, filter_run },
+    { "irrigation_decide", 1000000, state_setup, decide_run },
+    { "state_json_full", 10000, state_setup, json_run },
+    { "command_json_settings", 50000, no_setup, settings_run },
+};
+
+const microbench_case_t *microbench_cases(int *count) {
+    *count = (int)(sizeof(cases) / sizeof(cases[0]));
+    return cases;
+}
+
+void microbench_run(void) {
+    ESP_LOGI(TAG, "⏱️ Microbenchmarks: best of %d runs", MICROBENCH_RUNS);
+    for (int c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); c++) {
+        const microbench_case_t *bc = &cases[c];
+        bc->setup();
+        bc->run(bc->iterations / 10);   // warm the caches
+        uint32_t best = UINT32_MAX;
+        for (int r = 0; r < MICROBENCH_RUNS; r++) {
+            uint32_t start = (uint32_t)esp_cpu_get_cycle_count();
+            bc->run(bc->iterations);
+            uint32_t cycles = (uint32_t)esp_cpu_get_cycle_count() - start;
+            best = cycles < best ? cycles : best;
+        }
+        ESP_LOGI(TAG, "bench.%s.cycles_per_op=%lu", bc->name, (unsigned long)(best / bc->iterations));
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Microbenchmarks of the firmware's hot paths, on the real functions:
+//   soil_filter_frame   one 256-conversion ADC frame through the soil filter
+//   irrigation_decide   the periodic check's auto-mode decision, 16 zones
+//   state_json_full     the /api/data body, 16 zones
+//   command_json_settings  a POST /api/settings body through the streaming parser
+//
+// On the board microbench_run() prints cycles per operation
+// (esp_cpu_get_cycle_count); host/bench/firmware_bench.c runs the same cases for
+// ns and heap allocations per operation. Both print bench.<case>.<unit>=N
+// lines that tools/bench_compare.py checks against host/bench/baseline.txt.
+#define MICROBENCH_AT_BOOT      0       // 1 = app_main runs them before starting anything
+#define MICROBENCH_RUNS         5       // timed runs per case, the fastest one counts
+
+typedef struct {
+    const char *name;
+    uint32_t iterations;        // per timed run
+    void (*setup)(void);
+    void (*run)(uint32_t iterations);
+} microbench_case_t;
+
+const microbench_case_t *microbench_cases(int *count);
+// Defeats dead-code elimination: every case folds its results in here
+extern volatile uint32_t microbench_sink;
+
+// Board: run every case and log bench.<case>.cycles_per_op
+void microbench_run(void);
+
+#endif // MICROBENCH_H
@@ -0,0 +1,268 @@
+#include "ota.h"
+#include "ota_delta.h"
+#include "esp_app_desc.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_partition.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "mbedtls/sha256.h"
+#include "metrics.h"
+#include <string.h>
+
+static const char *TAG = "OTA";
+
+typedef struct {
+    ota_phase_t phase;
+    const char *error;
+    uint32_t received;
+    const esp_partition_t *running;
+    const esp_partition_t *target;
+    esp_ota_handle_t handle;        // 0 = no image open
+    mbedtls_sha256_context sha;
+    ota_delta_t delta;              // ~7 KB: static, never on a task stack
+} ota_t;
+
+static portMUX_TYPE ota_lock = portMUX_INITIALIZER_UNLOCKED;
+static ota_t ota;
+static esp_timer_handle_t restart_timer;
+static esp_timer_handle_t confirm_timer;
+
+static const char *const phase_names[] = {
+    [OTA_IDLE] = "idle",
+    [OTA_RECEIVING] = "receiving",
+    [OTA_READY] = "ready",
+    [OTA_FAILED] = "failed",
+};
+
+const char *ota_phase_name(ota_phase_t phase) {
+    return phase_names[phase];
+}
+
+/* ----------------------------------------------------- delta callbacks */
+
+// The running image must be the one the delta was made against
+static esp_err_t source_matches(const ota_delta_header_t *hdr) {
+    uint8_t buf[256];
+    uint8_t digest[32];
+    mbedtls_sha256_context sha;
+    mbedtls_sha256_init(&sha);
+    mbedtls_sha256_starts(&sha, 0);
+    esp_err_t err = ESP_OK;
+    for (uint32_t off = 0; off < hdr->source_size && err == ESP_OK; off += sizeof(buf)) {
+        uint32_t n = hdr->source_size - off < sizeof(buf) ? hdr->source_size - off : sizeof(buf);
+        err = esp_partition_read(ota.running, off, buf, n);
+        mbedtls_sha256_update(&sha, buf, n);
+    }
+    mbedtls_sha256_finish(&sha, digest);
+    mbedtls_sha256_free(&sha);
+    if (err != ESP_OK) {
+        return err;
+    }
+    return memcmp(digest, hdr->source_sha256, sizeof(digest)) == 0 ? ESP_OK : ESP_ERR_INVALID_CRC;
+}
+
+static esp_err_t image_begin(void *ctx, const ota_delta_header_t *hdr) {
+    if (hdr->source_size > ota.running->size) {
+        ota.error = "made against a bigger image";
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (hdr->target_size == 0 || hdr->target_size > ota.target->size) {
+        ota.error = "image does not fit the OTA partition";
+        return ESP_ERR_INVALID_SIZE;
+    }
+    esp_err_t err = source_matches(hdr);
+    if (err != ESP_OK) {
+        ota.error = "made against a different image";
+        return err;
+    }
+    // Erases as much of the partition as the image needs
+    err = esp_ota_begin(ota.target, hdr->target_size, &ota.handle);
+    if (err != ESP_OK) {
+        ota.handle = 0;
+        ota.error = "could not open the OTA partition";
+        return err;
+    }
+    mbedtls_sha256_starts(&ota.sha, 0);
+    ESP_LOGI(TAG, "📦 %s update: %lu byte image into %s",
+             hdr->source_size ? "Delta" : "Full", (unsigned long)hdr->target_size, ota.target->label);
+    return ESP_OK;
+}
+
+static esp_err_t image_read(void *ctx, uint32_t offset, void *buf, size_t len) {
+    return esp_partition_read(ota.running, offset, buf, len);
+}
+
+static esp_err_t image_write(void *ctx, const void *buf, size_t len) {
+    mbedtls_sha256_update(&ota.sha, buf, len);
+    return esp_ota_write(ota.handle, buf, len);
+}
+
+/* ------------------------------------------------------------- update */
+
+static void release(ota_phase_t phase) {
+    portENTER_CRITICAL(&ota_lock);
+    ota.phase = phase;
+    portEXIT_CRITICAL(&ota_lock);
+}
+
+esp_err_t ota_begin(void) {
+    portENTER_CRITICAL(&ota_lock);
+    bool busy = ota.phase == OTA_RECEIVING || ota.phase == OTA_READY;
+    if (!busy) {
+        ota.phase = OTA_RECEIVING;
+    }
+    portEXIT_CRITICAL(&ota_lock);
+    if (busy) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ota.error = NULL;
+    ota.received = 0;
+    ota.handle = 0;
+    ota.running = esp_ota_get_running_partition();
+    ota.target = esp_ota_get_next_update_partition(NULL);
+    if (ota.running == NULL || ota.target == NULL) {
+        ota.error = "no OTA partition";
+        release(OTA_FAILED);
+        return ESP_ERR_NOT_FOUND;
+    }
+    const ota_delta_io_t io = { .begin = image_begin, .read = image_read, .write = image_write };
+    ota_delta_init(&ota.delta, &io);
+    mbedtls_sha256_init(&ota.sha);
+    return ESP_OK;
+}
+
+void ota_abort(const char *reason) {
+    if (ota.phase != OTA_RECEIVING) {
+        return;
+    }
+    if (ota.handle != 0) {
+        esp_ota_abort(ota.handle);
+        ota.handle = 0;
+    }
+    mbedtls_sha256_free(&ota.sha);
+    if (ota.error == NULL) {
+        ota.error = reason;
+    }
+    ESP_LOGE(TAG, "❌ Update aborted after %lu bytes: %s", (unsigned long)ota.received, ota.error);
+    release(OTA_FAILED);
+}
+
+esp_err_t ota_write(const void *data, size_t len) {
+    if (ota.phase != OTA_RECEIVING) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    ota.received += len;
+    esp_err_t err = ota_delta_feed(&ota.delta, data, len);
+    if (err != ESP_OK) {
+        ota_abort(ota.delta.error);
+    }
+    return err;
+}
+
+esp_err_t ota_finish(void) {
+    if (ota.phase != OTA_RECEIVING) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t err = ota_delta_finish(&ota.delta);
+    if (err != ESP_OK) {
+        ota_abort(ota.delta.error);
+        return err;
+    }
+    uint8_t digest[32];
+    mbedtls_sha256_finish(&ota.sha, digest);
+    if (memcmp(digest, ota.delta.hdr.target_sha256, sizeof(digest)) != 0) {
+        ota_abort("image checksum mismatch");
+        return ESP_ERR_INVALID_CRC;
+    }
+    mbedtls_sha256_free(&ota.sha);
+    // Checks the app image itself (header, segments, appended hash)
+    err = esp_ota_end(ota.handle);
+    ota.handle = 0;
+    if (err == ESP_OK) {
+        err = esp_ota_set_boot_partition(ota.target);
+    }
+    if (err != ESP_OK) {
+        ota.error = err == ESP_ERR_OTA_VALIDATE_FAILED ? "not a valid app image" : "could not switch partitions";
+        ESP_LOGE(TAG, "❌ Update rejected: %s (%s)", ota.error, esp_err_to_name(err));
+        release(OTA_FAILED);
+        return err;
+    }
+    ESP_LOGI(TAG, "✅ Update verified: %lu delta bytes -> %lu byte image, boots from %s",
+             (unsigned long)ota.received, (unsigned long)ota.delta.written, ota.target->label);
+    release(OTA_READY);
+    return ESP_OK;
+}
+
+const char *ota_error(void) {
+    return ota.error;
+}
+
+static void restart_cb(void *arg) {
+    ESP_LOGW(TAG, "🔄 Restarting into the new firmware");
+    esp_restart();
+}
+
+void ota_restart(void) {
+    if (restart_timer == NULL) {
+        return;
+    }
+    esp_timer_start_once(restart_timer, (uint64_t)OTA_RESTART_DELAY_MS * 1000);
+}
+
+void ota_get_status(ota_status_t *out) {
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    const esp_partition_t *next = esp_ota_get_next_update_partition(NULL);
+    esp_ota_img_states_t state = ESP_OTA_IMG_UNDEFINED;
+    if (running != NULL) {
+        esp_ota_get_state_partition(running, &state);
+    }
+    portENTER_CRITICAL(&ota_lock);
+    *out = (ota_status_t){
+        .phase = ota.phase,
+        .received = ota.received,
+        .written = ota.delta.written,
+        .target_size = ota.delta.hdr.target_size,
+        .error = ota.error,
+    };
+    portEXIT_CRITICAL(&ota_lock);
+    out->running = running ? running->label : "";
+    out->next = next ? next->label : "";
+    out->version = esp_app_get_description()->version;
+    out->pending_verify = state == ESP_OTA_IMG_PENDING_VERIFY;
+}
+
+/* ---------------------------------------------------------- rollback */
+
+static void confirm_cb(void *arg) {
+    int64_t up_ms = esp_timer_get_time() / 1000;
+    bool healthy = metrics_boot_ms(METRIC_BOOT_CONTROL) >= 0 && metrics_boot_ms(METRIC_BOOT_WIFI) >= 0;
+    if (healthy && up_ms >= OTA_CONFIRM_MIN_MS) {
+        esp_timer_stop(confirm_timer);
+        esp_ota_mark_app_valid_cancel_rollback();
+        ESP_LOGI(TAG, "✅ New firmware %s confirmed", esp_app_get_description()->version);
+    } else if (up_ms >= OTA_CONFIRM_MAX_MS) {
+        esp_timer_stop(confirm_timer);
+        ESP_LOGE(TAG, "❌ New firmware never became healthy (%s), rolling back",
+                 metrics_boot_ms(METRIC_BOOT_CONTROL) < 0 ? "no control cycle" : "no IP address");
+        esp_ota_mark_app_invalid_rollback_and_reboot();
+    }
+}
+
+void ota_boot_check(void) {
+    // Made here rather than on the first update, so nothing allocates after boot
+    const esp_timer_create_args_t restart_args = { .callback = restart_cb, .name = "ota_restart" };
+    ESP_ERROR_CHECK(esp_timer_create(&restart_args, &restart_timer));
+
+    const esp_partition_t *running = esp_ota_get_running_partition();
+    esp_ota_img_states_t state;
+    if (running == NULL || esp_ota_get_state_partition(running, &state) != ESP_OK ||
+        state != ESP_OTA_IMG_PENDING_VERIFY) {
+        return;
+    }
+    ESP_LOGW(TAG, "🧪 Firmware %s on trial from %s", esp_app_get_description()->version, running->label);
+    const esp_timer_create_args_t args = { .callback = confirm_cb, .name = "ota_confirm" };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &confirm_timer));
+    esp_timer_start_periodic(confirm_timer, (uint64_t)OTA_CONFIRM_POLL_MS * 1000);
+}
@@ -0,0 +1,63 @@
+#ifndef OTA_H
+#define OTA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Firmware updates over HTTP. The upload is a delta against the running
+// image (tools/ota_delta.py), decoded as it streams in and written straight
+// to the inactive OTA partition, so RAM use does not grow with the image.
+// The new image must hash to the SHA-256 in the delta before it becomes the
+// boot partition.
+//
+// With CONFIG_BOOTLOADER_APP_ROLLBACK_ENABLE the new image then boots on
+// trial: it is kept once it has run the control loop and got an IP address
+// for OTA_CONFIRM_MIN_MS, and rolled back if it has not by OTA_CONFIRM_MAX_MS
+// (or resets before that, which the bootloader treats the same way).
+#define OTA_RESTART_DELAY_MS    1000        // lets the HTTP reply go out
+#define OTA_CONFIRM_POLL_MS     5000
+#define OTA_CONFIRM_MIN_MS      30000
+#define OTA_CONFIRM_MAX_MS      300000
+
+typedef enum {
+    OTA_IDLE,
+    OTA_RECEIVING,
+    OTA_READY,              // verified, boot partition switched, restart pending
+    OTA_FAILED,
+} ota_phase_t;
+
+typedef struct {
+    ota_phase_t phase;
+    uint32_t received;          // delta bytes
+    uint32_t written;           // image bytes
+    uint32_t target_size;
+    const char *error;          // last failure, NULL if none
+    const char *running;        // partition labels
+    const char *next;
+    const char *version;        // running app version
+    bool pending_verify;        // running image is on trial
+} ota_status_t;
+
+// One update at a time: ESP_ERR_INVALID_STATE while another is in progress
+esp_err_t ota_begin(void);
+// Feed the next piece of the delta; on error the update is already aborted
+esp_err_t ota_write(const void *data, size_t len);
+// All of it received: verify, finish the image and make it the boot partition
+esp_err_t ota_finish(void);
+// Connection lost or rejected by the caller
+void ota_abort(const char *reason);
+// What went wrong with the last update (valid until the next ota_begin)
+const char *ota_error(void);
+// Restart into the new image after OTA_RESTART_DELAY_MS
+void ota_restart(void);
+
+void ota_get_status(ota_status_t *out);
+const char *ota_phase_name(ota_phase_t phase);
+
+// At boot, before ota_restart(): an image on trial is confirmed or rolled
+// back from here
+void ota_boot_check(void);
+
+#endif // OTA_H
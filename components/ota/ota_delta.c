@@ -0,0 +1,273 @@
+#include "ota_delta.h"
+#include <string.h>
+
+enum { LZ_TOKEN, LZ_LITERALS, LZ_DIST_LO, LZ_DIST_HI };
+enum { OP_CODE, OP_OFFSET, OP_LEN, OP_DATA, OP_END };
+enum { OPC_END, OPC_COPY, OPC_INSERT, OPC_ADD };
+
+static esp_err_t fail(ota_delta_t *d, const char *error, esp_err_t err) {
+    if (d->error == NULL) {
+        d->error = error;
+    }
+    return err;
+}
+
+static uint32_t le32(const uint8_t *p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+void ota_delta_init(ota_delta_t *d, const ota_delta_io_t *io) {
+    memset(d, 0, sizeof(*d));
+    d->io = *io;
+}
+
+/* ------------------------------------------------------------ output */
+
+static esp_err_t flush_out(ota_delta_t *d) {
+    if (d->out_len == 0) {
+        return ESP_OK;
+    }
+    esp_err_t err = d->io.write(d->io.ctx, d->out, d->out_len);
+    d->out_len = 0;
+    return err == ESP_OK ? ESP_OK : fail(d, "image write failed", err);
+}
+
+static esp_err_t reserve(ota_delta_t *d, uint32_t len) {
+    if (len > d->hdr.target_size - d->written) {
+        return fail(d, "longer than the target size", ESP_ERR_INVALID_SIZE);
+    }
+    d->written += len;
+    return ESP_OK;
+}
+
+static esp_err_t emit(ota_delta_t *d, uint8_t b) {
+    d->out[d->out_len++] = b;
+    return d->out_len == OTA_DELTA_BUF ? flush_out(d) : ESP_OK;
+}
+
+static esp_err_t source_check(ota_delta_t *d, uint32_t offset, uint32_t len) {
+    if ((uint64_t)offset + len > d->hdr.source_size) {
+        return fail(d, "reference past the source image", ESP_ERR_INVALID_SIZE);
+    }
+    return reserve(d, len);
+}
+
+// COPY: straight from the running image into the output buffer
+static esp_err_t copy_source(ota_delta_t *d, uint32_t offset, uint32_t len) {
+    while (len > 0) {
+        uint32_t n = OTA_DELTA_BUF - d->out_len;
+        n = n < len ? n : len;
+        esp_err_t err = d->io.read(d->io.ctx, offset, d->out + d->out_len, n);
+        if (err != ESP_OK) {
+            return fail(d, "source read failed", err);
+        }
+        d->out_len += n;
+        offset += n;
+        len -= n;
+        if (d->out_len == OTA_DELTA_BUF && (err = flush_out(d)) != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t source_byte(ota_delta_t *d, uint32_t offset, uint8_t *b) {
+    if (offset - d->src_base >= d->src_len) {
+        uint32_t n = d->hdr.source_size - offset;
+        n = n < OTA_DELTA_BUF ? n : OTA_DELTA_BUF;
+        esp_err_t err = d->io.read(d->io.ctx, offset, d->src, n);
+        if (err != ESP_OK) {
+            return fail(d, "source read failed", err);
+        }
+        d->src_base = offset;
+        d->src_len = n;
+    }
+    *b = d->src[offset - d->src_base];
+    return ESP_OK;
+}
+
+/* --------------------------------------------------------------- ops */
+
+// One op with all its numbers read
+static esp_err_t start_op(ota_delta_t *d) {
+    esp_err_t err;
+    switch (d->op) {
+    case OPC_COPY:
+        if ((err = source_check(d, d->op_offset, d->op_left)) != ESP_OK) {
+            return err;
+        }
+        d->op_state = OP_CODE;
+        return copy_source(d, d->op_offset, d->op_left);
+    case OPC_INSERT:
+        err = reserve(d, d->op_left);
+        break;
+    default:
+        err = source_check(d, d->op_offset, d->op_left);
+        break;
+    }
+    d->op_state = d->op_left ? OP_DATA : OP_CODE;
+    return err;
+}
+
+static esp_err_t op_byte(ota_delta_t *d, uint8_t b) {
+    switch (d->op_state) {
+    case OP_CODE:
+        d->op = b;
+        d->var = 0;
+        d->var_shift = 0;
+        if (b == OPC_END) {
+            d->op_state = OP_END;
+            d->done = true;
+            return ESP_OK;
+        }
+        if (b > OPC_ADD) {
+            return fail(d, "unknown op", ESP_ERR_INVALID_ARG);
+        }
+        d->op_state = b == OPC_INSERT ? OP_LEN : OP_OFFSET;
+        return ESP_OK;
+    case OP_OFFSET:
+    case OP_LEN:
+        if (d->var_shift > 28 || (d->var_shift == 28 && (b & 0x70))) {
+            return fail(d, "number too large", ESP_ERR_INVALID_ARG);
+        }
+        d->var |= (uint32_t)(b & 0x7f) << d->var_shift;
+        d->var_shift += 7;
+        if (b & 0x80) {
+            return ESP_OK;
+        }
+        if (d->op_state == OP_OFFSET) {
+            d->op_offset = d->var;
+            d->var = 0;
+            d->var_shift = 0;
+            d->op_state = OP_LEN;
+            return ESP_OK;
+        }
+        d->op_left = d->var;
+        return start_op(d);
+    case OP_DATA: {
+        uint8_t out = b;
+        if (d->op == OPC_ADD) {
+            uint8_t s;
+            esp_err_t err = source_byte(d, d->op_offset++, &s);
+            if (err != ESP_OK) {
+                return err;
+            }
+            out = (uint8_t)(s + b);
+        }
+        if (--d->op_left == 0) {
+            d->op_state = OP_CODE;
+        }
+        return emit(d, out);
+    }
+    default:
+        return fail(d, "data after the end", ESP_ERR_INVALID_SIZE);
+    }
+}
+
+/* ---------------------------------------------------------------- LZ */
+
+static esp_err_t lz_out(ota_delta_t *d, uint8_t b) {
+    d->window[d->win_pos] = b;
+    d->win_pos = (d->win_pos + 1) & (OTA_DELTA_WINDOW - 1);
+    return op_byte(d, b);
+}
+
+static esp_err_t lz_byte(ota_delta_t *d, uint8_t b) {
+    switch (d->lz_state) {
+    case LZ_TOKEN:
+        if (b < 0x80) {
+            d->lz_left = b + 1;
+            d->lz_state = LZ_LITERALS;
+        } else {
+            d->lz_len = (b & 0x7f) + 3;
+            d->lz_state = LZ_DIST_LO;
+        }
+        return ESP_OK;
+    case LZ_LITERALS:
+        if (--d->lz_left == 0) {
+            d->lz_state = LZ_TOKEN;
+        }
+        return lz_out(d, b);
+    case LZ_DIST_LO:
+        d->lz_dist_lo = b;
+        d->lz_state = LZ_DIST_HI;
+        return ESP_OK;
+    default: {
+        uint32_t dist = ((uint32_t)b << 8 | d->lz_dist_lo) + 1;
+        d->lz_state = LZ_TOKEN;
+        if (dist > OTA_DELTA_WINDOW) {
+            return fail(d, "LZ distance past the window", ESP_ERR_INVALID_ARG);
+        }
+        for (int i = 0; i < d->lz_len; i++) {
+            esp_err_t err = lz_out(d, d->window[(d->win_pos - dist) & (OTA_DELTA_WINDOW - 1)]);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+        return ESP_OK;
+    }
+    }
+}
+
+/* ------------------------------------------------------------ header */
+
+static esp_err_t parse_header(ota_delta_t *d) {
+    const uint8_t *h = d->head;
+    if (memcmp(h, OTA_DELTA_MAGIC, 4) != 0) {
+        return fail(d, "not a firmware delta", ESP_ERR_INVALID_ARG);
+    }
+    if (h[4] != OTA_DELTA_VERSION) {
+        return fail(d, "unsupported delta version", ESP_ERR_INVALID_VERSION);
+    }
+    if (h[5] & ~OTA_DELTA_FLAG_LZ) {
+        return fail(d, "unknown delta flags", ESP_ERR_INVALID_ARG);
+    }
+    d->hdr.flags = h[5];
+    d->hdr.source_size = le32(h + 8);
+    d->hdr.target_size = le32(h + 12);
+    memcpy(d->hdr.source_sha256, h + 16, 32);
+    memcpy(d->hdr.target_sha256, h + 48, 32);
+    esp_err_t err = d->io.begin(d->io.ctx, &d->hdr);
+    return err == ESP_OK ? ESP_OK : fail(d, "rejected by the image store", err);
+}
+
+esp_err_t ota_delta_feed(ota_delta_t *d, const uint8_t *buf, size_t len) {
+    if (d->error != NULL) {
+        return ESP_FAIL;
+    }
+    size_t i = 0;
+    if (d->head_len < OTA_DELTA_HEADER_SIZE) {
+        size_t n = OTA_DELTA_HEADER_SIZE - d->head_len;
+        n = n < len ? n : len;
+        memcpy(d->head + d->head_len, buf, n);
+        d->head_len += n;
+        i = n;
+        if (d->head_len == OTA_DELTA_HEADER_SIZE) {
+            esp_err_t err = parse_header(d);
+            if (err != ESP_OK) {
+                return err;
+            }
+        }
+    }
+    bool lz = d->hdr.flags & OTA_DELTA_FLAG_LZ;
+    for (; i < len; i++) {
+        esp_err_t err = lz ? lz_byte(d, buf[i]) : op_byte(d, buf[i]);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t ota_delta_finish(ota_delta_t *d) {
+    if (d->error != NULL) {
+        return ESP_FAIL;
+    }
+    if (d->head_len < OTA_DELTA_HEADER_SIZE || !d->done || d->lz_state != LZ_TOKEN) {
+        return fail(d, "delta cut short", ESP_ERR_INVALID_SIZE);
+    }
+    if (d->written != d->hdr.target_size) {
+        return fail(d, "shorter than the target size", ESP_ERR_INVALID_SIZE);
+    }
+    return flush_out(d);
+}
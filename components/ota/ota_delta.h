@@ -0,0 +1,89 @@
+#ifndef OTA_DELTA_H
+#define OTA_DELTA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Streaming decoder for firmware deltas (tools/ota_delta.py), fed in pieces
+// of any size straight from the HTTP body. Fixed memory: one LZ window plus
+// a source and an output buffer, whatever the image size.
+//
+// Format, little-endian:
+//   header  "IRD1", version 1, flags, 2 reserved, source size, target size,
+//           SHA-256 of the source image, SHA-256 of the target image (80 B)
+//   body    ops, LZ-compressed when flags has OTA_DELTA_FLAG_LZ:
+//             0x01 COPY   offset, len          source bytes as they are
+//             0x02 INSERT len, bytes           new bytes
+//             0x03 ADD    offset, len, bytes   source bytes plus these (mod 256):
+//                                              code that moved and had its
+//                                              addresses shifted is mostly zeros
+//             0x00 END
+//           numbers are LEB128 varints; offsets are absolute in the source
+//   LZ      token byte t: t < 0x80 -> t + 1 literal bytes follow;
+//           t >= 0x80 -> copy (t & 0x7f) + 3 bytes from 1 + u16 back in the
+//           output (at most OTA_DELTA_WINDOW)
+#define OTA_DELTA_MAGIC         "IRD1"
+#define OTA_DELTA_VERSION       1
+#define OTA_DELTA_HEADER_SIZE   80
+#define OTA_DELTA_FLAG_LZ       0x01
+#define OTA_DELTA_WINDOW        4096    // LZ history, power of two
+#define OTA_DELTA_BUF           1024    // source reads / image writes
+
+typedef struct {
+    uint8_t flags;
+    uint32_t source_size;           // 0 = full image, no source needed
+    uint32_t target_size;
+    uint8_t source_sha256[32];
+    uint8_t target_sha256[32];
+} ota_delta_header_t;
+
+// The image store: read the running image, write the new one in order
+typedef struct {
+    esp_err_t (*begin)(void *ctx, const ota_delta_header_t *hdr);     // header read
+    esp_err_t (*read)(void *ctx, uint32_t offset, void *buf, size_t len);
+    esp_err_t (*write)(void *ctx, const void *buf, size_t len);
+    void *ctx;
+} ota_delta_io_t;
+
+typedef struct {
+    ota_delta_io_t io;
+    ota_delta_header_t hdr;
+    const char *error;              // NULL while the delta is fine
+    uint32_t written;               // target bytes produced
+    bool done;                      // END seen
+
+    uint8_t head[OTA_DELTA_HEADER_SIZE];
+    uint8_t head_len;
+
+    // LZ stage
+    uint8_t lz_state;
+    uint8_t lz_left;                // literals still to come
+    uint8_t lz_len;                 // match length, waiting for its distance
+    uint8_t lz_dist_lo;
+    uint16_t win_pos;
+    uint8_t window[OTA_DELTA_WINDOW];
+
+    // Op stage
+    uint8_t op;
+    uint8_t op_state;
+    uint8_t var_shift;
+    uint32_t var;
+    uint32_t op_offset;
+    uint32_t op_left;
+
+    uint8_t src[OTA_DELTA_BUF];     // cached source bytes for ADD
+    uint32_t src_base;
+    uint32_t src_len;
+    uint8_t out[OTA_DELTA_BUF];
+    uint32_t out_len;
+} ota_delta_t;
+
+void ota_delta_init(ota_delta_t *d, const ota_delta_io_t *io);
+// ESP_OK, or the first error (d->error says what) for this and every later call
+esp_err_t ota_delta_feed(ota_delta_t *d, const uint8_t *buf, size_t len);
+// After the last byte: the delta ended cleanly and produced the whole image
+esp_err_t ota_delta_finish(ota_delta_t *d);
+
+#endif // OTA_DELTA_H
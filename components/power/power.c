@@ -0,0 +1,285 @@
+#include "power.h"
+#include "sensors.h"
+#include "mem.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_sleep.h"
+#include "esp_wifi.h"
+#include "esp32/ulp.h"
+#include "ulp_adc.h"
+#include "hal/adc_ll.h"
+#include "driver/rtc_io.h"
+#include "soc/rtc_io_reg.h"
+#include "soc/rtc_cntl_reg.h"
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+
+static const char *TAG = "POWER";
+
+// RTC slow memory layout (32-bit words, the ULP uses the low 16 bits)
+#define ULP_VAR_SOIL    0                           // latest average per probe
+#define ULP_PROG_ADDR   (ULP_VAR_SOIL + SOIL_PROBE_MAX)
+#define ULP_PROG_MAX    320                         // macro entries, labels included
+
+// Program labels
+#define LABEL_WAKE      0
+#define LABEL_SAMPLE    1                           // + probe
+#define LABEL_NEXT      (LABEL_SAMPLE + SOIL_PROBE_MAX)   // + check
+
+_Static_assert(POWER_ULP_OVERSAMPLE_SHIFT <= 4, "ULP sum of 12-bit samples must fit 16 bits");
+
+static const gpio_num_t tank_pins[2] = { WATER_LEVEL1, WATER_LEVEL2 };
+
+static bool low_power = POWER_LOW_POWER_DEFAULT;
+static int64_t last_wake_us = 0;        // 0 = never slept
+static int64_t pending_wake_us = 0;     // ULP wake still waiting for its pump
+
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint64_t sleep_us_total = 0;
+static uint32_t sleeps, wakes_ulp, wakes_timer;
+static uint32_t w2p_count, w2p_max_us;
+static uint64_t w2p_sum_us;
+
+static ulp_insn_t program[ULP_PROG_MAX];
+
+void power_set_low_power(bool enabled) {
+    low_power = enabled;
+}
+
+bool power_low_power(void) {
+    return low_power;
+}
+
+bool power_can_sleep(void) {
+    return low_power && esp_timer_get_time() - last_wake_us >= (int64_t)POWER_AWAKE_MIN_MS * 1000;
+}
+
+// Append macro entries (some macros expand to two) or give up when full
+#define EMIT(...) do { \
+        const ulp_insn_t insn_[] = { __VA_ARGS__ }; \
+        size_t count_ = sizeof(insn_) / sizeof(insn_[0]); \
+        if (n + count_ > ULP_PROG_MAX) { \
+            return 0; \
+        } \
+        memcpy(&program[n], insn_, sizeof(insn_)); \
+        n += count_; \
+    } while (0)
+
+// One pass per ULP period: average each probe a zone uses, compare it with
+// every such zone's threshold, read the tanks that are full now, halt. Any
+// hit jumps to the wake sequence. Thresholds are immediates, so the program
+// is rebuilt for every sleep. Returns the entry count, 0 if it does not fit.
+static size_t build_program(const system_state_t *st, uint32_t *probes_used) {
+    size_t n = 0;
+    int check = 0;
+    *probes_used = 0;
+
+    EMIT(I_MOVI(R3, ULP_VAR_SOIL));
+    for (int probe = 0; probe < soil_probe_count(); probe++) {
+        bool used = false;
+        for (int z = 0; z < st->zone_count; z++) {
+            used |= zone_config(z)->probe == probe;
+        }
+        if (!used) {
+            continue;
+        }
+        *probes_used |= 1U << probe;
+        EMIT(I_MOVI(R2, 0),
+             I_MOVI(R1, 1 << POWER_ULP_OVERSAMPLE_SHIFT),
+             M_LABEL(LABEL_SAMPLE + probe),
+             I_ADC(R0, 0, soil_probe_channel(probe)),
+             I_ADDR(R2, R2, R0),
+             I_SUBI(R1, R1, 1),
+             I_MOVR(R0, R1),
+             M_BGE(LABEL_SAMPLE + probe, 1),
+             I_RSHI(R0, R2, POWER_ULP_OVERSAMPLE_SHIFT),
+             I_ST(R0, R3, ULP_VAR_SOIL + probe));
+        for (int z = 0; z < st->zone_count; z++) {
+            if (zone_config(z)->probe == probe) {
+                // Higher reading = drier: wake if R0 > threshold
+                EMIT(M_BL(LABEL_NEXT + check, st->zone_threshold[z] + 1),
+                     M_BX(LABEL_WAKE),
+                     M_LABEL(LABEL_NEXT + check));
+                check++;
+            }
+        }
+    }
+
+    // A tank that is already empty stays quiet; only full -> empty wakes
+    bool tank_full[2] = { st->water_tank_full, st->fertilizer_tank_full };
+    for (int t = 0; t < 2; t++) {
+        int rtcio = rtc_io_number_get(tank_pins[t]);
+        if (!tank_full[t] || rtcio < 0) {
+            continue;
+        }
+        EMIT(I_RD_REG(RTC_GPIO_IN_REG, RTC_GPIO_IN_NEXT_S + rtcio, RTC_GPIO_IN_NEXT_S + rtcio),
+             M_BGE(LABEL_NEXT + check, 1),
+             M_BX(LABEL_WAKE),
+             M_LABEL(LABEL_NEXT + check));
+        check++;
+    }
+
+    // Wait until the SoC can take the wakeup, then stop the ULP timer so it
+    // does not keep waking the cores
+    EMIT(I_HALT(),
+         M_LABEL(LABEL_WAKE),
+         I_RD_REG(RTC_CNTL_LOW_POWER_ST_REG, RTC_CNTL_RDY_FOR_WAKEUP_S, RTC_CNTL_RDY_FOR_WAKEUP_S),
+         M_BL(LABEL_WAKE, 1),
+         I_WAKE(),
+         I_END(),
+         I_HALT());
+    return n;
+}
+
+// ulp_adc_init() claims ADC1 for the ULP and sets up one channel; it cannot
+// be called again until ulp_adc_deinit(). The other probes only need their
+// attenuation, which is a per-channel register.
+static esp_err_t hand_inputs_to_ulp(uint32_t probes_used, bool to_ulp) {
+    esp_err_t err = ESP_OK;
+    bool adc_ready = false;
+    for (int probe = 0; to_ulp && probe < soil_probe_count(); probe++) {
+        if (!(probes_used & (1U << probe))) {
+            continue;
+        }
+        if (adc_ready) {
+            adc_ll_set_atten(ADC_UNIT_1, soil_probe_channel(probe), ADC_ATTEN_DB_12);
+            continue;
+        }
+        ulp_adc_cfg_t cfg = {
+            .adc_n = ADC_UNIT_1,
+            .channel = soil_probe_channel(probe),
+            .width = ADC_BITWIDTH_12,
+            .atten = ADC_ATTEN_DB_12,
+            .ulp_mode = ADC_ULP_MODE_FSM,
+        };
+        err = ulp_adc_init(&cfg);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "❌ ulp_adc_init(ch %d) failed: %s", cfg.channel, esp_err_to_name(err));
+            break;
+        }
+        adc_ready = true;
+    }
+    if (!to_ulp) {
+        ulp_adc_deinit();
+    }
+    for (int t = 0; t < 2; t++) {
+        if (to_ulp) {
+            rtc_gpio_init(tank_pins[t]);
+            rtc_gpio_set_direction(tank_pins[t], RTC_GPIO_MODE_INPUT_ONLY);
+        } else {
+            rtc_gpio_deinit(tank_pins[t]);
+        }
+    }
+    return err;
+}
+
+power_wake_t power_sleep(const system_state_t *st, uint64_t max_sleep_us) {
+    uint32_t probes_used;
+    size_t size = build_program(st, &probes_used);
+    if (size == 0) {
+        ESP_LOGE(TAG, "❌ ULP program does not fit - staying awake");
+        return POWER_WAKE_NONE;
+    }
+
+    // WiFi off first: httpd sessions drop and the dashboard reconnects after the wake
+    mem_driver_begin();
+    esp_wifi_stop();
+    mem_driver_end();
+    adc_suspend();
+    esp_err_t err = hand_inputs_to_ulp(probes_used, true);
+    if (err == ESP_OK) {
+        err = ulp_process_macros_and_load(ULP_PROG_ADDR, program, &size);
+    }
+    if (err == ESP_OK) {
+        ulp_set_wakeup_period(0, POWER_ULP_PERIOD_MS * 1000);
+        esp_sleep_enable_ulp_wakeup();
+        uint64_t sleep_us = (uint64_t)POWER_MAX_SLEEP_S * 1000000;
+        esp_sleep_enable_timer_wakeup(max_sleep_us < sleep_us ? max_sleep_us : sleep_us);
+        err = ulp_run(ULP_PROG_ADDR);
+    }
+
+    int64_t slept_at = esp_timer_get_time();
+    esp_sleep_wakeup_cause_t cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+    if (err == ESP_OK) {
+        ESP_LOGD(TAG, "💤 Light sleep (ULP program: %u instructions)", (unsigned)size);
+        err = esp_light_sleep_start();
+        cause = esp_sleep_get_wakeup_cause();
+    }
+    int64_t woke_at = esp_timer_get_time();
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Sleep failed: %s", esp_err_to_name(err));
+    }
+
+    ulp_timer_stop();
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_ALL);
+    hand_inputs_to_ulp(probes_used, false);
+
+    // The ULP ran at least once (ulp_run starts it right away): its averages
+    // are fresher than the filters, which stopped when we went to sleep
+    uint16_t raw[SOIL_PROBE_MAX];
+    for (int probe = 0; probe < soil_probe_count(); probe++) {
+        bool sampled = err == ESP_OK && (probes_used & (1U << probe));
+        raw[probe] = sampled ? (uint16_t)(RTC_SLOW_MEM[ULP_VAR_SOIL + probe] & 0xffff)
+                             : (uint16_t)read_soil_moisture_probe(probe);
+    }
+    adc_resume(raw);
+    mem_driver_begin();
+    esp_wifi_start();
+    mem_driver_end();
+
+    power_wake_t wake = cause == ESP_SLEEP_WAKEUP_ULP ? POWER_WAKE_ULP
+                      : cause == ESP_SLEEP_WAKEUP_TIMER ? POWER_WAKE_TIMER : POWER_WAKE_NONE;
+    last_wake_us = woke_at;
+    pending_wake_us = wake == POWER_WAKE_ULP ? woke_at : 0;
+
+    portENTER_CRITICAL(&stats_lock);
+    if (wake != POWER_WAKE_NONE) {
+        sleep_us_total += (uint64_t)(woke_at - slept_at);
+        sleeps++;
+    }
+    wakes_ulp += wake == POWER_WAKE_ULP;
+    wakes_timer += wake == POWER_WAKE_TIMER;
+    portEXIT_CRITICAL(&stats_lock);
+
+    ESP_LOGI(TAG, "⏰ Woke up after %lld s (%s), soil %u",
+             (long long)((woke_at - slept_at) / 1000000),
+             wake == POWER_WAKE_ULP ? "ULP" : wake == POWER_WAKE_TIMER ? "timer" : "error", raw[0]);
+    return wake;
+}
+
+void power_note_pump_on(void) {
+    if (pending_wake_us == 0) {
+        return;
+    }
+    uint32_t us = (uint32_t)(esp_timer_get_time() - pending_wake_us);
+    pending_wake_us = 0;
+    portENTER_CRITICAL(&stats_lock);
+    w2p_count++;
+    w2p_sum_us += us;
+    w2p_max_us = us > w2p_max_us ? us : w2p_max_us;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void power_get_stats(power_stats_t *out) {
+    memset(out, 0, sizeof(*out));
+    uint64_t uptime_us = (uint64_t)esp_timer_get_time();
+    portENTER_CRITICAL(&stats_lock);
+    uint64_t sleep_us = sleep_us_total;
+    out->sleeps = sleeps;
+    out->wakes_ulp = wakes_ulp;
+    out->wakes_timer = wakes_timer;
+    out->wake_to_pump_count = w2p_count;
+    out->wake_to_pump_avg_us = w2p_count ? (uint32_t)(w2p_sum_us / w2p_count) : 0;
+    out->wake_to_pump_max_us = w2p_max_us;
+    portEXIT_CRITICAL(&stats_lock);
+
+    out->low_power = low_power;
+    out->uptime_ms = uptime_us / 1000;
+    out->sleep_ms = sleep_us / 1000;
+    if (uptime_us > 0) {
+        uint64_t awake_us = uptime_us > sleep_us ? uptime_us - sleep_us : 0;
+        uint64_t charge = awake_us * POWER_AWAKE_UA + sleep_us * POWER_SLEEP_UA;   // uA * us
+        out->avg_current_ua = (uint32_t)(charge / uptime_us);
+        out->energy_mwh_per_day = (uint32_t)((uint64_t)out->avg_current_ua * POWER_SUPPLY_MV * 24 / 1000000);
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "system_state.h"
+
+// Low-power mode for solar sites.
+//
+// After a check that found nothing to do, the control task puts the chip in
+// light sleep with WiFi off. The ULP coprocessor keeps sampling every soil
+// probe (and the tank float switches) and wakes the main cores only when a
+// zone reads drier than its threshold or a full tank runs empty. A timer
+// wake every POWER_MAX_SLEEP_S keeps history, the event log and the
+// dashboard alive. Light sleep rather than deep sleep: RAM (history ring,
+// event batch, control state) survives and no reboot is needed.
+//
+// Off by default: the board stays awake and polls every check interval.
+// Turn it on in menuconfig (CONFIG_POWER_LOW_POWER, under "Irrigation
+// low-power mode"); the host sim uses --low-power.
+#ifdef CONFIG_POWER_LOW_POWER
+#define POWER_LOW_POWER_DEFAULT     true
+#else
+#define POWER_LOW_POWER_DEFAULT     false
+#endif
+#define POWER_ULP_PERIOD_MS         1000    // ULP sampling period while asleep
+#define POWER_ULP_OVERSAMPLE_SHIFT  4       // ULP averages 1 << 4 conversions per probe
+#define POWER_MAX_SLEEP_S           600     // timer wake even when nothing happens
+#define POWER_AWAKE_MIN_MS          10000   // stay up after a wake (WiFi, dashboard, log)
+
+// Energy model for the estimate (board only, pumps and relays excluded).
+// ESP32 datasheet figures: WiFi connected with modem sleep vs. light sleep
+// with the ULP sampling once a second.
+#define POWER_SUPPLY_MV             3300
+#define POWER_AWAKE_UA              80000
+#define POWER_SLEEP_UA              1000
+
+typedef enum {
+    POWER_WAKE_NONE,        // did not sleep
+    POWER_WAKE_ULP,         // dry zone or emptying tank
+    POWER_WAKE_TIMER,       // POWER_MAX_SLEEP_S or the caller's limit elapsed
+} power_wake_t;
+
+typedef struct {
+    bool low_power;
+    uint64_t uptime_ms;
+    uint64_t sleep_ms;
+    uint32_t sleeps;
+    uint32_t wakes_ulp;
+    uint32_t wakes_timer;
+    uint32_t wake_to_pump_count;    // ULP wakes that started a pump
+    uint32_t wake_to_pump_avg_us;
+    uint32_t wake_to_pump_max_us;
+    uint32_t avg_current_ua;        // energy model over the uptime
+    uint32_t energy_mwh_per_day;
+} power_stats_t;
+
+void power_set_low_power(bool enabled);
+bool power_low_power(void);
+
+// Low-power mode is on and the board has been awake long enough
+bool power_can_sleep(void);
+
+// Control task only: light-sleep until the ULP sees a zone drier than its
+// threshold in *st, a tank that is full in *st runs empty, or the timer
+// runs out (POWER_MAX_SLEEP_S, or max_sleep_us if sooner, e.g. the next
+// schedule rule). Soil readings taken by the ULP seed the ADC filters on wake.
+power_wake_t power_sleep(const system_state_t *st, uint64_t max_sleep_us);
+
+// Control task: a pump just turned on (closes a wake-to-pump measurement)
+void power_note_pump_on(void);
+
+void power_get_stats(power_stats_t *out);
+
+#endif // POWER_H
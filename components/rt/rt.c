@@ -0,0 +1,316 @@
+#include "rt.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "esp_task_wdt.h"
+#include "esp_timer.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "RT";
+
+typedef struct {
+    const char *name;
+    UBaseType_t priority;
+    UBaseType_t rt_priority;
+    BaseType_t rt_core;
+    uint32_t stack;
+} task_layout_t;
+
+// The table in rt.h
+static const task_layout_t layout[RT_TASK_COUNT] = {
+    [RT_TASK_CONTROL] = { "control", 5, 8, RT_CORE_CONTROL, RT_STACK_CONTROL },
+    [RT_TASK_SENSING] = { "sensing", 6, 7, RT_CORE_CONTROL, RT_STACK_SENSING },
+    [RT_TASK_HTTPD] = { "httpd", 5, 5, RT_CORE_NET, RT_STACK_HTTPD },
+    [RT_TASK_HTTP_WORKER] = { "http_worker", 5, 5, RT_CORE_NET, RT_STACK_HTTP_WORKER },
+    [RT_TASK_TELEMETRY] = { "telemetry", 2, 2, RT_CORE_NET, RT_STACK_TELEMETRY },
+    [RT_TASK_STORAGE] = { "storage", 2, 2, RT_CORE_NET, RT_STACK_STORAGE },
+    [RT_TASK_LOG] = { "log", 1, 1, RT_CORE_NET, RT_STACK_LOG },
+};
+
+static bool deterministic = RT_DETERMINISTIC_DEFAULT;
+static bool wdt_subscribed = false;
+
+// Filled in by app_main while it starts the tasks; read lock-free
+static rt_task_info_t tasks[RT_MAX_TASKS];
+static atomic_int task_count = 0;
+
+#if RT_STATIC_ALLOC
+static StackType_t stack_pool[RT_STATIC_STACK_BYTES / sizeof(StackType_t)];
+static StaticTask_t tcb_pool[RT_MAX_TASKS];
+static uint32_t stack_pool_used;        // bytes
+#endif
+
+void rt_set_deterministic(bool on) {
+    deterministic = on;
+}
+
+bool rt_deterministic(void) {
+    return deterministic;
+}
+
+UBaseType_t rt_priority(rt_task_t task) {
+    return deterministic ? layout[task].rt_priority : layout[task].priority;
+}
+
+BaseType_t rt_core(rt_task_t task) {
+    return deterministic ? layout[task].rt_core : tskNO_AFFINITY;
+}
+
+uint32_t rt_stack(rt_task_t task) {
+    return layout[task].stack;
+}
+
+const char *rt_task_kind_name(rt_task_t task) {
+    return task < RT_TASK_COUNT ? layout[task].name : "other";
+}
+
+BaseType_t rt_task_create(TaskFunction_t fn, const char *name, void *arg, rt_task_t task,
+                          TaskHandle_t *out) {
+    int slot = atomic_load(&task_count);
+    if (slot >= RT_MAX_TASKS) {
+        ESP_LOGE(TAG, "❌ %s: more tasks than the layout table has room for", name);
+        return pdFAIL;
+    }
+    uint32_t stack = layout[task].stack;
+    TaskHandle_t handle = NULL;
+#if RT_STATIC_ALLOC
+    if (stack > sizeof(stack_pool) - stack_pool_used) {
+        ESP_LOGE(TAG, "❌ %s: static stack pool exhausted", name);
+        return pdFAIL;
+    }
+    handle = xTaskCreateStaticPinnedToCore(fn, name, stack, arg, rt_priority(task),
+                                           stack_pool + stack_pool_used / sizeof(StackType_t),
+                                           &tcb_pool[slot], rt_core(task));
+    stack_pool_used += stack;
+    bool is_static = true;
+#else
+    if (xTaskCreatePinnedToCore(fn, name, stack, arg, rt_priority(task), &handle, rt_core(task)) != pdPASS) {
+        handle = NULL;
+    }
+    bool is_static = false;
+#endif
+    if (handle == NULL) {
+        return pdFAIL;
+    }
+    tasks[slot] = (rt_task_info_t){ .handle = handle, .kind = task, .stack = stack, .is_static = is_static };
+    atomic_store(&task_count, slot + 1);
+    if (out != NULL) {
+        *out = handle;
+    }
+    return pdPASS;
+}
+
+int rt_task_count(void) {
+    return atomic_load(&task_count);
+}
+
+const rt_task_info_t *rt_task_info(int index) {
+    return &tasks[index];
+}
+
+IRAM_ATTR rt_task_t rt_task_kind(TaskHandle_t handle) {
+    int n = atomic_load_explicit(&task_count, memory_order_acquire);
+    for (int i = 0; i < n; i++) {
+        if (tasks[i].handle == handle) {
+            return tasks[i].kind;
+        }
+    }
+    return RT_TASK_COUNT;
+}
+
+/* ------------------------------------------------------------ watchdog */
+
+void rt_wdt_start(void) {
+    if (!deterministic) {
+        return;
+    }
+    esp_task_wdt_config_t config = {
+        .timeout_ms = RT_WDT_TIMEOUT_MS,
+        .idle_core_mask = (1U << portNUM_PROCESSORS) - 1,
+        .trigger_panic = true,
+    };
+    // Normally started at boot (CONFIG_ESP_TASK_WDT_INIT) with a longer timeout
+    esp_err_t err = esp_task_wdt_reconfigure(&config);
+    if (err == ESP_ERR_INVALID_STATE) {
+        err = esp_task_wdt_init(&config);
+    }
+    if (err == ESP_OK) {
+        err = esp_task_wdt_add(NULL);
+    }
+    wdt_subscribed = err == ESP_OK;
+    if (wdt_subscribed) {
+        ESP_LOGI(TAG, "🐕 Control task watchdog: %d ms, on core %d", RT_WDT_TIMEOUT_MS, RT_CORE_CONTROL);
+    } else {
+        ESP_LOGE(TAG, "❌ Control task watchdog not started: %s", esp_err_to_name(err));
+    }
+}
+
+void rt_wdt_feed(void) {
+    if (wdt_subscribed) {
+        esp_task_wdt_reset();
+    }
+}
+
+void rt_wdt_pause(void) {
+    if (wdt_subscribed) {
+        esp_task_wdt_delete(NULL);
+    }
+}
+
+void rt_wdt_resume(void) {
+    if (wdt_subscribed) {
+        esp_task_wdt_add(NULL);
+    }
+}
+
+TickType_t rt_wdt_wait_ticks(void) {
+    return wdt_subscribed ? pdMS_TO_TICKS(RT_WDT_FEED_MS) : portMAX_DELAY;
+}
+
+/* ----------------------------------------------------------- benchmark */
+
+typedef struct {
+    bool running;
+    bool pending;           // a tick is waiting for the control task
+    int64_t period_us;
+    int64_t t0_us;
+    int64_t end_us;
+    int64_t due_us;         // deadline of the pending tick
+    int64_t last_start_us;
+    uint32_t fired;
+    uint32_t cycles;
+    uint32_t missed;
+    uint32_t period_min_us;
+    uint32_t period_max_us;
+    uint64_t period_sum_us;
+    uint64_t jitter_sum_us;
+    uint32_t jitter_max_us;
+    uint32_t buckets[RT_BENCH_BUCKETS];
+} bench_t;
+
+static portMUX_TYPE bench_lock = portMUX_INITIALIZER_UNLOCKED;
+static bench_t bench;
+static esp_timer_handle_t bench_timer;
+static void (*bench_tick)(void);
+static SemaphoreHandle_t get_lock;     // rt_bench_get() readers share one copy
+static StaticSemaphore_t get_lock_buf;
+
+static void bench_timer_cb(void *arg) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&bench_lock);
+    bench.fired++;
+    bench.missed += bench.pending;
+    bench.pending = true;
+    bench.due_us = bench.t0_us + (int64_t)bench.fired * bench.period_us;
+    bool done = now >= bench.end_us;
+    bench.running = !done;
+    portEXIT_CRITICAL(&bench_lock);
+    if (done) {
+        esp_timer_stop(bench_timer);
+    }
+    bench_tick();
+}
+
+void rt_bench_init(void (*tick)(void)) {
+    bench_tick = tick;
+    get_lock = xSemaphoreCreateMutexStatic(&get_lock_buf);
+    const esp_timer_create_args_t args = { .callback = bench_timer_cb, .name = "rt_bench" };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &bench_timer));
+}
+
+bool rt_bench_start(uint32_t period_ms, uint32_t seconds) {
+    if (bench_timer == NULL || period_ms == 0 || seconds == 0 || seconds > RT_BENCH_MAX_SECONDS ||
+        period_ms > seconds * 1000) {
+        return false;
+    }
+    portENTER_CRITICAL(&bench_lock);
+    if (bench.running) {
+        portEXIT_CRITICAL(&bench_lock);
+        return false;
+    }
+    memset(&bench, 0, sizeof(bench));
+    bench.running = true;
+    bench.period_us = (int64_t)period_ms * 1000;
+    bench.t0_us = esp_timer_get_time();
+    bench.end_us = bench.t0_us + (int64_t)seconds * 1000000;
+    bench.period_min_us = UINT32_MAX;
+    portEXIT_CRITICAL(&bench_lock);
+    esp_timer_start_periodic(bench_timer, (uint64_t)bench.period_us);
+    ESP_LOGI(TAG, "⏱️ Control loop benchmark: %lu ms period for %lu s",
+             (unsigned long)period_ms, (unsigned long)seconds);
+    return true;
+}
+
+bool rt_bench_running(void) {
+    portENTER_CRITICAL(&bench_lock);
+    bool running = bench.running;
+    portEXIT_CRITICAL(&bench_lock);
+    return running;
+}
+
+void rt_bench_record(int64_t started_us, int64_t done_us) {
+    portENTER_CRITICAL(&bench_lock);
+    if (!bench.pending) {
+        portEXIT_CRITICAL(&bench_lock);
+        return;
+    }
+    bench.pending = false;
+    if (bench.cycles > 0) {
+        uint32_t period = (uint32_t)(started_us - bench.last_start_us);
+        bench.period_sum_us += period;
+        bench.period_min_us = period < bench.period_min_us ? period : bench.period_min_us;
+        bench.period_max_us = period > bench.period_max_us ? period : bench.period_max_us;
+    }
+    bench.last_start_us = started_us;
+    bench.cycles++;
+    uint32_t jitter = done_us > bench.due_us ? (uint32_t)(done_us - bench.due_us) : 0;
+    uint32_t b = jitter / RT_BENCH_BUCKET_US;
+    bench.buckets[b < RT_BENCH_BUCKETS ? b : RT_BENCH_BUCKETS - 1]++;
+    bench.jitter_sum_us += jitter;
+    bench.jitter_max_us = jitter > bench.jitter_max_us ? jitter : bench.jitter_max_us;
+    portEXIT_CRITICAL(&bench_lock);
+}
+
+// Upper edge of the bucket holding the given fraction (per mille) of cycles;
+// past the histogram only the maximum is known
+static uint32_t percentile_us(const bench_t *b, uint32_t per_mille) {
+    uint64_t target = ((uint64_t)b->cycles * per_mille + 999) / 1000;
+    uint64_t seen = 0;
+    for (int i = 0; i < RT_BENCH_BUCKETS; i++) {
+        seen += b->buckets[i];
+        if (seen >= target && seen > 0 && i < RT_BENCH_BUCKETS - 1) {
+            uint32_t edge = (uint32_t)(i + 1) * RT_BENCH_BUCKET_US;
+            return edge < b->jitter_max_us ? edge : b->jitter_max_us;
+        }
+    }
+    return b->jitter_max_us;
+}
+
+void rt_bench_get(rt_bench_result_t *out) {
+    static bench_t copy;    // too big for an httpd stack
+    if (get_lock == NULL) {
+        *out = (rt_bench_result_t){ 0 };
+        return;
+    }
+    xSemaphoreTake(get_lock, portMAX_DELAY);
+    portENTER_CRITICAL(&bench_lock);
+    copy = bench;
+    portEXIT_CRITICAL(&bench_lock);
+    uint32_t periods = copy.cycles > 1 ? copy.cycles - 1 : 0;
+    *out = (rt_bench_result_t){
+        .running = copy.running,
+        .period_ms = (uint32_t)(copy.period_us / 1000),
+        .cycles = copy.cycles,
+        .missed = copy.missed,
+        .period_min_us = periods ? copy.period_min_us : 0,
+        .period_max_us = copy.period_max_us,
+        .period_avg_us = periods ? (uint32_t)(copy.period_sum_us / periods) : 0,
+        .jitter_avg_us = copy.cycles ? (uint32_t)(copy.jitter_sum_us / copy.cycles) : 0,
+        .jitter_p50_us = percentile_us(&copy, 500),
+        .jitter_p99_us = percentile_us(&copy, 990),
+        .jitter_p999_us = percentile_us(&copy, 999),
+        .jitter_max_us = copy.jitter_max_us,
+    };
+    xSemaphoreGive(get_lock);
+}
@@ -0,0 +1,139 @@
+#ifndef RT_H
+#define RT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Task layout. By default tasks float on both cores with the priorities
+// they always had. Deterministic mode pins control and sensing to the APP
+// core, where nothing else runs, and everything network-facing to the PRO
+// core next to WiFi (23), esp_timer (22) and lwIP (18), which
+// sdkconfig.defaults pins there too:
+//
+//   task              default      deterministic   stack
+//   irrigation_task   any, 5       APP, 8          4096    control loop, watchdog-supervised
+//   adc_sampling      any, 6       APP, 7          3072    ADC frames -> filters
+//   httpd             any, 5       PRO, 5          4096    created by esp_http_server
+//   http_w*           any, 5       PRO, 5          6144 x2
+//   telemetry         any, 2       PRO, 2          3072
+//   storage           any, 2       PRO, 2          3072
+//   dlog              any, 1       PRO, 1          3072
+//
+// Deterministic mode is a menuconfig option (CONFIG_RT_DETERMINISTIC, under
+// "Irrigation task layout"); the host sim turns it on with --realtime.
+#ifdef CONFIG_RT_DETERMINISTIC
+#define RT_DETERMINISTIC_DEFAULT    true
+#else
+#define RT_DETERMINISTIC_DEFAULT    false
+#endif
+#define RT_CORE_NET                 0       // PRO_CPU
+#define RT_CORE_CONTROL             1       // APP_CPU
+
+// Stack sizes in bytes (as ESP-IDF counts them)
+#define RT_STACK_CONTROL            4096
+#define RT_STACK_SENSING            3072
+#define RT_STACK_HTTPD              4096
+#define RT_STACK_HTTP_WORKER        6144
+#define RT_STACK_TELEMETRY          3072
+#define RT_STACK_STORAGE            3072
+#define RT_STACK_LOG                3072
+#define RT_HTTP_WORKERS             2
+
+// Build mode (-DRT_STATIC_ALLOC=1, or FW_STATIC_ALLOC=ON in CMake): stacks
+// and task control blocks come from one static pool sized from the table,
+// so they are fixed at link time instead of taken from the heap, and
+// components/mem asserts that the control path never allocates after boot.
+// The httpd task is esp_http_server's own and stays on the heap.
+#ifndef RT_STATIC_ALLOC
+#define RT_STATIC_ALLOC             0
+#endif
+#define RT_MAX_TASKS                (5 + RT_HTTP_WORKERS)
+#define RT_STATIC_STACK_BYTES       (RT_STACK_CONTROL + RT_STACK_SENSING + \
+                                     RT_HTTP_WORKERS * RT_STACK_HTTP_WORKER + \
+                                     RT_STACK_TELEMETRY + RT_STACK_STORAGE + RT_STACK_LOG)
+
+// Deterministic mode only: the task watchdog resets the board if the
+// control loop does not come round within RT_WDT_TIMEOUT_MS (relays fall
+// back to off); an idle loop wakes every RT_WDT_FEED_MS to feed it
+#define RT_WDT_TIMEOUT_MS           2000
+#define RT_WDT_FEED_MS              500
+
+// Control-loop benchmark: a periodic timer asks the control task for a
+// sense + actuate cycle (probes read, relays rewritten with their current
+// levels, so nothing switches) and records how late each one completed
+#define RT_BENCH_PERIOD_MS          10
+#define RT_BENCH_SECONDS            30
+#define RT_BENCH_MAX_SECONDS        600
+#define RT_BENCH_BUCKET_US          10      // jitter histogram resolution
+#define RT_BENCH_BUCKETS            500     // up to 5 ms, the last bucket open
+
+typedef enum {
+    RT_TASK_CONTROL,
+    RT_TASK_SENSING,
+    RT_TASK_HTTPD,
+    RT_TASK_HTTP_WORKER,
+    RT_TASK_TELEMETRY,
+    RT_TASK_STORAGE,
+    RT_TASK_LOG,
+    RT_TASK_COUNT
+} rt_task_t;
+
+// Before app_main creates the tasks
+void rt_set_deterministic(bool on);
+bool rt_deterministic(void);
+
+UBaseType_t rt_priority(rt_task_t task);
+BaseType_t rt_core(rt_task_t task);         // tskNO_AFFINITY unless deterministic
+uint32_t rt_stack(rt_task_t task);          // bytes
+const char *rt_task_kind_name(rt_task_t task);
+// Create a task with its table entry's priority, core and stack
+BaseType_t rt_task_create(TaskFunction_t fn, const char *name, void *arg, rt_task_t task,
+                          TaskHandle_t *out);
+
+// Tasks made by rt_task_create(), for the memory budget
+typedef struct {
+    TaskHandle_t handle;
+    rt_task_t kind;
+    uint32_t stack;             // bytes
+    bool is_static;             // from the static pool
+} rt_task_info_t;
+
+int rt_task_count(void);
+const rt_task_info_t *rt_task_info(int index);
+// RT_TASK_COUNT for tasks rt did not create (lock-free, for heap hooks)
+rt_task_t rt_task_kind(TaskHandle_t handle);
+
+// Control task watchdog; no-ops outside deterministic mode
+void rt_wdt_start(void);                    // subscribe the calling task
+void rt_wdt_feed(void);
+void rt_wdt_pause(void);                    // around light sleep
+void rt_wdt_resume(void);
+TickType_t rt_wdt_wait_ticks(void);         // longest the control task may block
+
+typedef struct {
+    bool running;
+    uint32_t period_ms;
+    uint32_t cycles;
+    uint32_t missed;            // ticks that came while the previous one was pending
+    uint32_t period_min_us;     // start to start
+    uint32_t period_max_us;
+    uint32_t period_avg_us;
+    uint32_t jitter_avg_us;     // relays written, after the tick's deadline
+    uint32_t jitter_p50_us;
+    uint32_t jitter_p99_us;
+    uint32_t jitter_p999_us;
+    uint32_t jitter_max_us;
+} rt_bench_result_t;
+
+// tick runs on the esp_timer task for every benchmark period
+void rt_bench_init(void (*tick)(void));
+bool rt_bench_start(uint32_t period_ms, uint32_t seconds);  // false if running or bad args
+bool rt_bench_running(void);
+// Control task: one cycle started at started_us was fully actuated at done_us
+void rt_bench_record(int64_t started_us, int64_t done_us);
+void rt_bench_get(rt_bench_result_t *out);
+
+#endif // RT_H
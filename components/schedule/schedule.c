@@ -0,0 +1,492 @@
+#include "schedule.h"
+#include "metrics.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_netif_sntp.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
+#include <string.h>
+
+static const char *TAG = "SCHEDULE";
+
+#define DAY_S           86400
+#define DAY_MIN         1440
+#define US_PER_S        1000000LL
+#define ZONE_BITS       ((uint16_t)((1U << SYSTEM_MAX_ZONES) - 1))
+
+_Static_assert(SCHEDULE_MAX_RULES < INT16_MAX, "heap_pos is int16_t");
+
+static SemaphoreHandle_t lock;
+static StaticSemaphore_t lock_buf;
+// Serialises saves, so the last commit holds the newest table. Held across
+// the flash write; the control task never takes it.
+static SemaphoreHandle_t save_lock;
+static StaticSemaphore_t save_lock_buf;
+static esp_timer_handle_t edge_timer;
+static void (*notify_fn)(void);
+
+// Rule table; slot = id - 1. Everything below is guarded by lock.
+static schedule_rule_t rules[SCHEDULE_MAX_RULES];
+static int rule_count;
+static int64_t next_s[SCHEDULE_MAX_RULES];      // next edge of each rule
+static bool is_open[SCHEDULE_MAX_RULES];        // window/blackout currently open
+
+// Min-heap of slots ordered by next_s; heap_pos finds a slot's entry so a
+// removed or rescheduled rule is fixed up in place
+static uint16_t heap[SCHEDULE_MAX_RULES];
+static int16_t heap_pos[SCHEDULE_MAX_RULES];    // -1 = not in the heap
+static int heap_len;
+
+// Per zone: window rules, open windows and open blackouts
+static uint16_t window_rules[SYSTEM_MAX_ZONES];
+static uint16_t windows_open[SYSTEM_MAX_ZONES];
+static uint16_t blackouts_open[SYSTEM_MAX_ZONES];
+static atomic_uint allowed = ZONE_BITS;
+
+// Local time in us = esp_timer + clock_offset_us; 0 until the first sync
+static int64_t clock_offset_us;
+static bool synced;
+
+static const char *const kind_names[SCHEDULE_KIND_COUNT] = {
+    [SCHEDULE_WINDOW] = "window",
+    [SCHEDULE_INTERVAL] = "interval",
+    [SCHEDULE_BLACKOUT] = "blackout",
+};
+
+const char *schedule_kind_name(uint8_t kind) {
+    return kind < SCHEDULE_KIND_COUNT ? kind_names[kind] : "?";
+}
+
+static int64_t clock_now_us(void) {
+    return esp_timer_get_time() + clock_offset_us;
+}
+
+/* ------------------------------------------------------------ calendar */
+
+// Day 0 (1970-01-01, or the boot day before a sync) counts as a Thursday
+static bool day_enabled(const schedule_rule_t *r, int64_t day) {
+    return r->days == 0 || ((r->days >> ((day + 4) % 7)) & 1);
+}
+
+static int64_t span_s(const schedule_rule_t *r) {
+    int min = r->end_min > r->start_min ? r->end_min - r->start_min
+                                        : r->end_min + DAY_MIN - r->start_min;
+    return (int64_t)min * 60;
+}
+
+// Start of the window holding now (it may have opened yesterday), -1 = closed
+static int64_t window_containing(const schedule_rule_t *r, int64_t now) {
+    int64_t day = now / DAY_S;
+    for (int64_t d = day - 1; d <= day; d++) {
+        int64_t start = d * DAY_S + r->start_min * 60;
+        if (d >= 0 && day_enabled(r, d) && start <= now && now < start + span_s(r)) {
+            return start;
+        }
+    }
+    return -1;
+}
+
+// First interval fire after now, -1 = none within a week
+static int64_t next_fire(const schedule_rule_t *r, int64_t now) {
+    int64_t day = now / DAY_S;
+    for (int64_t d = day; d <= day + 7; d++) {
+        if (!day_enabled(r, d)) {
+            continue;
+        }
+        int64_t first = d * DAY_S + r->start_min * 60;
+        if (now < first) {
+            return first;
+        }
+        if (r->every_min == 0) {
+            continue;
+        }
+        int64_t k = (now - first) / (r->every_min * 60) + 1;
+        if (r->start_min + k * r->every_min < DAY_MIN) {
+            return first + k * r->every_min * 60;
+        }
+    }
+    return -1;
+}
+
+// Next open/close (window, blackout) or fire (interval) after now
+static int64_t next_edge(int slot, int64_t now) {
+    const schedule_rule_t *r = &rules[slot];
+    if (r->kind == SCHEDULE_INTERVAL) {
+        return next_fire(r, now);
+    }
+    int64_t start = window_containing(r, now);
+    if (start >= 0) {
+        return start + span_s(r);
+    }
+    for (int64_t d = now / DAY_S; d <= now / DAY_S + 7; d++) {
+        int64_t s = d * DAY_S + r->start_min * 60;
+        if (s > now && day_enabled(r, d)) {
+            return s;
+        }
+    }
+    return -1;
+}
+
+/* ---------------------------------------------------------------- heap */
+
+static void heap_swap(int a, int b) {
+    uint16_t t = heap[a];
+    heap[a] = heap[b];
+    heap[b] = t;
+    heap_pos[heap[a]] = (int16_t)a;
+    heap_pos[heap[b]] = (int16_t)b;
+}
+
+static void heap_sift(int i) {
+    while (i > 0 && next_s[heap[(i - 1) / 2]] > next_s[heap[i]]) {
+        heap_swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+    for (;;) {
+        int least = i, l = 2 * i + 1, r = l + 1;
+        if (l < heap_len && next_s[heap[l]] < next_s[heap[least]]) {
+            least = l;
+        }
+        if (r < heap_len && next_s[heap[r]] < next_s[heap[least]]) {
+            least = r;
+        }
+        if (least == i) {
+            return;
+        }
+        heap_swap(i, least);
+        i = least;
+    }
+}
+
+// Put the slot at its next_s: inserted, moved, or removed if there is none
+static void heap_update(int slot) {
+    int i = heap_pos[slot];
+    if (next_s[slot] < 0) {
+        if (i >= 0) {
+            heap_swap(i, --heap_len);
+            heap_pos[slot] = -1;
+            if (i < heap_len) {
+                heap_sift(i);
+            }
+        }
+        return;
+    }
+    if (i < 0) {
+        i = heap_len++;
+        heap[i] = (uint16_t)slot;
+        heap_pos[slot] = (int16_t)i;
+    }
+    heap_sift(i);
+}
+
+/* --------------------------------------------------------------- rules */
+
+static void update_allowed(void) {
+    uint16_t mask = 0;
+    for (int z = 0; z < SYSTEM_MAX_ZONES; z++) {
+        if (blackouts_open[z] == 0 && (window_rules[z] == 0 || windows_open[z] > 0)) {
+            mask |= 1U << z;
+        }
+    }
+    atomic_store_explicit(&allowed, mask, memory_order_relaxed);
+}
+
+static void set_open(int slot, bool open) {
+    const schedule_rule_t *r = &rules[slot];
+    uint16_t *count = r->kind == SCHEDULE_WINDOW ? windows_open : blackouts_open;
+    for (uint16_t m = r->zones; m; m &= m - 1) {
+        count[__builtin_ctz(m)] += open ? 1 : -1;
+    }
+    is_open[slot] = open;
+}
+
+static void rule_attach(int slot, int64_t now) {
+    const schedule_rule_t *r = &rules[slot];
+    if (r->kind == SCHEDULE_WINDOW) {
+        for (uint16_t m = r->zones; m; m &= m - 1) {
+            window_rules[__builtin_ctz(m)]++;
+        }
+    }
+    is_open[slot] = false;
+    if (r->kind != SCHEDULE_INTERVAL && window_containing(r, now) >= 0) {
+        set_open(slot, true);
+    }
+    next_s[slot] = next_edge(slot, now);
+    heap_update(slot);
+}
+
+static void rule_detach(int slot) {
+    const schedule_rule_t *r = &rules[slot];
+    if (is_open[slot]) {
+        set_open(slot, false);
+    }
+    if (r->kind == SCHEDULE_WINDOW) {
+        for (uint16_t m = r->zones; m; m &= m - 1) {
+            window_rules[__builtin_ctz(m)]--;
+        }
+    }
+    next_s[slot] = -1;
+    heap_update(slot);
+}
+
+// After a clock jump every open state and next edge is stale
+static void rebuild_locked(void) {
+    heap_len = 0;
+    memset(window_rules, 0, sizeof(window_rules));
+    memset(windows_open, 0, sizeof(windows_open));
+    memset(blackouts_open, 0, sizeof(blackouts_open));
+    int64_t now = clock_now_us() / US_PER_S;
+    for (int slot = 0; slot < SCHEDULE_MAX_RULES; slot++) {
+        heap_pos[slot] = -1;
+        if (rules[slot].id != 0) {
+            rule_attach(slot, now);
+        }
+    }
+    update_allowed();
+}
+
+static void arm_locked(void) {
+    esp_timer_stop(edge_timer);
+    if (heap_len == 0) {
+        return;
+    }
+    int64_t delay_us = next_s[heap[0]] * US_PER_S - clock_now_us();
+    esp_timer_start_once(edge_timer, delay_us > 0 ? (uint64_t)delay_us : 1);
+}
+
+static void edge_timer_cb(void *arg) {
+    if (notify_fn) {
+        notify_fn();
+    }
+}
+
+/* ----------------------------------------------------------------- NVS */
+
+// The used slots, packed; ids keep them in place across reboots
+// Copy the rules under lock, then write them with lock released, so the
+// control task's polls never wait for a flash commit
+static void save_rules(void) {
+    static schedule_rule_t packed[SCHEDULE_MAX_RULES];     // guarded by save_lock
+    xSemaphoreTake(save_lock, portMAX_DELAY);
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int n = 0;
+    for (int slot = 0; slot < SCHEDULE_MAX_RULES; slot++) {
+        if (rules[slot].id != 0) {
+            packed[n++] = rules[slot];
+        }
+    }
+    xSemaphoreGive(lock);
+    nvs_handle_t nvs;
+    esp_err_t err = nvs_open(SCHEDULE_NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err == ESP_OK) {
+        err = n ? nvs_set_blob(nvs, "rules", packed, n * sizeof(packed[0])) : nvs_erase_key(nvs, "rules");
+        if (err == ESP_ERR_NVS_NOT_FOUND) {
+            err = ESP_OK;
+        }
+        if (err == ESP_OK) {
+            err = nvs_commit(nvs);
+        }
+        nvs_close(nvs);
+    }
+    xSemaphoreGive(save_lock);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "❌ Saving rules failed: %s", esp_err_to_name(err));
+    }
+}
+
+static bool rule_valid(const schedule_rule_t *r) {
+    return r->kind < SCHEDULE_KIND_COUNT && r->days < 0x80 && r->zones != 0 &&
+           (r->zones & ~ZONE_BITS) == 0 && r->start_min < DAY_MIN && r->end_min < DAY_MIN &&
+           r->every_min < DAY_MIN;
+}
+
+static void load_rules(void) {
+    static schedule_rule_t packed[SCHEDULE_MAX_RULES];
+    nvs_handle_t nvs;
+    if (nvs_open(SCHEDULE_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return;
+    }
+    size_t len = sizeof(packed);
+    esp_err_t err = nvs_get_blob(nvs, "rules", packed, &len);
+    nvs_close(nvs);
+    if (err != ESP_OK || len % sizeof(packed[0]) != 0) {
+        return;
+    }
+    for (size_t i = 0; i < len / sizeof(packed[0]); i++) {
+        const schedule_rule_t *r = &packed[i];
+        if (r->id >= 1 && r->id <= SCHEDULE_MAX_RULES && rule_valid(r) && rules[r->id - 1].id == 0) {
+            rules[r->id - 1] = *r;
+            rule_count++;
+        }
+    }
+}
+
+/* ----------------------------------------------------------------- API */
+
+void schedule_init(void (*notify)(void)) {
+    notify_fn = notify;
+    lock = xSemaphoreCreateMutexStatic(&lock_buf);
+    save_lock = xSemaphoreCreateMutexStatic(&save_lock_buf);
+    const esp_timer_create_args_t timer_args = { .callback = edge_timer_cb, .name = "schedule" };
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &edge_timer));
+    load_rules();
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    rebuild_locked();
+    arm_locked();
+    xSemaphoreGive(lock);
+    ESP_LOGI(TAG, "📅 %d schedule rule(s) loaded", rule_count);
+}
+
+static void on_sntp_sync(struct timeval *tv) {
+    schedule_set_time(tv->tv_sec);
+}
+
+void schedule_sntp_start(void) {
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(SCHEDULE_SNTP_SERVER);
+    config.sync_cb = on_sntp_sync;
+    esp_err_t err = esp_netif_sntp_init(&config);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "SNTP not started (%s) - schedules run on uptime", esp_err_to_name(err));
+    }
+}
+
+void schedule_set_time(int64_t utc_s) {
+    int64_t local_us = (utc_s + SCHEDULE_UTC_OFFSET_MIN * 60) * US_PER_S;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int64_t offset = local_us - esp_timer_get_time();
+    int64_t jump_us = offset - clock_offset_us;
+    bool first = !synced;
+    clock_offset_us = offset;
+    synced = true;
+    if (first || jump_us > SCHEDULE_RESYNC_MAX_S * US_PER_S || jump_us < -SCHEDULE_RESYNC_MAX_S * US_PER_S) {
+        rebuild_locked();
+    }
+    arm_locked();
+    xSemaphoreGive(lock);
+    if (first) {
+        ESP_LOGI(TAG, "🕒 Clock synced: day %lld, %02d:%02d local",
+                 (long long)(local_us / US_PER_S / DAY_S),
+                 (int)(local_us / US_PER_S % DAY_S / 3600), (int)(local_us / US_PER_S % 3600 / 60));
+    }
+}
+
+void schedule_poll(schedule_fired_t *fired) {
+    int64_t t0 = esp_timer_get_time();
+    bool changed = false;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int64_t now = clock_now_us() / US_PER_S;
+    while (heap_len > 0 && next_s[heap[0]] <= now) {
+        int slot = heap[0];
+        const schedule_rule_t *r = &rules[slot];
+        if (r->kind == SCHEDULE_INTERVAL) {
+            // Runs missed while asleep collapse into this one
+            fired->zones |= r->zones;
+            for (uint16_t m = r->zones; m; m &= m - 1) {
+                uint32_t *ms = &fired->duration_ms[__builtin_ctz(m)];
+                *ms = r->duration_ms > *ms ? r->duration_ms : *ms;
+            }
+            metrics_count(METRIC_SCHEDULE_RUNS);
+        } else {
+            bool open = window_containing(r, now) >= 0;
+            if (open != is_open[slot]) {
+                set_open(slot, open);
+                changed = true;
+            }
+        }
+        next_s[slot] = next_edge(slot, now);
+        heap_update(slot);
+    }
+    if (changed) {
+        update_allowed();
+    }
+    arm_locked();
+    xSemaphoreGive(lock);
+    metrics_observe(METRIC_SCHEDULE_POLL, (uint32_t)(esp_timer_get_time() - t0));
+}
+
+uint16_t schedule_allowed_zones(void) {
+    return (uint16_t)atomic_load_explicit(&allowed, memory_order_relaxed);
+}
+
+uint64_t schedule_next_us(void) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int64_t left_us = heap_len ? next_s[heap[0]] * US_PER_S - clock_now_us() : -1;
+    xSemaphoreGive(lock);
+    if (left_us < 0) {
+        return heap_len ? 0 : UINT64_MAX;
+    }
+    return (uint64_t)left_us;
+}
+
+esp_err_t schedule_add(schedule_rule_t *rule) {
+    if (!rule_valid(rule)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int slot = 0;
+    while (slot < SCHEDULE_MAX_RULES && rules[slot].id != 0) {
+        slot++;
+    }
+    if (slot == SCHEDULE_MAX_RULES) {
+        xSemaphoreGive(lock);
+        return ESP_ERR_NO_MEM;
+    }
+    rule->id = (uint16_t)(slot + 1);
+    rules[slot] = *rule;
+    rule_count++;
+    rule_attach(slot, clock_now_us() / US_PER_S);
+    update_allowed();
+    arm_locked();
+    xSemaphoreGive(lock);
+    save_rules();
+    ESP_LOGI(TAG, "Rule %u added: %s, zones 0x%04x, %02u:%02u", rule->id,
+             schedule_kind_name(rule->kind), rule->zones, rule->start_min / 60, rule->start_min % 60);
+    return ESP_OK;
+}
+
+esp_err_t schedule_remove(uint16_t id) {
+    if (id < 1 || id > SCHEDULE_MAX_RULES) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    int slot = id - 1;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    if (rules[slot].id == 0) {
+        xSemaphoreGive(lock);
+        return ESP_ERR_NOT_FOUND;
+    }
+    rule_detach(slot);
+    rules[slot].id = 0;
+    rule_count--;
+    update_allowed();
+    arm_locked();
+    xSemaphoreGive(lock);
+    save_rules();
+    ESP_LOGI(TAG, "Rule %u removed", id);
+    return ESP_OK;
+}
+
+void schedule_for_each(schedule_rule_fn_t fn, void *ctx) {
+    for (int slot = 0; slot < SCHEDULE_MAX_RULES; slot++) {
+        // One rule at a time: the callback may block on a socket
+        xSemaphoreTake(lock, portMAX_DELAY);
+        schedule_rule_t r = rules[slot];
+        xSemaphoreGive(lock);
+        if (r.id != 0 && !fn(&r, ctx)) {
+            return;
+        }
+    }
+}
+
+void schedule_get_status(schedule_status_t *out) {
+    xSemaphoreTake(lock, portMAX_DELAY);
+    int64_t now_us = clock_now_us();
+    out->synced = synced;
+    out->local_s = now_us / US_PER_S;
+    out->next_s = heap_len ? next_s[heap[0]] : -1;
+    out->rules = (uint16_t)rule_count;
+    xSemaphoreGive(lock);
+    out->allowed = schedule_allowed_zones();
+}
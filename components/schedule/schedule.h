@@ -0,0 +1,89 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "system_state.h"
+
+// Calendar rules on top of the moisture check, per zone:
+//   window:   between start and end on the given days, dry zones may water;
+//             a zone with windows waters only inside one
+//   interval: at start and every `every` minutes after it that day, water
+//             the zones for `duration_ms` (0 = each zone's own duration)
+//   blackout: between start and end on the given days, no watering starts
+//
+// Every rule has exactly one entry in a min-heap keyed by its next edge
+// (window open/close, interval fire), so a tick only looks at the top of the
+// heap: due rules cost O(log n) each and the rest nothing. Window and
+// blackout edges keep per-zone counters, so the allowed zones are one load.
+//
+// Time is local wall-clock seconds from SNTP (SCHEDULE_UTC_OFFSET_MIN, no
+// DST), advanced by esp_timer between syncs. Until the first sync the clock
+// is uptime with boot taken as 00:00 on day 0, so rules still run, shifted.
+#define SCHEDULE_MAX_RULES       256
+#define SCHEDULE_UTC_OFFSET_MIN  420         // Cambodia (ICT, UTC+7)
+#define SCHEDULE_SNTP_SERVER     "pool.ntp.org"
+#define SCHEDULE_NVS_NAMESPACE   "schedule"
+#define SCHEDULE_RESYNC_MAX_S    2           // smaller SNTP corrections keep the heap
+
+typedef enum {
+    SCHEDULE_WINDOW,
+    SCHEDULE_INTERVAL,
+    SCHEDULE_BLACKOUT,
+    SCHEDULE_KIND_COUNT
+} schedule_kind_t;
+
+typedef struct {
+    uint16_t id;            // 1..SCHEDULE_MAX_RULES, 0 = free slot
+    uint8_t kind;           // schedule_kind_t
+    uint8_t days;           // bit 0 = Sunday .. bit 6 = Saturday, 0 = every day
+    uint16_t zones;         // zone bit mask
+    uint16_t start_min;     // minute of the day, 0..1439
+    uint16_t end_min;       // window/blackout end; <= start wraps past midnight
+    uint16_t every_min;     // interval period, 0 = once at start
+    uint32_t duration_ms;   // interval run time, 0 = the zone's duration
+} schedule_rule_t;
+
+// Interval rules that came due, for the control task
+typedef struct {
+    uint16_t zones;
+    uint32_t duration_ms[SYSTEM_MAX_ZONES];     // 0 = the zone's own duration
+} schedule_fired_t;
+
+typedef struct {
+    bool synced;            // SNTP time, not uptime
+    int64_t local_s;        // now, local seconds since 1970 (or since boot)
+    int64_t next_s;         // next rule edge, -1 = none
+    uint16_t allowed;       // zones that may start watering now
+    uint16_t rules;
+} schedule_status_t;
+
+// Load the saved rules and start evaluating them; notify runs (from the
+// esp_timer task) whenever schedule_poll() has something to do
+void schedule_init(void (*notify)(void));
+// Start SNTP (after esp_netif_init); the first sync moves the clock to wall time
+void schedule_sntp_start(void);
+
+// Control task: apply due edges, OR the due interval runs into *fired
+void schedule_poll(schedule_fired_t *fired);
+// Zones whose windows and blackouts allow watering now (lock-free)
+uint16_t schedule_allowed_zones(void);
+// Microseconds until the next rule edge, UINT64_MAX if none (caps light sleep)
+uint64_t schedule_next_us(void);
+
+// Rule table (any task but the control task). Changes are saved to NVS at
+// once: the caller waits for the commit, schedule_poll() does not.
+esp_err_t schedule_add(schedule_rule_t *rule);     // fills rule->id
+esp_err_t schedule_remove(uint16_t id);
+// Walk the rules in id order; stops when fn returns false
+typedef bool (*schedule_rule_fn_t)(const schedule_rule_t *rule, void *ctx);
+void schedule_for_each(schedule_rule_fn_t fn, void *ctx);
+void schedule_get_status(schedule_status_t *out);
+
+// Wall-clock time (UTC seconds) from SNTP or a test harness
+void schedule_set_time(int64_t utc_s);
+
+const char *schedule_kind_name(uint8_t kind);
+
+#endif // SCHEDULE_H
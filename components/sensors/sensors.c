@@ -1,13 +1,94 @@
 #include "sensors.h"
+#include "soil_filter.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_intr_alloc.h"
+#include "sdkconfig.h"
+#include "soc/soc_caps.h"
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "metrics.h"
+#include "rt.h"
+#include "mem.h"
+#include <stdatomic.h>
+#include <string.h>
 
 static const char *TAG = "SENSORS";
-static esp_adc_cal_characteristics_t adc_chars;
+
+static const zone_config_t zones[] = ZONE_TABLE;
+#define ZONE_COUNT ((int)(sizeof(zones) / sizeof(zones[0])))
+_Static_assert(ZONE_COUNT <= ZONE_MAX, "too many zones in ZONE_TABLE");
+
+// Continuous ADC: the digital controller converts every probe channel
+// round-robin into DMA frames. A sampling task filters whole frames and
+// publishes one value per probe, so read_soil_moisture() never touches the
+// ADC. Soil moisture moves over minutes, so run at the slowest rate the
+// target's DMA path supports.
+#define ADC_SAMPLE_FREQ_HZ  SOC_ADC_SAMPLE_FREQ_THRES_LOW
+#define ADC_FRAME_BYTES     (ADC_FRAME_CONVS * SOC_ADC_DIGI_RESULT_BYTES)
+#define ADC_POOL_BYTES      (ADC_FRAME_BYTES * 4)
+
+static const adc_channel_t soil_channels[] = SOIL_PROBE_CHANNELS;
+#define SOIL_PROBE_COUNT ((int)(sizeof(soil_channels) / sizeof(soil_channels[0])))
+_Static_assert(SOIL_PROBE_COUNT <= SOIL_PROBE_MAX, "too many soil probes");
+_Static_assert(ADC_FRAME_BYTES % SOC_ADC_DIGI_DATA_BYTES_PER_CONV == 0, "ADC frame misaligned");
+
+static adc_continuous_handle_t adc_handle = NULL;
+static TaskHandle_t adc_task_handle = NULL;
+static soil_filter_t soil_filter;
+static atomic_int soil_latest[SOIL_PROBE_MAX];
+static atomic_uint adc_frames_filtered;
+static uint8_t adc_frame[ADC_FRAME_BYTES];
+
+// Read by tank_isr, which is IRAM-safe and may run while a flash write has
+// the cache off: the const table is placed in DRAM, not flash. The rest is
+// writable and lives in DRAM anyway.
+static DRAM_ATTR const gpio_num_t tank_pins[TANK_COUNT] = { WATER_LEVEL1, WATER_LEVEL2 };
+static uint64_t tank_relays[TANK_COUNT];
+static tank_cut_t tank_cut_fns[TANK_COUNT];
+static tank_notify_t tank_notify;
+static atomic_uint tank_edge_ms[TANK_COUNT];   // last edge, ms since boot
+static atomic_uint tank_cuts;
+
+int zone_count(void) {
+    return ZONE_COUNT;
+}
+
+const zone_config_t *zone_config(int zone) {
+    return zone >= 0 && zone < ZONE_COUNT ? &zones[zone] : NULL;
+}
+
+void IRAM_ATTR relays_write(uint64_t on_mask, uint64_t off_mask) {
+    // Active-low: OFF drives the pin high, ON low. OFF goes first so a
+    // handover between zones never has both running.
+    if ((uint32_t)off_mask) {
+        REG_WRITE(GPIO_OUT_W1TS_REG, (uint32_t)off_mask);
+    }
+    if ((uint32_t)on_mask) {
+        REG_WRITE(GPIO_OUT_W1TC_REG, (uint32_t)on_mask);
+    }
+#if SOC_GPIO_PIN_COUNT > 32
+    if (off_mask >> 32) {
+        REG_WRITE(GPIO_OUT1_W1TS_REG, (uint32_t)(off_mask >> 32));
+    }
+    if (on_mask >> 32) {
+        REG_WRITE(GPIO_OUT1_W1TC_REG, (uint32_t)(on_mask >> 32));
+    }
+#endif
+}
 
 void init_gpio(void) {
+    uint64_t relay_mask = 1ULL << RELAY_PUMP2;
+    for (int z = 0; z < ZONE_COUNT; z++) {
+        relay_mask |= 1ULL << zones[z].relay;
+    }
+
     // Configure relay pins and LEDs as output
     gpio_config_t io_conf = {
-        .pin_bit_mask = (1ULL << RELAY_PUMP1) | (1ULL << RELAY_PUMP2) | (1ULL << ALERT_LED_WATER) | (1ULL << ALERT_LED_FERT),
+        .pin_bit_mask = relay_mask | (1ULL << ALERT_LED_WATER) | (1ULL << ALERT_LED_FERT),
         .mode = GPIO_MODE_OUTPUT,
         .pull_up_en = GPIO_PULLUP_DISABLE,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
@@ -16,39 +97,184 @@ void init_gpio(void) {
     gpio_config(&io_conf);
     
     // Set relays to OFF (HIGH for active-low relay modules)
-    gpio_set_level(RELAY_PUMP1, 1);
-    gpio_set_level(RELAY_PUMP2, 1);
+    relays_write(0, relay_mask);
     
     // Set alert LEDs to OFF initially
     gpio_set_level(ALERT_LED_WATER, 0);
     gpio_set_level(ALERT_LED_FERT, 0);
     
-    // Configure water level sensor pins as input
+    // Configure water level sensor pins as input, interrupting on both edges
+    // (handlers are added by tank_watch_start)
     gpio_config_t input_conf = {
         .pin_bit_mask = (1ULL << WATER_LEVEL1) | (1ULL << WATER_LEVEL2),
         .mode = GPIO_MODE_INPUT,
         .pull_up_en = GPIO_PULLUP_DISABLE,
         .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE
+        .intr_type = GPIO_INTR_ANYEDGE
     };
     gpio_config(&input_conf);
     
     ESP_LOGI(TAG, "GPIO initialized");
 }
 
+static void IRAM_ATTR tank_isr(void *arg) {
+    tank_t tank = (tank_t)(uintptr_t)arg;
+    atomic_store_explicit(&tank_edge_ms[tank], (uint32_t)(esp_timer_get_time() / 1000),
+                          memory_order_relaxed);
+    if (!gpio_get_level(tank_pins[tank])) {
+        // Empty (or a bounce): stop drawing first, the owner re-checks
+        relays_write(0, tank_relays[tank]);
+        if (tank_cut_fns[tank]) {
+            tank_cut_fns[tank]();
+        }
+        atomic_fetch_or_explicit(&tank_cuts, 1U << tank, memory_order_relaxed);
+    }
+    tank_notify();
+}
+
+void tank_watch_start(const uint64_t relays[TANK_COUNT], const tank_cut_t cuts[TANK_COUNT],
+                      tank_notify_t notify) {
+    tank_notify = notify;
+    // IRAM-safe: the level switches keep cutting the pumps during NVS writes
+    esp_err_t err = gpio_install_isr_service(ESP_INTR_FLAG_IRAM);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "❌ GPIO ISR service failed: %s", esp_err_to_name(err));
+        return;
+    }
+    for (int tank = 0; tank < TANK_COUNT; tank++) {
+        tank_relays[tank] = relays[tank];
+        tank_cut_fns[tank] = cuts ? cuts[tank] : NULL;
+        atomic_store(&tank_edge_ms[tank], (uint32_t)(esp_timer_get_time() / 1000));
+        ESP_ERROR_CHECK(gpio_isr_handler_add(tank_pins[tank], tank_isr, (void *)(uintptr_t)tank));
+    }
+    ESP_LOGI(TAG, "Tank level interrupts on (%d ms debounce)", TANK_DEBOUNCE_MS);
+}
+
+bool tank_level_settled(tank_t tank, bool *full, uint32_t *settle_ms) {
+    uint32_t since_ms = (uint32_t)(esp_timer_get_time() / 1000) -
+                        atomic_load_explicit(&tank_edge_ms[tank], memory_order_relaxed);
+    if (since_ms < TANK_DEBOUNCE_MS) {
+        *settle_ms = TANK_DEBOUNCE_MS - since_ms;
+        return false;
+    }
+    *full = gpio_get_level(tank_pins[tank]);
+    *settle_ms = 0;
+    return true;
+}
+
+uint32_t tank_take_cuts(void) {
+    return atomic_exchange_explicit(&tank_cuts, 0, memory_order_relaxed);
+}
+
+static bool IRAM_ATTR adc_conv_done_cb(adc_continuous_handle_t handle,
+                                        const adc_continuous_evt_data_t *edata, void *user_data)
+{
+    BaseType_t must_yield = pdFALSE;
+    vTaskNotifyGiveFromISR(adc_task_handle, &must_yield);
+    return must_yield == pdTRUE;
+}
+
+static void filter_frame(const uint8_t *buf, uint32_t len) {
+    uint32_t updated = soil_filter_frame(&soil_filter, buf, len);
+    for (int probe = 0; probe < SOIL_PROBE_COUNT; probe++) {
+        if (updated & (1U << probe)) {
+            atomic_store_explicit(&soil_latest[probe], soil_filter_value(&soil_filter, probe),
+                                  memory_order_relaxed);
+        }
+    }
+    atomic_fetch_add_explicit(&adc_frames_filtered, 1, memory_order_release);
+}
+
+static void adc_sampling_task(void *pvParameters) {
+    mem_task_steady();
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t len = 0;
+        int64_t t0 = esp_timer_get_time();
+        while (adc_continuous_read(adc_handle, adc_frame, sizeof(adc_frame), &len, 0) == ESP_OK) {
+            filter_frame(adc_frame, len);
+            int64_t t1 = esp_timer_get_time();
+            metrics_observe(METRIC_ADC_READ, (uint32_t)(t1 - t0));
+            t0 = t1;
+        }
+    }
+}
+
 void init_adc(void) {
-    adc1_config_width(ADC_WIDTH_BIT_12);
-    adc1_config_channel_atten(SOIL_MOISTURE, ADC_ATTEN_DB_11);
-    esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &adc_chars);
-    ESP_LOGI(TAG, "ADC initialized");
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX] = {0};
+    for (int probe = 0; probe < SOIL_PROBE_COUNT; probe++) {
+        pattern[probe].atten = ADC_ATTEN_DB_12;
+        pattern[probe].channel = soil_channels[probe];
+        pattern[probe].unit = ADC_UNIT_1;
+        pattern[probe].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        atomic_store(&soil_latest[probe], 0);
+    }
+
+    uint32_t frame_us = (uint32_t)((uint64_t)ADC_FRAME_CONVS * 1000000 / ADC_SAMPLE_FREQ_HZ);
+    soil_filter_init(&soil_filter, soil_channels, SOIL_PROBE_COUNT, frame_us);
+
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = ADC_POOL_BYTES,
+        .conv_frame_size = ADC_FRAME_BYTES,
+    };
+    ESP_ERROR_CHECK(adc_continuous_new_handle(&handle_cfg, &adc_handle));
+
+    adc_continuous_config_t adc_cfg = {
+        .pattern_num = SOIL_PROBE_COUNT,
+        .adc_pattern = pattern,
+        .sample_freq_hz = ADC_SAMPLE_FREQ_HZ,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = SOIL_ADC_FORMAT,
+    };
+    ESP_ERROR_CHECK(adc_continuous_config(adc_handle, &adc_cfg));
+
+    rt_task_create(adc_sampling_task, "adc_sampling", NULL, RT_TASK_SENSING, &adc_task_handle);
+    metrics_watch_task(adc_task_handle);
+    adc_continuous_evt_cbs_t cbs = {
+        .on_conv_done = adc_conv_done_cb,
+    };
+    ESP_ERROR_CHECK(adc_continuous_register_event_callbacks(adc_handle, &cbs, NULL));
+    ESP_ERROR_CHECK(adc_continuous_start(adc_handle));
+
+    // Wait for the first filtered frame so the first control cycle has data
+    TickType_t wait = pdMS_TO_TICKS(4 * frame_us / 1000) + 1;
+    while (atomic_load_explicit(&adc_frames_filtered, memory_order_acquire) == 0 && wait-- > 0) {
+        vTaskDelay(1);
+    }
+    ESP_LOGI(TAG, "ADC initialized (continuous, %d probe(s), %d Hz, %u-sample frames)",
+             SOIL_PROBE_COUNT, ADC_SAMPLE_FREQ_HZ, (unsigned)ADC_FRAME_CONVS);
 }
 
-int read_soil_moisture(void) {
-    int adc_reading = 0;
-    for (int i = 0; i < 10; i++) {
-        adc_reading += adc1_get_raw(SOIL_MOISTURE);
+int soil_probe_count(void) {
+    return SOIL_PROBE_COUNT;
+}
+
+adc_channel_t soil_probe_channel(int probe) {
+    return soil_channels[probe >= 0 && probe < SOIL_PROBE_COUNT ? probe : 0];
+}
+
+void adc_suspend(void) {
+    adc_continuous_stop(adc_handle);
+}
+
+void adc_resume(const uint16_t *probe_raw) {
+    adc_continuous_flush_pool(adc_handle);
+    soil_filter_reset(&soil_filter, probe_raw);
+    for (int probe = 0; probe < SOIL_PROBE_COUNT && probe_raw; probe++) {
+        atomic_store_explicit(&soil_latest[probe], probe_raw[probe], memory_order_relaxed);
+    }
+    ESP_ERROR_CHECK(adc_continuous_start(adc_handle));
+}
+
+int read_soil_moisture_probe(int probe) {
+    if (probe < 0 || probe >= SOIL_PROBE_COUNT) {
+        return -1;
     }
-    return adc_reading / 10;
+    return atomic_load_explicit(&soil_latest[probe], memory_order_relaxed);
+}
+
+int read_soil_moisture(void) {
+    return read_soil_moisture_probe(0);
 }
 
 bool read_water_level_digital(gpio_num_t pin) {
@@ -2,8 +2,7 @@
 #define SENSORS_H
 
 #include "driver/gpio.h"
-#include "driver/adc.h"
-#include "esp_adc_cal.h"
+#include "esp_adc/adc_continuous.h"
 #include <stdbool.h>
 
 // GPIO Pin Definitions
@@ -11,14 +10,81 @@
 #define RELAY_PUMP2     GPIO_NUM_26
 #define WATER_LEVEL1    GPIO_NUM_34
 #define WATER_LEVEL2    GPIO_NUM_35
-#define SOIL_MOISTURE   ADC1_CHANNEL_0
+#define SOIL_MOISTURE   ADC_CHANNEL_0
 #define ALERT_LED_WATER GPIO_NUM_22
 #define ALERT_LED_FERT  GPIO_NUM_23
+#define FERT_PWM_PIN    GPIO_NUM_19     // MOSFET gate of the fertilizer pump (proportional dosing)
+
+// Soil probes sampled by the continuous ADC engine (ADC1 channels).
+// Probe 0 is SOIL_MOISTURE; append channels here to add probes.
+#define SOIL_PROBE_CHANNELS { SOIL_MOISTURE }
+#define SOIL_PROBE_MAX      8
+
+// Irrigation zones: the soil probe (index into SOIL_PROBE_CHANNELS) and the
+// relay of the pump or valve that waters it. Zone 1 is the original bed;
+// append rows to add zones (up to ZONE_MAX).
+typedef struct {
+    const char *name;
+    uint8_t probe;
+    gpio_num_t relay;
+} zone_config_t;
+
+#define ZONE_TABLE { \
+    { .name = "Bed 1", .probe = 0, .relay = RELAY_PUMP1 }, \
+}
+#define ZONE_MAX            16
+
+// Continuous ADC engine tuning
+#define ADC_FRAME_CONVS     256     // conversions per DMA frame (all probes)
+#define ADC_OVERSAMPLE      8       // consecutive samples averaged before the median
+#define ADC_FILTER_TAU_MS   500     // EMA time constant across frames
 
 // Function declarations
 void init_gpio(void);
 void init_adc(void);
 int read_soil_moisture(void);
+int read_soil_moisture_probe(int probe);
+int soil_probe_count(void);
+adc_channel_t soil_probe_channel(int probe);
+int zone_count(void);
+const zone_config_t *zone_config(int zone);
 bool read_water_level_digital(gpio_num_t pin);
 
+// Low-power mode: stop the continuous ADC so ADC1 can be handed to the ULP,
+// then restart it. probe_raw (one reading per probe, may be NULL) seeds the
+// filters so the first read after waking is current, not pre-sleep.
+void adc_suspend(void);
+void adc_resume(const uint16_t *probe_raw);
+
+// Switch several active-low relays at once: one write to the GPIO set
+// register (off) and one to the clear register (on) per 32-pin bank, so all
+// pins change together and the cost does not grow with the relay count.
+void relays_write(uint64_t on_mask, uint64_t off_mask);
+
+// Tank float switches (high = liquid present) interrupt on both edges. An
+// empty edge switches that tank's relays (and cut, for a pump on PWM) off
+// inside the ISR, so a pump never runs dry while the control task is busy;
+// notify then wakes the owner, who reads the debounced level once the
+// switch has held still.
+typedef enum {
+    TANK_WATER,         // WATER_LEVEL1
+    TANK_FERT,          // WATER_LEVEL2
+    TANK_COUNT
+} tank_t;
+
+#define TANK_DEBOUNCE_MS    50      // a switch must hold its level this long
+
+typedef void (*tank_notify_t)(void);    // runs in the GPIO ISR
+typedef void (*tank_cut_t)(void);       // runs in the GPIO ISR
+
+// relays[tank]: the relay pins drawing from each tank; cuts[tank] (NULL =
+// none) stops any other output drawing from it
+void tank_watch_start(const uint64_t relays[TANK_COUNT], const tank_cut_t cuts[TANK_COUNT],
+                      tank_notify_t notify);
+// Debounced level. False while the switch moved less than TANK_DEBOUNCE_MS
+// ago; *settle_ms is then how long to wait before asking again.
+bool tank_level_settled(tank_t tank, bool *full, uint32_t *settle_ms);
+// Tanks (bit per tank_t) whose relays the ISR cut since the last call
+uint32_t tank_take_cuts(void);
+
 #endif // SENSORS_H
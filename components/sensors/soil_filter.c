@@ -0,0 +1,82 @@
+#include "soil_filter.h"
+#include <string.h>
+
+void soil_filter_init(soil_filter_t *f, const adc_channel_t *channels, int probes, uint32_t frame_us) {
+    memset(f, 0, sizeof(*f));
+    memset(f->channel_to_probe, -1, sizeof(f->channel_to_probe));
+    f->probes = probes;
+    for (int probe = 0; probe < probes; probe++) {
+        f->channel_to_probe[channels[probe]] = (int8_t)probe;
+        f->probe[probe].ema_q = -1;
+    }
+    f->alpha_q8 = (uint32_t)(256ULL * frame_us / ((uint64_t)ADC_FILTER_TAU_MS * 1000 + frame_us));
+    if (f->alpha_q8 == 0) {
+        f->alpha_q8 = 1;
+    }
+}
+
+// Median of a small array by insertion sort (at most SOIL_FILTER_GROUPS_MAX entries)
+static uint16_t median_u16(uint16_t *v, int n) {
+    for (int i = 1; i < n; i++) {
+        uint16_t x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+    return v[n / 2];
+}
+
+uint32_t soil_filter_frame(soil_filter_t *f, const uint8_t *buf, uint32_t len) {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *p = (const adc_digi_output_data_t *)&buf[i];
+        uint32_t ch = SOIL_ADC_CHANNEL(p);
+        if (ch >= SOC_ADC_MAX_CHANNEL_NUM || f->channel_to_probe[ch] < 0) {
+            continue;
+        }
+        soil_probe_filter_t *pf = &f->probe[f->channel_to_probe[ch]];
+        pf->sum += SOIL_ADC_DATA(p);
+        if (++pf->in_group == ADC_OVERSAMPLE) {
+            if (pf->groups < SOIL_FILTER_GROUPS_MAX) {
+                pf->group_mean[pf->groups++] = pf->sum / ADC_OVERSAMPLE;
+            }
+            pf->sum = 0;
+            pf->in_group = 0;
+        }
+    }
+
+    uint32_t updated = 0;
+    for (int probe = 0; probe < f->probes; probe++) {
+        soil_probe_filter_t *pf = &f->probe[probe];
+        if (pf->groups == 0) {
+            continue;
+        }
+        int32_t target = (int32_t)median_u16(pf->group_mean, pf->groups) << SOIL_FILTER_FRAC_BITS;
+        if (pf->ema_q < 0) {
+            pf->ema_q = target;
+        } else {
+            pf->ema_q += (int32_t)(((int64_t)(target - pf->ema_q) * f->alpha_q8) / 256);
+        }
+        pf->groups = 0;
+        updated |= 1U << probe;
+    }
+    return updated;
+}
+
+int soil_filter_value(const soil_filter_t *f, int probe) {
+    return f->probe[probe].ema_q >> SOIL_FILTER_FRAC_BITS;
+}
+
+void soil_filter_reset(soil_filter_t *f, const uint16_t *raw) {
+    for (int probe = 0; probe < f->probes; probe++) {
+        soil_probe_filter_t *pf = &f->probe[probe];
+        pf->sum = 0;
+        pf->in_group = 0;
+        pf->groups = 0;
+        if (raw) {
+            pf->ema_q = (int32_t)raw[probe] << SOIL_FILTER_FRAC_BITS;
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SOIL_FILTER_H
+#define SOIL_FILTER_H
+
+#include <stdint.h>
+#include "esp_adc/adc_continuous.h"
+#include "soc/soc_caps.h"
+#include "sdkconfig.h"
+#include "sensors.h"
+
+// Frame filter behind read_soil_moisture(), per probe: ADC_OVERSAMPLE
+// consecutive samples averaged, the median of those groups over the frame,
+// then an EMA across frames. Plain state, no ADC or tasks, so the sampling
+// task and the microbenchmarks run the same code.
+#define SOIL_FILTER_GROUPS_MAX  (ADC_FRAME_CONVS / ADC_OVERSAMPLE)
+#define SOIL_FILTER_FRAC_BITS   4
+
+// DMA result layout of the target
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2 || CONFIG_IDF_TARGET_LINUX
+#define SOIL_ADC_FORMAT         ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define SOIL_ADC_CHANNEL(p)     ((p)->type1.channel)
+#define SOIL_ADC_DATA(p)        ((p)->type1.data)
+#else
+#define SOIL_ADC_FORMAT         ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define SOIL_ADC_CHANNEL(p)     ((p)->type2.channel)
+#define SOIL_ADC_DATA(p)        ((p)->type2.data)
+#endif
+
+typedef struct {
+    uint32_t sum;           // running oversample group
+    uint8_t  in_group;
+    uint8_t  groups;
+    uint16_t group_mean[SOIL_FILTER_GROUPS_MAX];
+    int32_t  ema_q;         // EMA with SOIL_FILTER_FRAC_BITS fractional bits, -1 = unset
+} soil_probe_filter_t;
+
+typedef struct {
+    int probes;
+    int8_t channel_to_probe[SOC_ADC_MAX_CHANNEL_NUM];
+    uint32_t alpha_q8;      // per-frame EMA weight out of 256
+    soil_probe_filter_t probe[SOIL_PROBE_MAX];
+} soil_filter_t;
+
+// frame_us: time one DMA frame covers, for an EMA time constant of
+// ADC_FILTER_TAU_MS whatever the frame rate
+void soil_filter_init(soil_filter_t *f, const adc_channel_t *channels, int probes, uint32_t frame_us);
+// Filter one DMA frame; returns the probes (bit per probe) with a new value
+uint32_t soil_filter_frame(soil_filter_t *f, const uint8_t *buf, uint32_t len);
+int soil_filter_value(const soil_filter_t *f, int probe);
+// Drop partial groups; raw (one reading per probe, may be NULL) restarts the EMAs there
+void soil_filter_reset(soil_filter_t *f, const uint16_t *raw);
+
+#endif // SOIL_FILTER_H
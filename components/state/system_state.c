@@ -0,0 +1,169 @@
+#include "system_state.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// Seqlock: the sequence is odd while the writer copies a new state in.
+// Readers retry if it was odd or changed while they copied.
+static atomic_uint state_seq = 0;
+static system_state_t state;
+
+typedef struct {
+    system_state_listener_t fn;
+    void *ctx;
+} listener_t;
+
+static listener_t listeners[SYSTEM_STATE_MAX_LISTENERS];
+static atomic_uint listener_count = 0;
+
+// Bounded MPMC ring (Vyukov): each cell's sequence says whose turn it is
+typedef struct {
+    atomic_uint seq;
+    system_command_t cmd;
+} command_cell_t;
+
+static command_cell_t cmd_ring[SYSTEM_CMD_QUEUE_LEN];
+static atomic_uint cmd_enqueue_pos = 0;
+static atomic_uint cmd_dequeue_pos = 0;
+
+_Static_assert((SYSTEM_CMD_QUEUE_LEN & (SYSTEM_CMD_QUEUE_LEN - 1)) == 0,
+               "SYSTEM_CMD_QUEUE_LEN must be a power of two");
+
+void system_state_init(const system_state_t *initial) {
+    memcpy(&state, initial, sizeof(state));
+    for (unsigned i = 0; i < SYSTEM_CMD_QUEUE_LEN; i++) {
+        atomic_store_explicit(&cmd_ring[i].seq, i, memory_order_relaxed);
+    }
+    atomic_store_explicit(&state_seq, 2, memory_order_release);
+}
+
+uint32_t system_state_read(system_state_t *out) {
+    unsigned spins = 0;
+    for (;;) {
+        unsigned before = atomic_load_explicit(&state_seq, memory_order_acquire);
+        if ((before & 1) == 0) {
+            memcpy(out, &state, sizeof(*out));
+            atomic_thread_fence(memory_order_acquire);
+            if (atomic_load_explicit(&state_seq, memory_order_relaxed) == before) {
+                return before;
+            }
+        }
+        // The writer was preempted mid-copy: let it finish
+        if (++spins % 64 == 0) {
+            vTaskDelay(1);
+        }
+    }
+}
+
+uint32_t system_state_version(void) {
+    return atomic_load_explicit(&state_seq, memory_order_acquire) & ~1U;
+}
+
+bool system_state_publish(const system_state_t *next) {
+    // Single writer: the current copy is stable from this task's view
+    if (memcmp(&state, next, sizeof(state)) == 0) {
+        return false;
+    }
+    unsigned seq = atomic_load_explicit(&state_seq, memory_order_relaxed);
+    atomic_store_explicit(&state_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&state, next, sizeof(state));
+    atomic_store_explicit(&state_seq, seq + 2, memory_order_release);
+
+    unsigned n = atomic_load_explicit(&listener_count, memory_order_acquire);
+    for (unsigned i = 0; i < n; i++) {
+        listeners[i].fn(seq + 2, listeners[i].ctx);
+    }
+    return true;
+}
+
+bool system_state_add_listener(system_state_listener_t fn, void *ctx) {
+    unsigned n = atomic_load_explicit(&listener_count, memory_order_relaxed);
+    if (fn == NULL || n >= SYSTEM_STATE_MAX_LISTENERS) {
+        return false;
+    }
+    // Fill the slot before making it visible to the writer
+    listeners[n].fn = fn;
+    listeners[n].ctx = ctx;
+    atomic_store_explicit(&listener_count, n + 1, memory_order_release);
+    return true;
+}
+
+bool system_command_post(const system_command_t *cmd) {
+    unsigned pos = atomic_load_explicit(&cmd_enqueue_pos, memory_order_relaxed);
+    command_cell_t *cell;
+    for (;;) {
+        cell = &cmd_ring[pos & (SYSTEM_CMD_QUEUE_LEN - 1)];
+        unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&cmd_enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   // full
+        } else {
+            pos = atomic_load_explicit(&cmd_enqueue_pos, memory_order_relaxed);
+        }
+    }
+    cell->cmd = *cmd;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+bool system_command_post_batch(const system_command_t *cmds, unsigned n) {
+    if (n == 0 || n > SYSTEM_CMD_QUEUE_LEN) {
+        return false;
+    }
+    // The consumer frees cells in order, so if the last cell of the run is
+    // free this lap, so are the ones before it
+    unsigned pos = atomic_load_explicit(&cmd_enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        unsigned last = pos + n - 1;
+        command_cell_t *cell = &cmd_ring[last & (SYSTEM_CMD_QUEUE_LEN - 1)];
+        unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - last);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&cmd_enqueue_pos, &pos, pos + n,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   // not enough room
+        } else {
+            pos = atomic_load_explicit(&cmd_enqueue_pos, memory_order_relaxed);
+        }
+    }
+    // Publish last to first: the consumer stops at the first unpublished cell
+    for (unsigned i = n; i-- > 0;) {
+        command_cell_t *cell = &cmd_ring[(pos + i) & (SYSTEM_CMD_QUEUE_LEN - 1)];
+        cell->cmd = cmds[i];
+        atomic_store_explicit(&cell->seq, pos + i + 1, memory_order_release);
+    }
+    return true;
+}
+
+bool system_command_take(system_command_t *out) {
+    unsigned pos = atomic_load_explicit(&cmd_dequeue_pos, memory_order_relaxed);
+    command_cell_t *cell;
+    for (;;) {
+        cell = &cmd_ring[pos & (SYSTEM_CMD_QUEUE_LEN - 1)];
+        unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - (pos + 1));
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&cmd_dequeue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   // empty
+        } else {
+            pos = atomic_load_explicit(&cmd_dequeue_pos, memory_order_relaxed);
+        }
+    }
+    *out = cell->cmd;
+    atomic_store_explicit(&cell->seq, pos + SYSTEM_CMD_QUEUE_LEN, memory_order_release);
+    return true;
+}
@@ -0,0 +1,124 @@
+#ifndef SYSTEM_STATE_H
+#define SYSTEM_STATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Everything the dashboard shows or can change, published as one block.
+//
+// The irrigation task is the only writer: it keeps a working copy, applies
+// commands to it and publishes the result with system_state_publish().
+// Any task can take a coherent snapshot with system_state_read() without a
+// mutex (seqlock), so a reader never sees half of an update and the control
+// task never waits for a reader.
+#define SYSTEM_MAX_ZONES 16
+#define SYSTEM_MAX_METERS 4
+
+// Settings the API accepts and NVS loads: thresholds are raw 12-bit ADC
+// readings, durations and the check interval at least 1 ms
+#define SYSTEM_THRESHOLD_MAX 4095
+
+typedef struct {
+    // Sensors and outputs
+    int soil_moisture;          // zone 1
+    bool water_tank_full;
+    bool fertilizer_tank_full;
+    bool pump1_running;         // any zone watering
+    bool pump2_running;         // fertilizer pump
+
+    // Mode
+    bool auto_mode;
+    bool pump1_manual;          // any zone under manual control
+    bool pump2_manual;
+
+    // Settings
+    int soil_dry_threshold;     // zone 1
+    int pump_duration_ms;       // zone 1
+    int fertilizer_duration_ms;
+    int check_interval_ms;
+    // Dose by volume where a flow meter covers the pump (0 = by time); the
+    // duration is then the longest the dose may take
+    uint32_t fertilizer_volume_ml;
+    // Mix the fertilizer into the water as it flows, in ml per litre (0 =
+    // a fertilizer stage after the water, as set above)
+    uint16_t fert_ratio_ml_l;
+
+    // Irrigation zones; zone 1 (index 0) is the original bed, which the
+    // single-bed fields above mirror. Bit i of a mask is zone i + 1.
+    uint8_t zone_count;
+    uint16_t zones_watering;
+    uint16_t zones_manual;
+    uint16_t zone_soil[SYSTEM_MAX_ZONES];
+    uint16_t zone_threshold[SYSTEM_MAX_ZONES];
+    uint32_t zone_duration_ms[SYSTEM_MAX_ZONES];
+    uint32_t zone_volume_ml[SYSTEM_MAX_ZONES];
+
+    // Flow meters (FLOW_METER_TABLE): volume measured over each one's last run
+    uint8_t meter_count;
+    uint32_t meter_last_ml[SYSTEM_MAX_METERS];
+} system_state_t;
+
+// Commands from the web server (or any other task) to the control task
+typedef enum {
+    SYSTEM_CMD_SET_AUTO,        // auto.enabled
+    SYSTEM_CMD_SET_PUMP,        // pump.pump (1/2), pump.on
+    SYSTEM_CMD_SET_SETTINGS,    // settings.*
+    SYSTEM_CMD_SET_ZONE,        // zone.zone (0-based), zone.on
+} system_command_type_t;
+
+typedef struct {
+    system_command_type_t type;
+    union {
+        struct {
+            bool enabled;
+        } automode;
+        struct {
+            uint8_t pump;
+            bool on;
+        } pump;
+        struct {
+            int zone;               // threshold/pump duration for this zone (0-based), -1 = all
+            int threshold;
+            int pump_duration_ms;
+            int fert_duration_ms;
+            int interval_ms;
+            int volume_ml;          // per zone as above, -1 = unchanged
+            int fert_volume_ml;     // -1 = unchanged
+            int fert_ratio_ml_l;    // -1 = unchanged
+        } settings;
+        struct {
+            uint8_t zone;
+            bool on;
+        } zone;
+    };
+} system_command_t;
+
+#define SYSTEM_CMD_QUEUE_LEN 32     // power of two
+
+void system_state_init(const system_state_t *initial);
+
+// Copy the latest published state into *out and return its version.
+// Versions increase by 2 for every published change.
+uint32_t system_state_read(system_state_t *out);
+uint32_t system_state_version(void);
+
+// Writer side (control task only). Publishes only if *next differs from the
+// current state; returns true if a new version was published.
+bool system_state_publish(const system_state_t *next);
+
+// Called by the writer right after a new version is published (in the
+// control task's context: keep it short and never block).
+typedef void (*system_state_listener_t)(uint32_t version, void *ctx);
+#define SYSTEM_STATE_MAX_LISTENERS 4
+bool system_state_add_listener(system_state_listener_t fn, void *ctx);
+
+// Command mailbox: lock-free, many producers, one consumer.
+// Post returns false if the mailbox is full.
+bool system_command_post(const system_command_t *cmd);
+// All n commands in consecutive slots, or none if they do not all fit. The
+// consumer sees the first one only once every one is in, so a drain that
+// takes it takes the whole batch.
+bool system_command_post_batch(const system_command_t *cmds, unsigned n);
+bool system_command_take(system_command_t *out);
+
+#endif // SYSTEM_STATE_H
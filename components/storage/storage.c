@@ -0,0 +1,418 @@
+#include "storage.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "metrics.h"
+#include "rt.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "STORAGE";
+
+#define SETTINGS_VERSION  4            // 1: single bed, no zone arrays; 2: no volumes; 3: no ratio
+#define KEY_SETTINGS      "settings"
+#define KEY_BOOTS         "boots"
+#define KEY_LOG_NEXT      "log_next"      // sequence number of the next chunk
+
+typedef struct {
+    uint16_t version;
+    uint8_t auto_mode;
+    uint8_t reserved;
+    int32_t soil_dry_threshold;
+    int32_t pump_duration_ms;
+    int32_t fertilizer_duration_ms;
+    int32_t check_interval_ms;
+    // Version 2: per-zone threshold and pump duration
+    uint8_t zone_count;
+    uint8_t reserved2[3];
+    uint16_t zone_threshold[SYSTEM_MAX_ZONES];
+    uint32_t zone_duration_ms[SYSTEM_MAX_ZONES];
+    // Version 3: dose volumes (0 = by time)
+    uint32_t fertilizer_volume_ml;
+    uint32_t zone_volume_ml[SYSTEM_MAX_ZONES];
+    // Version 4: fertilizer mixed into the water (0 = after it)
+    uint16_t fert_ratio_ml_l;
+    uint16_t reserved3;
+} stored_settings_t;
+
+#define SETTINGS_V1_BYTES offsetof(stored_settings_t, zone_count)
+#define SETTINGS_V2_BYTES offsetof(stored_settings_t, fertilizer_volume_ml)
+#define SETTINGS_V3_BYTES offsetof(stored_settings_t, fert_ratio_ml_l)
+
+// One chunk is one NVS blob (key "logNN", NN = seq % STORAGE_LOG_SLOTS).
+// Only the used part of rec[] is written.
+typedef struct {
+    uint32_t seq;
+    uint32_t boot;
+    uint16_t count;
+    uint16_t reserved;
+    storage_record_t rec[STORAGE_LOG_RECORDS];
+} log_chunk_t;
+
+#define CHUNK_HEADER_BYTES offsetof(log_chunk_t, rec)
+
+static nvs_handle_t nvs;
+static bool nvs_ready = false;
+static uint32_t boot_count = 0;
+
+static QueueHandle_t event_queue = NULL;
+static StaticQueue_t event_queue_buf;
+static uint8_t event_queue_storage[STORAGE_QUEUE_LEN * sizeof(storage_record_t)];
+static atomic_uint events_dropped = 0;
+
+// The batch is shared with readers of the log (web server), which copy it
+// out under log_lock. The control task never takes this lock.
+static SemaphoreHandle_t log_lock = NULL;
+static StaticSemaphore_t log_lock_buf;
+static log_chunk_t batch;          // chunk being filled; seq is its NVS slot
+// One reader at a time owns the read buffer, for as long as it walks the log
+static SemaphoreHandle_t read_lock = NULL;
+static StaticSemaphore_t read_lock_buf;
+static log_chunk_t read_buf;
+static stored_settings_t saved;    // what is in flash, to skip identical writes
+
+// Listener side (control task)
+static system_state_t last;
+static bool have_last = false;     // the first publish carries the first sensor reads
+
+static const char *event_names[STORAGE_EVT_COUNT] = {
+    [STORAGE_EVT_BOOT] = "boot",
+    [STORAGE_EVT_PUMP_ON] = "pump_on",
+    [STORAGE_EVT_PUMP_OFF] = "pump_off",
+    [STORAGE_EVT_TANK_EMPTY] = "tank_empty",
+    [STORAGE_EVT_TANK_FULL] = "tank_full",
+    [STORAGE_EVT_AUTO_MODE] = "auto_mode",
+    [STORAGE_EVT_SETTINGS] = "settings",
+    [STORAGE_EVT_ZONE_ON] = "zone_on",
+    [STORAGE_EVT_ZONE_OFF] = "zone_off",
+};
+
+const char *storage_event_name(uint8_t type) {
+    return type < STORAGE_EVT_COUNT ? event_names[type] : "unknown";
+}
+
+uint32_t storage_boot_count(void) {
+    return boot_count;
+}
+
+static void log_key(char *key, size_t len, uint32_t seq) {
+    snprintf(key, len, "log%02u", (unsigned)(seq % STORAGE_LOG_SLOTS));
+}
+
+static uint32_t now_s(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+/* ------------------------------------------------------------ settings */
+
+static bool settings_valid(const stored_settings_t *s, size_t len) {
+    bool v1 = s->version == 1 && len == SETTINGS_V1_BYTES;
+    bool v2 = s->version == 2 && len == SETTINGS_V2_BYTES && s->zone_count <= SYSTEM_MAX_ZONES;
+    bool v3 = s->version == 3 && len == SETTINGS_V3_BYTES && s->zone_count <= SYSTEM_MAX_ZONES;
+    bool v4 = s->version == SETTINGS_VERSION && len == sizeof(*s) && s->zone_count <= SYSTEM_MAX_ZONES;
+    return (v1 || v2 || v3 || v4) &&
+           s->soil_dry_threshold >= 0 && s->soil_dry_threshold <= SYSTEM_THRESHOLD_MAX &&
+           s->pump_duration_ms > 0 && s->fertilizer_duration_ms > 0 &&
+           s->check_interval_ms > 0;
+}
+
+bool storage_load_settings(system_state_t *state) {
+    esp_err_t err = nvs_open(STORAGE_NAMESPACE, NVS_READWRITE, &nvs);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "❌ nvs_open failed: %s", esp_err_to_name(err));
+        return false;
+    }
+    nvs_ready = true;
+
+    stored_settings_t s = { 0 };
+    size_t len = sizeof(s);
+    if (nvs_get_blob(nvs, KEY_SETTINGS, &s, &len) != ESP_OK || !settings_valid(&s, len)) {
+        ESP_LOGI(TAG, "No saved settings, using defaults");
+        return false;
+    }
+    state->auto_mode = s.auto_mode != 0;
+    state->soil_dry_threshold = s.soil_dry_threshold;
+    state->pump_duration_ms = s.pump_duration_ms;
+    state->fertilizer_duration_ms = s.fertilizer_duration_ms;
+    state->check_interval_ms = s.check_interval_ms;
+    state->fertilizer_volume_ml = s.fertilizer_volume_ml;   // 0 before version 3
+    state->fert_ratio_ml_l = s.fert_ratio_ml_l;             // 0 before version 4
+    // Zones added since the save (and every zone of a version 1 blob) start
+    // with zone 1's values, and dose by time
+    for (int z = 0; z < state->zone_count; z++) {
+        bool stored = s.version >= 2 && z < s.zone_count;
+        state->zone_threshold[z] = stored ? s.zone_threshold[z] : (uint16_t)s.soil_dry_threshold;
+        state->zone_duration_ms[z] = stored ? s.zone_duration_ms[z] : (uint32_t)s.pump_duration_ms;
+        state->zone_volume_ml[z] = stored ? s.zone_volume_ml[z] : 0;
+    }
+    if (s.version == SETTINGS_VERSION) {
+        saved = s;
+    }
+    ESP_LOGI(TAG, "💾 Restored settings: threshold=%d, pump=%dms, fert=%dms, interval=%dms, auto=%s",
+             state->soil_dry_threshold, state->pump_duration_ms, state->fertilizer_duration_ms,
+             state->check_interval_ms, state->auto_mode ? "ON" : "OFF");
+    return true;
+}
+
+static void save_settings(void) {
+    system_state_t st;
+    system_state_read(&st);
+    stored_settings_t s = {
+        .version = SETTINGS_VERSION,
+        .auto_mode = st.auto_mode,
+        .soil_dry_threshold = st.soil_dry_threshold,
+        .pump_duration_ms = st.pump_duration_ms,
+        .fertilizer_duration_ms = st.fertilizer_duration_ms,
+        .check_interval_ms = st.check_interval_ms,
+        .zone_count = st.zone_count,
+        .fertilizer_volume_ml = st.fertilizer_volume_ml,
+        .fert_ratio_ml_l = st.fert_ratio_ml_l,
+    };
+    memcpy(s.zone_threshold, st.zone_threshold, sizeof(s.zone_threshold));
+    memcpy(s.zone_duration_ms, st.zone_duration_ms, sizeof(s.zone_duration_ms));
+    memcpy(s.zone_volume_ml, st.zone_volume_ml, sizeof(s.zone_volume_ml));
+    if (memcmp(&s, &saved, sizeof(s)) == 0) {
+        return;   // changed and changed back
+    }
+    esp_err_t err = nvs_set_blob(nvs, KEY_SETTINGS, &s, sizeof(s));
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ Saving settings failed: %s", esp_err_to_name(err));
+        return;
+    }
+    saved = s;
+    ESP_LOGI(TAG, "💾 Settings saved");
+}
+
+/* ----------------------------------------------------------------- log */
+
+// Write the batch to its slot. A full chunk moves on to the next slot; a
+// partial one is rewritten in place by the next commit.
+static void commit_batch(void) {
+    xSemaphoreTake(log_lock, portMAX_DELAY);
+    if (batch.count == 0) {
+        xSemaphoreGive(log_lock);
+        return;
+    }
+    char key[8];
+    log_key(key, sizeof(key), batch.seq);
+    size_t len = CHUNK_HEADER_BYTES + batch.count * sizeof(storage_record_t);
+    esp_err_t err = nvs_set_blob(nvs, key, &batch, len);
+    if (err == ESP_OK) {
+        err = nvs_set_u32(nvs, KEY_LOG_NEXT, batch.seq + 1);
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(nvs);
+    }
+    unsigned count = batch.count;
+    uint32_t seq = batch.seq;
+    if (count == STORAGE_LOG_RECORDS) {
+        batch.seq++;
+        batch.count = 0;
+    }
+    xSemaphoreGive(log_lock);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ Log commit failed: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGD(TAG, "Log chunk %u committed (%u records)", (unsigned)seq, count);
+    }
+    unsigned dropped = atomic_exchange(&events_dropped, 0);
+    if (dropped) {
+        ESP_LOGW(TAG, "⚠️ %u events dropped (queue full)", dropped);
+    }
+}
+
+// Returns true if the chunk is now full
+static bool append(const storage_record_t *rec) {
+    xSemaphoreTake(log_lock, portMAX_DELAY);
+    batch.rec[batch.count++] = *rec;
+    bool full = batch.count == STORAGE_LOG_RECORDS;
+    xSemaphoreGive(log_lock);
+    return full;
+}
+
+bool storage_log_event(storage_event_t type, uint8_t arg, uint16_t value) {
+    storage_record_t rec = { .t_s = now_s(), .type = (uint8_t)type, .arg = arg, .value = value };
+    if (event_queue == NULL || xQueueSend(event_queue, &rec, 0) != pdTRUE) {
+        atomic_fetch_add(&events_dropped, 1);
+        return false;
+    }
+    return true;
+}
+
+void storage_read_log(storage_record_fn_t fn, void *ctx) {
+    if (log_lock == NULL) {
+        return;
+    }
+    // fn may block on a slow client: it gets a copy, never the batch itself,
+    // so the storage task can keep appending meanwhile
+    xSemaphoreTake(read_lock, portMAX_DELAY);
+    xSemaphoreTake(log_lock, portMAX_DELAY);
+    uint32_t head = batch.seq;
+    memcpy(&read_buf, &batch, CHUNK_HEADER_BYTES + batch.count * sizeof(storage_record_t));
+    xSemaphoreGive(log_lock);
+    for (int i = read_buf.count - 1; i >= 0; i--) {
+        if (!fn(&read_buf.rec[i], read_buf.boot, ctx)) {
+            goto done;
+        }
+    }
+    for (uint32_t back = 1; back < STORAGE_LOG_SLOTS && back <= head; back++) {
+        char key[8];
+        uint32_t seq = head - back;
+        size_t len = sizeof(read_buf);
+        log_key(key, sizeof(key), seq);
+        xSemaphoreTake(log_lock, portMAX_DELAY);
+        esp_err_t err = nvs_get_blob(nvs, key, &read_buf, &len);
+        xSemaphoreGive(log_lock);
+        if (err != ESP_OK || len < CHUNK_HEADER_BYTES || read_buf.seq != seq) {
+            continue;   // never written, or a slot from before a reset
+        }
+        int count = (int)((len - CHUNK_HEADER_BYTES) / sizeof(storage_record_t));
+        count = count < read_buf.count ? count : read_buf.count;
+        for (int i = count - 1; i >= 0; i--) {
+            if (!fn(&read_buf.rec[i], read_buf.boot, ctx)) {
+                goto done;
+            }
+        }
+    }
+done:
+    xSemaphoreGive(read_lock);
+}
+
+static TickType_t ticks_until(int64_t due_us) {
+    int64_t left_us = due_us - esp_timer_get_time();
+    if (left_us <= 0) {
+        return 0;
+    }
+    // Round up so we never wake before the deadline and spin
+    return (TickType_t)((left_us + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000));
+}
+
+static void storage_task(void *arg) {
+    int64_t flush_due = 0;       // 0 = nothing waiting to be committed
+    int64_t settings_due = 0;    // 0 = settings unchanged
+
+    for (;;) {
+        int64_t due = flush_due;
+        if (settings_due && (!due || settings_due < due)) {
+            due = settings_due;
+        }
+        storage_record_t rec;
+        if (xQueueReceive(event_queue, &rec, due ? ticks_until(due) : portMAX_DELAY) == pdTRUE) {
+            if (rec.type == STORAGE_EVT_SETTINGS || rec.type == STORAGE_EVT_AUTO_MODE) {
+                settings_due = esp_timer_get_time() + STORAGE_SETTINGS_DELAY_MS * 1000LL;
+            }
+            if (append(&rec)) {
+                commit_batch();
+                flush_due = 0;
+            } else if (!flush_due) {
+                flush_due = esp_timer_get_time() + STORAGE_FLUSH_INTERVAL_S * 1000000LL;
+            }
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (settings_due && now >= settings_due) {
+            // The flash is being written anyway: take the pending events along
+            save_settings();
+            commit_batch();
+            settings_due = 0;
+            flush_due = 0;
+        }
+        if (flush_due && now >= flush_due) {
+            commit_batch();
+            flush_due = 0;
+        }
+    }
+}
+
+/* -------------------------------------------------------------- source */
+
+// Runs in the control task right after it publishes: only queue, never write
+static void on_state_change(uint32_t version, void *ctx) {
+    (void)version;
+    (void)ctx;
+    system_state_t st;
+    system_state_read(&st);
+    if (!have_last) {
+        last = st;
+        have_last = true;
+        return;
+    }
+    uint16_t soil = (uint16_t)st.soil_moisture;
+
+    if (st.pump1_running != last.pump1_running) {
+        storage_log_event(st.pump1_running ? STORAGE_EVT_PUMP_ON : STORAGE_EVT_PUMP_OFF, 1, soil);
+    }
+    if (st.pump2_running != last.pump2_running) {
+        storage_log_event(st.pump2_running ? STORAGE_EVT_PUMP_ON : STORAGE_EVT_PUMP_OFF, 2, soil);
+    }
+    if (st.zone_count > 1) {
+        for (uint16_t m = st.zones_watering ^ last.zones_watering; m; m &= m - 1) {
+            int z = __builtin_ctz(m);
+            bool on = st.zones_watering & (1U << z);
+            storage_log_event(on ? STORAGE_EVT_ZONE_ON : STORAGE_EVT_ZONE_OFF, (uint8_t)(z + 1), st.zone_soil[z]);
+        }
+    }
+    if (st.water_tank_full != last.water_tank_full) {
+        storage_log_event(st.water_tank_full ? STORAGE_EVT_TANK_FULL : STORAGE_EVT_TANK_EMPTY, 1, 0);
+    }
+    if (st.fertilizer_tank_full != last.fertilizer_tank_full) {
+        storage_log_event(st.fertilizer_tank_full ? STORAGE_EVT_TANK_FULL : STORAGE_EVT_TANK_EMPTY, 2, 0);
+    }
+    if (st.auto_mode != last.auto_mode) {
+        storage_log_event(STORAGE_EVT_AUTO_MODE, 0, st.auto_mode);
+    }
+    if (st.soil_dry_threshold != last.soil_dry_threshold ||
+        st.pump_duration_ms != last.pump_duration_ms ||
+        st.fertilizer_duration_ms != last.fertilizer_duration_ms ||
+        st.check_interval_ms != last.check_interval_ms ||
+        st.fertilizer_volume_ml != last.fertilizer_volume_ml ||
+        st.fert_ratio_ml_l != last.fert_ratio_ml_l ||
+        memcmp(st.zone_threshold, last.zone_threshold, sizeof(st.zone_threshold)) != 0 ||
+        memcmp(st.zone_duration_ms, last.zone_duration_ms, sizeof(st.zone_duration_ms)) != 0 ||
+        memcmp(st.zone_volume_ml, last.zone_volume_ml, sizeof(st.zone_volume_ml)) != 0) {
+        storage_log_event(STORAGE_EVT_SETTINGS, 0, (uint16_t)st.soil_dry_threshold);
+    }
+    last = st;
+}
+
+void storage_init(void) {
+    if (!nvs_ready) {
+        ESP_LOGE(TAG, "❌ NVS not open, persistence disabled");
+        return;
+    }
+    uint32_t log_next = 0;
+    nvs_get_u32(nvs, KEY_BOOTS, &boot_count);
+    nvs_get_u32(nvs, KEY_LOG_NEXT, &log_next);
+    boot_count++;
+    if (nvs_set_u32(nvs, KEY_BOOTS, boot_count) != ESP_OK || nvs_commit(nvs) != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ Could not save the boot counter");
+    }
+
+    // Each boot starts a fresh chunk; the previous one keeps its slot
+    batch.seq = log_next;
+    batch.boot = boot_count;
+    batch.count = 0;
+
+    log_lock = xSemaphoreCreateMutexStatic(&log_lock_buf);
+    read_lock = xSemaphoreCreateMutexStatic(&read_lock_buf);
+    event_queue = xQueueCreateStatic(STORAGE_QUEUE_LEN, sizeof(storage_record_t),
+                                     event_queue_storage, &event_queue_buf);
+    storage_log_event(STORAGE_EVT_BOOT, 0, (uint16_t)boot_count);
+
+    system_state_add_listener(on_state_change, NULL);
+    TaskHandle_t task = NULL;
+    rt_task_create(storage_task, "storage", NULL, RT_TASK_STORAGE, &task);
+    metrics_watch_task(task);
+    ESP_LOGI(TAG, "💾 Boot #%u, event log at chunk %u (%d x %d records)",
+             (unsigned)boot_count, (unsigned)log_next, STORAGE_LOG_SLOTS, STORAGE_LOG_RECORDS);
+}
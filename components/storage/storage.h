@@ -0,0 +1,59 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "system_state.h"
+
+// Flash persistence for settings and an irrigation event log (NVS).
+//
+// Nothing here writes flash from the control task: events go through a
+// queue to a low-priority storage task that batches them in RAM and commits
+// one chunk blob at a time. Chunks rotate over STORAGE_LOG_SLOTS keys, so
+// the log has a fixed footprint and NVS spreads the writes over its pages.
+#define STORAGE_NAMESPACE          "irrigation"
+#define STORAGE_LOG_RECORDS        126     // per chunk: 8 B each, ~1 KB blob (a quarter NVS page)
+#define STORAGE_LOG_SLOTS          16      // chunks kept, oldest overwritten (~2000 events)
+#define STORAGE_FLUSH_INTERVAL_S   900     // commit a partly filled chunk at least this often
+#define STORAGE_SETTINGS_DELAY_MS  5000    // save settings once unchanged this long
+#define STORAGE_QUEUE_LEN          32
+
+typedef enum {
+    STORAGE_EVT_BOOT,           // value: boot count (low 16 bits)
+    STORAGE_EVT_PUMP_ON,        // arg: pump 1/2, value: soil moisture
+    STORAGE_EVT_PUMP_OFF,       // arg: pump 1/2, value: soil moisture
+    STORAGE_EVT_TANK_EMPTY,     // arg: tank 1 water / 2 fertilizer
+    STORAGE_EVT_TANK_FULL,      // arg: tank 1 water / 2 fertilizer
+    STORAGE_EVT_AUTO_MODE,      // value: 1 on / 0 off
+    STORAGE_EVT_SETTINGS,       // value: soil dry threshold
+    STORAGE_EVT_ZONE_ON,        // arg: zone 1..16, value: its soil moisture (multi-zone tables only)
+    STORAGE_EVT_ZONE_OFF,       // arg: zone 1..16, value: its soil moisture
+    STORAGE_EVT_COUNT
+} storage_event_t;
+
+typedef struct {
+    uint32_t t_s;               // seconds since that boot
+    uint8_t type;               // storage_event_t
+    uint8_t arg;
+    uint16_t value;
+} storage_record_t;
+
+// Overlay the saved settings and mode on *state (call before
+// system_state_init, after nvs_flash_init). Returns false if none are saved.
+bool storage_load_settings(system_state_t *state);
+
+// Start the storage task and log state changes from now on
+void storage_init(void);
+
+// Queue an event for the log; never blocks. False if the queue was full.
+bool storage_log_event(storage_event_t type, uint8_t arg, uint16_t value);
+
+// Walk the log newest first, including records not committed yet. Stops
+// when fn returns false. Not for the control task (may wait for a commit).
+typedef bool (*storage_record_fn_t)(const storage_record_t *rec, uint32_t boot, void *ctx);
+void storage_read_log(storage_record_fn_t fn, void *ctx);
+
+const char *storage_event_name(uint8_t type);
+uint32_t storage_boot_count(void);
+
+#endif // STORAGE_H
@@ -0,0 +1,147 @@
+#include "telemetry.h"
+#include "telemetry_frame.h"
+#include "system_state.h"
+#include "metrics.h"
+#include "rt.h"
+#include "esp_log.h"
+#include "esp_mac.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+static const char *TAG = "TELEMETRY";
+
+_Static_assert(TELEMETRY_BATCH <= TELEMETRY_MAX_RECORDS, "batch must fit one datagram");
+
+static char target_host[16] = TELEMETRY_HOST;
+static uint16_t target_port = TELEMETRY_PORT;
+static TaskHandle_t telemetry_task_handle = NULL;
+
+// Telemetry task only
+static uint8_t packet[TELEMETRY_HEADER_BYTES + TELEMETRY_BATCH * TELEMETRY_RECORD_BYTES];
+static telemetry_header_t header;
+static int64_t batch_start_us = 0;
+
+void telemetry_set_target(const char *host, uint16_t port) {
+    strncpy(target_host, host, sizeof(target_host) - 1);
+    target_host[sizeof(target_host) - 1] = '\0';
+    target_port = port;
+}
+
+// Control task context: just wake the telemetry task
+static void on_state_published(uint32_t version, void *ctx) {
+    xTaskNotifyGive(telemetry_task_handle);
+}
+
+static void add_record(const system_state_t *st, uint32_t version, bool heartbeat, int64_t now_us) {
+    telemetry_record_t rec = {
+        .t_ms = (uint32_t)(now_us / 1000),
+        .soil = (uint16_t)st->soil_moisture,
+        .threshold = (uint16_t)st->soil_dry_threshold,
+        .zones_watering = st->zones_watering,
+        .zones_manual = st->zones_manual,
+        .flags = (uint8_t)((st->pump1_running ? TELEMETRY_PUMP1 : 0) |
+                           (st->pump2_running ? TELEMETRY_PUMP2 : 0) |
+                           (st->water_tank_full ? TELEMETRY_WATER_FULL : 0) |
+                           (st->fertilizer_tank_full ? TELEMETRY_FERT_FULL : 0) |
+                           (st->auto_mode ? TELEMETRY_AUTO : 0) |
+                           (st->pump2_manual ? TELEMETRY_PUMP2_MANUAL : 0) |
+                           (heartbeat ? TELEMETRY_HEARTBEAT : 0)),
+        .zone_count = st->zone_count,
+        .version = (uint16_t)(version >> 1),
+    };
+    if (header.count == 0) {
+        batch_start_us = now_us;
+    }
+    telemetry_put_record(packet + TELEMETRY_HEADER_BYTES + header.count * TELEMETRY_RECORD_BYTES, &rec);
+    header.count++;
+}
+
+static void send_batch(int sock, const struct sockaddr_in *dest) {
+    header.sent_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    telemetry_put_header(packet, &header);
+    size_t len = TELEMETRY_HEADER_BYTES + header.count * TELEMETRY_RECORD_BYTES;
+    if (sendto(sock, packet, len, 0, (const struct sockaddr *)dest, sizeof(*dest)) == (ssize_t)len) {
+        metrics_count(METRIC_TELEMETRY_SENT);
+    } else {
+        metrics_count(METRIC_TELEMETRY_ERRORS);     // e.g. WiFi down: the batch is lost
+    }
+    // The sequence advances either way: the collector sees the gap
+    header.seq++;
+    header.count = 0;
+}
+
+static TickType_t ticks_until(int64_t due_us) {
+    int64_t left_us = due_us - esp_timer_get_time();
+    if (left_us <= 0) {
+        return 0;
+    }
+    return (TickType_t)((left_us + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000));
+}
+
+static void telemetry_task(void *arg) {
+    const struct sockaddr_in *dest = arg;
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) {
+        ESP_LOGE(TAG, "❌ socket() failed: %d", errno);
+        vTaskDelete(NULL);
+        return;
+    }
+
+    uint32_t last_version = 0;
+    int64_t last_record_us = 0;
+    for (;;) {
+        int64_t due_us = last_record_us + (int64_t)TELEMETRY_HEARTBEAT_MS * 1000;
+        if (header.count > 0 && batch_start_us + (int64_t)TELEMETRY_FLUSH_MS * 1000 < due_us) {
+            due_us = batch_start_us + (int64_t)TELEMETRY_FLUSH_MS * 1000;
+        }
+        ulTaskNotifyTake(pdTRUE, ticks_until(due_us));
+
+        int64_t now_us = esp_timer_get_time();
+        bool changed = system_state_version() != last_version;
+        if (changed || now_us - last_record_us >= (int64_t)TELEMETRY_HEARTBEAT_MS * 1000) {
+            system_state_t st;
+            last_version = system_state_read(&st);
+            last_record_us = now_us;
+            add_record(&st, last_version, !changed, now_us);
+        }
+        if (header.count == TELEMETRY_BATCH ||
+            (header.count > 0 && now_us - batch_start_us >= (int64_t)TELEMETRY_FLUSH_MS * 1000)) {
+            send_batch(sock, dest);
+        }
+    }
+}
+
+esp_err_t telemetry_start(void) {
+    static struct sockaddr_in dest;
+    if (target_host[0] == '\0') {
+        ESP_LOGI(TAG, "Telemetry off (no collector configured)");
+        return ESP_OK;
+    }
+    dest.sin_family = AF_INET;
+    dest.sin_port = htons(target_port);
+    if (inet_pton(AF_INET, target_host, &dest.sin_addr) != 1) {
+        ESP_LOGE(TAG, "❌ Bad collector address '%s' (IPv4 expected)", target_host);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint8_t mac[6];
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    header.node_id = (uint32_t)mac[2] << 24 | (uint32_t)mac[3] << 16 | (uint32_t)mac[4] << 8 | mac[5];
+    header.boot_id = esp_random();
+
+    rt_task_create(telemetry_task, "telemetry", &dest, RT_TASK_TELEMETRY, &telemetry_task_handle);
+    if (telemetry_task_handle == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    metrics_watch_task(telemetry_task_handle);
+    system_state_add_listener(on_state_published, NULL);
+    ESP_LOGI(TAG, "📡 Telemetry to %s:%u (node %08" PRIx32 ", %d records per datagram)",
+             target_host, target_port, header.node_id, TELEMETRY_BATCH);
+    return ESP_OK;
+}
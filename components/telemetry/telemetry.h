@@ -0,0 +1,30 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Fleet telemetry: state records pushed over UDP to a central collector, so
+// many controllers can be watched without polling /api/data on each.
+//
+// Every published state change (and a heartbeat when nothing changes) adds
+// a 16-byte record to a batch; the batch goes out as one datagram when it
+// is full or its oldest record is TELEMETRY_FLUSH_MS old. Changes that
+// arrive faster than the task runs are folded into one record. Datagrams
+// are fire-and-forget: the collector counts losses from the sequence
+// numbers. Wire format in telemetry_frame.h.
+//
+// Off unless a collector address is set (TELEMETRY_HOST, IPv4).
+#define TELEMETRY_HOST          ""
+#define TELEMETRY_PORT          9999
+#define TELEMETRY_BATCH         8       // records per datagram
+#define TELEMETRY_FLUSH_MS      30000   // longest a record waits for its batch
+#define TELEMETRY_HEARTBEAT_MS  10000   // record even without a change
+
+// Override TELEMETRY_HOST/PORT (call before telemetry_start)
+void telemetry_set_target(const char *host, uint16_t port);
+
+// Start publishing; does nothing when no collector is configured
+esp_err_t telemetry_start(void);
+
+#endif // TELEMETRY_H
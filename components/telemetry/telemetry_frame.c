@@ -0,0 +1,68 @@
+#include "telemetry_frame.h"
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    put16(p, (uint16_t)v);
+    put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return get16(p) | (uint32_t)get16(p + 2) << 16;
+}
+
+void telemetry_put_header(uint8_t *buf, const telemetry_header_t *h) {
+    put16(buf, TELEMETRY_MAGIC);
+    buf[2] = TELEMETRY_VERSION;
+    buf[3] = h->count;
+    put32(buf + 4, h->node_id);
+    put32(buf + 8, h->boot_id);
+    put32(buf + 12, h->seq);
+    put32(buf + 16, h->sent_ms);
+}
+
+void telemetry_put_record(uint8_t *buf, const telemetry_record_t *r) {
+    put32(buf, r->t_ms);
+    put16(buf + 4, r->soil);
+    put16(buf + 6, r->threshold);
+    put16(buf + 8, r->zones_watering);
+    put16(buf + 10, r->zones_manual);
+    buf[12] = r->flags;
+    buf[13] = r->zone_count;
+    put16(buf + 14, r->version);
+}
+
+bool telemetry_get_header(const uint8_t *buf, size_t len, telemetry_header_t *h) {
+    if (len < TELEMETRY_HEADER_BYTES || get16(buf) != TELEMETRY_MAGIC || buf[2] != TELEMETRY_VERSION) {
+        return false;
+    }
+    h->count = buf[3];
+    if (h->count == 0 || h->count > TELEMETRY_MAX_RECORDS ||
+        len != TELEMETRY_HEADER_BYTES + (size_t)h->count * TELEMETRY_RECORD_BYTES) {
+        return false;
+    }
+    h->node_id = get32(buf + 4);
+    h->boot_id = get32(buf + 8);
+    h->seq = get32(buf + 12);
+    h->sent_ms = get32(buf + 16);
+    return true;
+}
+
+void telemetry_get_record(const uint8_t *buf, int i, telemetry_record_t *r) {
+    const uint8_t *p = buf + TELEMETRY_HEADER_BYTES + (size_t)i * TELEMETRY_RECORD_BYTES;
+    r->t_ms = get32(p);
+    r->soil = get16(p + 4);
+    r->threshold = get16(p + 6);
+    r->zones_watering = get16(p + 8);
+    r->zones_manual = get16(p + 10);
+    r->flags = p[12];
+    r->zone_count = p[13];
+    r->version = get16(p + 14);
+}
@@ -0,0 +1,65 @@
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Telemetry wire format, shared by the firmware and the host collector.
+// One UDP datagram = header + `count` fixed-size records, all little-endian,
+// no padding:
+//
+//   header (20 B)  magic u16 | version u8 | count u8 | node_id u32 |
+//                  boot_id u32 | seq u32 | sent_ms u32
+//   record (16 B)  t_ms u32 | soil u16 | threshold u16 | zones_watering u16 |
+//                  zones_manual u16 | flags u8 | zone_count u8 | version u16
+//
+// seq counts datagrams from 0 for each boot_id, so a receiver can tell lost
+// and reordered datagrams from a reboot. Records are zone 1's soil and
+// threshold plus the zone masks; `version` is the state version / 2 (low 16
+// bits), so a gap between records counts the changes folded into the later
+// one.
+#define TELEMETRY_MAGIC         0x4952      // "RI" on the wire
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_HEADER_BYTES  20
+#define TELEMETRY_RECORD_BYTES  16
+#define TELEMETRY_MAX_RECORDS   64          // fits one unfragmented datagram
+
+// Record flags
+#define TELEMETRY_PUMP1         (1U << 0)
+#define TELEMETRY_PUMP2         (1U << 1)
+#define TELEMETRY_WATER_FULL    (1U << 2)
+#define TELEMETRY_FERT_FULL     (1U << 3)
+#define TELEMETRY_AUTO          (1U << 4)
+#define TELEMETRY_PUMP2_MANUAL  (1U << 5)
+#define TELEMETRY_HEARTBEAT     (1U << 6)   // nothing changed since the last record
+
+typedef struct {
+    uint8_t count;
+    uint32_t node_id;
+    uint32_t boot_id;
+    uint32_t seq;
+    uint32_t sent_ms;
+} telemetry_header_t;
+
+typedef struct {
+    uint32_t t_ms;
+    uint16_t soil;
+    uint16_t threshold;
+    uint16_t zones_watering;
+    uint16_t zones_manual;
+    uint8_t flags;
+    uint8_t zone_count;
+    uint16_t version;
+} telemetry_record_t;
+
+// Write into buf (TELEMETRY_HEADER_BYTES / TELEMETRY_RECORD_BYTES long)
+void telemetry_put_header(uint8_t *buf, const telemetry_header_t *h);
+void telemetry_put_record(uint8_t *buf, const telemetry_record_t *r);
+
+// False unless buf holds exactly one well-formed datagram
+bool telemetry_get_header(const uint8_t *buf, size_t len, telemetry_header_t *h);
+// Record i of a datagram telemetry_get_header() accepted
+void telemetry_get_record(const uint8_t *buf, int i, telemetry_record_t *r);
+
+#endif // TELEMETRY_FRAME_H
@@ -0,0 +1,138 @@
+#include "bench_api.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "rt.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    json_reader_t reader;
+    int64_t *field;         // value of the key being read, NULL = unknown key
+    int64_t period_ms;
+    int64_t seconds;
+} parse_t;
+
+static bool on_token(void *ctx, const json_tok_t *tok) {
+    parse_t *p = ctx;
+    if (tok->depth == 0) {
+        return tok->type == JSON_TOK_OBJ_BEGIN || tok->type == JSON_TOK_OBJ_END;
+    }
+    if (tok->depth > 1) {
+        return true;
+    }
+    if (tok->type == JSON_TOK_KEY) {
+        p->field = strcmp(tok->str, "period_ms") == 0 ? &p->period_ms
+                 : strcmp(tok->str, "seconds") == 0 ? &p->seconds : NULL;
+        return true;
+    }
+    if (p->field == NULL) {
+        return true;
+    }
+    if (tok->type != JSON_TOK_INT) {
+        json_reader_fail(&p->reader, "period_ms and seconds must be integers");
+        return false;
+    }
+    *p->field = tok->num;
+    return true;
+}
+
+static esp_err_t api_bench_post_handler(httpd_req_t *req)
+{
+    parse_t p = { .period_ms = RT_BENCH_PERIOD_MS, .seconds = RT_BENCH_SECONDS };
+    if (req->content_len > BENCH_API_BODY_MAX) {
+        httpd_resp_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "body too large");
+        return ESP_FAIL;
+    }
+    if (req->content_len > 0) {
+        char body[BENCH_API_BODY_MAX];
+        size_t got = 0;
+        while (got < req->content_len) {
+            int ret = httpd_req_recv(req, body + got, req->content_len - got);
+            if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+                httpd_resp_send_408(req);
+                return ESP_FAIL;
+            }
+            if (ret <= 0) {
+                return ESP_FAIL;   // client went away
+            }
+            got += (size_t)ret;
+        }
+        json_reader_init(&p.reader, on_token, &p);
+        if (!json_reader_feed(&p.reader, body, got) || !json_reader_finish(&p.reader)) {
+            char msg[80];
+            snprintf(msg, sizeof(msg), "%s (byte %u)",
+                     p.reader.error ? p.reader.error : "expected an object", (unsigned)p.reader.offset);
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+            return ESP_FAIL;
+        }
+    }
+    if (p.period_ms < 1 || p.seconds < 1 || p.seconds > RT_BENCH_MAX_SECONDS ||
+        p.period_ms > p.seconds * 1000) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Need 1 <= seconds <= 600 and 1 <= period_ms <= the run");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    if (!rt_bench_start((uint32_t)p.period_ms, (uint32_t)p.seconds)) {
+        httpd_resp_set_status(req, "409 Conflict");
+        return httpd_resp_sendstr(req, "{\"status\":\"running\"}");
+    }
+    return httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
+}
+
+static esp_err_t api_bench_get_handler(httpd_req_t *req)
+{
+    rt_bench_result_t r;
+    rt_bench_get(&r);
+
+    char body[512];
+    json_writer_t w;
+    json_writer_init(&w, body, sizeof(body));
+    json_obj_begin(&w);
+    json_kv_bool(&w, "running", r.running);
+    json_kv_bool(&w, "deterministic", rt_deterministic());
+    json_kv_uint(&w, "period_ms", r.period_ms);
+    json_kv_uint(&w, "cycles", r.cycles);
+    json_kv_uint(&w, "missed", r.missed);
+    json_key(&w, "period_us");
+    json_obj_begin(&w);
+    json_kv_uint(&w, "min", r.period_min_us);
+    json_kv_uint(&w, "avg", r.period_avg_us);
+    json_kv_uint(&w, "max", r.period_max_us);
+    json_obj_end(&w);
+    json_key(&w, "jitter_us");
+    json_obj_begin(&w);
+    json_kv_uint(&w, "avg", r.jitter_avg_us);
+    json_kv_uint(&w, "p50", r.jitter_p50_us);
+    json_kv_uint(&w, "p99", r.jitter_p99_us);
+    json_kv_uint(&w, "p999", r.jitter_p999_us);
+    json_kv_uint(&w, "max", r.jitter_max_us);
+    json_obj_end(&w);
+    json_obj_end(&w);
+    size_t len = json_writer_finish(&w);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    return httpd_resp_send(req, body, (ssize_t)len);
+}
+
+esp_err_t bench_api_register(httpd_handle_t server)
+{
+    // Both are quick: served on the httpd task
+    httpd_uri_t get_uri = {
+        .uri = "/api/bench",
+        .method = HTTP_GET,
+        .handler = api_bench_get_handler
+    };
+    httpd_uri_t post_uri = {
+        .uri = "/api/bench",
+        .method = HTTP_POST,
+        .handler = api_bench_post_handler
+    };
+    esp_err_t err = httpd_register_uri_handler(server, &get_uri);
+    if (err == ESP_OK) {
+        err = httpd_register_uri_handler(server, &post_uri);
+    }
+    return err;
+}
@@ -0,0 +1,15 @@
+#ifndef BENCH_API_H
+#define BENCH_API_H
+
+#include "esp_http_server.h"
+
+// Control-loop benchmark (components/rt) over HTTP:
+//   POST /api/bench   start it; optional body {"period_ms":10,"seconds":30}
+//   GET  /api/bench   progress, then the result: cycle period and how long
+//                     after each tick's deadline its relays were written
+// Run it while tools/loadgen.py hammers the dashboard (loadgen --bench).
+#define BENCH_API_BODY_MAX  128
+
+esp_err_t bench_api_register(httpd_handle_t server);
+
+#endif // BENCH_API_H
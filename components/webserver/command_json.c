@@ -0,0 +1,293 @@
+#include "command_json.h"
+#include "json_reader.h"
+#include "sensors.h"
+#include "dosing.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef enum {
+    F_TYPE,
+    F_PUMP,
+    F_ZONE,
+    F_STATE,
+    F_ENABLED,
+    F_THRESHOLD,
+    F_PUMP_DURATION,
+    F_FERT_DURATION,
+    F_INTERVAL,
+    F_VOLUME,
+    F_FERT_VOLUME,
+    F_FERT_RATIO,
+    F_COUNT
+} field_t;
+
+static const char *const field_names[F_COUNT] = {
+    [F_TYPE] = "type",
+    [F_PUMP] = "pump",
+    [F_ZONE] = "zone",
+    [F_STATE] = "state",
+    [F_ENABLED] = "enabled",
+    [F_THRESHOLD] = "threshold",
+    [F_PUMP_DURATION] = "pump_duration",
+    [F_FERT_DURATION] = "fert_duration",
+    [F_INTERVAL] = "interval",
+    [F_VOLUME] = "volume",
+    [F_FERT_VOLUME] = "fert_volume",
+    [F_FERT_RATIO] = "fert_ratio",
+};
+
+// "type" values, in command_json_kind_t order
+static const char *const type_names[] = { "pump", "auto", "settings" };
+
+#define HAS(p, f) (((p)->seen >> (f)) & 1)
+
+typedef struct {
+    json_reader_t reader;
+    command_json_kind_t kind;
+    int cmd_depth;          // depth of the command objects
+    system_command_t *out;
+    int max;
+    int n;
+    int field;              // key being read, -1 = unknown (value skipped)
+    uint16_t seen;          // F_* bits of the current object
+    int32_t v[F_COUNT];
+    char error[48];
+} parse_t;
+
+static bool reject(parse_t *p, const char *error) {
+    json_reader_fail(&p->reader, error);
+    return false;
+}
+
+static bool reject_field(parse_t *p) {
+    snprintf(p->error, sizeof(p->error), "bad value for %s", field_names[p->field]);
+    return reject(p, p->error);
+}
+
+static bool set_field(parse_t *p, const json_tok_t *tok) {
+    int32_t v;
+    if (p->field == F_TYPE) {
+        v = -1;
+        for (int i = 0; i < (int)(sizeof(type_names) / sizeof(type_names[0])); i++) {
+            if (tok->type == JSON_TOK_STR && strcmp(tok->str, type_names[i]) == 0) {
+                v = i;
+            }
+        }
+        if (v < 0) {
+            return reject(p, "type must be pump, auto or settings");
+        }
+    } else if (tok->type == JSON_TOK_INT && tok->num >= INT32_MIN && tok->num <= INT32_MAX) {
+        v = (int32_t)tok->num;
+    } else if (tok->type == JSON_TOK_BOOL) {
+        v = tok->boolean;
+    } else {
+        return reject_field(p);
+    }
+    p->v[p->field] = v;
+    p->seen |= 1U << p->field;
+    return true;
+}
+
+// Same checks and messages the single-command endpoints always had
+static const char *to_command(const parse_t *p, command_json_kind_t kind, system_command_t *cmd) {
+    switch (kind) {
+    case COMMAND_JSON_PUMP:
+        if ((!HAS(p, F_PUMP) && !HAS(p, F_ZONE)) || !HAS(p, F_STATE)) {
+            return "pump or zone, and state required";
+        }
+        if (HAS(p, F_ZONE)) {
+            if (p->v[F_ZONE] < 1 || p->v[F_ZONE] > zone_count()) {
+                return "unknown zone";
+            }
+            *cmd = (system_command_t){
+                .type = SYSTEM_CMD_SET_ZONE,
+                .zone = { .zone = (uint8_t)(p->v[F_ZONE] - 1), .on = p->v[F_STATE] != 0 },
+            };
+        } else if (p->v[F_PUMP] == 1 || p->v[F_PUMP] == 2) {
+            *cmd = (system_command_t){
+                .type = SYSTEM_CMD_SET_PUMP,
+                .pump = { .pump = (uint8_t)p->v[F_PUMP], .on = p->v[F_STATE] != 0 },
+            };
+        } else {
+            return "pump must be 1 or 2";
+        }
+        return NULL;
+    case COMMAND_JSON_AUTO:
+        if (!HAS(p, F_ENABLED)) {
+            return "enabled required";
+        }
+        *cmd = (system_command_t){
+            .type = SYSTEM_CMD_SET_AUTO,
+            .automode = { .enabled = p->v[F_ENABLED] != 0 },
+        };
+        return NULL;
+    case COMMAND_JSON_SETTINGS:
+        if (!HAS(p, F_THRESHOLD) || !HAS(p, F_PUMP_DURATION) || !HAS(p, F_FERT_DURATION) ||
+            !HAS(p, F_INTERVAL)) {
+            return "threshold, pump_duration, fert_duration and interval required";
+        }
+        if (HAS(p, F_ZONE) && (p->v[F_ZONE] < 1 || p->v[F_ZONE] > zone_count())) {
+            return "unknown zone";
+        }
+        // Same bounds as the saved settings (storage.c), so NVS keeps what the API took
+        if (p->v[F_THRESHOLD] < 0 || p->v[F_THRESHOLD] > SYSTEM_THRESHOLD_MAX) {
+            return "threshold must be 0 to 4095";
+        }
+        if (p->v[F_PUMP_DURATION] <= 0 || p->v[F_FERT_DURATION] <= 0 || p->v[F_INTERVAL] <= 0) {
+            return "durations and interval must be over 0 ms";
+        }
+        // Volumes are optional: ml, 0 = by time, left as they are if absent
+        if ((HAS(p, F_VOLUME) && p->v[F_VOLUME] < 0) || (HAS(p, F_FERT_VOLUME) && p->v[F_FERT_VOLUME] < 0)) {
+            return "volume and fert_volume must be 0 or more ml";
+        }
+        if (HAS(p, F_FERT_RATIO) && (p->v[F_FERT_RATIO] < 0 || p->v[F_FERT_RATIO] > DOSING_RATIO_MAX)) {
+            return "fert_ratio must be 0 to 1000 ml per litre";
+        }
+        *cmd = (system_command_t){
+            .type = SYSTEM_CMD_SET_SETTINGS,
+            .settings = {
+                .zone = HAS(p, F_ZONE) ? p->v[F_ZONE] - 1 : -1,
+                .threshold = p->v[F_THRESHOLD],
+                .pump_duration_ms = p->v[F_PUMP_DURATION],
+                .fert_duration_ms = p->v[F_FERT_DURATION],
+                .interval_ms = p->v[F_INTERVAL],
+                .volume_ml = HAS(p, F_VOLUME) ? p->v[F_VOLUME] : -1,
+                .fert_volume_ml = HAS(p, F_FERT_VOLUME) ? p->v[F_FERT_VOLUME] : -1,
+                .fert_ratio_ml_l = HAS(p, F_FERT_RATIO) ? p->v[F_FERT_RATIO] : -1,
+            },
+        };
+        return NULL;
+    default:
+        return "type required";
+    }
+}
+
+static bool end_command(parse_t *p) {
+    if (p->n >= p->max) {
+        return reject(p, "too many commands");
+    }
+    command_json_kind_t kind = p->kind;
+    if (kind == COMMAND_JSON_BATCH) {
+        kind = HAS(p, F_TYPE) ? (command_json_kind_t)p->v[F_TYPE] : COMMAND_JSON_BATCH;
+    }
+    const char *error = to_command(p, kind, &p->out[p->n]);
+    if (error != NULL) {
+        return reject(p, error);
+    }
+    p->n++;
+    return true;
+}
+
+static bool on_token(void *ctx, const json_tok_t *tok) {
+    parse_t *p = ctx;
+    if (tok->depth < p->cmd_depth) {
+        // The batch array itself
+        return tok->type == JSON_TOK_ARR_BEGIN || tok->type == JSON_TOK_ARR_END ||
+               reject(p, "expected an array of commands");
+    }
+    if (tok->depth == p->cmd_depth) {
+        if (tok->type == JSON_TOK_OBJ_BEGIN) {
+            p->seen = 0;
+            p->field = -1;
+            return true;
+        }
+        if (tok->type == JSON_TOK_OBJ_END) {
+            return end_command(p);
+        }
+        return reject(p, p->cmd_depth ? "commands must be objects" : "expected an object");
+    }
+    if (tok->depth > p->cmd_depth + 1) {
+        return true;    // inside the value of an unknown key
+    }
+    if (tok->type == JSON_TOK_KEY) {
+        p->field = -1;
+        for (int f = 0; f < F_COUNT; f++) {
+            if (strcmp(tok->str, field_names[f]) == 0) {
+                p->field = f;
+            }
+        }
+        // "type" only means something in a batch
+        if (p->field == F_TYPE && p->kind != COMMAND_JSON_BATCH) {
+            p->field = -1;
+        }
+        return true;
+    }
+    return p->field < 0 || set_field(p, tok);
+}
+
+static void parse_begin(parse_t *p, command_json_kind_t kind, system_command_t *out, int max) {
+    *p = (parse_t){
+        .kind = kind,
+        .cmd_depth = kind == COMMAND_JSON_BATCH ? 1 : 0,
+        .out = out,
+        .max = kind == COMMAND_JSON_BATCH ? max : 1,
+        .field = -1,
+    };
+    json_reader_init(&p->reader, on_token, p);
+}
+
+// Number of commands, or 0 with the message for a 400
+static int parse_end(parse_t *p, char *error, size_t error_len) {
+    if (!json_reader_finish(&p->reader) || p->n == 0) {
+        if (p->reader.error) {
+            snprintf(error, error_len, "%s (byte %u)", p->reader.error, (unsigned)p->reader.offset);
+        } else {
+            snprintf(error, error_len, "no commands");
+        }
+        return 0;
+    }
+    return p->n;
+}
+
+int command_json_parse(const char *body, size_t len, command_json_kind_t kind, system_command_t *out,
+                       int max, char *error, size_t error_len) {
+    parse_t p;
+    parse_begin(&p, kind, out, max);
+    for (size_t off = 0; off < len; off += COMMAND_JSON_RECV_CHUNK) {
+        size_t n = len - off < COMMAND_JSON_RECV_CHUNK ? len - off : COMMAND_JSON_RECV_CHUNK;
+        if (!json_reader_feed(&p.reader, body + off, n)) {
+            break;
+        }
+    }
+    return parse_end(&p, error, error_len);
+}
+
+int command_json_read(httpd_req_t *req, command_json_kind_t kind, system_command_t *out, int max)
+{
+    if (req->content_len == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "empty body");
+        return 0;
+    }
+    if (req->content_len > COMMAND_JSON_BODY_MAX) {
+        httpd_resp_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "body too large");
+        return 0;
+    }
+
+    parse_t p;
+    parse_begin(&p, kind, out, max);
+
+    // Parse as it arrives: a body split over several segments is read whole
+    char buf[COMMAND_JSON_RECV_CHUNK];
+    size_t left = req->content_len;
+    while (left > 0) {
+        int ret = httpd_req_recv(req, buf, left < sizeof(buf) ? left : sizeof(buf));
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+            httpd_resp_send_408(req);
+            return 0;
+        }
+        if (ret <= 0) {
+            return 0;   // client went away
+        }
+        left -= (size_t)ret;
+        if (!json_reader_feed(&p.reader, buf, (size_t)ret)) {
+            break;
+        }
+    }
+
+    char msg[96];
+    int n = parse_end(&p, msg, sizeof(msg));
+    if (n == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+    }
+    return n;
+}
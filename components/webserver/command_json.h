@@ -0,0 +1,39 @@
+#ifndef COMMAND_JSON_H
+#define COMMAND_JSON_H
+
+#include "esp_http_server.h"
+#include "system_state.h"
+
+// Request bodies -> control commands, parsed while they are received
+// (json_reader, fixed memory). Every command is checked before any is
+// returned, so a bad field rejects the whole body.
+//
+// Command objects, keys in any order:
+//   pump:     {"pump":1|2,"state":b} or {"zone":1..N,"state":b}
+//   auto:     {"enabled":b}
+//   settings: {"threshold":n,"pump_duration":ms,"fert_duration":ms,"interval":ms[,"zone":1..N]}
+// A batch is an array of these, each with "type":"pump"|"auto"|"settings".
+// Booleans may also be given as numbers (0 = false).
+#define COMMAND_JSON_BODY_MAX   4096    // longer bodies get 413 unread
+#define COMMAND_JSON_BATCH_MAX  16      // commands per batch
+#define COMMAND_JSON_RECV_CHUNK 128     // bytes received per httpd_req_recv
+
+_Static_assert(COMMAND_JSON_BATCH_MAX <= SYSTEM_CMD_QUEUE_LEN, "a batch must fit the mailbox");
+
+typedef enum {
+    COMMAND_JSON_PUMP,
+    COMMAND_JSON_AUTO,
+    COMMAND_JSON_SETTINGS,
+    COMMAND_JSON_BATCH,     // array of typed commands
+} command_json_kind_t;
+
+// Read and parse the request body into out[0..max). Returns the number of
+// commands, or 0 after answering the request with an error (400, 408, 413).
+int command_json_read(httpd_req_t *req, command_json_kind_t kind, system_command_t *out, int max);
+// The same parser over a body already in memory, fed in COMMAND_JSON_RECV_CHUNK
+// pieces like a received one. Returns the number of commands, or 0 with the
+// 400 message in error.
+int command_json_parse(const char *body, size_t len, command_json_kind_t kind, system_command_t *out,
+                       int max, char *error, size_t error_len);
+
+#endif // COMMAND_JSON_H
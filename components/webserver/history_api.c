@@ -0,0 +1,140 @@
+#include "history_api.h"
+#include "http_workers.h"
+#include "history.h"
+#include "json_writer.h"
+#include <stdlib.h>
+
+// Query parameter as seconds since boot; negative counts back from now
+static bool query_time(const char *qry, const char *key, uint32_t now, uint32_t *out) {
+    char val[16];
+    if (qry == NULL || httpd_query_key_value(qry, key, val, sizeof(val)) != ESP_OK) {
+        return false;
+    }
+    char *end;
+    long v = strtol(val, &end, 10);
+    if (end == val) {
+        return false;
+    }
+    if (v < 0) {
+        *out = (uint32_t)-v >= now ? 0 : now - (uint32_t)-v;
+    } else {
+        *out = (uint32_t)v > now ? now : (uint32_t)v;
+    }
+    return true;
+}
+
+static bool send_chunk(void *ctx, const char *buf, size_t len) {
+    return httpd_resp_send_chunk(ctx, buf, (ssize_t)len) == ESP_OK;
+}
+
+typedef enum { COL_SOIL_MIN, COL_SOIL_MAX, COL_SOIL_AVG, COL_PUMP1, COL_PUMP2, COL_WATER, COL_FERT } column_t;
+
+static void write_column(json_writer_t *w, const char *key, column_t col,
+                         const history_bucket_t *buckets, int n) {
+    json_key(w, key);
+    json_arr_begin(w);
+    for (int i = 0; i < n; i++) {
+        const history_bucket_t *b = &buckets[i];
+        switch (col) {
+        case COL_SOIL_MIN:
+        case COL_SOIL_MAX:
+        case COL_SOIL_AVG:
+            if (!b->has_soil) {
+                json_null(w);
+            } else {
+                json_uint(w, col == COL_SOIL_MIN ? b->soil_min :
+                             col == COL_SOIL_MAX ? b->soil_max : b->soil_avg);
+            }
+            break;
+        case COL_PUMP1:
+            json_uint(w, b->pump1_on_s);
+            break;
+        case COL_PUMP2:
+            json_uint(w, b->pump2_on_s);
+            break;
+        case COL_WATER:
+        case COL_FERT: {
+            int8_t v = col == COL_WATER ? b->water_full : b->fert_full;
+            if (v < 0) {
+                json_null(w);
+            } else {
+                json_uint(w, (uint64_t)v);
+            }
+            break;
+        }
+        }
+    }
+    json_arr_end(w);
+}
+
+static esp_err_t api_history_handler(httpd_req_t *req)
+{
+    uint32_t now = history_now_s();
+    history_stats_t stats;
+    history_get_stats(&stats);
+
+    char qry[64];
+    const char *q = httpd_req_get_url_query_str(req, qry, sizeof(qry)) == ESP_OK ? qry : NULL;
+    uint32_t from = stats.oldest_s, to = now;
+    query_time(q, "from", now, &from);
+    query_time(q, "to", now, &to);
+    int points = HISTORY_API_DEFAULT_POINTS;
+    char val[8];
+    if (q && httpd_query_key_value(q, "points", val, sizeof(val)) == ESP_OK) {
+        points = atoi(val);
+    }
+    if (points < 1 || points > HISTORY_MAX_POINTS || from >= to) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Need from < to and 1 <= points <= 120");
+        return ESP_FAIL;
+    }
+
+    // On the worker's stack: requests can run on several workers at once
+    history_bucket_t buckets[HISTORY_MAX_POINTS];
+    uint32_t step = 0;
+    int n = history_query(from, to, points, buckets, &step);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char chunk[HISTORY_API_CHUNK];
+    json_writer_t w;
+    json_writer_init(&w, chunk, sizeof(chunk));
+    json_writer_set_flush(&w, send_chunk, req);
+
+    json_obj_begin(&w);
+    json_kv_uint(&w, "now", now);
+    json_kv_uint(&w, "from", from);
+    json_kv_uint(&w, "step", step);
+    json_kv_uint(&w, "records", stats.records);
+    json_kv_uint(&w, "bytes", stats.bytes_used);
+    json_key(&w, "t");
+    json_arr_begin(&w);
+    for (int i = 0; i < n; i++) {
+        json_uint(&w, buckets[i].t);
+    }
+    json_arr_end(&w);
+    write_column(&w, "soil_min", COL_SOIL_MIN, buckets, n);
+    write_column(&w, "soil_max", COL_SOIL_MAX, buckets, n);
+    write_column(&w, "soil_avg", COL_SOIL_AVG, buckets, n);
+    write_column(&w, "pump1_s", COL_PUMP1, buckets, n);
+    write_column(&w, "pump2_s", COL_PUMP2, buckets, n);
+    write_column(&w, "water_full", COL_WATER, buckets, n);
+    write_column(&w, "fert_full", COL_FERT, buckets, n);
+    json_obj_end(&w);
+
+    if (json_writer_finish(&w) == 0) {
+        return ESP_FAIL;   // client went away mid-response
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+esp_err_t history_api_register(httpd_handle_t server)
+{
+    httpd_uri_t history_uri = {
+        .uri = "/api/history",
+        .method = HTTP_GET,
+        .handler = api_history_handler
+    };
+    return http_workers_register(server, &history_uri);
+}
@@ -0,0 +1,16 @@
+#ifndef HISTORY_API_H
+#define HISTORY_API_H
+
+#include "esp_http_server.h"
+
+// Downsampled trends at GET /api/history?from=&to=&points=
+//
+// from/to are seconds since boot; negative values count back from now
+// (from=-86400 is the last day). Defaults: everything held, 60 points.
+// Each column has one entry per bucket, so the browser never pulls raw samples.
+#define HISTORY_API_DEFAULT_POINTS 60
+#define HISTORY_API_CHUNK          256     // response is streamed in chunks this size
+
+esp_err_t history_api_register(httpd_handle_t server);
+
+#endif // HISTORY_API_H
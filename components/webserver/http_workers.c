@@ -0,0 +1,212 @@
+#include "http_workers.h"
+#include "metrics.h"
+#include "rt.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/sockets.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "HTTP_WORKERS";
+
+// Registered handler and its own user_ctx; the queued request carries a
+// pointer to this, the worker puts the handler's user_ctx back
+typedef struct {
+    esp_err_t (*handler)(httpd_req_t *req);
+    void *user_ctx;
+} worker_handler_t;
+
+typedef struct {
+    httpd_req_t *req;       // NULL = free slot
+    uint32_t client;        // IPv4 address of the peer, 0 if unknown
+    uint32_t seq;           // queue order
+    int64_t queued_us;
+} pending_t;
+
+typedef struct {
+    uint32_t client;
+    uint32_t served;        // serve_clock when it was last picked
+} client_t;
+
+static worker_handler_t handlers[HTTP_WORKER_HANDLERS];
+static int handler_count = 0;
+
+// Guarded by lock; `ready` counts the requests waiting
+static SemaphoreHandle_t lock = NULL;
+static SemaphoreHandle_t ready = NULL;
+static StaticSemaphore_t lock_buf;
+static StaticSemaphore_t ready_buf;
+static pending_t pending[HTTP_WORKER_QUEUE];
+static client_t clients[HTTP_WORKER_CLIENTS];
+static uint32_t queue_seq = 0;
+static uint32_t serve_clock = 0;
+
+static uint32_t peer_of(httpd_req_t *req) {
+    struct sockaddr_storage addr;
+    socklen_t len = sizeof(addr);
+    if (getpeername(httpd_req_to_sockfd(req), (struct sockaddr *)&addr, &len) != 0) {
+        return 0;
+    }
+    uint32_t ip = 0;
+    if (addr.ss_family == AF_INET) {
+        ip = ((struct sockaddr_in *)&addr)->sin_addr.s_addr;
+    } else if (addr.ss_family == AF_INET6) {
+        // IPv4-mapped on a dual-stack socket: the address is the last 4 bytes
+        memcpy(&ip, &((struct sockaddr_in6 *)&addr)->sin6_addr.s6_addr[12], sizeof(ip));
+    }
+    return ip;
+}
+
+static client_t *client_find(uint32_t ip) {
+    for (int i = 0; i < HTTP_WORKER_CLIENTS; i++) {
+        if (clients[i].served != 0 && clients[i].client == ip) {
+            return &clients[i];
+        }
+    }
+    return NULL;
+}
+
+// Call with lock held
+static uint32_t last_served(uint32_t ip) {
+    client_t *c = client_find(ip);
+    return c ? c->served : 0;
+}
+
+// Call with lock held. A new client replaces the one served longest ago.
+static void note_served(uint32_t ip) {
+    client_t *c = client_find(ip);
+    if (c == NULL) {
+        c = &clients[0];
+        for (int i = 1; i < HTTP_WORKER_CLIENTS; i++) {
+            if (clients[i].served < c->served) {
+                c = &clients[i];
+            }
+        }
+        c->client = ip;
+    }
+    c->served = ++serve_clock;
+}
+
+// Call with lock held: the request of the least recently served client,
+// oldest first
+static pending_t take_next(void) {
+    pending_t *best = NULL;
+    uint32_t best_served = 0;
+    for (int i = 0; i < HTTP_WORKER_QUEUE; i++) {
+        pending_t *p = &pending[i];
+        if (p->req == NULL) {
+            continue;
+        }
+        uint32_t served = last_served(p->client);
+        if (best == NULL || served < best_served ||
+            (served == best_served && (int32_t)(p->seq - best->seq) < 0)) {
+            best = p;
+            best_served = served;
+        }
+    }
+    pending_t job = *best;
+    best->req = NULL;
+    note_served(job.client);
+    return job;
+}
+
+static void worker_task(void *pvParameters) {
+    for (;;) {
+        xSemaphoreTake(ready, portMAX_DELAY);
+        xSemaphoreTake(lock, portMAX_DELAY);
+        pending_t job = take_next();
+        xSemaphoreGive(lock);
+        metrics_observe(METRIC_HTTP_QUEUE, (uint32_t)(esp_timer_get_time() - job.queued_us));
+
+        httpd_req_t *req = job.req;
+        const worker_handler_t *h = req->user_ctx;
+        req->user_ctx = h->user_ctx;
+        if (h->handler(req) != ESP_OK) {
+            // As on the httpd task: a failed handler closes the session
+            httpd_sess_trigger_close(req->handle, httpd_req_to_sockfd(req));
+        }
+        httpd_req_async_handler_complete(req);
+        metrics_boot_mark(METRIC_BOOT_HTTP);
+    }
+}
+
+// Runs on the httpd task, the only one that adds requests: a slot found
+// free stays free until it is filled below
+static esp_err_t queue_handler(httpd_req_t *req)
+{
+    int slot = -1;
+    xSemaphoreTake(lock, portMAX_DELAY);
+    for (int i = 0; i < HTTP_WORKER_QUEUE && slot < 0; i++) {
+        if (pending[i].req == NULL) {
+            slot = i;
+        }
+    }
+    xSemaphoreGive(lock);
+
+    if (slot < 0) {
+        metrics_count(METRIC_HTTP_SHED);
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_type(req, "application/json");
+        httpd_resp_set_hdr(req, "Retry-After", HTTP_WORKER_RETRY_S);
+        return httpd_resp_sendstr(req, "{\"status\":\"busy\"}");
+    }
+
+    uint32_t client = peer_of(req);
+    httpd_req_t *copy = NULL;
+    esp_err_t err = httpd_req_async_handler_begin(req, &copy);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "⚠️ Could not hand request to a worker: %s", esp_err_to_name(err));
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    xSemaphoreTake(lock, portMAX_DELAY);
+    pending[slot] = (pending_t){
+        .req = copy,
+        .client = client,
+        .seq = queue_seq++,
+        .queued_us = esp_timer_get_time(),
+    };
+    xSemaphoreGive(lock);
+    xSemaphoreGive(ready);
+    return ESP_OK;
+}
+
+esp_err_t http_workers_start(void)
+{
+    lock = xSemaphoreCreateMutexStatic(&lock_buf);
+    ready = xSemaphoreCreateCountingStatic(HTTP_WORKER_QUEUE, 0, &ready_buf);
+    if (lock == NULL || ready == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (int i = 0; i < HTTP_WORKERS; i++) {
+        char name[16];
+        snprintf(name, sizeof(name), "http_w%d", i);
+        TaskHandle_t task = NULL;
+        if (rt_task_create(worker_task, name, NULL, RT_TASK_HTTP_WORKER, &task) != pdPASS) {
+            ESP_LOGE(TAG, "❌ Failed to create %s", name);
+            return ESP_FAIL;
+        }
+        metrics_watch_task(task);
+    }
+    ESP_LOGI(TAG, "✅ %d HTTP workers, queue of %d", HTTP_WORKERS, HTTP_WORKER_QUEUE);
+    return ESP_OK;
+}
+
+esp_err_t http_workers_register(httpd_handle_t server, const httpd_uri_t *uri)
+{
+    if (handler_count >= HTTP_WORKER_HANDLERS) {
+        return ESP_ERR_NO_MEM;
+    }
+    worker_handler_t *h = &handlers[handler_count++];
+    h->handler = uri->handler;
+    h->user_ctx = uri->user_ctx;
+
+    httpd_uri_t queued = *uri;
+    queued.handler = queue_handler;
+    queued.user_ctx = h;
+    return httpd_register_uri_handler(server, &queued);
+}
@@ -0,0 +1,28 @@
+#ifndef HTTP_WORKERS_H
+#define HTTP_WORKERS_H
+
+#include "esp_http_server.h"
+#include "rt.h"
+
+// Pool of worker tasks for the slow handlers (dashboard page, history,
+// event log, metrics, OTA upload, schedule edits), so one long response does
+// not hold up /api/data polls and commands, which stay on the httpd task.
+//
+// The httpd task only queues the request (httpd_req_async_handler_begin)
+// and goes back to its sockets. A free worker takes the queued request of
+// the client it served least recently, oldest first, so one busy browser
+// cannot starve the others. With the queue full the request is answered
+// 503 with Retry-After straight away.
+#define HTTP_WORKERS            RT_HTTP_WORKERS     // stacks: RT_STACK_HTTP_WORKER
+#define HTTP_WORKER_QUEUE       8       // requests waiting for a worker
+#define HTTP_WORKER_CLIENTS     8       // clients remembered for fairness
+#define HTTP_WORKER_HANDLERS    8
+#define HTTP_WORKER_RETRY_S     "1"     // Retry-After on a full queue
+
+// Create the workers (once, before the first http_workers_register)
+esp_err_t http_workers_start(void);
+
+// Register uri on the server, with its handler running on a worker
+esp_err_t http_workers_register(httpd_handle_t server, const httpd_uri_t *uri);
+
+#endif // HTTP_WORKERS_H
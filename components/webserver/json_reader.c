@@ -0,0 +1,314 @@
+#include "json_reader.h"
+#include <string.h>
+
+// What the grammar allows next
+enum { ST_VALUE, ST_ARR_FIRST, ST_OBJ_FIRST, ST_KEY, ST_COLON, ST_NEXT, ST_DONE };
+// Token being scanned
+enum { LEX_NONE, LEX_STR, LEX_KEY, LEX_NUM, LEX_LIT };
+
+#define NUM_DIGITS_MAX 18   // always fits an int64_t
+
+void json_reader_fail(json_reader_t *r, const char *error) {
+    if (r->error == NULL) {
+        r->error = error;
+    }
+}
+
+static bool fail(json_reader_t *r, const char *error) {
+    json_reader_fail(r, error);
+    return false;
+}
+
+static bool emit(json_reader_t *r, json_tok_type_t type) {
+    json_tok_t tok = {
+        .type = type,
+        .depth = r->depth,
+        .str = r->tok,
+        .num = r->negative ? -r->num : r->num,
+        .boolean = r->tok[0] == 't',
+    };
+    if (!r->fn(r->ctx, &tok)) {
+        return fail(r, "rejected");
+    }
+    return true;
+}
+
+static void value_done(json_reader_t *r) {
+    r->state = r->depth == 0 ? ST_DONE : ST_NEXT;
+}
+
+static bool top_is_object(const json_reader_t *r) {
+    return r->depth > 0 && (r->containers >> (r->depth - 1)) & 1;
+}
+
+static bool open_container(json_reader_t *r, bool object) {
+    if (r->depth >= JSON_READER_MAX_DEPTH) {
+        return fail(r, "nested too deeply");
+    }
+    if (!emit(r, object ? JSON_TOK_OBJ_BEGIN : JSON_TOK_ARR_BEGIN)) {
+        return false;
+    }
+    r->containers = (uint8_t)((r->containers & ~(1U << r->depth)) | ((unsigned)object << r->depth));
+    r->depth++;
+    r->state = object ? ST_OBJ_FIRST : ST_ARR_FIRST;
+    return true;
+}
+
+static bool close_container(json_reader_t *r, bool object) {
+    if (r->depth == 0 || top_is_object(r) != object) {
+        return fail(r, "mismatched bracket");
+    }
+    r->depth--;
+    if (!emit(r, object ? JSON_TOK_OBJ_END : JSON_TOK_ARR_END)) {
+        return false;
+    }
+    value_done(r);
+    return true;
+}
+
+static bool put(json_reader_t *r, char c) {
+    if (r->len >= JSON_READER_TOKEN_MAX - 1) {
+        return fail(r, "string too long");
+    }
+    r->tok[r->len++] = c;
+    return true;
+}
+
+static bool put_utf8(json_reader_t *r, unsigned cp) {
+    if (cp < 0x80) {
+        return put(r, (char)cp);
+    }
+    if (cp < 0x800) {
+        return put(r, (char)(0xc0 | (cp >> 6))) && put(r, (char)(0x80 | (cp & 0x3f)));
+    }
+    return put(r, (char)(0xe0 | (cp >> 12))) && put(r, (char)(0x80 | ((cp >> 6) & 0x3f))) &&
+           put(r, (char)(0x80 | (cp & 0x3f)));
+}
+
+static void start_token(json_reader_t *r, uint8_t lex) {
+    r->lex = lex;
+    r->lex_pos = 0;
+    r->len = 0;
+    r->num = 0;
+    r->negative = false;
+}
+
+// lex_pos: 0 plain, 1 after a backslash, 2..5 reading \uXXXX digits
+static bool string_char(json_reader_t *r, char c) {
+    if (r->lex_pos == 0) {
+        if (c == '"') {
+            bool key = r->lex == LEX_KEY;
+            r->tok[r->len] = '\0';
+            r->lex = LEX_NONE;
+            if (!emit(r, key ? JSON_TOK_KEY : JSON_TOK_STR)) {
+                return false;
+            }
+            if (key) {
+                r->state = ST_COLON;
+            } else {
+                value_done(r);
+            }
+            return true;
+        }
+        if (c == '\\') {
+            r->lex_pos = 1;
+            return true;
+        }
+        if ((unsigned char)c < 0x20) {
+            return fail(r, "control character in string");
+        }
+        return put(r, c);
+    }
+
+    if (r->lex_pos == 1) {
+        static const char from[] = "\"\\/bfnrt";
+        static const char to[] = "\"\\/\b\f\n\r\t";
+        if (c == 'u') {
+            r->lex_pos = 2;
+            r->num = 0;
+            return true;
+        }
+        const char *e = c ? strchr(from, c) : NULL;
+        if (e == NULL) {
+            return fail(r, "bad escape");
+        }
+        r->lex_pos = 0;
+        return put(r, to[e - from]);
+    }
+
+    int v = c >= '0' && c <= '9' ? c - '0' :
+            c >= 'a' && c <= 'f' ? c - 'a' + 10 :
+            c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+    if (v < 0) {
+        return fail(r, "bad \\u escape");
+    }
+    r->num = r->num * 16 + v;
+    if (++r->lex_pos == 6) {
+        r->lex_pos = 0;
+        return put_utf8(r, (unsigned)r->num);
+    }
+    return true;
+}
+
+static const char *literal_of(char first) {
+    return first == 't' ? "true" : first == 'f' ? "false" : "null";
+}
+
+static bool literal_char(json_reader_t *r, char c) {
+    const char *lit = literal_of(r->tok[0]);
+    if (c != lit[r->lex_pos]) {
+        return fail(r, "bad literal");
+    }
+    if (lit[++r->lex_pos] != '\0') {
+        return true;
+    }
+    r->lex = LEX_NONE;
+    if (!emit(r, r->tok[0] == 'n' ? JSON_TOK_NULL : JSON_TOK_BOOL)) {
+        return false;
+    }
+    value_done(r);
+    return true;
+}
+
+// c is the character after the number; the caller still handles it
+static bool end_number(json_reader_t *r, char c) {
+    if (c == '.' || c == 'e' || c == 'E') {
+        return fail(r, "numbers must be integers");
+    }
+    if (r->len == 0) {
+        return fail(r, "bad number");
+    }
+    r->lex = LEX_NONE;
+    if (!emit(r, JSON_TOK_INT)) {
+        return false;
+    }
+    value_done(r);
+    return true;
+}
+
+static bool begin_value(json_reader_t *r, char c) {
+    switch (c) {
+    case '{':
+        return open_container(r, true);
+    case '[':
+        return open_container(r, false);
+    case '"':
+        start_token(r, LEX_STR);
+        return true;
+    case 't':
+    case 'f':
+    case 'n':
+        start_token(r, LEX_LIT);
+        r->tok[0] = c;
+        r->lex_pos = 1;
+        return true;
+    default:
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            start_token(r, LEX_NUM);
+            r->negative = c == '-';
+            if (!r->negative) {
+                r->num = c - '0';
+                r->len = 1;
+            }
+            return true;
+        }
+        return fail(r, "unexpected character");
+    }
+}
+
+static bool structural(json_reader_t *r, char c) {
+    if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        return true;
+    }
+    switch (r->state) {
+    case ST_DONE:
+        return fail(r, "trailing characters");
+    case ST_COLON:
+        if (c != ':') {
+            return fail(r, "expected ':'");
+        }
+        r->state = ST_VALUE;
+        return true;
+    case ST_NEXT:
+        if (c == ',') {
+            r->state = top_is_object(r) ? ST_KEY : ST_VALUE;
+            return true;
+        }
+        if (c == '}' || c == ']') {
+            return close_container(r, c == '}');
+        }
+        return fail(r, "expected ',' or a closing bracket");
+    case ST_OBJ_FIRST:
+        if (c == '}') {
+            return close_container(r, true);
+        }
+        // fall through
+    case ST_KEY:
+        if (c != '"') {
+            return fail(r, "expected a key");
+        }
+        start_token(r, LEX_KEY);
+        return true;
+    case ST_ARR_FIRST:
+        if (c == ']') {
+            return close_container(r, false);
+        }
+        // fall through
+    default:
+        return begin_value(r, c);
+    }
+}
+
+static bool step(json_reader_t *r, char c) {
+    switch (r->lex) {
+    case LEX_STR:
+    case LEX_KEY:
+        return string_char(r, c);
+    case LEX_LIT:
+        return literal_char(r, c);
+    case LEX_NUM:
+        if (c >= '0' && c <= '9') {
+            if (r->len >= NUM_DIGITS_MAX) {
+                return fail(r, "number too large");
+            }
+            r->num = r->num * 10 + (c - '0');
+            r->len++;
+            return true;
+        }
+        if (!end_number(r, c)) {
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+    return structural(r, c);
+}
+
+void json_reader_init(json_reader_t *r, json_tok_fn_t fn, void *ctx) {
+    memset(r, 0, sizeof(*r));
+    r->fn = fn;
+    r->ctx = ctx;
+    r->state = ST_VALUE;
+    r->lex = LEX_NONE;
+}
+
+bool json_reader_feed(json_reader_t *r, const char *buf, size_t len) {
+    for (size_t i = 0; i < len && r->error == NULL; i++) {
+        if (!step(r, buf[i])) {
+            break;
+        }
+        r->offset++;
+    }
+    return r->error == NULL;
+}
+
+bool json_reader_finish(json_reader_t *r) {
+    if (r->error == NULL && r->lex == LEX_NUM) {
+        end_number(r, ' ');     // a bare number ends with the document
+    }
+    if (r->error == NULL && (r->lex != LEX_NONE || r->state != ST_DONE)) {
+        fail(r, "document ends early");
+    }
+    return r->error == NULL;
+}
@@ -0,0 +1,67 @@
+#ifndef JSON_READER_H
+#define JSON_READER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming JSON tokenizer with fixed memory. Feed it the document in pieces
+// of any size (e.g. straight from httpd_req_recv) and it calls back once per
+// token; no heap, no DOM, and a token may straddle two pieces. Numbers must
+// be integers. Keys and strings longer than JSON_READER_TOKEN_MAX - 1 bytes,
+// or nesting deeper than JSON_READER_MAX_DEPTH, are errors.
+#define JSON_READER_TOKEN_MAX   32
+#define JSON_READER_MAX_DEPTH   8
+
+typedef enum {
+    JSON_TOK_OBJ_BEGIN,
+    JSON_TOK_OBJ_END,
+    JSON_TOK_ARR_BEGIN,
+    JSON_TOK_ARR_END,
+    JSON_TOK_KEY,
+    JSON_TOK_STR,
+    JSON_TOK_INT,
+    JSON_TOK_BOOL,
+    JSON_TOK_NULL,
+} json_tok_type_t;
+
+typedef struct {
+    json_tok_type_t type;
+    int depth;              // 0 = the top-level value, 1 = its members, ...
+    const char *str;        // KEY / STR: unescaped, NUL-terminated, valid during the call
+    int64_t num;            // INT
+    bool boolean;           // BOOL
+} json_tok_t;
+
+// Return false to stop: the feed fails with the error the callback set
+// through json_reader_fail(), or "rejected"
+typedef bool (*json_tok_fn_t)(void *ctx, const json_tok_t *tok);
+
+typedef struct {
+    json_tok_fn_t fn;
+    void *ctx;
+    uint8_t state;
+    uint8_t lex;            // token being scanned
+    uint8_t lex_pos;        // escape / literal / \u digit progress
+    uint8_t depth;
+    uint8_t containers;     // bit per open container: 1 = object
+    bool negative;
+    size_t len;
+    int64_t num;
+    char tok[JSON_READER_TOKEN_MAX];
+    size_t offset;          // bytes consumed so far
+    const char *error;      // NULL while the document is fine
+} json_reader_t;
+
+_Static_assert(JSON_READER_MAX_DEPTH <= 8, "one bit per level in `containers`");
+
+void json_reader_init(json_reader_t *r, json_tok_fn_t fn, void *ctx);
+// False once the document is malformed or the callback stopped it
+bool json_reader_feed(json_reader_t *r, const char *buf, size_t len);
+// True if exactly one complete value was read (trailing whitespace allowed)
+bool json_reader_finish(json_reader_t *r);
+// For callbacks: reject the document with this message (kept by pointer:
+// it must outlive the reader)
+void json_reader_fail(json_reader_t *r, const char *error);
+
+#endif // JSON_READER_H
@@ -0,0 +1,174 @@
+#include "json_writer.h"
+#include <string.h>
+
+static void put(json_writer_t *w, const char *s, size_t n) {
+    if (!w->overflow && w->len + n >= w->cap && w->flush && w->len > 0) {
+        if (w->flush(w->flush_ctx, w->buf, w->len)) {
+            w->flushed += w->len;
+            w->len = 0;
+        } else {
+            w->overflow = true;
+        }
+    }
+    if (w->overflow || w->len + n >= w->cap) {   // keep room for the NUL
+        w->overflow = true;
+        return;
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static void put_char(json_writer_t *w, char c) {
+    put(w, &c, 1);
+}
+
+// Comma before every value except the first in a container or after a key
+static void begin_value(json_writer_t *w) {
+    if (w->need_comma) {
+        put_char(w, ',');
+    }
+    w->need_comma = true;
+}
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap) {
+    w->buf = buf;
+    w->cap = cap;
+    w->len = 0;
+    w->flushed = 0;
+    w->need_comma = false;
+    w->overflow = cap == 0;
+    w->flush = NULL;
+    w->flush_ctx = NULL;
+}
+
+void json_writer_set_flush(json_writer_t *w, json_flush_fn_t flush, void *ctx) {
+    w->flush = flush;
+    w->flush_ctx = ctx;
+}
+
+size_t json_writer_finish(json_writer_t *w) {
+    if (w->overflow) {
+        if (w->cap > 0) {
+            w->buf[0] = '\0';
+        }
+        return 0;
+    }
+    w->buf[w->len] = '\0';
+    if (w->flush) {
+        if (w->len > 0 && !w->flush(w->flush_ctx, w->buf, w->len)) {
+            return 0;
+        }
+        w->flushed += w->len;
+        w->len = 0;
+        return w->flushed;
+    }
+    return w->len;
+}
+
+void json_obj_begin(json_writer_t *w) {
+    begin_value(w);
+    put_char(w, '{');
+    w->need_comma = false;
+}
+
+void json_obj_end(json_writer_t *w) {
+    put_char(w, '}');
+    w->need_comma = true;
+}
+
+void json_arr_begin(json_writer_t *w) {
+    begin_value(w);
+    put_char(w, '[');
+    w->need_comma = false;
+}
+
+void json_arr_end(json_writer_t *w) {
+    put_char(w, ']');
+    w->need_comma = true;
+}
+
+static void put_escaped(json_writer_t *w, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    put_char(w, '"');
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            put(w, esc, 2);
+        } else if (c < 0x20) {
+            char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf] };
+            put(w, esc, 6);
+        } else {
+            put_char(w, (char)c);
+        }
+    }
+    put_char(w, '"');
+}
+
+void json_key(json_writer_t *w, const char *key) {
+    begin_value(w);
+    put_escaped(w, key);
+    put_char(w, ':');
+    w->need_comma = false;
+}
+
+void json_uint(json_writer_t *w, uint64_t v) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[sizeof(digits) - 1 - n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    begin_value(w);
+    put(w, digits + sizeof(digits) - n, (size_t)n);
+}
+
+void json_int(json_writer_t *w, int64_t v) {
+    if (v >= 0) {
+        json_uint(w, (uint64_t)v);
+        return;
+    }
+    begin_value(w);
+    put_char(w, '-');
+    w->need_comma = false;
+    json_uint(w, (uint64_t)0 - (uint64_t)v);
+}
+
+void json_bool(json_writer_t *w, bool v) {
+    begin_value(w);
+    if (v) {
+        put(w, "true", 4);
+    } else {
+        put(w, "false", 5);
+    }
+}
+
+void json_str(json_writer_t *w, const char *s) {
+    begin_value(w);
+    put_escaped(w, s ? s : "");
+}
+
+void json_null(json_writer_t *w) {
+    begin_value(w);
+    put(w, "null", 4);
+}
+
+void json_kv_int(json_writer_t *w, const char *key, int64_t v) {
+    json_key(w, key);
+    json_int(w, v);
+}
+
+void json_kv_uint(json_writer_t *w, const char *key, uint64_t v) {
+    json_key(w, key);
+    json_uint(w, v);
+}
+
+void json_kv_bool(json_writer_t *w, const char *key, bool v) {
+    json_key(w, key);
+    json_bool(w, v);
+}
+
+void json_kv_str(json_writer_t *w, const char *key, const char *s) {
+    json_key(w, key);
+    json_str(w, s);
+}
@@ -0,0 +1,53 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming JSON writer into a caller-owned buffer. No heap, no DOM: values
+// are appended in order and commas are inserted automatically. If the buffer
+// runs out the writer stops writing and json_writer_finish() returns 0.
+//
+// With a flush callback the buffer is a window instead: when it fills up its
+// contents are handed to the callback (e.g. one HTTP chunk) and reused, so
+// documents of any size stream through a small buffer.
+typedef bool (*json_flush_fn_t)(void *ctx, const char *buf, size_t len);
+
+typedef struct {
+    char *buf;
+    size_t cap;
+    size_t len;
+    size_t flushed;         // bytes already handed to the flush callback
+    bool need_comma;
+    bool overflow;
+    json_flush_fn_t flush;
+    void *flush_ctx;
+} json_writer_t;
+
+void json_writer_init(json_writer_t *w, char *buf, size_t cap);
+void json_writer_set_flush(json_writer_t *w, json_flush_fn_t flush, void *ctx);
+// NUL-terminates and returns the length, or 0 if the buffer was too small.
+// With a flush callback, flushes the tail and returns the total length
+// (0 if a flush failed).
+size_t json_writer_finish(json_writer_t *w);
+
+void json_obj_begin(json_writer_t *w);
+void json_obj_end(json_writer_t *w);
+void json_arr_begin(json_writer_t *w);
+void json_arr_end(json_writer_t *w);
+
+void json_key(json_writer_t *w, const char *key);
+void json_int(json_writer_t *w, int64_t v);
+void json_uint(json_writer_t *w, uint64_t v);
+void json_bool(json_writer_t *w, bool v);
+void json_str(json_writer_t *w, const char *s);
+void json_null(json_writer_t *w);
+
+// key + value shorthands
+void json_kv_int(json_writer_t *w, const char *key, int64_t v);
+void json_kv_uint(json_writer_t *w, const char *key, uint64_t v);
+void json_kv_bool(json_writer_t *w, const char *key, bool v);
+void json_kv_str(json_writer_t *w, const char *key, const char *s);
+
+#endif // JSON_WRITER_H
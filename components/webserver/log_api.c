@@ -0,0 +1,74 @@
+#include "log_api.h"
+#include "http_workers.h"
+#include "storage.h"
+#include "json_writer.h"
+#include <stdlib.h>
+
+typedef struct {
+    json_writer_t *w;
+    int left;
+} log_walk_t;
+
+static bool send_chunk(void *ctx, const char *buf, size_t len) {
+    return httpd_resp_send_chunk(ctx, buf, (ssize_t)len) == ESP_OK;
+}
+
+static bool write_record(const storage_record_t *rec, uint32_t boot, void *ctx) {
+    log_walk_t *walk = ctx;
+    json_writer_t *w = walk->w;
+    json_obj_begin(w);
+    json_kv_uint(w, "boot", boot);
+    json_kv_uint(w, "t", rec->t_s);
+    json_kv_str(w, "event", storage_event_name(rec->type));
+    json_kv_uint(w, "arg", rec->arg);
+    json_kv_uint(w, "value", rec->value);
+    json_obj_end(w);
+    return --walk->left > 0 && !w->overflow;
+}
+
+static esp_err_t api_log_handler(httpd_req_t *req)
+{
+    int limit = LOG_API_DEFAULT_LIMIT;
+    char qry[32], val[8];
+    if (httpd_req_get_url_query_str(req, qry, sizeof(qry)) == ESP_OK &&
+        httpd_query_key_value(qry, "limit", val, sizeof(val)) == ESP_OK) {
+        limit = atoi(val);
+    }
+    if (limit < 1 || limit > LOG_API_MAX_LIMIT) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Need 1 <= limit <= 500");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char chunk[LOG_API_CHUNK];
+    json_writer_t w;
+    json_writer_init(&w, chunk, sizeof(chunk));
+    json_writer_set_flush(&w, send_chunk, req);
+
+    json_obj_begin(&w);
+    json_kv_uint(&w, "boot", storage_boot_count());
+    json_key(&w, "events");
+    json_arr_begin(&w);
+    log_walk_t walk = { .w = &w, .left = limit };
+    storage_read_log(write_record, &walk);
+    json_arr_end(&w);
+    json_obj_end(&w);
+
+    if (json_writer_finish(&w) == 0) {
+        return ESP_FAIL;   // client went away mid-response
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+esp_err_t log_api_register(httpd_handle_t server)
+{
+    httpd_uri_t log_uri = {
+        .uri = "/api/log",
+        .method = HTTP_GET,
+        .handler = api_log_handler
+    };
+    return http_workers_register(server, &log_uri);
+}
@@ -0,0 +1,14 @@
+#ifndef LOG_API_H
+#define LOG_API_H
+
+#include "esp_http_server.h"
+
+// Irrigation event log at GET /api/log?limit=N (newest first), read from
+// the RAM batch and the committed NVS chunks.
+#define LOG_API_DEFAULT_LIMIT 50
+#define LOG_API_MAX_LIMIT     500
+#define LOG_API_CHUNK         256     // response is streamed in chunks this size
+
+esp_err_t log_api_register(httpd_handle_t server);
+
+#endif // LOG_API_H
@@ -0,0 +1,139 @@
+#include "metrics_api.h"
+#include "http_workers.h"
+#include "metrics.h"
+#include "mem.h"
+#include "json_writer.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_wifi.h"
+
+static bool send_chunk(void *ctx, const char *buf, size_t len) {
+    return httpd_resp_send_chunk(ctx, buf, (ssize_t)len) == ESP_OK;
+}
+
+static void write_hist(json_writer_t *w, metric_hist_t hist) {
+    metrics_hist_snapshot_t h;
+    metrics_hist_read(hist, &h);
+    int used = METRICS_BUCKETS;
+    while (used > 0 && h.buckets[used - 1] == 0) {
+        used--;
+    }
+
+    json_key(w, metrics_hist_name(hist));
+    json_obj_begin(w);
+    json_kv_uint(w, "n", h.count);
+    json_kv_uint(w, "sum_us", h.sum_us);
+    json_kv_uint(w, "max_us", h.max_us);
+    json_key(w, "b");
+    json_arr_begin(w);
+    for (int b = 0; b < used; b++) {
+        json_uint(w, h.buckets[b]);
+    }
+    json_arr_end(w);
+    json_obj_end(w);
+}
+
+static esp_err_t api_metrics_handler(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char chunk[METRICS_API_CHUNK];
+    json_writer_t w;
+    json_writer_init(&w, chunk, sizeof(chunk));
+    json_writer_set_flush(&w, send_chunk, req);
+
+    json_obj_begin(&w);
+    json_kv_uint(&w, "uptime_ms", (uint64_t)esp_timer_get_time() / 1000);
+
+    // Boot latency; null until the milestone is reached
+    json_key(&w, "boot_ms");
+    json_obj_begin(&w);
+    for (int m = 0; m < METRIC_BOOT_COUNT; m++) {
+        int32_t ms = metrics_boot_ms((metric_boot_t)m);
+        json_key(&w, metrics_boot_name((metric_boot_t)m));
+        if (ms >= 0) {
+            json_int(&w, ms);
+        } else {
+            json_null(&w);
+        }
+    }
+    json_obj_end(&w);
+
+    json_key(&w, "bucket_us");
+    json_arr_begin(&w);
+    for (int b = 0; b < METRICS_BUCKETS - 1; b++) {
+        json_uint(&w, (uint32_t)METRICS_BUCKET0_US << b);
+    }
+    json_arr_end(&w);
+
+    json_key(&w, "hist");
+    json_obj_begin(&w);
+    for (int h = 0; h < METRIC_HIST_COUNT; h++) {
+        write_hist(&w, (metric_hist_t)h);
+    }
+    json_obj_end(&w);
+
+    json_key(&w, "counters");
+    json_obj_begin(&w);
+    for (int c = 0; c < METRIC_COUNTER_COUNT; c++) {
+        json_kv_uint(&w, metrics_counter_name((metric_counter_t)c), metrics_counter((metric_counter_t)c));
+    }
+    json_obj_end(&w);
+
+    // Unused stack in bytes; this handler runs on the httpd task itself
+    json_key(&w, "stack_free");
+    json_obj_begin(&w);
+    for (int i = 0; i < metrics_task_count(); i++) {
+        TaskHandle_t task = metrics_task(i);
+        json_kv_uint(&w, pcTaskGetName(task), uxTaskGetStackHighWaterMark(task));
+    }
+    json_kv_uint(&w, "httpd", uxTaskGetStackHighWaterMark(NULL));
+    json_obj_end(&w);
+
+    json_kv_uint(&w, "heap_free", esp_get_free_heap_size());
+    json_kv_uint(&w, "heap_min_free", esp_get_minimum_free_heap_size());
+
+    // Stack budget and allocations per task kind since boot
+    mem_report_t mem;
+    mem_get_report(&mem);
+    json_key(&w, "memory");
+    json_obj_begin(&w);
+    json_kv_bool(&w, "static_alloc", mem.static_alloc);
+    json_kv_uint(&w, "heap_largest_block", mem.heap_largest_block);
+    json_kv_uint(&w, "stack_static", mem.stack_static);
+    json_kv_uint(&w, "stack_heap", mem.stack_heap);
+    json_kv_uint(&w, "violations", mem.violations);
+    json_key(&w, "allocs");
+    json_obj_begin(&w);
+    for (int k = 0; k < MEM_KINDS; k++) {
+        json_kv_uint(&w, mem_kind_name(k), mem.kinds[k].allocs);
+    }
+    json_obj_end(&w);
+    json_obj_end(&w);
+
+    wifi_ap_record_t ap;
+    json_key(&w, "rssi");
+    if (esp_wifi_sta_get_ap_info(&ap) == ESP_OK) {
+        json_int(&w, ap.rssi);
+    } else {
+        json_null(&w);
+    }
+    json_obj_end(&w);
+
+    if (json_writer_finish(&w) == 0) {
+        return ESP_FAIL;   // client went away mid-response
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+esp_err_t metrics_api_register(httpd_handle_t server)
+{
+    httpd_uri_t metrics_uri = {
+        .uri = "/api/metrics",
+        .method = HTTP_GET,
+        .handler = api_metrics_handler
+    };
+    return http_workers_register(server, &metrics_uri);
+}
@@ -0,0 +1,16 @@
+#ifndef METRICS_API_H
+#define METRICS_API_H
+
+#include "esp_http_server.h"
+
+// Runtime health at GET /api/metrics as compact JSON: latency histograms
+// (handlers, control-loop jitter, ADC frame time), counters, stack
+// high-water marks, heap low-water mark and WiFi RSSI.
+//
+// Histogram "b" arrays hold per-bucket counts, trailing empty buckets
+// dropped; "bucket_us" gives each bucket's upper bound (the last is open).
+#define METRICS_API_CHUNK 256     // response is streamed in chunks this size
+
+esp_err_t metrics_api_register(httpd_handle_t server);
+
+#endif // METRICS_API_H
@@ -0,0 +1,126 @@
+#include "ota_api.h"
+#include "http_workers.h"
+#include "json_writer.h"
+#include "ota.h"
+#include "esp_log.h"
+#include <stdio.h>
+
+static const char *TAG = "OTA_API";
+
+static esp_err_t send_status(httpd_req_t *req, const char *status, const char *error)
+{
+    char body[160];
+    json_writer_t w;
+    json_writer_init(&w, body, sizeof(body));
+    json_obj_begin(&w);
+    json_kv_str(&w, "status", status);
+    if (error != NULL) {
+        json_kv_str(&w, "error", error);
+    }
+    json_obj_end(&w);
+    size_t len = json_writer_finish(&w);
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_send(req, body, (ssize_t)len);
+}
+
+// Runs on an HTTP worker: a whole image streams through here
+static esp_err_t api_ota_post_handler(httpd_req_t *req)
+{
+    if (req->content_len == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Expected a firmware delta");
+        return ESP_FAIL;
+    }
+    esp_err_t err = ota_begin();
+    if (err == ESP_ERR_INVALID_STATE) {
+        httpd_resp_set_status(req, "409 Conflict");
+        send_status(req, "busy", NULL);
+        return ESP_FAIL;
+    }
+    if (err != ESP_OK) {
+        httpd_resp_set_status(req, HTTPD_500);
+        send_status(req, "error", ota_error());
+        return ESP_FAIL;
+    }
+    ESP_LOGI(TAG, "📥 Receiving a %u byte firmware delta", (unsigned)req->content_len);
+
+    char buf[OTA_API_RECV_CHUNK];
+    size_t left = req->content_len;
+    int timeouts = 0;
+    while (left > 0) {
+        int ret = httpd_req_recv(req, buf, left < sizeof(buf) ? left : sizeof(buf));
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT && ++timeouts <= OTA_API_RECV_RETRIES) {
+            continue;
+        }
+        if (ret <= 0) {
+            ota_abort("upload interrupted");
+            return ESP_FAIL;    // client went away
+        }
+        timeouts = 0;
+        left -= (size_t)ret;
+        if (ota_write(buf, (size_t)ret) != ESP_OK) {
+            httpd_resp_set_status(req, HTTPD_400);
+            send_status(req, "error", ota_error());
+            return ESP_FAIL;
+        }
+    }
+    if (ota_finish() != ESP_OK) {
+        httpd_resp_set_status(req, HTTPD_400);
+        send_status(req, "error", ota_error());
+        return ESP_FAIL;
+    }
+    err = send_status(req, "ok", NULL);
+    ota_restart();
+    return err;
+}
+
+static esp_err_t api_ota_get_handler(httpd_req_t *req)
+{
+    ota_status_t s;
+    ota_get_status(&s);
+
+    char body[320];
+    json_writer_t w;
+    json_writer_init(&w, body, sizeof(body));
+    json_obj_begin(&w);
+    json_kv_str(&w, "running", s.running);
+    json_kv_str(&w, "next", s.next);
+    json_kv_str(&w, "version", s.version);
+    json_kv_bool(&w, "pending_verify", s.pending_verify);
+    json_kv_str(&w, "phase", ota_phase_name(s.phase));
+    json_kv_uint(&w, "received", s.received);
+    json_kv_uint(&w, "written", s.written);
+    json_kv_uint(&w, "target_size", s.target_size);
+    json_key(&w, "error");
+    if (s.error != NULL) {
+        json_str(&w, s.error);
+    } else {
+        json_null(&w);
+    }
+    json_obj_end(&w);
+    size_t len = json_writer_finish(&w);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    return httpd_resp_send(req, body, (ssize_t)len);
+}
+
+esp_err_t ota_api_register(httpd_handle_t server)
+{
+    httpd_uri_t get_uri = {
+        .uri = "/api/ota",
+        .method = HTTP_GET,
+        .handler = api_ota_get_handler
+    };
+    // The upload holds a worker for as long as it takes, never the httpd task
+    httpd_uri_t post_uri = {
+        .uri = "/api/ota",
+        .method = HTTP_POST,
+        .handler = api_ota_post_handler
+    };
+    esp_err_t err = httpd_register_uri_handler(server, &get_uri);
+    if (err == ESP_OK) {
+        err = http_workers_register(server, &post_uri);
+    }
+    return err;
+}
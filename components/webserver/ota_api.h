@@ -0,0 +1,17 @@
+#ifndef OTA_API_H
+#define OTA_API_H
+
+#include "esp_http_server.h"
+
+// Firmware updates (components/ota) over HTTP:
+//   POST /api/ota   body = a delta from tools/ota_delta.py, any size; it is
+//                   decoded into the inactive partition as it arrives, then
+//                   the board restarts into it
+//   GET  /api/ota   running partition and version, progress of an update
+// Push with: tools/ota_delta.py push PATCH --url http://<board>
+#define OTA_API_RECV_CHUNK      1024
+#define OTA_API_RECV_RETRIES    3       // socket timeouts in a row before giving up
+
+esp_err_t ota_api_register(httpd_handle_t server);
+
+#endif // OTA_API_H
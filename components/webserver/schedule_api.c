@@ -0,0 +1,382 @@
+#include "schedule_api.h"
+#include "http_workers.h"
+#include "json_reader.h"
+#include "json_writer.h"
+#include "command_json.h"
+#include "schedule.h"
+#include "sensors.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const day_names[7] = { "sun", "mon", "tue", "wed", "thu", "fri", "sat" };
+
+static bool send_chunk(void *ctx, const char *buf, size_t len) {
+    return httpd_resp_send_chunk(ctx, buf, (ssize_t)len) == ESP_OK;
+}
+
+static void json_kv_hhmm(json_writer_t *w, const char *key, unsigned min) {
+    char hhmm[8];
+    snprintf(hhmm, sizeof(hhmm), "%02u:%02u", (min / 60) % 24, min % 60);
+    json_kv_str(w, key, hhmm);
+}
+
+static bool write_rule(const schedule_rule_t *r, void *ctx) {
+    json_writer_t *w = ctx;
+    json_obj_begin(w);
+    json_kv_uint(w, "id", r->id);
+    json_kv_str(w, "kind", schedule_kind_name(r->kind));
+    json_key(w, "zones");
+    json_arr_begin(w);
+    for (uint16_t m = r->zones; m; m &= m - 1) {
+        json_uint(w, (unsigned)__builtin_ctz(m) + 1);
+    }
+    json_arr_end(w);
+    json_key(w, "days");
+    json_arr_begin(w);
+    for (int d = 0; d < 7; d++) {
+        if (r->days == 0 || (r->days >> d) & 1) {
+            json_str(w, day_names[d]);
+        }
+    }
+    json_arr_end(w);
+    json_kv_hhmm(w, "start", r->start_min);
+    if (r->kind == SCHEDULE_INTERVAL) {
+        json_kv_uint(w, "every", r->every_min);
+        json_kv_uint(w, "duration", r->duration_ms);
+    } else {
+        json_kv_hhmm(w, "end", r->end_min);
+    }
+    json_obj_end(w);
+    return !w->overflow;     // stop walking once the client is gone
+}
+
+static esp_err_t api_schedule_get_handler(httpd_req_t *req)
+{
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+
+    char chunk[SCHEDULE_API_CHUNK];
+    json_writer_t w;
+    json_writer_init(&w, chunk, sizeof(chunk));
+    json_writer_set_flush(&w, send_chunk, req);
+
+    schedule_status_t status;
+    schedule_get_status(&status);
+    json_obj_begin(&w);
+    json_kv_bool(&w, "synced", status.synced);
+    json_kv_int(&w, "local_s", status.local_s);
+    json_key(&w, "next_s");
+    if (status.next_s >= 0) {
+        json_int(&w, status.next_s);
+    } else {
+        json_null(&w);
+    }
+    json_kv_uint(&w, "allowed", status.allowed);
+    json_key(&w, "rules");
+    json_arr_begin(&w);
+    schedule_for_each(write_rule, &w);
+    json_arr_end(&w);
+    json_obj_end(&w);
+
+    if (json_writer_finish(&w) == 0) {
+        return ESP_FAIL;   // client went away mid-response
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
+/* --------------------------------------------------------- rule parsing */
+
+typedef enum {
+    F_KIND,
+    F_ZONE,
+    F_ZONES,
+    F_DAYS,
+    F_START,
+    F_END,
+    F_EVERY,
+    F_DURATION,
+    F_COUNT
+} field_t;
+
+static const char *const field_names[F_COUNT] = {
+    [F_KIND] = "kind",
+    [F_ZONE] = "zone",
+    [F_ZONES] = "zones",
+    [F_DAYS] = "days",
+    [F_START] = "start",
+    [F_END] = "end",
+    [F_EVERY] = "every",
+    [F_DURATION] = "duration",
+};
+
+#define HAS(p, f) (((p)->seen >> (f)) & 1)
+
+typedef struct {
+    json_reader_t reader;
+    int field;              // key being read, -1 = unknown (value skipped)
+    uint16_t seen;          // F_* bits
+    schedule_rule_t rule;
+    char error[48];
+} parse_t;
+
+static bool reject(parse_t *p, const char *error) {
+    json_reader_fail(&p->reader, error);
+    return false;
+}
+
+static bool reject_field(parse_t *p) {
+    snprintf(p->error, sizeof(p->error), "bad value for %s", field_names[p->field]);
+    return reject(p, p->error);
+}
+
+// "HH:MM" -> minute of the day, -1 if malformed
+static int parse_hhmm(const char *s) {
+    char *end;
+    long h = strtol(s, &end, 10);
+    if (end == s || *end != ':' || h < 0 || h > 23) {
+        return -1;
+    }
+    const char *m_str = end + 1;
+    long m = strtol(m_str, &end, 10);
+    if (end == m_str || *end != '\0' || m < 0 || m > 59) {
+        return -1;
+    }
+    return (int)(h * 60 + m);
+}
+
+// "sun".."sat" -> 0..6, -1 if not a day name
+static int day_index(const char *s) {
+    for (int d = 0; d < 7; d++) {
+        if (strcmp(s, day_names[d]) == 0) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+// Array items: zone numbers (1..N) or days (0..6, or the names GET lists)
+static bool set_item(parse_t *p, const json_tok_t *tok) {
+    if (p->field == F_ZONES) {
+        if (tok->type != JSON_TOK_INT) {
+            return reject_field(p);
+        }
+        if (tok->num < 1 || tok->num > zone_count()) {
+            return reject(p, "unknown zone");
+        }
+        p->rule.zones |= 1U << (tok->num - 1);
+    } else {
+        int day = -1;
+        if (tok->type == JSON_TOK_INT && tok->num >= 0 && tok->num <= 6) {
+            day = (int)tok->num;
+        } else if (tok->type == JSON_TOK_STR) {
+            day = day_index(tok->str);
+        }
+        if (day < 0) {
+            return reject(p, "days are 0 (Sunday) to 6 or sun to sat");
+        }
+        p->rule.days |= 1U << day;
+    }
+    return true;
+}
+
+static bool set_field(parse_t *p, const json_tok_t *tok) {
+    switch (p->field) {
+    case F_KIND: {
+        int kind = -1;
+        for (int k = 0; k < SCHEDULE_KIND_COUNT; k++) {
+            if (tok->type == JSON_TOK_STR && strcmp(tok->str, schedule_kind_name(k)) == 0) {
+                kind = k;
+            }
+        }
+        if (kind < 0) {
+            return reject(p, "kind must be window, interval or blackout");
+        }
+        p->rule.kind = (uint8_t)kind;
+        break;
+    }
+    case F_ZONE:
+        if (tok->type != JSON_TOK_INT || tok->num < 1 || tok->num > zone_count()) {
+            return reject(p, "unknown zone");
+        }
+        p->rule.zones |= 1U << (tok->num - 1);
+        break;
+    case F_ZONES:
+    case F_DAYS:
+        // Items arrive one level down (set_item); this is the array itself
+        if (tok->type != JSON_TOK_ARR_BEGIN && tok->type != JSON_TOK_ARR_END) {
+            return reject_field(p);
+        }
+        break;
+    case F_START:
+    case F_END: {
+        int min = tok->type == JSON_TOK_STR ? parse_hhmm(tok->str) : -1;
+        if (min < 0) {
+            snprintf(p->error, sizeof(p->error), "%s must be \"HH:MM\"", field_names[p->field]);
+            return reject(p, p->error);
+        }
+        if (p->field == F_START) {
+            p->rule.start_min = (uint16_t)min;
+        } else {
+            p->rule.end_min = (uint16_t)min;
+        }
+        break;
+    }
+    case F_EVERY:
+        if (tok->type != JSON_TOK_INT || tok->num < 0 || tok->num >= 24 * 60) {
+            return reject_field(p);
+        }
+        p->rule.every_min = (uint16_t)tok->num;
+        break;
+    case F_DURATION:
+        if (tok->type != JSON_TOK_INT || tok->num < 0 || tok->num > UINT32_MAX) {
+            return reject_field(p);
+        }
+        p->rule.duration_ms = (uint32_t)tok->num;
+        break;
+    }
+    p->seen |= 1U << p->field;
+    return true;
+}
+
+static bool on_token(void *ctx, const json_tok_t *tok) {
+    parse_t *p = ctx;
+    if (tok->depth == 0) {
+        return tok->type == JSON_TOK_OBJ_BEGIN || tok->type == JSON_TOK_OBJ_END ||
+               reject(p, "expected an object");
+    }
+    if (tok->depth == 2 && (p->field == F_ZONES || p->field == F_DAYS)) {
+        return set_item(p, tok);
+    }
+    if (tok->depth > 1) {
+        return true;    // inside the value of an unknown key
+    }
+    if (tok->type == JSON_TOK_KEY) {
+        p->field = -1;
+        for (int f = 0; f < F_COUNT; f++) {
+            if (strcmp(tok->str, field_names[f]) == 0) {
+                p->field = f;
+            }
+        }
+        return true;
+    }
+    return p->field < 0 || set_field(p, tok);
+}
+
+static const char *check_rule(const parse_t *p) {
+    if (!HAS(p, F_KIND) || !HAS(p, F_START)) {
+        return "kind and start required";
+    }
+    if (p->rule.zones == 0) {
+        return "zone or zones required";
+    }
+    if (p->rule.kind != SCHEDULE_INTERVAL && !HAS(p, F_END)) {
+        return "end required";
+    }
+    return NULL;
+}
+
+static esp_err_t api_schedule_post_handler(httpd_req_t *req)
+{
+    if (req->content_len == 0) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "empty body");
+        return ESP_FAIL;
+    }
+    if (req->content_len > SCHEDULE_API_BODY_MAX) {
+        httpd_resp_send_err(req, HTTPD_413_CONTENT_TOO_LARGE, "body too large");
+        return ESP_FAIL;
+    }
+
+    parse_t p = { .field = -1 };
+    json_reader_init(&p.reader, on_token, &p);
+    char buf[COMMAND_JSON_RECV_CHUNK];
+    size_t left = req->content_len;
+    while (left > 0) {
+        int ret = httpd_req_recv(req, buf, left < sizeof(buf) ? left : sizeof(buf));
+        if (ret == HTTPD_SOCK_ERR_TIMEOUT) {
+            httpd_resp_send_408(req);
+            return ESP_FAIL;
+        }
+        if (ret <= 0) {
+            return ESP_FAIL;   // client went away
+        }
+        left -= (size_t)ret;
+        if (!json_reader_feed(&p.reader, buf, (size_t)ret)) {
+            break;
+        }
+    }
+
+    if (!json_reader_finish(&p.reader)) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s (byte %u)",
+                 p.reader.error ? p.reader.error : "incomplete body", (unsigned)p.reader.offset);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, msg);
+        return ESP_FAIL;
+    }
+    const char *error = check_rule(&p);
+    if (error != NULL) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, error);
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/json");
+    esp_err_t err = schedule_add(&p.rule);
+    if (err == ESP_ERR_NO_MEM) {
+        httpd_resp_set_status(req, "507 Insufficient Storage");
+        return httpd_resp_sendstr(req, "{\"status\":\"full\"}");
+    }
+    if (err != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "invalid rule");
+        return ESP_FAIL;
+    }
+    char body[40];
+    snprintf(body, sizeof(body), "{\"status\":\"ok\",\"id\":%u}", p.rule.id);
+    return httpd_resp_sendstr(req, body);
+}
+
+static esp_err_t api_schedule_delete_handler(httpd_req_t *req)
+{
+    char qry[32];
+    char val[8];
+    if (httpd_req_get_url_query_str(req, qry, sizeof(qry)) != ESP_OK ||
+        httpd_query_key_value(qry, "id", val, sizeof(val)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "id required");
+        return ESP_FAIL;
+    }
+    int id = atoi(val);
+    if (schedule_remove((uint16_t)(id > 0 && id <= UINT16_MAX ? id : 0)) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "no such rule");
+        return ESP_FAIL;
+    }
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
+}
+
+esp_err_t schedule_api_register(httpd_handle_t server)
+{
+    // The listing can be long and edits wait for an NVS commit: all on workers
+    httpd_uri_t get_uri = {
+        .uri = "/api/schedule",
+        .method = HTTP_GET,
+        .handler = api_schedule_get_handler
+    };
+    httpd_uri_t post_uri = {
+        .uri = "/api/schedule",
+        .method = HTTP_POST,
+        .handler = api_schedule_post_handler
+    };
+    httpd_uri_t delete_uri = {
+        .uri = "/api/schedule",
+        .method = HTTP_DELETE,
+        .handler = api_schedule_delete_handler
+    };
+    esp_err_t err = http_workers_register(server, &get_uri);
+    if (err == ESP_OK) {
+        err = http_workers_register(server, &post_uri);
+    }
+    if (err == ESP_OK) {
+        err = http_workers_register(server, &delete_uri);
+    }
+    return err;
+}
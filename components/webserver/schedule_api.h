@@ -0,0 +1,22 @@
+#ifndef SCHEDULE_API_H
+#define SCHEDULE_API_H
+
+#include "esp_http_server.h"
+
+// Calendar rules (components/schedule) over HTTP:
+//   GET    /api/schedule          clock, allowed zones and every rule
+//   POST   /api/schedule          add a rule, replies {"status":"ok","id":n}
+//   DELETE /api/schedule?id=n     remove one
+//
+// Rule objects, keys in any order:
+//   {"kind":"window"|"blackout","zones":[1,2],"days":[1,2,3,4,5],"start":"06:00","end":"08:30"}
+//   {"kind":"interval","zone":3,"start":"05:00","every":240,"duration":60000}
+// "zone" is shorthand for a single zone; no "days" means every day (0 =
+// Sunday); "every" is in minutes (0 = once a day at start), "duration" in ms
+// (0 = the zone's own pump duration).
+#define SCHEDULE_API_CHUNK      256     // GET response is streamed in chunks this size
+#define SCHEDULE_API_BODY_MAX   512     // longer POST bodies get 413 unread
+
+esp_err_t schedule_api_register(httpd_handle_t server);
+
+#endif // SCHEDULE_API_H
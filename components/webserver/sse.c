@@ -0,0 +1,171 @@
+#include "sse.h"
+#include "state_json.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "SSE";
+
+#define SSE_EVENT_MAX (STATE_JSON_MAX + 64)
+
+// Subscriber list and last-sent state belong to the httpd task: they are
+// only touched by the handler, queued work and close_fn, which it runs.
+static httpd_handle_t sse_server = NULL;
+static int sse_clients[SSE_MAX_CLIENTS];
+static atomic_int sse_client_count = 0;
+static atomic_bool sse_push_pending = false;
+static system_state_t sse_last;
+static uint32_t sse_last_version = 0;
+static esp_timer_handle_t sse_ping_timer = NULL;
+static char sse_event[SSE_EVENT_MAX];
+
+static const char sse_headers[] =
+    "HTTP/1.1 200 OK\r\n"
+    "Content-Type: text/event-stream\r\n"
+    "Cache-Control: no-cache\r\n"
+    "Connection: keep-alive\r\n"
+    "Access-Control-Allow-Origin: *\r\n"
+    "\r\n"
+    "retry: 3000\n\n";
+
+// "id: <version>\ndata: {...}\n\n" into sse_event; 0 if nothing to send
+static size_t format_event(uint32_t version, const system_state_t *st, const system_state_t *prev) {
+    int n = snprintf(sse_event, sizeof(sse_event), "id: %" PRIu32 "\ndata: ", version);
+    json_writer_t w;
+    json_writer_init(&w, sse_event + n, sizeof(sse_event) - n - 2);
+    int fields = state_json_write(&w, st, prev);
+    size_t len = json_writer_finish(&w);
+    if (len == 0) {
+        ESP_LOGE(TAG, "❌ State event does not fit in %d bytes", SSE_EVENT_MAX);
+        return 0;
+    }
+    if (fields == 0) {
+        return 0;
+    }
+    len += n;
+    sse_event[len++] = '\n';
+    sse_event[len++] = '\n';
+    return len;
+}
+
+static void remove_client(int i) {
+    int n = atomic_load(&sse_client_count);
+    sse_clients[i] = sse_clients[n - 1];
+    atomic_store(&sse_client_count, n - 1);
+    if (n - 1 == 0 && sse_ping_timer) {
+        esp_timer_stop(sse_ping_timer);
+    }
+}
+
+static void send_to_all(const char *buf, size_t len) {
+    for (int i = atomic_load(&sse_client_count) - 1; i >= 0; i--) {
+        int fd = sse_clients[i];
+        if (httpd_socket_send(sse_server, fd, buf, len, 0) < 0) {
+            ESP_LOGI(TAG, "📴 Subscriber %d gone", fd);
+            remove_client(i);
+            httpd_sess_trigger_close(sse_server, fd);
+        }
+    }
+}
+
+static void push_work(void *arg) {
+    atomic_store(&sse_push_pending, false);
+    system_state_t st;
+    uint32_t version = system_state_read(&st);
+    if (version == sse_last_version) {
+        return;
+    }
+    size_t len = format_event(version, &st, &sse_last);
+    sse_last = st;
+    sse_last_version = version;
+    if (len > 0) {
+        send_to_all(sse_event, len);
+    }
+}
+
+static void ping_work(void *arg) {
+    static const char ping[] = ": ping\n\n";
+    send_to_all(ping, sizeof(ping) - 1);
+}
+
+// Control task context: just hand the work to the httpd task
+static void on_state_published(uint32_t version, void *ctx) {
+    if (atomic_load(&sse_client_count) == 0) {
+        return;
+    }
+    if (!atomic_exchange(&sse_push_pending, true)) {
+        if (httpd_queue_work(sse_server, push_work, NULL) != ESP_OK) {
+            atomic_store(&sse_push_pending, false);
+        }
+    }
+}
+
+static void ping_timer_cb(void *arg) {
+    httpd_queue_work(sse_server, ping_work, NULL);
+}
+
+static esp_err_t api_events_handler(httpd_req_t *req) {
+    int n = atomic_load(&sse_client_count);
+    if (n >= SSE_MAX_CLIENTS) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_set_type(req, "text/plain");
+        return httpd_resp_sendstr(req, "too many event subscribers");
+    }
+
+    // Headers and the full state go out directly on the socket; the
+    // response stays open and later events follow on the same socket.
+    int fd = httpd_req_to_sockfd(req);
+    system_state_t st;
+    uint32_t version = system_state_read(&st);
+    size_t len = format_event(version, &st, NULL);
+    if (len == 0) {
+        return httpd_resp_send_500(req);
+    }
+    if (httpd_socket_send(sse_server, fd, sse_headers, sizeof(sse_headers) - 1, 0) < 0 ||
+        httpd_socket_send(sse_server, fd, sse_event, len, 0) < 0) {
+        return ESP_FAIL;
+    }
+    if (sse_last_version == 0) {
+        sse_last = st;
+        sse_last_version = version;
+    }
+
+    sse_clients[n] = fd;
+    atomic_store(&sse_client_count, n + 1);
+    if (n == 0) {
+        esp_timer_start_periodic(sse_ping_timer, (uint64_t)SSE_PING_INTERVAL_S * 1000000);
+    }
+    ESP_LOGI(TAG, "📡 Subscriber %d connected (%d/%d)", fd, n + 1, SSE_MAX_CLIENTS);
+    return ESP_OK;
+}
+
+void sse_forget(int sockfd) {
+    for (int i = atomic_load(&sse_client_count) - 1; i >= 0; i--) {
+        if (sse_clients[i] == sockfd) {
+            remove_client(i);
+            ESP_LOGI(TAG, "📴 Subscriber %d disconnected", sockfd);
+        }
+    }
+}
+
+esp_err_t sse_register(httpd_handle_t server) {
+    sse_server = server;
+    if (sse_ping_timer == NULL) {
+        const esp_timer_create_args_t ping_args = {
+            .callback = ping_timer_cb,
+            .name = "sse_ping",
+        };
+        ESP_ERROR_CHECK(esp_timer_create(&ping_args, &sse_ping_timer));
+        system_state_add_listener(on_state_published, NULL);
+    }
+
+    httpd_uri_t events_uri = {
+        .uri = "/api/events",
+        .method = HTTP_GET,
+        .handler = api_events_handler
+    };
+    return httpd_register_uri_handler(server, &events_uri);
+}
@@ -0,0 +1,18 @@
+#ifndef SSE_H
+#define SSE_H
+
+#include "esp_http_server.h"
+
+// Server-Sent Events push channel at GET /api/events.
+//
+// A subscriber first gets the full state, then one event per published state
+// change carrying only the fields that changed. Changes published while a
+// push is still queued are coalesced into that push.
+#define SSE_MAX_CLIENTS     3       // keep sockets free for regular requests
+#define SSE_PING_INTERVAL_S 15      // comment line so dead peers are noticed
+
+esp_err_t sse_register(httpd_handle_t server);
+// Must be called from the server's close_fn for every closed socket
+void sse_forget(int sockfd);
+
+#endif // SSE_H
@@ -0,0 +1,152 @@
+#include "state_json.h"
+#include "sensors.h"
+#include "flow.h"
+#include <string.h>
+
+_Static_assert(STATE_JSON_MAX >= STATE_JSON_WORST,
+               "STATE_JSON_MAX too small for SYSTEM_MAX_ZONES zones and SYSTEM_MAX_METERS meters");
+
+#define CHANGED(field) (prev == NULL || prev->field != st->field)
+#define COLUMN_CHANGED(field) (prev == NULL || memcmp(prev->field, st->field, sizeof(st->field)) != 0)
+
+static void write_column(json_writer_t *w, const char *key, const uint16_t *u16, const uint32_t *u32, int n) {
+    json_key(w, key);
+    json_arr_begin(w);
+    for (int z = 0; z < n; z++) {
+        json_uint(w, u16 ? u16[z] : u32[z]);
+    }
+    json_arr_end(w);
+}
+
+static void write_mask(json_writer_t *w, const char *key, uint16_t mask, int n) {
+    json_key(w, key);
+    json_arr_begin(w);
+    for (int z = 0; z < n; z++) {
+        json_bool(w, (mask >> z) & 1);
+    }
+    json_arr_end(w);
+}
+
+static int write_zones(json_writer_t *w, const system_state_t *st, const system_state_t *prev) {
+    int n = st->zone_count;
+    bool names = CHANGED(zone_count);
+    bool soil = names || COLUMN_CHANGED(zone_soil);
+    bool threshold = names || COLUMN_CHANGED(zone_threshold);
+    bool duration = names || COLUMN_CHANGED(zone_duration_ms);
+    bool volume = names || COLUMN_CHANGED(zone_volume_ml);
+    bool on = names || CHANGED(zones_watering);
+    bool manual = names || CHANGED(zones_manual);
+    if (!(soil || threshold || duration || volume || on || manual)) {
+        return 0;
+    }
+    json_key(w, "zones");
+    json_obj_begin(w);
+    if (names) {
+        json_key(w, "name");
+        json_arr_begin(w);
+        for (int z = 0; z < n; z++) {
+            const zone_config_t *cfg = zone_config(z);
+            json_str(w, cfg ? cfg->name : "");
+        }
+        json_arr_end(w);
+    }
+    if (soil) {
+        write_column(w, "soil", st->zone_soil, NULL, n);
+    }
+    if (threshold) {
+        write_column(w, "threshold", st->zone_threshold, NULL, n);
+    }
+    if (duration) {
+        write_column(w, "duration", NULL, st->zone_duration_ms, n);
+    }
+    if (volume) {
+        write_column(w, "volume", NULL, st->zone_volume_ml, n);
+    }
+    if (on) {
+        write_mask(w, "on", st->zones_watering, n);
+    }
+    if (manual) {
+        write_mask(w, "manual", st->zones_manual, n);
+    }
+    json_obj_end(w);
+    return 1;
+}
+
+// Flow meters: names once, then the ml measured over each one's last run
+static int write_meters(json_writer_t *w, const system_state_t *st, const system_state_t *prev) {
+    bool names = CHANGED(meter_count);
+    if (!names && !COLUMN_CHANGED(meter_last_ml)) {
+        return 0;
+    }
+    json_key(w, "meters");
+    json_obj_begin(w);
+    if (names) {
+        json_key(w, "name");
+        json_arr_begin(w);
+        for (int m = 0; m < st->meter_count; m++) {
+            const flow_meter_config_t *cfg = flow_meter_config(m);
+            json_str(w, cfg ? cfg->name : "");
+        }
+        json_arr_end(w);
+    }
+    write_column(w, "last_ml", NULL, st->meter_last_ml, st->meter_count);
+    json_obj_end(w);
+    return 1;
+}
+
+int state_json_write(json_writer_t *w, const system_state_t *st, const system_state_t *prev) {
+    int fields = 0;
+    json_obj_begin(w);
+    if (CHANGED(soil_moisture)) {
+        json_kv_int(w, "soil_moisture", st->soil_moisture);
+        fields++;
+    }
+    if (CHANGED(water_tank_full)) {
+        json_kv_bool(w, "water_tank", st->water_tank_full);
+        fields++;
+    }
+    if (CHANGED(fertilizer_tank_full)) {
+        json_kv_bool(w, "fert_tank", st->fertilizer_tank_full);
+        fields++;
+    }
+    if (CHANGED(pump1_running)) {
+        json_kv_bool(w, "pump1", st->pump1_running);
+        fields++;
+    }
+    if (CHANGED(pump2_running)) {
+        json_kv_bool(w, "pump2", st->pump2_running);
+        fields++;
+    }
+    if (CHANGED(auto_mode)) {
+        json_kv_bool(w, "auto_mode", st->auto_mode);
+        fields++;
+    }
+    if (CHANGED(soil_dry_threshold)) {
+        json_kv_int(w, "threshold", st->soil_dry_threshold);
+        fields++;
+    }
+    if (CHANGED(pump_duration_ms)) {
+        json_kv_int(w, "pump_duration", st->pump_duration_ms);
+        fields++;
+    }
+    if (CHANGED(fertilizer_duration_ms)) {
+        json_kv_int(w, "fert_duration", st->fertilizer_duration_ms);
+        fields++;
+    }
+    if (CHANGED(check_interval_ms)) {
+        json_kv_int(w, "interval", st->check_interval_ms);
+        fields++;
+    }
+    if (CHANGED(fertilizer_volume_ml)) {
+        json_kv_uint(w, "fert_volume", st->fertilizer_volume_ml);
+        fields++;
+    }
+    if (CHANGED(fert_ratio_ml_l)) {
+        json_kv_uint(w, "fert_ratio", st->fert_ratio_ml_l);
+        fields++;
+    }
+    fields += write_zones(w, st, prev);
+    fields += write_meters(w, st, prev);
+    json_obj_end(w);
+    return fields;
+}
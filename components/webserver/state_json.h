@@ -0,0 +1,30 @@
+#ifndef STATE_JSON_H
+#define STATE_JSON_H
+
+#include "json_writer.h"
+#include "system_state.h"
+
+// Write the dashboard view of the state as one JSON object (the /api/data
+// field names). With prev == NULL every field is written; otherwise only the
+// fields that differ from prev. Returns the number of fields written.
+//
+// Zones are columnar, one array per field ("zones":{"soil":[...],...}), and
+// a delta carries only the columns that changed.
+//
+// Worst case of the full object: every scalar, zone column and meter column
+// at its widest value, with SYSTEM_MAX_ZONES zones, SYSTEM_MAX_METERS meters
+// and names of up to STATE_JSON_NAME_MAX bytes as written. Longer names
+// overflow the writer, which the callers report as an error.
+#define STATE_JSON_NAME_MAX     32
+#define STATE_JSON_SCALARS_MAX  260     // "{" and the top-level fields
+#define STATE_JSON_ZONES_KEYS   84      // ,"zones":{...} minus the values
+#define STATE_JSON_ZONE_MAX     (STATE_JSON_NAME_MAX + 3 + 6 + 6 + 11 + 11 + 6 + 6)
+#define STATE_JSON_METERS_KEYS  32      // ,"meters":{...} minus the values
+#define STATE_JSON_METER_MAX    (STATE_JSON_NAME_MAX + 3 + 11)
+#define STATE_JSON_WORST        (STATE_JSON_SCALARS_MAX + \
+                                 STATE_JSON_ZONES_KEYS + SYSTEM_MAX_ZONES * STATE_JSON_ZONE_MAX + \
+                                 STATE_JSON_METERS_KEYS + SYSTEM_MAX_METERS * STATE_JSON_METER_MAX + 2)
+#define STATE_JSON_MAX          2048
+int state_json_write(json_writer_t *w, const system_state_t *st, const system_state_t *prev);
+
+#endif // STATE_JSON_H
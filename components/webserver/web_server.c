@@ -1,220 +1,296 @@
 #include "web_server.h"
 #include "esp_log.h"
-#include "cJSON.h"
+#include "esp_random.h"
+#include "state_json.h"
+#include "command_json.h"
+#include "sse.h"
+#include "history_api.h"
+#include "log_api.h"
+#include "metrics_api.h"
+#include "schedule_api.h"
+#include "bench_api.h"
+#include "ota_api.h"
+#include "http_workers.h"
+#include "metrics.h"
+#include "rt.h"
+#include "esp_timer.h"
+#include <inttypes.h>
+#include <stdio.h>
 #include <string.h>
+#include <unistd.h>
 #include "dashboard.h"  // Include generated HTML
 
 static const char *TAG = "WEB_SERVER";
 static httpd_handle_t server = NULL;
 
-// External references
-extern int current_soil_moisture;
-extern bool current_water_tank_full;
-extern bool current_fertilizer_tank_full;
-extern bool pump1_running;
-extern bool pump2_running;
-extern bool auto_mode;
-extern bool pump1_manual;
-extern bool pump2_manual;
-extern int soil_dry_threshold;
-extern int pump_duration_ms;
-extern int fertilizer_duration_ms;
-extern int check_interval_ms;
-
-// External function
-extern void control_pump(gpio_num_t relay_pin, bool state);
-
-// HTML Dashboard (now from dashboard.h)
+// HTML Dashboard (now from dashboard.h, stored gzip-compressed)
 // To update: Edit dashboard.html, then run: python html_to_header.py
+#define DASHBOARD_CACHE_CONTROL "public, max-age=86400"
 
 // HTTP GET handler for root
 static esp_err_t root_handler(httpd_req_t *req)
 {
     httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, dashboard_html, HTTPD_RESP_USE_STRLEN);
-    return ESP_OK;
+    httpd_resp_set_hdr(req, "Cache-Control", DASHBOARD_CACHE_CONTROL);
+    httpd_resp_set_hdr(req, "ETag", DASHBOARD_ETAG);
+
+    // Same page as the browser's cached copy: headers only
+    char inm[64];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK &&
+        strstr(inm, DASHBOARD_ETAG) != NULL) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    httpd_resp_set_hdr(req, "Vary", "Accept-Encoding");
+    return httpd_resp_send(req, (const char *)dashboard_html_gz, DASHBOARD_HTML_GZ_LEN);
+}
+
+// /api/data body, re-rendered only when the state version changes.
+// httpd runs one handler at a time, so the cache needs no lock.
+#define DATA_BODY_MAX STATE_JSON_MAX
+static char data_body[DATA_BODY_MAX];
+static size_t data_body_len = 0;
+static uint32_t data_body_version = 0;     // 0 = nothing rendered yet
+static char data_etag[24];
+static uint32_t boot_id;                   // keeps ETags from matching across reboots
+
+static void render_data(void)
+{
+    uint32_t version = system_state_version();
+    if (version == data_body_version) {
+        return;
+    }
+
+    // One coherent snapshot of the shared state
+    system_state_t st;
+    version = system_state_read(&st);
+
+    json_writer_t w;
+    json_writer_init(&w, data_body, sizeof(data_body));
+    state_json_write(&w, &st, NULL);
+    data_body_len = json_writer_finish(&w);
+    if (data_body_len == 0) {
+        ESP_LOGE(TAG, "❌ State JSON does not fit in %d bytes", DATA_BODY_MAX);
+    }
+
+    snprintf(data_etag, sizeof(data_etag), "\"%08" PRIx32 "-%" PRIu32 "\"", boot_id, version);
+    data_body_version = version;
 }
 
-// API handler for sensor data (replaces WebSocket)
+// API handler for sensor data (polling fallback; live updates use /api/events)
 static esp_err_t api_data_handler(httpd_req_t *req)
 {
-    // Send sensor data as JSON
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddNumberToObject(root, "soil_moisture", current_soil_moisture);
-    cJSON_AddBoolToObject(root, "water_tank", current_water_tank_full);
-    cJSON_AddBoolToObject(root, "fert_tank", current_fertilizer_tank_full);
-    cJSON_AddBoolToObject(root, "pump1", pump1_running);
-    cJSON_AddBoolToObject(root, "pump2", pump2_running);
-    cJSON_AddBoolToObject(root, "auto_mode", auto_mode);
-    cJSON_AddNumberToObject(root, "threshold", soil_dry_threshold);
-    cJSON_AddNumberToObject(root, "pump_duration", pump_duration_ms);
-    cJSON_AddNumberToObject(root, "fert_duration", fertilizer_duration_ms);
-    cJSON_AddNumberToObject(root, "interval", check_interval_ms);
-    
-    char *json_str = cJSON_PrintUnformatted(root);
-    cJSON_Delete(root);
+    render_data();
+    if (data_body_len == 0) {
+        return httpd_resp_send_500(req);
+    }
 
     httpd_resp_set_type(req, "application/json");
     httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_sendstr(req, json_str);
-    
-    free(json_str);
+    httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+    httpd_resp_set_hdr(req, "ETag", data_etag);
+
+    // Unchanged since the client's copy: headers only
+    char inm[64];
+    if (httpd_req_get_hdr_value_str(req, "If-None-Match", inm, sizeof(inm)) == ESP_OK &&
+        strstr(inm, data_etag) != NULL) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+    return httpd_resp_send(req, data_body, data_body_len);
+}
+
+// Hand a command to the control task; never blocks on it
+static esp_err_t send_command(httpd_req_t *req, const system_command_t *cmd)
+{
+    httpd_resp_set_type(req, "application/json");
+    if (!irrigation_submit(cmd)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "{\"status\":\"busy\"}");
+        return ESP_OK;
+    }
+    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
     return ESP_OK;
 }
 
 // API handler for pump control
 static esp_err_t api_pump_handler(httpd_req_t *req)
 {
-    char buf[100];
-    int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (ret <= 0) {
-        httpd_resp_send_500(req);
+    system_command_t cmd;
+    if (command_json_read(req, COMMAND_JSON_PUMP, &cmd, 1) == 0) {
         return ESP_FAIL;
     }
-    buf[ret] = '\0';
 
-    cJSON *json = cJSON_Parse(buf);
-    if (json == NULL) {
-        httpd_resp_send_500(req);
-        return ESP_FAIL;
-    }
-
-    int pump = cJSON_GetObjectItem(json, "pump")->valueint;
-    bool state = cJSON_GetObjectItem(json, "state")->valueint;
-
-    if (pump == 1) {
-        // Manual mode stays ON regardless of pump state (ON/OFF)
-        // User must use auto mode toggle to return to automatic control
-        pump1_manual = true;  // Always enable manual mode when user controls pump
-        control_pump(RELAY_PUMP1, state);
-        pump1_running = state;
-        ESP_LOGI(TAG, "Pump 1 MANUAL %s - automatic control disabled until auto mode re-enabled", 
-                 state ? "ON" : "OFF");
-    } else if (pump == 2) {
-        // Manual mode stays ON regardless of pump state (ON/OFF)
-        // User must use auto mode toggle to return to automatic control
-        pump2_manual = true;  // Always enable manual mode when user controls pump
-        control_pump(RELAY_PUMP2, state);
-        pump2_running = state;
-        ESP_LOGI(TAG, "Pump 2 MANUAL %s - automatic control disabled until auto mode re-enabled", 
-                 state ? "ON" : "OFF");
-    }
-
-    cJSON_Delete(json);
-
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
-    return ESP_OK;
+    // Manual mode stays ON regardless of pump state (ON/OFF)
+    // User must use auto mode toggle to return to automatic control
+    bool zone = cmd.type == SYSTEM_CMD_SET_ZONE;
+    ESP_LOGI(TAG, "%s %d MANUAL %s - automatic control disabled until auto mode re-enabled",
+             zone ? "Zone" : "Pump", zone ? cmd.zone.zone + 1 : cmd.pump.pump,
+             (zone ? cmd.zone.on : cmd.pump.on) ? "ON" : "OFF");
+    return send_command(req, &cmd);
 }
 
 // API handler for auto mode
 static esp_err_t api_auto_handler(httpd_req_t *req)
 {
-    char buf[100];
-    int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (ret <= 0) {
-        httpd_resp_send_500(req);
+    system_command_t cmd;
+    if (command_json_read(req, COMMAND_JSON_AUTO, &cmd, 1) == 0) {
         return ESP_FAIL;
     }
-    buf[ret] = '\0';
 
-    cJSON *json = cJSON_Parse(buf);
-    if (json == NULL) {
-        httpd_resp_send_500(req);
-        return ESP_FAIL;
-    }
-
-    auto_mode = cJSON_GetObjectItem(json, "enabled")->valueint;
-    
-    // When auto mode is enabled, clear manual flags to allow automatic control
-    if (auto_mode) {
-        pump1_manual = false;
-        pump2_manual = false;
+    // When auto mode is enabled, the control task clears the manual flags
+    if (cmd.automode.enabled) {
         ESP_LOGI(TAG, "Auto mode ENABLED - clearing manual control flags");
     } else {
         ESP_LOGI(TAG, "Auto mode DISABLED - manual control only");
     }
-
-    cJSON_Delete(json);
-
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
-    return ESP_OK;
+    return send_command(req, &cmd);
 }
 
 // API handler for settings
 static esp_err_t api_settings_handler(httpd_req_t *req)
 {
-    char buf[200];
-    int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
-    if (ret <= 0) {
-        httpd_resp_send_500(req);
+    system_command_t cmd;
+    if (command_json_read(req, COMMAND_JSON_SETTINGS, &cmd, 1) == 0) {
         return ESP_FAIL;
     }
-    buf[ret] = '\0';
 
-    cJSON *json = cJSON_Parse(buf);
-    if (json == NULL) {
-        httpd_resp_send_500(req);
+    ESP_LOGI(TAG, "Settings updated (zone %d, 0 = all) - Threshold: %d, Pump: %d ms, Fert: %d ms, Interval: %d ms",
+             cmd.settings.zone + 1, cmd.settings.threshold, cmd.settings.pump_duration_ms,
+             cmd.settings.fert_duration_ms, cmd.settings.interval_ms);
+    return send_command(req, &cmd);
+}
+
+// API handler for a list of commands, applied together or not at all
+static esp_err_t api_batch_handler(httpd_req_t *req)
+{
+    system_command_t cmds[COMMAND_JSON_BATCH_MAX];
+    int n = command_json_read(req, COMMAND_JSON_BATCH, cmds, COMMAND_JSON_BATCH_MAX);
+    if (n == 0) {
         return ESP_FAIL;
     }
 
-    soil_dry_threshold = cJSON_GetObjectItem(json, "threshold")->valueint;
-    pump_duration_ms = cJSON_GetObjectItem(json, "pump_duration")->valueint;
-    fertilizer_duration_ms = cJSON_GetObjectItem(json, "fert_duration")->valueint;
-    check_interval_ms = cJSON_GetObjectItem(json, "interval")->valueint;
-
-    ESP_LOGI(TAG, "Settings updated - Threshold: %d, Pump: %d ms, Fert: %d ms, Interval: %d ms",
-             soil_dry_threshold, pump_duration_ms, fertilizer_duration_ms, check_interval_ms);
+    httpd_resp_set_type(req, "application/json");
+    if (!irrigation_submit_batch(cmds, (unsigned)n)) {
+        httpd_resp_set_status(req, "503 Service Unavailable");
+        httpd_resp_sendstr(req, "{\"status\":\"busy\"}");
+        return ESP_OK;
+    }
+    ESP_LOGI(TAG, "Batch of %d command(s) submitted", n);
+    char body[40];
+    snprintf(body, sizeof(body), "{\"status\":\"ok\",\"applied\":%d}", n);
+    return httpd_resp_sendstr(req, body);
+}
 
-    cJSON_Delete(json);
+// Handlers on the dashboard's hot paths run through timed_handler(), which
+// records their latency (parsing, work and sending) in a metrics histogram
+typedef struct {
+    esp_err_t (*handler)(httpd_req_t *req);
+    metric_hist_t hist;
+} timed_handler_t;
+
+static const timed_handler_t timed_root = { root_handler, METRIC_HTTP_ROOT };
+static const timed_handler_t timed_data = { api_data_handler, METRIC_HTTP_DATA };
+static const timed_handler_t timed_pump = { api_pump_handler, METRIC_HTTP_PUMP };
+static const timed_handler_t timed_auto = { api_auto_handler, METRIC_HTTP_AUTO };
+static const timed_handler_t timed_settings = { api_settings_handler, METRIC_HTTP_SETTINGS };
+static const timed_handler_t timed_batch = { api_batch_handler, METRIC_HTTP_BATCH };
+
+static esp_err_t timed_handler(httpd_req_t *req)
+{
+    const timed_handler_t *timed = req->user_ctx;
+    int64_t start = esp_timer_get_time();
+    esp_err_t err = timed->handler(req);
+    metrics_observe(timed->hist, (uint32_t)(esp_timer_get_time() - start));
+    metrics_boot_mark(METRIC_BOOT_HTTP);
+    return err;
+}
 
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_sendstr(req, "{\"status\":\"ok\"}");
-    return ESP_OK;
+// Sessions closing for any reason: drop event subscribers before the fd is reused
+static void web_close_fn(httpd_handle_t hd, int sockfd)
+{
+    sse_forget(sockfd);
+    close(sockfd);
 }
 
 httpd_handle_t start_webserver(void)
 {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.uri_match_fn = httpd_uri_match_wildcard;
-
-    if (httpd_start(&server, &config) == ESP_OK) {
+    config.max_uri_handlers = 20;   // 17 registered, default is 8
+    config.close_fn = web_close_fn;
+    config.stack_size = rt_stack(RT_TASK_HTTPD);
+    config.task_priority = rt_priority(RT_TASK_HTTPD);
+    config.core_id = rt_core(RT_TASK_HTTPD);
+    config.max_open_sockets = WEB_MAX_SOCKETS;
+    config.backlog_conn = WEB_BACKLOG;
+    config.lru_purge_enable = true;
+    config.keep_alive_enable = true;
+    config.keep_alive_idle = WEB_KEEPALIVE_IDLE_S;
+    config.keep_alive_interval = WEB_KEEPALIVE_INTVL_S;
+    config.keep_alive_count = WEB_KEEPALIVE_COUNT;
+    boot_id = esp_random();
+
+    if (http_workers_start() == ESP_OK && httpd_start(&server, &config) == ESP_OK) {
+        // The page is the largest response: served from a worker
         httpd_uri_t root_uri = {
             .uri = "/",
             .method = HTTP_GET,
-            .handler = root_handler
+            .handler = timed_handler,
+            .user_ctx = (void *)&timed_root
         };
-        httpd_register_uri_handler(server, &root_uri);
+        http_workers_register(server, &root_uri);
 
         httpd_uri_t api_data_uri = {
             .uri = "/api/data",
             .method = HTTP_GET,
-            .handler = api_data_handler
+            .handler = timed_handler,
+            .user_ctx = (void *)&timed_data
         };
         httpd_register_uri_handler(server, &api_data_uri);
 
         httpd_uri_t api_pump_uri = {
             .uri = "/api/pump",
             .method = HTTP_POST,
-            .handler = api_pump_handler
+            .handler = timed_handler,
+            .user_ctx = (void *)&timed_pump
         };
         httpd_register_uri_handler(server, &api_pump_uri);
 
         httpd_uri_t api_auto_uri = {
             .uri = "/api/auto",
             .method = HTTP_POST,
-            .handler = api_auto_handler
+            .handler = timed_handler,
+            .user_ctx = (void *)&timed_auto
         };
         httpd_register_uri_handler(server, &api_auto_uri);
 
         httpd_uri_t api_settings_uri = {
             .uri = "/api/settings",
             .method = HTTP_POST,
-            .handler = api_settings_handler
+            .handler = timed_handler,
+            .user_ctx = (void *)&timed_settings
         };
         httpd_register_uri_handler(server, &api_settings_uri);
 
+        httpd_uri_t api_batch_uri = {
+            .uri = "/api/batch",
+            .method = HTTP_POST,
+            .handler = timed_handler,
+            .user_ctx = (void *)&timed_batch
+        };
+        httpd_register_uri_handler(server, &api_batch_uri);
+
+        sse_register(server);
+        history_api_register(server);
+        log_api_register(server);
+        metrics_api_register(server);
+        schedule_api_register(server);
+        bench_api_register(server);
+        ota_api_register(server);
+
         ESP_LOGI(TAG, "✅ Web server started successfully");
         return server;
     }
@@ -4,6 +4,17 @@
 #include "esp_http_server.h"
 #include "irrigation_control.h"
 
+// Server tuning for several dashboards at once. Sessions are kept open
+// between requests and the least recently used one is dropped when a new
+// client needs its slot; TCP keep-alive probes reap clients that vanished
+// without closing. LWIP_MAX_SOCKETS (sdkconfig) must cover WEB_MAX_SOCKETS
+// plus the 3 httpd uses internally.
+#define WEB_MAX_SOCKETS         12
+#define WEB_BACKLOG             8
+#define WEB_KEEPALIVE_IDLE_S    10
+#define WEB_KEEPALIVE_INTVL_S   5
+#define WEB_KEEPALIVE_COUNT     3
+
 httpd_handle_t start_webserver(void);
 void stop_webserver(httpd_handle_t server);
 
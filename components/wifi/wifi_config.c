@@ -1,35 +1,132 @@
 #include "wifi_config.h"
 #include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "nvs.h"
+#include "metrics.h"
+#include <string.h>
 
 static const char *TAG = "WIFI";
 static EventGroupHandle_t s_wifi_event_group;
-static int s_retry_num = 0;
+static StaticEventGroup_t s_wifi_event_group_buf;
+static esp_timer_handle_t s_retry_timer;
+static int s_attempts = 0;          // failed attempts since the last connection
+static bool s_ever_connected = false;
+static bool s_using_cache = false;  // current config points at the cached AP
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t channel;
+} wifi_ap_cache_t;
+
+static bool ap_cache_load(wifi_ap_cache_t *out)
+{
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    size_t len = sizeof(*out);
+    esp_err_t err = nvs_get_blob(nvs, "ap", out, &len);
+    nvs_close(nvs);
+    return err == ESP_OK && len == sizeof(*out) && out->channel != 0;
+}
+
+// Only written when the AP changed, so a normal reboot costs no flash write
+static void ap_cache_store(const uint8_t *bssid, uint8_t channel)
+{
+    wifi_ap_cache_t old, cache = { .channel = channel };
+    memcpy(cache.bssid, bssid, sizeof(cache.bssid));
+    if (ap_cache_load(&old) && memcmp(&old, &cache, sizeof(cache)) == 0) {
+        return;
+    }
+    nvs_handle_t nvs;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_blob(nvs, "ap", &cache, sizeof(cache)) == ESP_OK) {
+        nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+}
+
+static void set_sta_config(const wifi_ap_cache_t *ap)
+{
+    wifi_config_t wifi_config = {
+        .sta = {
+            .ssid = WIFI_SSID,
+            .password = WIFI_PASS,
+            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
+        },
+    };
+    if (ap != NULL) {
+        // Straight to the known AP on its channel instead of scanning them all
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, ap->bssid, sizeof(ap->bssid));
+        wifi_config.sta.channel = ap->channel;
+    }
+    s_using_cache = ap != NULL;
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+}
+
+static uint32_t backoff_ms(int attempts)
+{
+    uint32_t ms = WIFI_BACKOFF_MAX_MS;
+    if (attempts < 16 && ((uint32_t)WIFI_BACKOFF_MIN_MS << attempts) < WIFI_BACKOFF_MAX_MS) {
+        ms = (uint32_t)WIFI_BACKOFF_MIN_MS << attempts;
+    }
+    return ms - ms / 4 + esp_random() % (ms / 2 + 1);
+}
+
+static void retry_cb(void *arg)
+{
+    esp_wifi_connect();     // fails harmlessly while WiFi is stopped for sleep
+}
 
 static void event_handler(void* arg, esp_event_base_t event_base,
                           int32_t event_id, void* event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        // Boot or wake from sleep: try now, not after an old backoff
+        esp_timer_stop(s_retry_timer);
         esp_wifi_connect();
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        wifi_event_sta_connected_t* event = (wifi_event_sta_connected_t*) event_data;
+        ap_cache_store(event->bssid, event->channel);
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < WIFI_MAXIMUM_RETRY) {
-            esp_wifi_connect();
-            s_retry_num++;
-            ESP_LOGI(TAG, "Retry to connect to the AP");
-        } else {
-            xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
+        wifi_event_sta_disconnected_t* event = (wifi_event_sta_disconnected_t*) event_data;
+        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        metrics_count(METRIC_WIFI_DISCONNECTS);
+        if (s_using_cache && event->reason == WIFI_REASON_NO_AP_FOUND) {
+            // AP replaced or moved channel: fall back to a full scan
+            ESP_LOGW(TAG, "Cached AP not found - scanning all channels");
+            set_sta_config(NULL);
+        }
+        uint32_t delay_ms = backoff_ms(s_attempts);
+        if (s_attempts < 16) {
+            s_attempts++;
         }
-        ESP_LOGI(TAG,"Connect to the AP fail");
+        ESP_LOGI(TAG, "Connect to the AP fail (reason %d) - retry in %lu ms",
+                 event->reason, (unsigned long)delay_ms);
+        esp_timer_stop(s_retry_timer);
+        esp_timer_start_once(s_retry_timer, (uint64_t)delay_ms * 1000);
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(TAG, "Got IP:" IPSTR, IP2STR(&event->ip_info.ip));
-        s_retry_num = 0;
+        s_attempts = 0;
+        if (s_ever_connected) {
+            metrics_count(METRIC_WIFI_RECONNECTS);
+        }
+        s_ever_connected = true;
+        metrics_boot_mark(METRIC_BOOT_WIFI);
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
 
 void wifi_init_sta(void)
 {
-    s_wifi_event_group = xEventGroupCreate();
+    s_wifi_event_group = xEventGroupCreateStatic(&s_wifi_event_group_buf);
+    const esp_timer_create_args_t retry_args = { .callback = retry_cb, .name = "wifi_retry" };
+    ESP_ERROR_CHECK(esp_timer_create(&retry_args, &s_retry_timer));
 
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
@@ -51,28 +148,21 @@ void wifi_init_sta(void)
                                                         NULL,
                                                         &instance_got_ip));
 
-    wifi_config_t wifi_config = {
-        .sta = {
-            .ssid = WIFI_SSID,
-            .password = WIFI_PASS,
-            .threshold.authmode = WIFI_AUTH_WPA2_PSK,
-        },
-    };
+    wifi_ap_cache_t ap;
+    bool cached = ap_cache_load(&ap);
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
+    set_sta_config(cached ? &ap : NULL);
     ESP_ERROR_CHECK(esp_wifi_start());
 
-    ESP_LOGI(TAG, "WiFi initialization finished.");
-
-    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
-            WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
-            pdFALSE,
-            pdFALSE,
-            portMAX_DELAY);
-
-    if (bits & WIFI_CONNECTED_BIT) {
-        ESP_LOGI(TAG, "Connected to AP SSID:%s", WIFI_SSID);
-    } else if (bits & WIFI_FAIL_BIT) {
-        ESP_LOGI(TAG, "Failed to connect to SSID:%s", WIFI_SSID);
+    if (cached) {
+        ESP_LOGI(TAG, "Connecting to SSID:%s (cached AP on channel %d)", WIFI_SSID, ap.channel);
+    } else {
+        ESP_LOGI(TAG, "Connecting to SSID:%s (scanning)", WIFI_SSID);
     }
 }
+
+bool wifi_is_connected(void)
+{
+    return s_wifi_event_group != NULL &&
+           (xEventGroupGetBits(s_wifi_event_group) & WIFI_CONNECTED_BIT);
+}
@@ -1,6 +1,7 @@
 #ifndef WIFI_CONFIG_H
 #define WIFI_CONFIG_H
 
+#include <stdbool.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include "esp_wifi.h"
@@ -10,11 +11,21 @@
 // WiFi Configuration - CHANGE THESE TO YOUR NETWORK
 #define WIFI_SSID      "CAMTECH-STUDENT"
 #define WIFI_PASS      "2!CamTech!@$"
-#define WIFI_MAXIMUM_RETRY  5
+
+// Reconnect backoff: the wait doubles after every failed attempt, up to the
+// maximum, with +/-25% jitter so a power cut doesn't reconnect every board
+// at once. Never gives up; a connection resets it.
+#define WIFI_BACKOFF_MIN_MS     500
+#define WIFI_BACKOFF_MAX_MS     60000
+
+// Last AP (BSSID + channel) kept in NVS so a reboot skips the full scan
+#define WIFI_NVS_NAMESPACE      "wifi"
 
 #define WIFI_CONNECTED_BIT BIT0
-#define WIFI_FAIL_BIT      BIT1
 
+// Start the station and return at once: connecting and reconnecting happen
+// in the background, so control never waits for the network
 void wifi_init_sta(void);
+bool wifi_is_connected(void);
 
 #endif // WIFI_CONFIG_H
@@ -0,0 +1,137 @@
+// Host runner for the firmware microbenchmarks (components/microbench):
+// the same cases as on the board, timed in ns per operation, with the heap
+// allocations each operation makes. Prints bench.<case>.* lines for
+// tools/bench_compare.py. See docs/HOST_SIMULATION.md.
+//
+//   ./build-host/firmware_bench -o /tmp/bench.txt
+
+#include "microbench.h"
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Count every allocation in the process by wrapping glibc's allocator
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static atomic_ulong allocs;
+
+void *malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&allocs, 1, memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+    atomic_fetch_add_explicit(&allocs, 1, memory_order_relaxed);
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    atomic_fetch_add_explicit(&allocs, 1, memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -o, --output FILE      also write the bench.* lines to FILE\n"
+            "  -r, --runs N           timed runs per case, the fastest counts (default %d)\n"
+            "  -x, --scale X          iterations per run times X (default 1)\n"
+            "  -q, --quiet            print nothing (with -o)\n",
+            argv0, MICROBENCH_RUNS);
+}
+
+int main(int argc, char **argv)
+{
+    const char *out_path = NULL;
+    int runs = MICROBENCH_RUNS;
+    double scale = 1.0;
+    bool quiet = false;
+    static const struct option long_opts[] = {
+        { "output", required_argument, NULL, 'o' },
+        { "runs", required_argument, NULL, 'r' },
+        { "scale", required_argument, NULL, 'x' },
+        { "quiet", no_argument, NULL, 'q' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "o:r:x:qh", long_opts, NULL)) != -1) {
+        switch (c) {
+        case 'o': out_path = optarg; break;
+        case 'r': runs = atoi(optarg); break;
+        case 'x': scale = atof(optarg); break;
+        case 'q': quiet = true; break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+    if (runs < 1 || scale <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *out = NULL;
+    if (out_path != NULL && (out = fopen(out_path, "w")) == NULL) {
+        perror(out_path);
+        return 1;
+    }
+    if (out != NULL) {
+        // The benchmarked code, for whoever finds this file as a baseline
+        fprintf(out, "# host/bench/firmware_bench: soil_filter.c, irrigation_decide() in irrigation_control.c,\n"
+                     "# state_json.c + json_writer.c, command_json.c + json_reader.c\n");
+    }
+
+    int count;
+    const microbench_case_t *cases = microbench_cases(&count);
+    for (int i = 0; i < count; i++) {
+        const microbench_case_t *bc = &cases[i];
+        uint32_t iterations = (uint32_t)(bc->iterations * scale) ? (uint32_t)(bc->iterations * scale) : 1;
+        bc->setup();
+        bc->run(iterations / 10);   // warm the caches
+        uint64_t best = UINT64_MAX;
+        unsigned long alloc_start = atomic_load(&allocs);
+        for (int r = 0; r < runs; r++) {
+            uint64_t start = now_ns();
+            bc->run(iterations);
+            uint64_t ns = now_ns() - start;
+            best = ns < best ? ns : best;
+        }
+        unsigned long alloc_count = atomic_load(&allocs) - alloc_start;
+        char lines[2][128];
+        snprintf(lines[0], sizeof(lines[0]), "bench.%s.ns_per_op=%.1f",
+                 bc->name, (double)best / iterations);
+        snprintf(lines[1], sizeof(lines[1]), "bench.%s.allocs_per_op=%.2f",
+                 bc->name, (double)alloc_count / ((double)iterations * runs));
+        for (int l = 0; l < 2; l++) {
+            if (!quiet) {
+                printf("%s\n", lines[l]);
+            }
+            if (out != NULL) {
+                fprintf(out, "%s\n", lines[l]);
+            }
+        }
+    }
+    if (out != NULL) {
+        fclose(out);
+    }
+    return 0;
+}
@@ -0,0 +1,285 @@
+// Continuous (DMA) ADC driver on the virtual clock.
+//
+// One counted "adc_dma" task plays the digital controller: every frame period
+// (conv_frame_size / result bytes / sample_freq_hz) it converts the pattern
+// table round-robin, appends the frame to the pool and fires on_conv_done.
+// adc_continuous_read() drains the pool and blocks on it like the driver's
+// ring buffer does.
+
+#include "esp_adc/adc_continuous.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sim_hal.h"
+#include "sim_kernel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+struct adc_continuous_ctx_t {
+    uint8_t *pool;
+    uint32_t pool_size;
+    uint32_t pool_head;     // read index
+    uint32_t pool_used;
+    uint32_t frame_size;
+    bool flush_pool;
+
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX];
+    uint32_t pattern_num;
+    uint32_t sample_freq_hz;
+    adc_digi_output_format_t format;
+    bool configured;
+
+    adc_continuous_evt_cbs_t cbs;
+    void *user_data;
+
+    bool running;
+    bool task_started;
+    uint64_t start_us;
+    uint64_t frames;
+    uint8_t *frame;
+    uint16_t *scratch;
+};
+
+__attribute__((weak)) void sim_hal_fill_adc(int unit, int channel, uint16_t *out, size_t n)
+{
+    (void)unit;
+    (void)channel;
+    memset(out, 0, n * sizeof(*out));
+}
+
+static uint64_t frame_due_us(const struct adc_continuous_ctx_t *h, uint64_t frame_no)
+{
+    uint64_t convs = (uint64_t)h->frame_size / SOC_ADC_DIGI_RESULT_BYTES;
+    return h->start_us + frame_no * convs * 1000000ULL / h->sample_freq_hz;
+}
+
+static void build_frame(struct adc_continuous_ctx_t *h)
+{
+    uint32_t convs = h->frame_size / SOC_ADC_DIGI_RESULT_BYTES;
+    adc_digi_output_data_t *out = (adc_digi_output_data_t *)h->frame;
+    for (uint32_t p = 0; p < h->pattern_num; p++) {
+        // Conversions p, p + n, p + 2n, ... belong to pattern entry p
+        uint32_t count = convs > p ? (convs - p + h->pattern_num - 1) / h->pattern_num : 0;
+        const adc_digi_pattern_config_t *pat = &h->pattern[p];
+        sim_hal_fill_adc(pat->unit, pat->channel, h->scratch, count);
+        for (uint32_t k = 0; k < count; k++) {
+            adc_digi_output_data_t d = { .val = 0 };
+            uint16_t v = h->scratch[k] > 4095 ? 4095 : h->scratch[k];
+            if (h->format == ADC_DIGI_OUTPUT_FORMAT_TYPE1) {
+                d.type1.data = v;
+                d.type1.channel = pat->channel;
+            } else {
+                d.type2.data = v >> 1;
+                d.type2.channel = pat->channel;
+                d.type2.unit = pat->unit;
+            }
+            out[p + k * h->pattern_num] = d;
+        }
+    }
+}
+
+// Must hold sim_lock(). Returns false if the frame was dropped.
+static bool pool_push_locked(struct adc_continuous_ctx_t *h)
+{
+    if (h->pool_size - h->pool_used < h->frame_size) {
+        if (!h->flush_pool) {
+            return false;
+        }
+        h->pool_head = 0;
+        h->pool_used = 0;
+    }
+    uint32_t tail = (h->pool_head + h->pool_used) % h->pool_size;
+    uint32_t first = h->pool_size - tail < h->frame_size ? h->pool_size - tail : h->frame_size;
+    memcpy(h->pool + tail, h->frame, first);
+    memcpy(h->pool, h->frame + first, h->frame_size - first);
+    h->pool_used += h->frame_size;
+    sim_wake_all_locked(&h->pool);
+    return true;
+}
+
+static void adc_dma_task(void *arg)
+{
+    struct adc_continuous_ctx_t *h = arg;
+    for (;;) {
+        sim_lock();
+        while (!h->running) {
+            sim_block_locked(h, SIM_FOREVER);
+        }
+        uint64_t due = frame_due_us(h, h->frames + 1);
+        while (h->running && sim_now_us_locked() < due) {
+            sim_block_locked(h, due);
+        }
+        if (!h->running) {
+            sim_unlock();
+            continue;
+        }
+        h->frames++;
+        sim_unlock();
+
+        build_frame(h);
+
+        sim_lock();
+        bool stored = h->running && pool_push_locked(h);
+        sim_unlock();
+
+        adc_continuous_evt_data_t edata = { .conv_frame_buffer = h->frame, .size = h->frame_size };
+        if (!stored && h->cbs.on_pool_ovf) {
+            h->cbs.on_pool_ovf(h, &edata, h->user_data);
+        }
+        if (h->cbs.on_conv_done) {
+            h->cbs.on_conv_done(h, &edata, h->user_data);
+        }
+    }
+}
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *hdl_config,
+                                    adc_continuous_handle_t *ret_handle)
+{
+    if (hdl_config == NULL || ret_handle == NULL || hdl_config->conv_frame_size == 0 ||
+        hdl_config->conv_frame_size % SOC_ADC_DIGI_DATA_BYTES_PER_CONV != 0 ||
+        hdl_config->max_store_buf_size < hdl_config->conv_frame_size) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct adc_continuous_ctx_t *h = calloc(1, sizeof(*h));
+    if (h == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    h->pool_size = hdl_config->max_store_buf_size;
+    h->frame_size = hdl_config->conv_frame_size;
+    h->flush_pool = hdl_config->flags.flush_pool;
+    h->pool = malloc(h->pool_size);
+    h->frame = malloc(h->frame_size);
+    h->scratch = malloc(h->frame_size / SOC_ADC_DIGI_RESULT_BYTES * sizeof(uint16_t));
+    if (h->pool == NULL || h->frame == NULL || h->scratch == NULL) {
+        free(h->pool);
+        free(h->frame);
+        free(h->scratch);
+        free(h);
+        return ESP_ERR_NO_MEM;
+    }
+    *ret_handle = h;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t h, const adc_continuous_config_t *config)
+{
+    if (h == NULL || config == NULL || h->running || config->pattern_num == 0 ||
+        config->pattern_num > SOC_ADC_PATT_LEN_MAX ||
+        config->sample_freq_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW ||
+        config->sample_freq_hz > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < config->pattern_num; i++) {
+        const adc_digi_pattern_config_t *p = &config->adc_pattern[i];
+        if (p->unit > ADC_UNIT_2 || p->channel >= SOC_ADC_CHANNEL_NUM(p->unit)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (config->conv_mode == ADC_CONV_SINGLE_UNIT_1 && p->unit != ADC_UNIT_1) {
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    memcpy(h->pattern, config->adc_pattern, config->pattern_num * sizeof(h->pattern[0]));
+    h->pattern_num = config->pattern_num;
+    h->sample_freq_hz = config->sample_freq_hz;
+    h->format = config->format;
+    h->configured = true;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_register_event_callbacks(adc_continuous_handle_t h,
+                                                  const adc_continuous_evt_cbs_t *cbs, void *user_data)
+{
+    if (h == NULL || cbs == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (h->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    h->cbs = *cbs;
+    h->user_data = user_data;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t h)
+{
+    if (h == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    if (h->running || !h->configured) {
+        sim_unlock();
+        return ESP_ERR_INVALID_STATE;
+    }
+    h->running = true;
+    h->start_us = sim_now_us_locked();
+    h->frames = 0;
+    bool spawn = !h->task_started;
+    h->task_started = true;
+    sim_wake_all_locked(h);
+    sim_unlock();
+    if (spawn) {
+        sim_task_spawn("adc_dma", adc_dma_task, h, 2048, configMAX_PRIORITIES - 1, tskNO_AFFINITY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_read(adc_continuous_handle_t h, uint8_t *buf, uint32_t length_max,
+                              uint32_t *out_length, uint32_t timeout_ms)
+{
+    if (h == NULL || buf == NULL || out_length == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    uint64_t deadline = timeout_ms == ADC_MAX_DELAY ? SIM_FOREVER
+                        : sim_now_us_locked() + (uint64_t)timeout_ms * 1000;
+    while (h->pool_used == 0 && timeout_ms != 0 && sim_now_us_locked() < deadline) {
+        sim_block_locked(&h->pool, deadline);
+    }
+    uint32_t n = h->pool_used < length_max ? h->pool_used : length_max;
+    for (uint32_t i = 0; i < n; i++) {
+        buf[i] = h->pool[(h->pool_head + i) % h->pool_size];
+    }
+    h->pool_head = (h->pool_head + n) % h->pool_size;
+    h->pool_used -= n;
+    sim_unlock();
+    *out_length = n;
+    return n ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t h)
+{
+    if (h == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    bool was_running = h->running;
+    h->running = false;
+    sim_wake_all_locked(h);
+    sim_unlock();
+    return was_running ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+esp_err_t adc_continuous_flush_pool(adc_continuous_handle_t h)
+{
+    if (h == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    h->pool_head = 0;
+    h->pool_used = 0;
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_deinit(adc_continuous_handle_t h)
+{
+    if (h == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (h->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // The engine task parks forever on a stopped handle; keep the context
+    // alive for it rather than tearing the task down underneath.
+    return ESP_OK;
+}
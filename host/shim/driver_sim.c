@@ -0,0 +1,290 @@
+// GPIO driver shim backed by sim_hal.h.
+
+#include "driver/gpio.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "soc/gpio_reg.h"
+#include "soc/soc.h"
+#include "sim_hal.h"
+#include "sim_kernel.h"
+
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Relay modules idle high through their input pull-ups, so start latched high
+static atomic_int s_out_level[GPIO_NUM_MAX] = {
+    [0 ... GPIO_NUM_MAX - 1] = 1,
+};
+static uint64_t s_output_mask = 0;
+
+// Edge interrupts: the "gpio_intr" task compares input levels whenever the
+// plant says one may have changed and runs the handlers, as the GPIO ISR would
+typedef struct {
+    gpio_int_type_t type;
+    bool enabled;
+    gpio_isr_t handler;
+    void *arg;
+    int level;              // as last seen by the interrupt task
+} pin_intr_t;
+
+static pin_intr_t s_intr[GPIO_NUM_MAX];
+static bool s_isr_service;
+static uint32_t s_input_gen;    // bumped by sim_gpio_inputs_changed(); under sim_lock()
+
+__attribute__((weak)) int sim_hal_read_input(int gpio)
+{
+    (void)gpio;
+    return 0;
+}
+
+__attribute__((weak)) void sim_hal_output_changed(int gpio, int level, uint64_t now_us)
+{
+    (void)gpio;
+    (void)level;
+    (void)now_us;
+}
+
+__attribute__((weak)) uint64_t sim_hal_next_input_change_us(void)
+{
+    return SIM_FOREVER;
+}
+
+int sim_hal_output_level(int gpio)
+{
+    if (gpio < 0 || gpio >= GPIO_NUM_MAX) {
+        return 0;
+    }
+    return atomic_load(&s_out_level[gpio]);
+}
+
+esp_err_t gpio_config(const gpio_config_t *pGPIOConfig)
+{
+    if (pGPIOConfig == NULL || (pGPIOConfig->pin_bit_mask >> GPIO_NUM_MAX) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pGPIOConfig->mode & GPIO_MODE_OUTPUT) {
+        s_output_mask |= pGPIOConfig->pin_bit_mask;
+    } else {
+        s_output_mask &= ~pGPIOConfig->pin_bit_mask;
+    }
+    sim_lock();
+    for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+        if (pGPIOConfig->pin_bit_mask & (1ULL << pin)) {
+            s_intr[pin].type = pGPIOConfig->intr_type;
+            s_intr[pin].enabled = pGPIOConfig->intr_type != GPIO_INTR_DISABLE;
+        }
+    }
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_output_mask &= ~(1ULL << gpio_num);
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mode & GPIO_MODE_OUTPUT) {
+        s_output_mask |= 1ULL << gpio_num;
+    } else {
+        s_output_mask &= ~(1ULL << gpio_num);
+    }
+    return ESP_OK;
+}
+
+static void set_output(int gpio, int level, uint64_t now_us)
+{
+    int old_level = atomic_exchange(&s_out_level[gpio], level);
+    if (old_level != level) {
+        sim_hal_output_changed(gpio, level, now_us);
+    }
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    set_output(gpio_num, level ? 1 : 0, sim_now_us());
+    return ESP_OK;
+}
+
+// One register write switches every pin in the mask at the same instant
+void sim_reg_write(uint32_t addr, uint32_t value)
+{
+    int base, level;
+    switch (addr) {
+    case GPIO_OUT_W1TS_REG:  base = 0;  level = 1; break;
+    case GPIO_OUT_W1TC_REG:  base = 0;  level = 0; break;
+    case GPIO_OUT1_W1TS_REG: base = 32; level = 1; break;
+    case GPIO_OUT1_W1TC_REG: base = 32; level = 0; break;
+    default:
+        return;
+    }
+    uint64_t now = sim_now_us();
+    for (int bit = 0; bit < 32 && base + bit < GPIO_NUM_MAX; bit++) {
+        if (value & (1U << bit)) {
+            set_output(base + bit, level, now);
+        }
+    }
+}
+
+uint32_t sim_reg_read(uint32_t addr)
+{
+    int base = addr == GPIO_OUT_REG ? 0 : (addr == GPIO_OUT1_REG ? 32 : -1);
+    uint32_t value = 0;
+    for (int bit = 0; base >= 0 && bit < 32 && base + bit < GPIO_NUM_MAX; bit++) {
+        value |= (uint32_t)atomic_load(&s_out_level[base + bit]) << bit;
+    }
+    return value;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return 0;
+    }
+    if (s_output_mask & (1ULL << gpio_num)) {
+        return atomic_load(&s_out_level[gpio_num]);
+    }
+    return sim_hal_read_input(gpio_num) ? 1 : 0;
+}
+
+static bool edge_matches(gpio_int_type_t type, int level)
+{
+    switch (type) {
+    case GPIO_INTR_ANYEDGE:     return true;
+    case GPIO_INTR_POSEDGE:     return level == 1;
+    case GPIO_INTR_NEGEDGE:     return level == 0;
+    default:                    return false;   // level interrupts are not modelled
+    }
+}
+
+static void gpio_intr_task(void *arg)
+{
+    (void)arg;
+    for (;;) {
+        sim_lock();
+        uint32_t gen = s_input_gen;
+        sim_unlock();
+
+        // The plant takes its own lock, so ask it without holding sim_lock()
+        uint64_t due = sim_hal_next_input_change_us();
+
+        sim_lock();
+        while (s_input_gen == gen && sim_now_us_locked() < due) {
+            sim_block_locked(&s_input_gen, due);
+        }
+        sim_unlock();
+
+        for (int pin = 0; pin < GPIO_NUM_MAX; pin++) {
+            sim_lock();
+            pin_intr_t intr = s_intr[pin];
+            sim_unlock();
+            if (intr.handler == NULL || (s_output_mask & (1ULL << pin))) {
+                continue;
+            }
+            int level = sim_hal_read_input(pin) ? 1 : 0;
+            if (level == intr.level) {
+                continue;
+            }
+            sim_lock();
+            s_intr[pin].level = level;
+            sim_unlock();
+            if (intr.enabled && edge_matches(intr.type, level)) {
+                intr.handler(intr.arg);
+            }
+        }
+    }
+}
+
+void sim_gpio_inputs_changed(void)
+{
+    sim_lock();
+    s_input_gen++;
+    sim_wake_all_locked(&s_input_gen);
+    sim_unlock();
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t gpio_num, gpio_int_type_t intr_type)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    s_intr[gpio_num].type = intr_type;
+    sim_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t set_intr_enabled(gpio_num_t gpio_num, bool enabled)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    s_intr[gpio_num].enabled = enabled;
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t gpio_num)
+{
+    return set_intr_enabled(gpio_num, true);
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t gpio_num)
+{
+    return set_intr_enabled(gpio_num, false);
+}
+
+esp_err_t gpio_install_isr_service(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    sim_lock();
+    bool installed = s_isr_service;
+    s_isr_service = true;
+    sim_unlock();
+    if (installed) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    sim_task_spawn("gpio_intr", gpio_intr_task, NULL, 2048, configMAX_PRIORITIES - 1, tskNO_AFFINITY);
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t gpio_num, gpio_isr_t isr_handler, void *args)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX || isr_handler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int level = sim_hal_read_input(gpio_num) ? 1 : 0;
+    sim_lock();
+    if (!s_isr_service) {
+        sim_unlock();
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_intr[gpio_num].handler = isr_handler;
+    s_intr[gpio_num].arg = args;
+    s_intr[gpio_num].level = level;     // edges from here on
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    s_intr[gpio_num].handler = NULL;
+    sim_unlock();
+    return ESP_OK;
+}
@@ -0,0 +1,137 @@
+// Default event loop: a FreeRTOS queue drained by the "sys_evt" task.
+
+#include "esp_event.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct handler_entry {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t fn;
+    void *arg;
+    struct handler_entry *next;
+} handler_entry_t;
+
+typedef struct {
+    esp_event_base_t base;
+    int32_t id;
+    void *data;
+} posted_event_t;
+
+static QueueHandle_t s_queue = NULL;
+static handler_entry_t *s_handlers = NULL;
+static portMUX_TYPE s_handlers_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static bool matches(const handler_entry_t *h, esp_event_base_t base, int32_t id)
+{
+    bool base_ok = h->base == ESP_EVENT_ANY_BASE || h->base == base || strcmp(h->base, base) == 0;
+    bool id_ok = h->id == ESP_EVENT_ANY_ID || h->id == id;
+    return base_ok && id_ok;
+}
+
+static void event_task(void *arg)
+{
+    (void)arg;
+    posted_event_t ev;
+    while (1) {
+        if (xQueueReceive(s_queue, &ev, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        taskENTER_CRITICAL(&s_handlers_mux);
+        handler_entry_t *list = s_handlers;
+        taskEXIT_CRITICAL(&s_handlers_mux);
+        // Handlers are only ever prepended, so the snapshot stays valid
+        for (handler_entry_t *h = list; h; h = h->next) {
+            if (matches(h, ev.base, ev.id)) {
+                h->fn(h->arg, ev.base, ev.id, ev.data);
+            }
+        }
+        free(ev.data);
+    }
+}
+
+esp_err_t esp_event_loop_create_default(void)
+{
+    if (s_queue != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_queue = xQueueCreate(32, sizeof(posted_event_t));
+    if (s_queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    xTaskCreate(event_task, "sys_evt", 2304, NULL, 20, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_loop_delete_default(void)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_event_handler_instance_register(esp_event_base_t event_base, int32_t event_id,
+                                              esp_event_handler_t event_handler, void *event_handler_arg,
+                                              esp_event_handler_instance_t *instance)
+{
+    handler_entry_t *h = calloc(1, sizeof(*h));
+    if (h == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    h->base = event_base;
+    h->id = event_id;
+    h->fn = event_handler;
+    h->arg = event_handler_arg;
+    taskENTER_CRITICAL(&s_handlers_mux);
+    h->next = s_handlers;
+    s_handlers = h;
+    taskEXIT_CRITICAL(&s_handlers_mux);
+    if (instance) {
+        *instance = h;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_register(esp_event_base_t event_base, int32_t event_id,
+                                     esp_event_handler_t event_handler, void *event_handler_arg)
+{
+    return esp_event_handler_instance_register(event_base, event_id, event_handler,
+                                               event_handler_arg, NULL);
+}
+
+esp_err_t esp_event_handler_instance_unregister(esp_event_base_t event_base, int32_t event_id,
+                                                esp_event_handler_instance_t instance)
+{
+    (void)event_base;
+    (void)event_id;
+    handler_entry_t *h = instance;
+    if (h == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Disarm rather than unlink so in-flight dispatch stays safe
+    h->id = INT32_MIN;
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id, const void *event_data,
+                         size_t event_data_size, TickType_t ticks_to_wait)
+{
+    if (s_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    posted_event_t ev = { .base = event_base, .id = event_id, .data = NULL };
+    if (event_data && event_data_size) {
+        ev.data = malloc(event_data_size);
+        if (ev.data == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(ev.data, event_data, event_data_size);
+    }
+    if (xQueueSend(s_queue, &ev, ticks_to_wait) != pdTRUE) {
+        free(ev.data);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
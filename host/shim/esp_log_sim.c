@@ -0,0 +1,68 @@
+#include "esp_log.h"
+#include "esp_err.h"
+#include "esp_ota_ops.h"
+#include "sim_kernel.h"
+
+#include <pthread.h>
+#include <stdio.h>
+
+static esp_log_level_t s_level = ESP_LOG_INFO;
+static pthread_mutex_t s_out_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    // Per-tag levels are not modelled; "*" and any tag set the default
+    (void)tag;
+    s_level = level;
+}
+
+esp_log_level_t esp_log_get_default_level(void)
+{
+    return s_level;
+}
+
+esp_log_level_t esp_log_level_get(const char *tag)
+{
+    (void)tag;
+    return s_level;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)(sim_now_us() / 1000);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    (void)tag;
+    if (level > s_level) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&s_out_lock);
+    vfprintf(stdout, format, args);
+    pthread_mutex_unlock(&s_out_lock);
+    va_end(args);
+}
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:                  return "ESP_OK";
+    case ESP_FAIL:                return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:          return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:     return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:   return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:    return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:       return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:   return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:         return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_CRC:     return "ESP_ERR_INVALID_CRC";
+    case ESP_ERR_NVS_NOT_FOUND:   return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_NVS_NO_FREE_PAGES: return "ESP_ERR_NVS_NO_FREE_PAGES";
+    case ESP_ERR_OTA_VALIDATE_FAILED: return "ESP_ERR_OTA_VALIDATE_FAILED";
+    case ESP_ERR_OTA_ROLLBACK_INVALID_STATE: return "ESP_ERR_OTA_ROLLBACK_INVALID_STATE";
+    default:                      return "UNKNOWN ERROR";
+    }
+}
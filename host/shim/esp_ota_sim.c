@@ -0,0 +1,254 @@
+// Simulated app partitions for OTA updates: ota_0 holds the running image,
+// ota_1 takes updates. See esp_ota_ops.h.
+
+#include "esp_app_desc.h"
+#include "esp_log.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "ota_sim";
+
+static const esp_partition_t s_parts[2] = {
+    { .type = ESP_PARTITION_TYPE_APP, .subtype = ESP_PARTITION_SUBTYPE_APP_OTA_0, .address = 0x10000,
+      .size = SIM_OTA_PARTITION_SIZE, .erase_size = 0x1000, .label = "ota_0" },
+    { .type = ESP_PARTITION_TYPE_APP, .subtype = ESP_PARTITION_SUBTYPE_APP_OTA_1, .address = 0x110000,
+      .size = SIM_OTA_PARTITION_SIZE, .erase_size = 0x1000, .label = "ota_1" },
+};
+
+static uint8_t s_flash[2][SIM_OTA_PARTITION_SIZE];
+static uint32_t s_image_len[2];
+static const esp_partition_t *s_boot = &s_parts[0];
+static esp_ota_img_states_t s_running_state = ESP_OTA_IMG_VALID;
+static esp_ota_handle_t s_handle;          // open update, 0 = none
+static esp_ota_handle_t s_next_handle = 1;
+static uint32_t s_written;
+static uint32_t s_updates;
+static uint32_t s_rollbacks;
+static const char *s_output_path;
+
+static int index_of(const esp_partition_t *p)
+{
+    return p == &s_parts[1] ? 1 : (p == &s_parts[0] ? 0 : -1);
+}
+
+// Image header, then xorshift noise: stands in for a real app binary
+static void synthetic_image(void)
+{
+    uint32_t x = 0x2545f491u;
+    uint8_t *img = s_flash[0];
+    for (uint32_t i = 0; i < SIM_OTA_IMAGE_SIZE; i += 4) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        memcpy(img + i, &x, 4);
+    }
+    img[0] = ESP_IMAGE_HEADER_MAGIC;
+    s_image_len[0] = SIM_OTA_IMAGE_SIZE;
+}
+
+__attribute__((constructor)) static void flash_init(void)
+{
+    memset(s_flash, 0xff, sizeof(s_flash));
+    synthetic_image();
+}
+
+bool sim_ota_load_firmware(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "cannot open firmware image '%s'\n", path);
+        return false;
+    }
+    memset(s_flash[0], 0xff, SIM_OTA_PARTITION_SIZE);
+    size_t n = fread(s_flash[0], 1, SIM_OTA_PARTITION_SIZE, f);
+    bool too_big = fgetc(f) != EOF;
+    fclose(f);
+    if (n == 0 || too_big) {
+        fprintf(stderr, "firmware image '%s' is empty or larger than the %d byte partition\n",
+                path, SIM_OTA_PARTITION_SIZE);
+        return false;
+    }
+    s_image_len[0] = (uint32_t)n;
+    return true;
+}
+
+void sim_ota_set_pending_verify(bool pending)
+{
+    s_running_state = pending ? ESP_OTA_IMG_PENDING_VERIFY : ESP_OTA_IMG_VALID;
+}
+
+void sim_ota_set_output(const char *path)
+{
+    s_output_path = path;
+}
+
+const esp_app_desc_t *esp_app_get_description(void)
+{
+    static const esp_app_desc_t desc = {
+        .magic_word = 0xABCD5432,
+        .version = "host-sim",
+        .project_name = "irrigation",
+        .time = __TIME__,
+        .date = __DATE__,
+        .idf_ver = "v5.5-host",
+    };
+    return &desc;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition, size_t src_offset, void *dst, size_t size)
+{
+    int i = index_of(partition);
+    if (i < 0 || src_offset > partition->size || size > partition->size - src_offset) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(dst, s_flash[i] + src_offset, size);
+    return ESP_OK;
+}
+
+const esp_partition_t *esp_ota_get_running_partition(void)
+{
+    return &s_parts[0];
+}
+
+const esp_partition_t *esp_ota_get_boot_partition(void)
+{
+    return s_boot;
+}
+
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from)
+{
+    return &s_parts[1];
+}
+
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle)
+{
+    int i = index_of(partition);
+    if (i < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (i == 0) {
+        return ESP_ERR_OTA_PARTITION_CONFLICT;
+    }
+    if (image_size != OTA_SIZE_UNKNOWN && image_size > partition->size) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    size_t erase = image_size == 0 || image_size == OTA_SIZE_UNKNOWN ? partition->size : image_size;
+    memset(s_flash[i], 0xff, erase);
+    s_image_len[i] = 0;
+    s_written = 0;
+    s_handle = s_next_handle++;
+    *out_handle = s_handle;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size)
+{
+    if (handle == 0 || handle != s_handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (size > SIM_OTA_PARTITION_SIZE - s_written) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (s_written == 0 && size > 0 && ((const uint8_t *)data)[0] != ESP_IMAGE_HEADER_MAGIC) {
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+    memcpy(s_flash[1] + s_written, data, size);
+    s_written += size;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_end(esp_ota_handle_t handle)
+{
+    if (handle == 0 || handle != s_handle) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_handle = 0;
+    if (s_written == 0 || s_flash[1][0] != ESP_IMAGE_HEADER_MAGIC) {
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+    s_image_len[1] = s_written;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_abort(esp_ota_handle_t handle)
+{
+    if (handle == 0 || handle != s_handle) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    s_handle = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition)
+{
+    int i = index_of(partition);
+    if (i < 0 || s_image_len[i] == 0) {
+        return ESP_ERR_OTA_VALIDATE_FAILED;
+    }
+    s_boot = partition;
+    s_updates += i == 1;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_get_state_partition(const esp_partition_t *partition, esp_ota_img_states_t *ota_state)
+{
+    int i = index_of(partition);
+    if (i < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (i == 1 && s_image_len[1] == 0) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    *ota_state = i == 0 ? s_running_state : ESP_OTA_IMG_NEW;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_valid_cancel_rollback(void)
+{
+    s_running_state = ESP_OTA_IMG_VALID;
+    return ESP_OK;
+}
+
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot(void)
+{
+    if (s_running_state != ESP_OTA_IMG_PENDING_VERIFY) {
+        return ESP_ERR_OTA_ROLLBACK_INVALID_STATE;
+    }
+    s_running_state = ESP_OTA_IMG_INVALID;
+    s_boot = &s_parts[1];       // the image the update replaced
+    s_rollbacks++;
+    ESP_LOGW(TAG, "Rolling back to %s", s_boot->label);
+    esp_restart();
+    return ESP_FAIL;
+}
+
+static const char *state_name(esp_ota_img_states_t state)
+{
+    switch (state) {
+    case ESP_OTA_IMG_PENDING_VERIFY: return "pending_verify";
+    case ESP_OTA_IMG_VALID:          return "valid";
+    case ESP_OTA_IMG_INVALID:        return "invalid";
+    default:                         return "undefined";
+    }
+}
+
+void sim_ota_report(FILE *out)
+{
+    fprintf(out, "ota.running=%s\nota.running_state=%s\nota.boot=%s\n",
+            s_parts[0].label, state_name(s_running_state), s_boot->label);
+    fprintf(out, "ota.updates=%u\nota.image_bytes=%u\nota.rollbacks=%u\n",
+            s_updates, s_image_len[1], s_rollbacks);
+    if (s_output_path == NULL || s_boot != &s_parts[1] || s_image_len[1] == 0) {
+        return;
+    }
+    FILE *f = fopen(s_output_path, "wb");
+    if (f == NULL || fwrite(s_flash[1], 1, s_image_len[1], f) != s_image_len[1]) {
+        fprintf(stderr, "cannot write '%s'\n", s_output_path);
+    }
+    if (f != NULL) {
+        fclose(f);
+    }
+}
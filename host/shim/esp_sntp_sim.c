@@ -0,0 +1,58 @@
+// Simulated SNTP: a sync arrives SIM_SNTP_DELAY_US after every IP, carrying
+// a virtual wall clock that starts at the configured epoch when the sim
+// boots. An epoch of 0 plays a network without a reachable time server.
+
+#include "esp_netif_sntp.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+
+#define SIM_SNTP_DELAY_US (300 * 1000)  // request + reply after the IP arrives
+
+static int64_t s_epoch_s = SIM_SNTP_DEFAULT_EPOCH;
+static esp_sntp_time_cb_t s_sync_cb;
+static esp_timer_handle_t s_reply_timer;
+
+void sim_sntp_set_epoch(int64_t epoch_s)
+{
+    s_epoch_s = epoch_s;
+}
+
+static void reply_cb(void *arg)
+{
+    (void)arg;
+    if (s_sync_cb == NULL || s_epoch_s <= 0) {
+        return;
+    }
+    int64_t now_us = esp_timer_get_time();
+    struct timeval tv = {
+        .tv_sec = (time_t)(s_epoch_s + now_us / 1000000),
+        .tv_usec = (suseconds_t)(now_us % 1000000),
+    };
+    s_sync_cb(&tv);
+}
+
+static void on_got_ip(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    esp_timer_stop(s_reply_timer);
+    esp_timer_start_once(s_reply_timer, SIM_SNTP_DELAY_US);
+}
+
+esp_err_t esp_netif_sntp_init(const esp_sntp_config_t *config)
+{
+    if (config == NULL || s_reply_timer != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_sync_cb = config->sync_cb;
+    const esp_timer_create_args_t args = { .callback = reply_cb, .name = "sntp" };
+    esp_err_t err = esp_timer_create(&args, &s_reply_timer);
+    if (err == ESP_OK) {
+        err = esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, on_got_ip, NULL, NULL);
+    }
+    return err;
+}
+
+void esp_netif_sntp_deinit(void)
+{
+    s_sync_cb = NULL;
+}
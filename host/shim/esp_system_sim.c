@@ -0,0 +1,83 @@
+// esp_system / esp_hw_support odds and ends: random numbers, heap figures,
+// the MAC address, restart.
+
+#include "esp_heap_caps.h"
+#include "esp_mac.h"
+#include "esp_random.h"
+#include "esp_system.h"
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static atomic_uint_fast32_t s_rand_state = 0x9e3779b9u;
+
+uint32_t esp_random(void)
+{
+    uint_fast32_t x = atomic_load(&s_rand_state);
+    uint_fast32_t next;
+    do {
+        next = x;
+        next ^= (next << 13) & 0xffffffffu;
+        next ^= next >> 17;
+        next ^= (next << 5) & 0xffffffffu;
+    } while (!atomic_compare_exchange_weak(&s_rand_state, &x, next));
+    return (uint32_t)next;
+}
+
+void esp_fill_random(void *buf, size_t len)
+{
+    uint8_t *p = buf;
+    while (len > 0) {
+        uint32_t r = esp_random();
+        size_t n = len < sizeof(r) ? len : sizeof(r);
+        memcpy(p, &r, n);
+        p += n;
+        len -= n;
+    }
+}
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return SIM_FREE_HEAP_BYTES;
+}
+
+uint32_t esp_get_minimum_free_heap_size(void)
+{
+    return SIM_FREE_HEAP_BYTES;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps)
+{
+    return SIM_FREE_HEAP_BYTES;
+}
+
+size_t heap_caps_get_minimum_free_size(uint32_t caps)
+{
+    return SIM_FREE_HEAP_BYTES;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps)
+{
+    return SIM_LARGEST_FREE_BLOCK;
+}
+
+esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type)
+{
+    static const uint8_t base[6] = { 0x24, 0x0a, 0xc4, 0x00, 0x00, 0x01 };
+    memcpy(mac, base, sizeof(base));
+    mac[5] += (uint8_t)type;    // same per-interface offsets as the chip
+    return ESP_OK;
+}
+
+__attribute__((weak)) void sim_restart(void)
+{
+    fflush(stdout);
+    _Exit(0);
+}
+
+void esp_restart(void)
+{
+    sim_restart();
+}
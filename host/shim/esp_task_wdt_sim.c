@@ -0,0 +1,128 @@
+// Simulated task watchdog: an esp_timer checks every half timeout that each
+// subscribed task has reset it recently. Idle-task checks are not modelled
+// (host threads never starve an idle task).
+
+#include "esp_task_wdt.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define SIM_WDT_MAX_TASKS 8
+
+static const char *TAG = "task_wdt";
+
+typedef struct {
+    TaskHandle_t task;
+    int64_t last_reset_us;
+} wdt_entry_t;
+
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static wdt_entry_t s_entries[SIM_WDT_MAX_TASKS];
+static esp_timer_handle_t s_check_timer;
+static uint32_t s_timeout_ms;
+static uint32_t s_triggers;
+
+static void check_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < SIM_WDT_MAX_TASKS; i++) {
+        portENTER_CRITICAL(&s_lock);
+        TaskHandle_t task = s_entries[i].task;
+        bool late = task != NULL && now - s_entries[i].last_reset_us > (int64_t)s_timeout_ms * 1000;
+        if (late) {
+            s_entries[i].last_reset_us = now;   // one report per timeout, not per check
+            s_triggers++;
+        }
+        portEXIT_CRITICAL(&s_lock);
+        if (late) {
+            ESP_LOGE(TAG, "Task watchdog got triggered. The following tasks did not reset the watchdog in time:");
+            ESP_LOGE(TAG, " - %s", pcTaskGetName(task));
+        }
+    }
+}
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t *config)
+{
+    if (s_check_timer != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    const esp_timer_create_args_t args = { .callback = check_cb, .name = "task_wdt" };
+    esp_err_t err = esp_timer_create(&args, &s_check_timer);
+    if (err == ESP_OK) {
+        s_timeout_ms = config->timeout_ms;
+        err = esp_timer_start_periodic(s_check_timer, (uint64_t)config->timeout_ms * 500);
+    }
+    return err;
+}
+
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t *config)
+{
+    if (s_check_timer == NULL) {
+        return ESP_ERR_INVALID_STATE;   // like CONFIG_ESP_TASK_WDT_INIT=n
+    }
+    esp_timer_stop(s_check_timer);
+    s_timeout_ms = config->timeout_ms;
+    return esp_timer_start_periodic(s_check_timer, (uint64_t)config->timeout_ms * 500);
+}
+
+esp_err_t esp_task_wdt_deinit(void)
+{
+    if (s_check_timer == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_timer_stop(s_check_timer);
+    esp_timer_delete(s_check_timer);
+    s_check_timer = NULL;
+    return ESP_OK;
+}
+
+esp_err_t esp_task_wdt_add(TaskHandle_t task_handle)
+{
+    TaskHandle_t task = task_handle ? task_handle : xTaskGetCurrentTaskHandle();
+    esp_err_t err = ESP_ERR_NO_MEM;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < SIM_WDT_MAX_TASKS && err != ESP_OK; i++) {
+        if (s_entries[i].task == NULL || s_entries[i].task == task) {
+            s_entries[i] = (wdt_entry_t){ task, esp_timer_get_time() };
+            err = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return s_check_timer == NULL ? ESP_ERR_INVALID_STATE : err;
+}
+
+esp_err_t esp_task_wdt_delete(TaskHandle_t task_handle)
+{
+    TaskHandle_t task = task_handle ? task_handle : xTaskGetCurrentTaskHandle();
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < SIM_WDT_MAX_TASKS; i++) {
+        if (s_entries[i].task == task) {
+            s_entries[i].task = NULL;
+            err = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+esp_err_t esp_task_wdt_reset(void)
+{
+    TaskHandle_t task = xTaskGetCurrentTaskHandle();
+    esp_err_t err = ESP_ERR_NOT_FOUND;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < SIM_WDT_MAX_TASKS; i++) {
+        if (s_entries[i].task == task) {
+            s_entries[i].last_reset_us = now;
+            err = ESP_OK;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+void sim_task_wdt_report(FILE *out)
+{
+    fprintf(out, "wdt.timeout_ms=%lu\n", (unsigned long)(s_check_timer ? s_timeout_ms : 0));
+    fprintf(out, "wdt.triggers=%lu\n", (unsigned long)s_triggers);
+}
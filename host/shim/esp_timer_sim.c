@@ -0,0 +1,186 @@
+// esp_timer on the virtual clock: one service task fires expired timers.
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sim_kernel.h"
+
+#include <stdlib.h>
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+    uint64_t alarm_us;
+    uint64_t period_us;
+    bool armed;
+    struct esp_timer *next;
+};
+
+static struct esp_timer *s_timers = NULL;
+static bool s_started = false;
+static int s_timer_list;  // wait object for the service task
+
+static void timer_task(void *arg)
+{
+    (void)arg;
+    sim_lock();
+    while (1) {
+        uint64_t now = sim_now_us_locked();
+        struct esp_timer *due = NULL;
+        uint64_t next = SIM_FOREVER;
+        for (struct esp_timer *t = s_timers; t; t = t->next) {
+            if (!t->armed) {
+                continue;
+            }
+            if (t->alarm_us <= now && (due == NULL || t->alarm_us < due->alarm_us)) {
+                due = t;
+            }
+            if (t->alarm_us < next) {
+                next = t->alarm_us;
+            }
+        }
+        if (due == NULL) {
+            sim_block_locked(&s_timer_list, next);
+            continue;
+        }
+        if (due->period_us) {
+            due->alarm_us += due->period_us;
+        } else {
+            due->armed = false;
+        }
+        esp_timer_cb_t cb = due->callback;
+        void *cb_arg = due->arg;
+        sim_unlock();
+        cb(cb_arg);
+        sim_lock();
+    }
+}
+
+esp_err_t esp_timer_init(void)
+{
+    sim_lock();
+    bool start = !s_started;
+    s_started = true;
+    sim_unlock();
+    if (start) {
+        xTaskCreate(timer_task, "esp_timer", 4096, NULL, 22, NULL);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_timer_init();
+    struct esp_timer *t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    t->callback = create_args->callback;
+    t->arg = create_args->arg;
+    t->name = create_args->name;
+    sim_lock();
+    t->next = s_timers;
+    s_timers = t;
+    sim_unlock();
+    *out_handle = t;
+    return ESP_OK;
+}
+
+static esp_err_t arm(esp_timer_handle_t timer, uint64_t timeout_us, uint64_t period_us, bool restart)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    if (timer->armed && !restart) {
+        sim_unlock();
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->alarm_us = sim_now_us_locked() + timeout_us;
+    timer->period_us = period_us;
+    timer->armed = true;
+    sim_wake_all_locked(&s_timer_list);
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    return arm(timer, timeout_us, 0, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period)
+{
+    return arm(timer, period, period, false);
+}
+
+esp_err_t esp_timer_restart(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    if (timer == NULL || !esp_timer_is_active(timer)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    return arm(timer, timeout_us, timer->period_us ? timeout_us : 0, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    esp_err_t err = timer->armed ? ESP_OK : ESP_ERR_INVALID_STATE;
+    timer->armed = false;
+    sim_unlock();
+    return err;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (timer == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    if (timer->armed) {
+        sim_unlock();
+        return ESP_ERR_INVALID_STATE;
+    }
+    for (struct esp_timer **pp = &s_timers; *pp; pp = &(*pp)->next) {
+        if (*pp == timer) {
+            *pp = timer->next;
+            break;
+        }
+    }
+    sim_unlock();
+    free(timer);
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer)
+{
+    sim_lock();
+    bool armed = timer->armed;
+    sim_unlock();
+    return armed;
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return (int64_t)sim_now_us();
+}
+
+int64_t esp_timer_get_next_alarm(void)
+{
+    sim_lock();
+    uint64_t next = SIM_FOREVER;
+    for (struct esp_timer *t = s_timers; t; t = t->next) {
+        if (t->armed && t->alarm_us < next) {
+            next = t->alarm_us;
+        }
+    }
+    sim_unlock();
+    return next == SIM_FOREVER ? INT64_MAX : (int64_t)next;
+}
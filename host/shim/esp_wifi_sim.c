@@ -0,0 +1,179 @@
+// Simulated WiFi station + netif: association completes after a fixed
+// virtual delay when the simulated access point is available. A config
+// naming the AP's BSSID and channel skips the all-channel scan and connects
+// faster; a wrong BSSID or channel finds no AP.
+
+#include "esp_wifi.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+
+#include <stdatomic.h>
+#include <string.h>
+
+#define SIM_WIFI_ASSOC_DELAY_US (800 * 1000)        // full scan + association
+#define SIM_WIFI_FAST_ASSOC_DELAY_US (200 * 1000)   // one channel, known BSSID
+
+ESP_EVENT_DEFINE_BASE(WIFI_EVENT);
+ESP_EVENT_DEFINE_BASE(IP_EVENT);
+
+struct esp_netif_obj {
+    esp_netif_ip_info_t ip_info;
+};
+
+static struct esp_netif_obj s_sta_netif;
+static wifi_config_t s_sta_config;
+static esp_timer_handle_t s_assoc_timer = NULL;
+static atomic_bool s_ap_available = true;
+static atomic_bool s_connected = false;
+static bool s_started = false;
+
+static const uint8_t SIM_BSSID[6] = { 0x02, 0x00, 0x5e, 0x10, 0x00, 0x01 };
+#define SIM_CHANNEL 6
+
+void sim_wifi_set_ap_available(bool available)
+{
+    atomic_store(&s_ap_available, available);
+    if (!available && atomic_exchange(&s_connected, false)) {
+        wifi_event_sta_disconnected_t ev = { .reason = WIFI_REASON_BEACON_TIMEOUT };
+        esp_event_post(IP_EVENT, IP_EVENT_STA_LOST_IP, NULL, 0, portMAX_DELAY);
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &ev, sizeof(ev), portMAX_DELAY);
+    }
+}
+
+static bool config_targets_other_ap(void)
+{
+    const wifi_sta_config_t *sta = &s_sta_config.sta;
+    return (sta->bssid_set && memcmp(sta->bssid, SIM_BSSID, sizeof(SIM_BSSID)) != 0) ||
+           (sta->channel != 0 && sta->channel != SIM_CHANNEL);
+}
+
+static void assoc_done(void *arg)
+{
+    (void)arg;
+    if (!atomic_load(&s_ap_available) || config_targets_other_ap()) {
+        wifi_event_sta_disconnected_t ev = { .reason = WIFI_REASON_NO_AP_FOUND, .rssi = -127 };
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &ev, sizeof(ev), portMAX_DELAY);
+        return;
+    }
+    atomic_store(&s_connected, true);
+    wifi_event_sta_connected_t conn = { .channel = SIM_CHANNEL, .authmode = WIFI_AUTH_WPA2_PSK };
+    memcpy(conn.bssid, SIM_BSSID, sizeof(conn.bssid));
+    esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_CONNECTED, &conn, sizeof(conn), portMAX_DELAY);
+
+    // Loopback stands in for the DHCP lease
+    s_sta_netif.ip_info.ip.addr = 0x0100007f;
+    s_sta_netif.ip_info.netmask.addr = 0x000000ff;
+    s_sta_netif.ip_info.gw.addr = 0x0100007f;
+    ip_event_got_ip_t got = { .esp_netif = &s_sta_netif, .ip_info = s_sta_netif.ip_info, .ip_changed = true };
+    esp_event_post(IP_EVENT, IP_EVENT_STA_GOT_IP, &got, sizeof(got), portMAX_DELAY);
+}
+
+esp_err_t esp_netif_init(void)
+{
+    return ESP_OK;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_sta(void)
+{
+    return &s_sta_netif;
+}
+
+esp_err_t esp_netif_get_ip_info(esp_netif_t *esp_netif, esp_netif_ip_info_t *ip_info)
+{
+    if (esp_netif == NULL || ip_info == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *ip_info = esp_netif->ip_info;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    (void)config;
+    if (s_assoc_timer == NULL) {
+        const esp_timer_create_args_t args = { .callback = assoc_done, .name = "sim_assoc" };
+        return esp_timer_create(&args, &s_assoc_timer);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_deinit(void)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode)
+{
+    return mode == WIFI_MODE_STA ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    if (interface != WIFI_IF_STA || conf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_sta_config = *conf;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    if (interface != WIFI_IF_STA || conf == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *conf = s_sta_config;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    if (!s_started) {
+        s_started = true;
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_START, NULL, 0, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_stop(void)
+{
+    s_started = false;
+    esp_timer_stop(s_assoc_timer);
+    if (atomic_exchange(&s_connected, false)) {
+        wifi_event_sta_disconnected_t ev = { .reason = WIFI_REASON_UNSPECIFIED };
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &ev, sizeof(ev), portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+    if (!s_started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_timer_stop(s_assoc_timer);
+    bool fast = s_sta_config.sta.bssid_set && s_sta_config.sta.channel != 0;
+    return esp_timer_start_once(s_assoc_timer, fast ? SIM_WIFI_FAST_ASSOC_DELAY_US : SIM_WIFI_ASSOC_DELAY_US);
+}
+
+esp_err_t esp_wifi_disconnect(void)
+{
+    if (atomic_exchange(&s_connected, false)) {
+        wifi_event_sta_disconnected_t ev = { .reason = WIFI_REASON_UNSPECIFIED };
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &ev, sizeof(ev), portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_sta_get_ap_info(wifi_ap_record_t *ap_info)
+{
+    if (!atomic_load(&s_connected)) {
+        return ESP_ERR_WIFI_BASE + 0x0F;  // ESP_ERR_WIFI_NOT_CONNECT
+    }
+    memset(ap_info, 0, sizeof(*ap_info));
+    memcpy(ap_info->bssid, SIM_BSSID, sizeof(ap_info->bssid));
+    memcpy(ap_info->ssid, s_sta_config.sta.ssid, sizeof(s_sta_config.sta.ssid));
+    ap_info->primary = SIM_CHANNEL;
+    ap_info->rssi = -58;
+    ap_info->authmode = WIFI_AUTH_WPA2_PSK;
+    return ESP_OK;
+}
@@ -0,0 +1,447 @@
+// FreeRTOS task / queue / semaphore / event group API on top of sim_kernel.
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "sim_kernel.h"
+
+#include <sched.h>
+#include <string.h>
+
+#define TICK_US (1000000ULL / configTICK_RATE_HZ)
+
+static uint64_t deadline_from_ticks(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        return SIM_FOREVER;
+    }
+    return sim_now_us_locked() + (uint64_t)ticks * TICK_US;
+}
+
+void sim_assert_failed(const char *expr, const char *file, int line)
+{
+    fflush(stdout);     // the log lines leading up to it
+    fprintf(stderr, "assert failed: %s (%s:%d)\n", expr, file, line);
+    abort();
+}
+
+void sim_port_enter_critical(portMUX_TYPE *mux)
+{
+    pthread_mutex_lock(&mux->mutex);
+}
+
+void sim_port_exit_critical(portMUX_TYPE *mux)
+{
+    pthread_mutex_unlock(&mux->mutex);
+}
+
+/* ---------------------------------------------------------------- tasks */
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName,
+                                   uint32_t usStackDepth, void *pvParameters,
+                                   UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask,
+                                   BaseType_t xCoreID)
+{
+    sim_task_t *t = sim_task_spawn(pcName, pvTaskCode, pvParameters, usStackDepth,
+                                   (int)uxPriority, (int)xCoreID);
+    if (pvCreatedTask) {
+        *pvCreatedTask = t;
+    }
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t pxTaskCode, const char *pcName,
+                                         uint32_t ulStackDepth, void *pvParameters,
+                                         UBaseType_t uxPriority, StackType_t *puxStackBuffer,
+                                         StaticTask_t *pxTaskBuffer, BaseType_t xCoreID)
+{
+    // Host threads bring their own stacks; the buffers only have to be there
+    if (puxStackBuffer == NULL || pxTaskBuffer == NULL) {
+        return NULL;
+    }
+    return sim_task_spawn(pcName, pxTaskCode, pvParameters, ulStackDepth,
+                          (int)uxPriority, (int)xCoreID);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    // Only self-deletion is used by the firmware
+    if (xTaskToDelete == NULL || xTaskToDelete == sim_self()) {
+        sim_task_exit();
+    }
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    if (xTicksToDelay == 0) {
+        sched_yield();
+        return;
+    }
+    sim_lock();
+    uint64_t deadline = deadline_from_ticks(xTicksToDelay);
+    while (sim_block_locked(NULL, deadline)) {
+        // spurious wake: keep sleeping until the deadline
+    }
+    sim_unlock();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement)
+{
+    TickType_t target = *pxPreviousWakeTime + xTimeIncrement;
+    sim_lock();
+    uint64_t deadline = (uint64_t)target * TICK_US;
+    BaseType_t delayed = deadline > sim_now_us_locked() ? pdTRUE : pdFALSE;
+    while (sim_block_locked(NULL, deadline)) {
+    }
+    sim_unlock();
+    *pxPreviousWakeTime = target;
+    return delayed;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(sim_now_us() / TICK_US);
+}
+
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return xTaskGetTickCount();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return sim_self();
+}
+
+char *pcTaskGetName(TaskHandle_t xTaskToQuery)
+{
+    sim_task_t *t = xTaskToQuery ? xTaskToQuery : sim_self();
+    return t->name;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    // Host threads have large stacks; report the configured depth unused
+    sim_task_t *t = xTask ? xTask : sim_self();
+    return t->stack_depth;
+}
+
+BaseType_t xTaskGetCoreID(TaskHandle_t xTask)
+{
+    sim_task_t *t = xTask ? xTask : sim_self();
+    return t->core_id;
+}
+
+/* -------------------------------------------------------- notifications */
+
+BaseType_t xTaskGenericNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue,
+                              eNotifyAction eAction, uint32_t *pulPreviousNotificationValue)
+{
+    sim_task_t *t = xTaskToNotify;
+    BaseType_t ret = pdPASS;
+
+    sim_lock();
+    if (pulPreviousNotificationValue) {
+        *pulPreviousNotificationValue = t->notify_value;
+    }
+    switch (eAction) {
+    case eSetBits:
+        t->notify_value |= ulValue;
+        break;
+    case eIncrement:
+        t->notify_value++;
+        break;
+    case eSetValueWithOverwrite:
+        t->notify_value = ulValue;
+        break;
+    case eSetValueWithoutOverwrite:
+        if (t->notify_pending) {
+            ret = pdFAIL;
+        } else {
+            t->notify_value = ulValue;
+        }
+        break;
+    case eNoAction:
+    default:
+        break;
+    }
+    t->notify_pending = true;
+    if (t->waiting_on == &t->notify_value) {
+        sim_wake_locked(t);
+    }
+    sim_unlock();
+    return ret;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                           uint32_t *pulNotificationValue, TickType_t xTicksToWait)
+{
+    sim_task_t *t = sim_self();
+    BaseType_t ret = pdFALSE;
+
+    sim_lock();
+    uint64_t deadline = deadline_from_ticks(xTicksToWait);
+    if (!t->notify_pending) {
+        t->notify_value &= ~ulBitsToClearOnEntry;
+        while (!t->notify_pending && sim_block_locked(&t->notify_value, deadline)) {
+        }
+    }
+    if (pulNotificationValue) {
+        *pulNotificationValue = t->notify_value;
+    }
+    if (t->notify_pending) {
+        t->notify_value &= ~ulBitsToClearOnExit;
+        t->notify_pending = false;
+        ret = pdTRUE;
+    }
+    sim_unlock();
+    return ret;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    sim_task_t *t = sim_self();
+
+    sim_lock();
+    uint64_t deadline = deadline_from_ticks(xTicksToWait);
+    while (t->notify_value == 0 && sim_block_locked(&t->notify_value, deadline)) {
+    }
+    uint32_t value = t->notify_value;
+    if (value != 0) {
+        t->notify_value = xClearCountOnExit ? 0 : value - 1;
+    }
+    t->notify_pending = false;
+    sim_unlock();
+    return value;
+}
+
+/* --------------------------------------------------- queues / semaphores */
+
+struct sim_queue {
+    uint8_t *storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;
+    uint8_t type;
+    bool static_storage;
+};
+
+QueueHandle_t xQueueGenericCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t ucQueueType)
+{
+    struct sim_queue *q = calloc(1, sizeof(*q));
+    if (q == NULL) {
+        return NULL;
+    }
+    q->length = uxQueueLength;
+    q->item_size = uxItemSize;
+    q->type = ucQueueType;
+    if (uxItemSize > 0) {
+        q->storage = calloc(uxQueueLength, uxItemSize);
+        if (q->storage == NULL) {
+            free(q);
+            return NULL;
+        }
+    }
+    return q;
+}
+
+QueueHandle_t xQueueGenericCreateStatic(UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                        uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue,
+                                        uint8_t ucQueueType)
+{
+    // Items live in the caller's storage, as on the target
+    (void)pxStaticQueue;
+    QueueHandle_t q = xQueueGenericCreate(uxQueueLength, 0, ucQueueType);
+    if (q) {
+        q->item_size = uxItemSize;
+        q->storage = pucQueueStorage;
+        q->static_storage = true;
+    }
+    return q;
+}
+
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount)
+{
+    QueueHandle_t q = xQueueGenericCreate(uxMaxCount, 0, queueQUEUE_TYPE_COUNTING_SEMAPHORE);
+    if (q) {
+        q->count = uxInitialCount;
+    }
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    if (xQueue) {
+        if (!xQueue->static_storage) {
+            free(xQueue->storage);
+        }
+        free(xQueue);
+    }
+}
+
+BaseType_t xQueueGenericSend(QueueHandle_t q, const void *pvItemToQueue,
+                             TickType_t xTicksToWait, BaseType_t xCopyPosition)
+{
+    sim_lock();
+    uint64_t deadline = deadline_from_ticks(xTicksToWait);
+    if (xCopyPosition != queueOVERWRITE) {
+        while (q->count >= q->length) {
+            if (!sim_block_locked(q, deadline) && q->count >= q->length) {
+                sim_unlock();
+                return errQUEUE_FULL;
+            }
+        }
+    }
+    if (q->item_size > 0) {
+        UBaseType_t slot;
+        if (xCopyPosition == queueOVERWRITE && q->count > 0) {
+            slot = q->head;
+            q->count = 0;
+        } else if (xCopyPosition == queueSEND_TO_FRONT) {
+            q->head = (q->head + q->length - 1) % q->length;
+            slot = q->head;
+        } else {
+            slot = (q->head + q->count) % q->length;
+        }
+        memcpy(q->storage + slot * q->item_size, pvItemToQueue, q->item_size);
+    }
+    q->count++;
+    sim_wake_all_locked(q);
+    sim_unlock();
+    return pdPASS;
+}
+
+static BaseType_t queue_take(QueueHandle_t q, void *pvBuffer, TickType_t xTicksToWait, bool remove)
+{
+    sim_lock();
+    uint64_t deadline = deadline_from_ticks(xTicksToWait);
+    while (q->count == 0) {
+        if (!sim_block_locked(q, deadline) && q->count == 0) {
+            sim_unlock();
+            return errQUEUE_EMPTY;
+        }
+    }
+    if (q->item_size > 0 && pvBuffer) {
+        memcpy(pvBuffer, q->storage + q->head * q->item_size, q->item_size);
+    }
+    if (remove) {
+        if (q->item_size > 0) {
+            q->head = (q->head + 1) % q->length;
+        }
+        q->count--;
+        sim_wake_all_locked(q);
+    }
+    sim_unlock();
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    return queue_take(xQueue, pvBuffer, xTicksToWait, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    return queue_take(xQueue, pvBuffer, xTicksToWait, false);
+}
+
+BaseType_t xQueueSemaphoreTake(QueueHandle_t xQueue, TickType_t xTicksToWait)
+{
+    return queue_take(xQueue, NULL, xTicksToWait, true);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+    sim_lock();
+    UBaseType_t n = xQueue->count;
+    sim_unlock();
+    return n;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue)
+{
+    sim_lock();
+    UBaseType_t n = xQueue->length - xQueue->count;
+    sim_unlock();
+    return n;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+    sim_lock();
+    xQueue->count = 0;
+    xQueue->head = 0;
+    sim_wake_all_locked(xQueue);
+    sim_unlock();
+    return pdPASS;
+}
+
+/* --------------------------------------------------------- event groups */
+
+struct sim_event_group {
+    EventBits_t bits;
+};
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return calloc(1, sizeof(struct sim_event_group));
+}
+
+void vEventGroupDelete(EventGroupHandle_t xEventGroup)
+{
+    free(xEventGroup);
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t g, const EventBits_t uxBitsToSet)
+{
+    sim_lock();
+    g->bits |= uxBitsToSet;
+    EventBits_t bits = g->bits;
+    sim_wake_all_locked(g);
+    sim_unlock();
+    return bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t g, const EventBits_t uxBitsToClear)
+{
+    sim_lock();
+    EventBits_t bits = g->bits;
+    g->bits &= ~uxBitsToClear;
+    sim_unlock();
+    return bits;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t g)
+{
+    sim_lock();
+    EventBits_t bits = g->bits;
+    sim_unlock();
+    return bits;
+}
+
+static bool bits_satisfied(EventBits_t bits, EventBits_t wanted, BaseType_t all)
+{
+    return all ? (bits & wanted) == wanted : (bits & wanted) != 0;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t g, const EventBits_t uxBitsToWaitFor,
+                                const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits,
+                                TickType_t xTicksToWait)
+{
+    sim_lock();
+    uint64_t deadline = deadline_from_ticks(xTicksToWait);
+    while (!bits_satisfied(g->bits, uxBitsToWaitFor, xWaitForAllBits)) {
+        if (!sim_block_locked(g, deadline)) {
+            break;
+        }
+    }
+    EventBits_t bits = g->bits;
+    if (xClearOnExit && bits_satisfied(bits, uxBitsToWaitFor, xWaitForAllBits)) {
+        g->bits &= ~uxBitsToWaitFor;
+    }
+    sim_unlock();
+    return bits;
+}
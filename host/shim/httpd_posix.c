@@ -0,0 +1,1024 @@
+// esp_http_server on POSIX sockets (see esp_http_server.h for the model).
+
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "sim_kernel.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static const char *TAG = "httpd";
+
+#define SESS_RX_LEN (HTTPD_MAX_REQ_HDR_LEN + 1024)
+
+typedef struct {
+    int fd;
+    char rx[SESS_RX_LEN];
+    size_t rx_len;
+    uint64_t lru;
+    bool close_requested;
+    bool async_busy;        // a request is out on a worker: do not read or purge
+    void *ctx;
+    httpd_free_ctx_fn_t free_ctx;
+} sess_t;
+
+typedef struct {
+    const char *field;
+    const char *value;
+} resp_hdr_t;
+
+typedef struct {
+    sess_t *sess;
+    char hdr[HTTPD_MAX_REQ_HDR_LEN + 1];
+    size_t body_remaining;
+    const char *status;
+    const char *content_type;
+    resp_hdr_t *resp_hdrs;
+    unsigned n_resp_hdrs;
+    bool headers_sent;
+    bool chunked;
+    bool keep_alive;
+    bool detached;          // handed to httpd_req_async_handler_begin()
+} req_aux_t;
+
+typedef enum { REQ_KEEP, REQ_CLOSE, REQ_DETACHED } req_result_t;
+
+typedef struct work_item {
+    httpd_work_fn_t fn;
+    void *arg;
+    struct work_item *next;
+} work_item_t;
+
+typedef struct {
+    httpd_config_t config;
+    int listen_fd;
+    int wake_pipe[2];
+    httpd_uri_t *handlers;
+    unsigned n_handlers;
+    sess_t *sessions;
+    uint64_t lru_clock;
+    pthread_mutex_t work_lock;
+    work_item_t *work_head;
+    work_item_t *work_tail;
+    pthread_t thread;
+    volatile bool stop;
+} server_t;
+
+static uint16_t s_port_override = 0;
+
+void sim_httpd_set_port_override(uint16_t port)
+{
+    s_port_override = port;
+}
+
+/* ------------------------------------------------------------- helpers */
+
+static int send_all(int fd, const char *buf, size_t len)
+{
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = send(fd, buf + sent, len - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+        }
+        sent += (size_t)n;
+    }
+    return (int)sent;
+}
+
+static sess_t *sess_find(server_t *srv, int fd)
+{
+    for (unsigned i = 0; i < srv->config.max_open_sockets; i++) {
+        if (srv->sessions[i].fd == fd) {
+            return &srv->sessions[i];
+        }
+    }
+    return NULL;
+}
+
+static void sess_close(server_t *srv, sess_t *sess)
+{
+    if (sess->fd < 0) {
+        return;
+    }
+    if (sess->free_ctx && sess->ctx) {
+        sess->free_ctx(sess->ctx);
+    }
+    if (srv->config.close_fn) {
+        srv->config.close_fn(srv, sess->fd);  // close_fn owns closing the socket
+    } else {
+        close(sess->fd);
+    }
+    sess->fd = -1;
+    sess->rx_len = 0;
+    sess->ctx = NULL;
+    sess->free_ctx = NULL;
+    sess->close_requested = false;
+    sess->async_busy = false;
+}
+
+static void set_sock_opts(int fd, const httpd_config_t *cfg)
+{
+    struct timeval rcv = { .tv_sec = cfg->recv_wait_timeout };
+    struct timeval snd = { .tv_sec = cfg->send_wait_timeout };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &rcv, sizeof(rcv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &snd, sizeof(snd));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (cfg->keep_alive_enable) {
+        setsockopt(fd, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+        setsockopt(fd, IPPROTO_TCP, TCP_KEEPIDLE, &cfg->keep_alive_idle, sizeof(int));
+        setsockopt(fd, IPPROTO_TCP, TCP_KEEPINTVL, &cfg->keep_alive_interval, sizeof(int));
+        setsockopt(fd, IPPROTO_TCP, TCP_KEEPCNT, &cfg->keep_alive_count, sizeof(int));
+    }
+}
+
+static const char *find_hdr(const char *block, const char *field, size_t *value_len)
+{
+    size_t flen = strlen(field);
+    const char *line = block;
+    while (*line) {
+        const char *eol = strstr(line, "\r\n");
+        if (eol == NULL) {
+            eol = line + strlen(line);
+        }
+        if ((size_t)(eol - line) > flen && strncasecmp(line, field, flen) == 0 && line[flen] == ':') {
+            const char *v = line + flen + 1;
+            while (v < eol && (*v == ' ' || *v == '\t')) {
+                v++;
+            }
+            const char *vend = eol;
+            while (vend > v && (vend[-1] == ' ' || vend[-1] == '\t')) {
+                vend--;
+            }
+            *value_len = (size_t)(vend - v);
+            return v;
+        }
+        line = *eol ? eol + 2 : eol;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------ responses */
+
+static esp_err_t send_headers(httpd_req_t *r, ssize_t content_len)
+{
+    req_aux_t *aux = r->aux;
+    char head[256];
+    int n = snprintf(head, sizeof(head), "HTTP/1.1 %s\r\nContent-Type: %s\r\n",
+                     aux->status, aux->content_type);
+    if (content_len >= 0) {
+        n += snprintf(head + n, sizeof(head) - n, "Content-Length: %zd\r\n", content_len);
+    } else {
+        n += snprintf(head + n, sizeof(head) - n, "Transfer-Encoding: chunked\r\n");
+    }
+    if (send_all(aux->sess->fd, head, (size_t)n) < 0) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    for (unsigned i = 0; i < aux->n_resp_hdrs; i++) {
+        n = snprintf(head, sizeof(head), "%s: %s\r\n", aux->resp_hdrs[i].field, aux->resp_hdrs[i].value);
+        if (n >= (int)sizeof(head) || send_all(aux->sess->fd, head, (size_t)n) < 0) {
+            return ESP_ERR_HTTPD_RESP_SEND;
+        }
+    }
+    if (send_all(aux->sess->fd, "\r\n", 2) < 0) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    aux->headers_sent = true;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status)
+{
+    if (r == NULL || status == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ((req_aux_t *)r->aux)->status = status;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+    if (r == NULL || type == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ((req_aux_t *)r->aux)->content_type = type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value)
+{
+    if (r == NULL || field == NULL || value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    req_aux_t *aux = r->aux;
+    server_t *srv = r->handle;
+    if (aux->n_resp_hdrs >= srv->config.max_resp_headers) {
+        return ESP_ERR_HTTPD_RESP_HDR;
+    }
+    aux->resp_hdrs[aux->n_resp_hdrs].field = field;
+    aux->resp_hdrs[aux->n_resp_hdrs].value = value;
+    aux->n_resp_hdrs++;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (r == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    req_aux_t *aux = r->aux;
+    if (buf == NULL) {
+        buf_len = 0;
+    } else if (buf_len == HTTPD_RESP_USE_STRLEN) {
+        buf_len = (ssize_t)strlen(buf);
+    }
+    esp_err_t err = send_headers(r, buf_len);
+    if (err != ESP_OK) {
+        return err;
+    }
+    if (buf_len > 0 && send_all(aux->sess->fd, buf, (size_t)buf_len) < 0) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    if (r == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    req_aux_t *aux = r->aux;
+    if (buf == NULL) {
+        buf_len = 0;
+    } else if (buf_len == HTTPD_RESP_USE_STRLEN) {
+        buf_len = (ssize_t)strlen(buf);
+    }
+    if (!aux->headers_sent) {
+        aux->chunked = true;
+        esp_err_t err = send_headers(r, -1);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    char len_line[16];
+    int n = snprintf(len_line, sizeof(len_line), "%zx\r\n", buf_len);
+    if (send_all(aux->sess->fd, len_line, (size_t)n) < 0 ||
+        (buf_len > 0 && send_all(aux->sess->fd, buf, (size_t)buf_len) < 0) ||
+        send_all(aux->sess->fd, "\r\n", 2) < 0) {
+        return ESP_ERR_HTTPD_RESP_SEND;
+    }
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    const char *status;
+    const char *default_msg;
+    switch (error) {
+    case HTTPD_501_METHOD_NOT_IMPLEMENTED:
+        status = "501 Method Not Implemented";
+        default_msg = "Server does not support this method";
+        break;
+    case HTTPD_505_VERSION_NOT_SUPPORTED:
+        status = "505 Version Not Supported";
+        default_msg = "HTTP version not supported by server";
+        break;
+    case HTTPD_400_BAD_REQUEST:
+        status = "400 Bad Request";
+        default_msg = "Bad request syntax";
+        break;
+    case HTTPD_401_UNAUTHORIZED:
+        status = "401 Unauthorized";
+        default_msg = "No permission -- see authorization schemes";
+        break;
+    case HTTPD_403_FORBIDDEN:
+        status = "403 Forbidden";
+        default_msg = "Request forbidden -- authorization will not help";
+        break;
+    case HTTPD_404_NOT_FOUND:
+        status = "404 Not Found";
+        default_msg = "Nothing matches the given URI";
+        break;
+    case HTTPD_405_METHOD_NOT_ALLOWED:
+        status = "405 Method Not Allowed";
+        default_msg = "Specified method is invalid for this resource";
+        break;
+    case HTTPD_408_REQ_TIMEOUT:
+        status = "408 Request Timeout";
+        default_msg = "Server closed this connection";
+        break;
+    case HTTPD_411_LENGTH_REQUIRED:
+        status = "411 Length Required";
+        default_msg = "Client must specify Content-Length";
+        break;
+    case HTTPD_413_CONTENT_TOO_LARGE:
+        status = "413 Content Too Large";
+        default_msg = "Content is too large";
+        break;
+    case HTTPD_414_URI_TOO_LONG:
+        status = "414 URI Too Long";
+        default_msg = "URI is too long";
+        break;
+    case HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE:
+        status = "431 Request Header Fields Too Large";
+        default_msg = "Header fields are too long";
+        break;
+    case HTTPD_500_INTERNAL_SERVER_ERROR:
+    default:
+        status = "500 Internal Server Error";
+        default_msg = "Server has encountered an unexpected error";
+        break;
+    }
+    httpd_resp_set_status(req, status);
+    httpd_resp_set_type(req, HTTPD_TYPE_TEXT);
+    return httpd_resp_send(req, msg ? msg : default_msg, HTTPD_RESP_USE_STRLEN);
+}
+
+/* ------------------------------------------------------------- requests */
+
+// Discard whatever part of the body the handler did not consume. False if
+// the session must be closed.
+static bool finish_request(httpd_req_t *req)
+{
+    req_aux_t *aux = req->aux;
+    char scratch[256];
+    while (aux->body_remaining > 0) {
+        if (httpd_req_recv(req, scratch, sizeof(scratch)) <= 0) {
+            return false;
+        }
+    }
+    return aux->keep_alive;
+}
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    if (r == NULL || buf == NULL) {
+        return HTTPD_SOCK_ERR_INVALID;
+    }
+    req_aux_t *aux = r->aux;
+    sess_t *sess = aux->sess;
+    size_t want = buf_len < aux->body_remaining ? buf_len : aux->body_remaining;
+    if (want == 0) {
+        return 0;
+    }
+    if (sess->rx_len > 0) {
+        size_t n = want < sess->rx_len ? want : sess->rx_len;
+        memcpy(buf, sess->rx, n);
+        memmove(sess->rx, sess->rx + n, sess->rx_len - n);
+        sess->rx_len -= n;
+        aux->body_remaining -= n;
+        return (int)n;
+    }
+    ssize_t n = recv(sess->fd, buf, want, 0);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+    }
+    if (n == 0) {
+        return HTTPD_SOCK_ERR_FAIL;
+    }
+    aux->body_remaining -= (size_t)n;
+    return (int)n;
+}
+
+size_t httpd_req_get_hdr_value_len(httpd_req_t *r, const char *field)
+{
+    size_t len = 0;
+    if (r == NULL || field == NULL || find_hdr(((req_aux_t *)r->aux)->hdr, field, &len) == NULL) {
+        return 0;
+    }
+    return len;
+}
+
+esp_err_t httpd_req_get_hdr_value_str(httpd_req_t *r, const char *field, char *val, size_t val_size)
+{
+    if (r == NULL || field == NULL || val == NULL || val_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t len = 0;
+    const char *v = find_hdr(((req_aux_t *)r->aux)->hdr, field, &len);
+    if (v == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t n = len < val_size - 1 ? len : val_size - 1;
+    memcpy(val, v, n);
+    val[n] = '\0';
+    return n < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+size_t httpd_req_get_url_query_len(httpd_req_t *r)
+{
+    const char *q = r ? strchr(r->uri, '?') : NULL;
+    return q ? strlen(q + 1) : 0;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    if (r == NULL || buf == NULL || buf_len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const char *q = strchr(r->uri, '?');
+    if (q == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    q++;
+    size_t len = strlen(q);
+    size_t n = len < buf_len - 1 ? len : buf_len - 1;
+    memcpy(buf, q, n);
+    buf[n] = '\0';
+    return n < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size)
+{
+    if (qry == NULL || key == NULL || val == NULL || val_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t klen = strlen(key);
+    const char *p = qry;
+    while (*p) {
+        const char *end = strchr(p, '&');
+        if (end == NULL) {
+            end = p + strlen(p);
+        }
+        if ((size_t)(end - p) >= klen && strncmp(p, key, klen) == 0 && (p[klen] == '=' || p + klen == end)) {
+            const char *v = p + klen + (p[klen] == '=' ? 1 : 0);
+            size_t len = (size_t)(end - v);
+            size_t n = len < val_size - 1 ? len : val_size - 1;
+            memcpy(val, v, n);
+            val[n] = '\0';
+            return n < len ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+        }
+        p = *end ? end + 1 : end;
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r)
+{
+    return r ? ((req_aux_t *)r->aux)->sess->fd : -1;
+}
+
+bool httpd_uri_match_wildcard(const char *uri_template, const char *uri_to_match, size_t match_upto)
+{
+    const size_t tpl_len = strlen(uri_template);
+    size_t exact_match_chars = tpl_len;
+
+    const char last = (const char)(tpl_len > 0 ? uri_template[tpl_len - 1] : 0);
+    const char prevlast = (const char)(tpl_len > 1 ? uri_template[tpl_len - 2] : 0);
+    const bool asterisk = last == '*' || (prevlast == '*' && last == '?');
+    const bool quest = last == '?' || (prevlast == '?' && last == '*');
+
+    if (exact_match_chars < (size_t)(asterisk + quest * 2)) {
+        return false;
+    }
+    exact_match_chars -= asterisk + quest * 2;
+    if (match_upto < exact_match_chars) {
+        return false;
+    }
+    if (!quest) {
+        if (!asterisk && match_upto != exact_match_chars) {
+            return false;
+        }
+        return strncmp(uri_template, uri_to_match, exact_match_chars) == 0;
+    }
+    if (match_upto > exact_match_chars && uri_template[exact_match_chars] != uri_to_match[exact_match_chars]) {
+        return false;
+    }
+    if (strncmp(uri_template, uri_to_match, exact_match_chars) != 0) {
+        return false;
+    }
+    return asterisk || match_upto <= exact_match_chars + 1;
+}
+
+static bool uri_matches(server_t *srv, const httpd_uri_t *h, const char *uri, size_t len)
+{
+    if (srv->config.uri_match_fn) {
+        return srv->config.uri_match_fn(h->uri, uri, len);
+    }
+    return strlen(h->uri) == len && strncmp(h->uri, uri, len) == 0;
+}
+
+static int parse_method(const char *m, size_t len)
+{
+    static const struct {
+        const char *name;
+        int method;
+    } methods[] = {
+        { "DELETE", HTTP_DELETE }, { "GET", HTTP_GET }, { "HEAD", HTTP_HEAD },
+        { "POST", HTTP_POST }, { "PUT", HTTP_PUT }, { "OPTIONS", HTTP_OPTIONS },
+        { "PATCH", HTTP_PATCH },
+    };
+    for (size_t i = 0; i < sizeof(methods) / sizeof(methods[0]); i++) {
+        if (strlen(methods[i].name) == len && strncmp(methods[i].name, m, len) == 0) {
+            return methods[i].method;
+        }
+    }
+    return -1;
+}
+
+// Read and dispatch one request from a readable session
+static req_result_t handle_request(server_t *srv, sess_t *sess)
+{
+    char *hdr_end = NULL;
+    while ((hdr_end = memmem(sess->rx, sess->rx_len, "\r\n\r\n", 4)) == NULL) {
+        if (sess->rx_len >= SESS_RX_LEN) {
+            return REQ_CLOSE;
+        }
+        ssize_t n = recv(sess->fd, sess->rx + sess->rx_len, SESS_RX_LEN - sess->rx_len, 0);
+        if (n <= 0) {
+            return REQ_CLOSE;
+        }
+        sess->rx_len += (size_t)n;
+    }
+    sess->lru = ++srv->lru_clock;
+
+    static resp_hdr_t resp_hdrs[64];
+    req_aux_t aux = {
+        .sess = sess,
+        .status = HTTPD_200,
+        .content_type = HTTPD_TYPE_TEXT,
+        .resp_hdrs = resp_hdrs,
+        .keep_alive = true,
+    };
+    httpd_req_t req = { .handle = srv, .aux = &aux };
+
+    size_t head_len = (size_t)(hdr_end - sess->rx) + 4;
+    char *line_end = memmem(sess->rx, head_len, "\r\n", 2);
+    char *sp1 = memchr(sess->rx, ' ', (size_t)(line_end - sess->rx));
+    char *sp2 = sp1 ? memchr(sp1 + 1, ' ', (size_t)(line_end - sp1 - 1)) : NULL;
+    size_t hdr_block_len = head_len - (size_t)(line_end + 2 - sess->rx);
+    bool bad = sp1 == NULL || sp2 == NULL || hdr_block_len > HTTPD_MAX_REQ_HDR_LEN;
+    bool uri_too_long = !bad && (size_t)(sp2 - sp1 - 1) > HTTPD_MAX_URI_LEN;
+    if (!bad) {
+        req.method = parse_method(sess->rx, (size_t)(sp1 - sess->rx));
+        if (!uri_too_long) {
+            memcpy((char *)req.uri, sp1 + 1, (size_t)(sp2 - sp1 - 1));
+        }
+        memcpy(aux.hdr, line_end + 2, hdr_block_len);
+        aux.hdr[hdr_block_len] = '\0';
+        if (strncmp(sp2 + 1, "HTTP/1.0", 8) == 0) {
+            aux.keep_alive = false;
+        }
+    }
+    memmove(sess->rx, sess->rx + head_len, sess->rx_len - head_len);
+    sess->rx_len -= head_len;
+
+    if (bad || uri_too_long) {
+        httpd_resp_send_err(&req, bad ? HTTPD_431_REQ_HDR_FIELDS_TOO_LARGE : HTTPD_414_URI_TOO_LONG, NULL);
+        return REQ_CLOSE;
+    }
+
+    char conn[16];
+    if (httpd_req_get_hdr_value_str(&req, "Connection", conn, sizeof(conn)) == ESP_OK) {
+        aux.keep_alive = strcasecmp(conn, "close") != 0 &&
+                         (aux.keep_alive || strcasecmp(conn, "keep-alive") == 0);
+    }
+    char clen[24];
+    if (httpd_req_get_hdr_value_str(&req, "Content-Length", clen, sizeof(clen)) == ESP_OK) {
+        req.content_len = strtoul(clen, NULL, 10);
+        aux.body_remaining = req.content_len;
+    }
+
+    const char *q = strchr(req.uri, '?');
+    size_t match_len = q ? (size_t)(q - req.uri) : strlen(req.uri);
+    const httpd_uri_t *handler = NULL;
+    bool uri_known = false;
+    for (unsigned i = 0; i < srv->n_handlers; i++) {
+        if (uri_matches(srv, &srv->handlers[i], req.uri, match_len)) {
+            uri_known = true;
+            if ((int)srv->handlers[i].method == req.method) {
+                handler = &srv->handlers[i];
+                break;
+            }
+        }
+    }
+
+    esp_err_t ret;
+    if (handler == NULL) {
+        ret = httpd_resp_send_err(&req, uri_known ? HTTPD_405_METHOD_NOT_ALLOWED : HTTPD_404_NOT_FOUND, NULL);
+    } else {
+        req.user_ctx = handler->user_ctx;
+        req.sess_ctx = sess->ctx;
+        req.free_ctx = sess->free_ctx;
+        ret = handler->handler(&req);
+        if (req.sess_ctx != sess->ctx) {
+            if (sess->free_ctx && sess->ctx) {
+                sess->free_ctx(sess->ctx);
+            }
+            sess->ctx = req.sess_ctx;
+            sess->free_ctx = req.free_ctx;
+        }
+    }
+    if (aux.detached) {
+        return ret == ESP_OK ? REQ_DETACHED : REQ_CLOSE;
+    }
+    if (ret != ESP_OK) {
+        return REQ_CLOSE;
+    }
+    return finish_request(&req) ? REQ_KEEP : REQ_CLOSE;
+}
+
+/* -------------------------------------------------------- server thread */
+
+static void serve_session(server_t *srv, sess_t *sess)
+{
+    req_result_t res = handle_request(srv, sess);
+    // Serve pipelined requests already sitting in the buffer
+    while (res == REQ_KEEP && memmem(sess->rx, sess->rx_len, "\r\n\r\n", 4) != NULL) {
+        res = handle_request(srv, sess);
+    }
+    if (res == REQ_CLOSE) {
+        sess_close(srv, sess);
+    }
+}
+
+static void run_work(server_t *srv)
+{
+    char drain[64];
+    while (read(srv->wake_pipe[0], drain, sizeof(drain)) > 0) {
+    }
+    pthread_mutex_lock(&srv->work_lock);
+    work_item_t *list = srv->work_head;
+    srv->work_head = srv->work_tail = NULL;
+    pthread_mutex_unlock(&srv->work_lock);
+    while (list) {
+        work_item_t *next = list->next;
+        list->fn(list->arg);
+        free(list);
+        list = next;
+    }
+    for (unsigned i = 0; i < srv->config.max_open_sockets; i++) {
+        if (srv->sessions[i].fd >= 0 && srv->sessions[i].close_requested && !srv->sessions[i].async_busy) {
+            sess_close(srv, &srv->sessions[i]);
+        }
+    }
+}
+
+static sess_t *sess_alloc(server_t *srv)
+{
+    sess_t *lru = NULL;
+    for (unsigned i = 0; i < srv->config.max_open_sockets; i++) {
+        if (srv->sessions[i].fd < 0) {
+            return &srv->sessions[i];
+        }
+        if (!srv->sessions[i].async_busy && (lru == NULL || srv->sessions[i].lru < lru->lru)) {
+            lru = &srv->sessions[i];
+        }
+    }
+    if (srv->config.lru_purge_enable && lru) {
+        ESP_LOGD(TAG, "purging LRU session %d", lru->fd);
+        sess_close(srv, lru);
+        return lru;
+    }
+    return NULL;
+}
+
+static void *server_thread(void *arg)
+{
+    server_t *srv = arg;
+    // Look like the IDF httpd task to pcTaskGetName / stack high-water marks
+    sim_task_t *self = sim_self();
+    snprintf(self->name, sizeof(self->name), "httpd");
+    self->stack_depth = srv->config.stack_size;
+    while (!srv->stop) {
+        fd_set rfds;
+        FD_ZERO(&rfds);
+        FD_SET(srv->wake_pipe[0], &rfds);
+        int maxfd = srv->wake_pipe[0];
+        unsigned open = 0;
+        for (unsigned i = 0; i < srv->config.max_open_sockets; i++) {
+            int fd = srv->sessions[i].fd;
+            if (fd >= 0) {
+                open++;
+                if (!srv->sessions[i].async_busy) {
+                    FD_SET(fd, &rfds);
+                    maxfd = fd > maxfd ? fd : maxfd;
+                }
+            }
+        }
+        // Like the device server, stop accepting while every slot is taken
+        if (open < srv->config.max_open_sockets || srv->config.lru_purge_enable) {
+            FD_SET(srv->listen_fd, &rfds);
+            maxfd = srv->listen_fd > maxfd ? srv->listen_fd : maxfd;
+        }
+        if (select(maxfd + 1, &rfds, NULL, NULL, NULL) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ESP_LOGE(TAG, "select failed: %s", strerror(errno));
+            break;
+        }
+        if (FD_ISSET(srv->wake_pipe[0], &rfds)) {
+            run_work(srv);
+        }
+        for (unsigned i = 0; i < srv->config.max_open_sockets; i++) {
+            sess_t *sess = &srv->sessions[i];
+            if (sess->fd >= 0 && !sess->async_busy && FD_ISSET(sess->fd, &rfds)) {
+                serve_session(srv, sess);
+            }
+        }
+        if (FD_ISSET(srv->listen_fd, &rfds)) {
+            int fd = accept(srv->listen_fd, NULL, NULL);
+            if (fd < 0) {
+                continue;
+            }
+            sess_t *sess = sess_alloc(srv);
+            if (sess == NULL) {
+                close(fd);
+                continue;
+            }
+            set_sock_opts(fd, &srv->config);
+            if (srv->config.open_fn && srv->config.open_fn(srv, fd) != ESP_OK) {
+                close(fd);
+                continue;
+            }
+            sess->fd = fd;
+            sess->rx_len = 0;
+            sess->lru = ++srv->lru_clock;
+        }
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------ lifecycle */
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    if (handle == NULL || config == NULL || config->max_open_sockets == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    server_t *srv = calloc(1, sizeof(*srv));
+    if (srv == NULL) {
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    srv->config = *config;
+    if (srv->config.max_resp_headers > 64) {
+        srv->config.max_resp_headers = 64;
+    }
+    srv->handlers = calloc(config->max_uri_handlers, sizeof(httpd_uri_t));
+    srv->sessions = calloc(config->max_open_sockets, sizeof(sess_t));
+    if (srv->handlers == NULL || srv->sessions == NULL) {
+        free(srv->handlers);
+        free(srv->sessions);
+        free(srv);
+        return ESP_ERR_HTTPD_ALLOC_MEM;
+    }
+    for (unsigned i = 0; i < config->max_open_sockets; i++) {
+        srv->sessions[i].fd = -1;
+    }
+    pthread_mutex_init(&srv->work_lock, NULL);
+
+    uint16_t port = s_port_override ? s_port_override : config->server_port;
+    srv->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(srv->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons(port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (srv->listen_fd < 0 || bind(srv->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(srv->listen_fd, config->backlog_conn) < 0 || pipe(srv->wake_pipe) < 0) {
+        ESP_LOGE(TAG, "error binding port %u: %s", port, strerror(errno));
+        if (srv->listen_fd >= 0) {
+            close(srv->listen_fd);
+        }
+        free(srv->handlers);
+        free(srv->sessions);
+        free(srv);
+        return ESP_ERR_HTTPD_TASK;
+    }
+    fcntl(srv->wake_pipe[0], F_SETFL, O_NONBLOCK);
+
+    if (pthread_create(&srv->thread, NULL, server_thread, srv) != 0) {
+        close(srv->listen_fd);
+        free(srv->handlers);
+        free(srv->sessions);
+        free(srv);
+        return ESP_ERR_HTTPD_TASK;
+    }
+    pthread_setname_np(srv->thread, "httpd");
+    ESP_LOGI(TAG, "Started server on port: '%u'", port);
+    *handle = srv;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    server_t *srv = handle;
+    if (srv == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    srv->stop = true;
+    (void)!write(srv->wake_pipe[1], "x", 1);
+    pthread_join(srv->thread, NULL);
+    for (unsigned i = 0; i < srv->config.max_open_sockets; i++) {
+        sess_close(srv, &srv->sessions[i]);
+    }
+    close(srv->listen_fd);
+    close(srv->wake_pipe[0]);
+    close(srv->wake_pipe[1]);
+    free(srv->handlers);
+    free(srv->sessions);
+    free(srv);
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    server_t *srv = handle;
+    if (srv == NULL || uri_handler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (unsigned i = 0; i < srv->n_handlers; i++) {
+        if (srv->handlers[i].method == uri_handler->method &&
+            strcmp(srv->handlers[i].uri, uri_handler->uri) == 0) {
+            return ESP_ERR_HTTPD_HANDLER_EXISTS;
+        }
+    }
+    if (srv->n_handlers >= srv->config.max_uri_handlers) {
+        ESP_LOGW(TAG, "no slots left for registering handler");
+        return ESP_ERR_HTTPD_HANDLERS_FULL;
+    }
+    srv->handlers[srv->n_handlers++] = *uri_handler;
+    return ESP_OK;
+}
+
+esp_err_t httpd_unregister_uri_handler(httpd_handle_t handle, const char *uri, httpd_method_t method)
+{
+    server_t *srv = handle;
+    for (unsigned i = 0; srv && i < srv->n_handlers; i++) {
+        if (srv->handlers[i].method == method && strcmp(srv->handlers[i].uri, uri) == 0) {
+            memmove(&srv->handlers[i], &srv->handlers[i + 1], (srv->n_handlers - i - 1) * sizeof(httpd_uri_t));
+            srv->n_handlers--;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+/* ------------------------------------------------------- async helpers */
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg)
+{
+    server_t *srv = handle;
+    if (srv == NULL || work == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    work_item_t *item = malloc(sizeof(*item));
+    if (item == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    item->fn = work;
+    item->arg = arg;
+    item->next = NULL;
+    pthread_mutex_lock(&srv->work_lock);
+    if (srv->work_tail) {
+        srv->work_tail->next = item;
+    } else {
+        srv->work_head = item;
+    }
+    srv->work_tail = item;
+    pthread_mutex_unlock(&srv->work_lock);
+    (void)!write(srv->wake_pipe[1], "w", 1);
+    return ESP_OK;
+}
+
+int httpd_socket_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags)
+{
+    (void)hd;
+    (void)flags;
+    return send_all(sockfd, buf, buf_len);
+}
+
+static void close_work(void *arg)
+{
+    (void)arg;  // run_work() closes sessions flagged close_requested
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd)
+{
+    server_t *srv = handle;
+    sess_t *sess = srv ? sess_find(srv, sockfd) : NULL;
+    if (sess == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    sess->close_requested = true;
+    return httpd_queue_work(handle, close_work, NULL);
+}
+
+// Async requests: the handler hands a copy of the request to another task
+// and returns; the session is left alone until the copy is completed.
+typedef struct {
+    httpd_req_t req;
+    req_aux_t aux;
+} async_req_t;
+
+typedef struct {
+    server_t *srv;
+    sess_t *sess;
+    bool keep;
+} async_done_t;
+
+esp_err_t httpd_req_async_handler_begin(httpd_req_t *r, httpd_req_t **out)
+{
+    if (r == NULL || out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    server_t *srv = r->handle;
+    req_aux_t *aux = r->aux;
+    async_req_t *copy = calloc(1, sizeof(*copy));
+    resp_hdr_t *hdrs = calloc(srv->config.max_resp_headers, sizeof(resp_hdr_t));
+    if (copy == NULL || hdrs == NULL) {
+        free(copy);
+        free(hdrs);
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(&copy->req, r, sizeof(*r));
+    copy->aux = *aux;
+    memcpy(hdrs, aux->resp_hdrs, aux->n_resp_hdrs * sizeof(resp_hdr_t));
+    copy->aux.resp_hdrs = hdrs;
+    copy->req.aux = &copy->aux;
+    aux->detached = true;
+    aux->sess->async_busy = true;
+    *out = &copy->req;
+    return ESP_OK;
+}
+
+static void async_done_work(void *arg)
+{
+    async_done_t *done = arg;
+    sess_t *sess = done->sess;
+    sess->async_busy = false;
+    sess->lru = ++done->srv->lru_clock;
+    if (!done->keep || sess->close_requested) {
+        sess_close(done->srv, sess);
+    } else if (memmem(sess->rx, sess->rx_len, "\r\n\r\n", 4) != NULL) {
+        serve_session(done->srv, sess);
+    }
+    free(done);
+}
+
+esp_err_t httpd_req_async_handler_complete(httpd_req_t *r)
+{
+    if (r == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    async_req_t *copy = (async_req_t *)r;
+    async_done_t *done = malloc(sizeof(*done));
+    if (done == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    done->srv = r->handle;
+    done->sess = copy->aux.sess;
+    done->keep = finish_request(r);
+    free(copy->aux.resp_hdrs);
+    free(copy);
+    return httpd_queue_work(done->srv, async_done_work, done);
+}
+
+void *httpd_sess_get_ctx(httpd_handle_t handle, int sockfd)
+{
+    sess_t *sess = handle ? sess_find(handle, sockfd) : NULL;
+    return sess ? sess->ctx : NULL;
+}
+
+void httpd_sess_set_ctx(httpd_handle_t handle, int sockfd, void *ctx, httpd_free_ctx_fn_t free_fn)
+{
+    sess_t *sess = handle ? sess_find(handle, sockfd) : NULL;
+    if (sess) {
+        sess->ctx = ctx;
+        sess->free_ctx = free_fn;
+    }
+}
+
+esp_err_t httpd_get_client_list(httpd_handle_t handle, size_t *fds, int *client_fds)
+{
+    server_t *srv = handle;
+    if (srv == NULL || fds == NULL || client_fds == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    size_t n = 0;
+    for (unsigned i = 0; i < srv->config.max_open_sockets && n < *fds; i++) {
+        if (srv->sessions[i].fd >= 0) {
+            client_fds[n++] = srv->sessions[i].fd;
+        }
+    }
+    *fds = n;
+    return ESP_OK;
+}
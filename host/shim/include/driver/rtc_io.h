@@ -0,0 +1,24 @@
+#ifndef DRIVER_RTC_IO_H
+#define DRIVER_RTC_IO_H
+
+// Host stand-in for driver/rtc_io.h: routing a pin to the RTC domain (so
+// the ULP can read it in sleep) and back. Levels still come from the plant.
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+
+typedef enum {
+    RTC_GPIO_MODE_INPUT_ONLY,
+    RTC_GPIO_MODE_OUTPUT_ONLY,
+    RTC_GPIO_MODE_INPUT_OUTPUT,
+    RTC_GPIO_MODE_DISABLED,
+} rtc_gpio_mode_t;
+
+bool rtc_gpio_is_valid_gpio(gpio_num_t gpio_num);
+int rtc_io_number_get(gpio_num_t gpio_num);     // -1 if the pin has no RTC function
+esp_err_t rtc_gpio_init(gpio_num_t gpio_num);
+esp_err_t rtc_gpio_deinit(gpio_num_t gpio_num);
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio_num, rtc_gpio_mode_t mode);
+
+#endif // DRIVER_RTC_IO_H
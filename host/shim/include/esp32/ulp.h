@@ -0,0 +1,83 @@
+#ifndef ESP32_ULP_H
+#define ESP32_ULP_H
+
+// Host stand-in for the ESP32 ULP FSM macro assembler (esp32/ulp.h).
+//
+// Programs are written with the same I_xxx / M_xxx macros as on the device
+// and loaded with ulp_process_macros_and_load(). The encoding is a plain
+// struct instead of the 32-bit instruction word: the ULP shim interprets it
+// on the virtual clock, reading the ADC and RTC GPIO inputs through the same
+// plant hooks as the main-core drivers.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+enum { R0, R1, R2, R3 };
+
+typedef enum {
+    SIM_ULP_LABEL = 1,
+    SIM_ULP_MOVI,
+    SIM_ULP_MOVR,
+    SIM_ULP_ADDR,
+    SIM_ULP_ADDI,
+    SIM_ULP_SUBR,
+    SIM_ULP_SUBI,
+    SIM_ULP_RSHI,
+    SIM_ULP_LD,
+    SIM_ULP_ST,
+    SIM_ULP_ADC,
+    SIM_ULP_RD_REG,
+    SIM_ULP_BL,         // branch to label if R0 < imm
+    SIM_ULP_BGE,        // branch to label if R0 >= imm
+    SIM_ULP_BX,         // jump to label
+    SIM_ULP_WAKE,
+    SIM_ULP_END,        // stop the ULP wakeup timer
+    SIM_ULP_HALT,
+} sim_ulp_op_t;
+
+typedef struct {
+    uint8_t op;
+    uint8_t a, b, c;
+    uint32_t imm;
+} ulp_insn_t;
+
+#define M_LABEL(n)               { .op = SIM_ULP_LABEL, .imm = (n) }
+#define I_MOVI(d, v)             { .op = SIM_ULP_MOVI, .a = (d), .imm = (v) }
+#define I_MOVR(d, s)             { .op = SIM_ULP_MOVR, .a = (d), .b = (s) }
+#define I_ADDR(d, s1, s2)        { .op = SIM_ULP_ADDR, .a = (d), .b = (s1), .c = (s2) }
+#define I_ADDI(d, s, v)          { .op = SIM_ULP_ADDI, .a = (d), .b = (s), .imm = (v) }
+#define I_SUBR(d, s1, s2)        { .op = SIM_ULP_SUBR, .a = (d), .b = (s1), .c = (s2) }
+#define I_SUBI(d, s, v)          { .op = SIM_ULP_SUBI, .a = (d), .b = (s), .imm = (v) }
+#define I_RSHI(d, s, v)          { .op = SIM_ULP_RSHI, .a = (d), .b = (s), .imm = (v) }
+#define I_LD(d, addr, off)       { .op = SIM_ULP_LD, .a = (d), .b = (addr), .imm = (off) }
+#define I_ST(v, addr, off)       { .op = SIM_ULP_ST, .a = (v), .b = (addr), .imm = (off) }
+#define I_ADC(d, adc, pad)       { .op = SIM_ULP_ADC, .a = (d), .b = (adc), .c = (pad) }
+#define I_RD_REG(reg, lo, hi)    { .op = SIM_ULP_RD_REG, .b = (lo), .c = (hi), .imm = (reg) }
+#define M_BL(label, v)           { .op = SIM_ULP_BL, .a = (label), .imm = (v) }
+#define M_BGE(label, v)          { .op = SIM_ULP_BGE, .a = (label), .imm = (v) }
+#define M_BX(label)              { .op = SIM_ULP_BX, .a = (label) }
+#define I_WAKE()                 { .op = SIM_ULP_WAKE }
+#define I_END()                  { .op = SIM_ULP_END }
+#define I_HALT()                 { .op = SIM_ULP_HALT }
+
+// RTC slow memory shared between the main cores and the ULP (32-bit words,
+// the ULP reads and writes the low 16 bits)
+#define SIM_RTC_SLOW_MEM_WORDS 2048
+extern uint32_t sim_rtc_slow_mem[SIM_RTC_SLOW_MEM_WORDS];
+#define RTC_SLOW_MEM sim_rtc_slow_mem
+
+#define ESP_ERR_ULP_BASE            0x1200
+#define ESP_ERR_ULP_SIZE_TOO_BIG    (ESP_ERR_ULP_BASE + 1)
+#define ESP_ERR_ULP_INVALID_LOAD_ADDR (ESP_ERR_ULP_BASE + 2)
+#define ESP_ERR_ULP_DUPLICATE_LABEL (ESP_ERR_ULP_BASE + 3)
+#define ESP_ERR_ULP_UNDEFINED_LABEL (ESP_ERR_ULP_BASE + 4)
+#define ESP_ERR_ULP_BRANCH_OUT_OF_RANGE (ESP_ERR_ULP_BASE + 5)
+
+esp_err_t ulp_process_macros_and_load(uint32_t load_addr, const ulp_insn_t *program, size_t *psize);
+esp_err_t ulp_run(uint32_t entry_point);
+esp_err_t ulp_set_wakeup_period(size_t period_index, uint32_t period_us);
+void ulp_timer_stop(void);
+void ulp_timer_resume(void);
+
+#endif // ESP32_ULP_H
@@ -0,0 +1,20 @@
+#ifndef ESP_APP_DESC_H
+#define ESP_APP_DESC_H
+
+// Host stand-in for esp_app_desc.h: the fields the firmware reads.
+
+#include <stdint.h>
+
+typedef struct {
+    uint32_t magic_word;
+    uint32_t secure_version;
+    char version[32];
+    char project_name[32];
+    char time[16];
+    char date[16];
+    char idf_ver[32];
+} esp_app_desc_t;
+
+const esp_app_desc_t *esp_app_get_description(void);
+
+#endif // ESP_APP_DESC_H
@@ -0,0 +1,12 @@
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+// Host stand-in for esp_attr.h: placement attributes have no meaning off-chip.
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define EXT_RAM_BSS_ATTR
+
+#endif // ESP_ATTR_H
@@ -0,0 +1,19 @@
+#ifndef ESP_CPU_H
+#define ESP_CPU_H
+
+// Host stand-in for esp_cpu.h: the "cycle" counter ticks once per
+// nanosecond of host monotonic time, wrapping at 32 bits like CCOUNT.
+
+#include <stdint.h>
+#include <time.h>
+
+typedef uint32_t esp_cpu_cycle_count_t;
+
+static inline esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (esp_cpu_cycle_count_t)((uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec);
+}
+
+#endif // ESP_CPU_H
@@ -0,0 +1,24 @@
+#ifndef ESP_HEAP_CAPS_H
+#define ESP_HEAP_CAPS_H
+
+// Host stand-in for esp_heap_caps.h: the same fixed heap figures as
+// esp_system.h, and the allocation hooks (CONFIG_HEAP_USE_HOOKS), which
+// host/sim/sim_heap.c calls for every malloc and free a firmware task makes.
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_system.h"
+
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+#define SIM_LARGEST_FREE_BLOCK 110592
+
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+__attribute__((weak)) void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps);
+__attribute__((weak)) void esp_heap_trace_free_hook(void *ptr);
+
+#endif // ESP_HEAP_CAPS_H
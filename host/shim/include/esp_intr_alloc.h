@@ -0,0 +1,13 @@
+#ifndef ESP_INTR_ALLOC_H
+#define ESP_INTR_ALLOC_H
+
+// Host stand-in for esp_intr_alloc.h: the allocation flags are accepted and
+// ignored, handlers always run on the shim's interrupt tasks.
+
+#define ESP_INTR_FLAG_LEVEL1     (1 << 1)
+#define ESP_INTR_FLAG_SHARED     (1 << 8)
+#define ESP_INTR_FLAG_EDGE       (1 << 9)
+#define ESP_INTR_FLAG_IRAM       (1 << 10)
+#define ESP_INTR_FLAG_INTRDISABLED (1 << 11)
+
+#endif // ESP_INTR_ALLOC_H
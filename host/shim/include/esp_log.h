@@ -0,0 +1,45 @@
+#ifndef ESP_LOG_H
+#define ESP_LOG_H
+
+#include <stdarg.h>
+#include <stdint.h>
+
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE,
+} esp_log_level_t;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level);
+esp_log_level_t esp_log_get_default_level(void);
+esp_log_level_t esp_log_level_get(const char *tag);
+uint32_t esp_log_timestamp(void);
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+
+#define ESP_LOG_LEVEL_ENABLED(level) ((level) <= esp_log_get_default_level())
+
+#define ESP_LOG_LEVEL(level, letter, tag, format, ...) do {                         \
+        if (ESP_LOG_LEVEL_ENABLED(level)) {                                         \
+            esp_log_write(level, tag, #letter " (%u) %s: " format "\n",             \
+                          (unsigned)esp_log_timestamp(), tag, ##__VA_ARGS__);       \
+        }                                                                           \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_ERROR,   E, tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_WARN,    W, tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_INFO,    I, tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_DEBUG,   D, tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) ESP_LOG_LEVEL(ESP_LOG_VERBOSE, V, tag, format, ##__VA_ARGS__)
+
+#define ESP_EARLY_LOGE ESP_LOGE
+#define ESP_EARLY_LOGW ESP_LOGW
+#define ESP_EARLY_LOGI ESP_LOGI
+#define ESP_DRAM_LOGE  ESP_LOGE
+#define ESP_DRAM_LOGW  ESP_LOGW
+#define ESP_DRAM_LOGI  ESP_LOGI
+
+#endif // ESP_LOG_H
@@ -0,0 +1,50 @@
+#ifndef ESP_NETIF_SNTP_H
+#define ESP_NETIF_SNTP_H
+
+// Host stand-in for esp_netif_sntp.h: the simulated server answers shortly
+// after the station gets an IP, with a virtual wall clock (esp_sntp_sim.c).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include "esp_err.h"
+
+typedef void (*esp_sntp_time_cb_t)(struct timeval *tv);
+
+#define SIM_SNTP_MAX_SERVERS 1
+
+typedef struct esp_sntp_config {
+    bool smooth_sync;
+    bool server_from_dhcp;
+    bool wait_for_sync;
+    bool start;
+    esp_sntp_time_cb_t sync_cb;
+    bool renew_servers_after_new_IP;
+    int ip_event_to_renew;
+    size_t index_of_first_server;
+    size_t num_of_servers;
+    const char *servers[SIM_SNTP_MAX_SERVERS];
+} esp_sntp_config_t;
+
+#define ESP_NETIF_SNTP_DEFAULT_CONFIG(server) { \
+    .smooth_sync = false,                       \
+    .server_from_dhcp = false,                  \
+    .wait_for_sync = true,                      \
+    .start = true,                              \
+    .sync_cb = NULL,                            \
+    .renew_servers_after_new_IP = false,        \
+    .ip_event_to_renew = 0,                     \
+    .index_of_first_server = 0,                 \
+    .num_of_servers = 1,                        \
+    .servers = { server },                      \
+}
+
+esp_err_t esp_netif_sntp_init(const esp_sntp_config_t *config);
+void esp_netif_sntp_deinit(void);
+
+// Simulation: UTC seconds on the virtual clock at boot (0 = no time server)
+#define SIM_SNTP_DEFAULT_EPOCH  1767225600      // 2026-01-01 00:00:00 UTC
+void sim_sntp_set_epoch(int64_t epoch_s);
+
+#endif // ESP_NETIF_SNTP_H
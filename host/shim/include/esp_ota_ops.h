@@ -0,0 +1,63 @@
+#ifndef ESP_OTA_OPS_H
+#define ESP_OTA_OPS_H
+
+// Host stand-in for esp_ota_ops.h. The simulated flash has two app
+// partitions of SIM_OTA_PARTITION_SIZE, the firmware running from ota_0
+// (the image from --firmware, or a synthetic one). Updates write ota_1 in
+// memory; esp_ota_end() only checks the image magic byte. A restart ends
+// the run, so "booting" the new image is the report's ota.boot line and
+// --ota-out's file.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "esp_partition.h"
+
+#define SIM_OTA_PARTITION_SIZE      0x100000    // 1 MB, as partitions_two_ota.csv
+#define SIM_OTA_IMAGE_SIZE          0x30000     // synthetic running image
+#define ESP_IMAGE_HEADER_MAGIC      0xE9
+
+#define OTA_SIZE_UNKNOWN            0xffffffff
+
+#define ESP_ERR_OTA_PARTITION_CONFLICT          (ESP_ERR_OTA_BASE + 0x01)
+#define ESP_ERR_OTA_SELECT_INFO_INVALID         (ESP_ERR_OTA_BASE + 0x02)
+#define ESP_ERR_OTA_VALIDATE_FAILED             (ESP_ERR_OTA_BASE + 0x03)
+#define ESP_ERR_OTA_SMALL_SEC_VER               (ESP_ERR_OTA_BASE + 0x04)
+#define ESP_ERR_OTA_ROLLBACK_FAILED             (ESP_ERR_OTA_BASE + 0x05)
+#define ESP_ERR_OTA_ROLLBACK_INVALID_STATE      (ESP_ERR_OTA_BASE + 0x06)
+
+typedef uint32_t esp_ota_handle_t;
+
+typedef enum {
+    ESP_OTA_IMG_NEW = 0x0U,
+    ESP_OTA_IMG_PENDING_VERIFY = 0x1U,
+    ESP_OTA_IMG_VALID = 0x2U,
+    ESP_OTA_IMG_INVALID = 0x3U,
+    ESP_OTA_IMG_ABORTED = 0x4U,
+    ESP_OTA_IMG_UNDEFINED = 0xFFFFFFFFU,
+} esp_ota_img_states_t;
+
+const esp_partition_t *esp_ota_get_running_partition(void);
+const esp_partition_t *esp_ota_get_boot_partition(void);
+const esp_partition_t *esp_ota_get_next_update_partition(const esp_partition_t *start_from);
+esp_err_t esp_ota_begin(const esp_partition_t *partition, size_t image_size, esp_ota_handle_t *out_handle);
+esp_err_t esp_ota_write(esp_ota_handle_t handle, const void *data, size_t size);
+esp_err_t esp_ota_end(esp_ota_handle_t handle);
+esp_err_t esp_ota_abort(esp_ota_handle_t handle);
+esp_err_t esp_ota_set_boot_partition(const esp_partition_t *partition);
+esp_err_t esp_ota_get_state_partition(const esp_partition_t *partition, esp_ota_img_states_t *ota_state);
+esp_err_t esp_ota_mark_app_valid_cancel_rollback(void);
+esp_err_t esp_ota_mark_app_invalid_rollback_and_reboot(void);
+
+// Simulation: the running image (NULL = synthetic) and whether it boots on
+// trial, as after an update; before app_main
+bool sim_ota_load_firmware(const char *path);
+void sim_ota_set_pending_verify(bool pending);
+// Save the image ota_1 holds when it is the boot partition
+void sim_ota_set_output(const char *path);
+// ota.* lines for the run report; writes the --ota-out file
+void sim_ota_report(FILE *out);
+
+#endif // ESP_OTA_OPS_H
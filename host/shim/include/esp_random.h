@@ -0,0 +1,13 @@
+#ifndef ESP_RANDOM_H
+#define ESP_RANDOM_H
+
+// Host stand-in for esp_random.h. Deterministic per run (xorshift) so
+// fast-forward simulations stay reproducible.
+
+#include <stddef.h>
+#include <stdint.h>
+
+uint32_t esp_random(void);
+void esp_fill_random(void *buf, size_t len);
+
+#endif // ESP_RANDOM_H
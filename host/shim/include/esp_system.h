@@ -0,0 +1,20 @@
+#ifndef ESP_SYSTEM_H
+#define ESP_SYSTEM_H
+
+// Host stand-in for esp_system.h: heap figures and restart. The host heap
+// is not the ESP32's, so these report a fixed, typical free heap for the
+// firmware.
+
+#include <stdint.h>
+
+#define SIM_FREE_HEAP_BYTES 180000
+
+uint32_t esp_get_free_heap_size(void);
+uint32_t esp_get_minimum_free_heap_size(void);
+void esp_restart(void) __attribute__((noreturn));
+
+// Simulation: esp_restart() ends the run here. The default just exits;
+// host/sim prints its report first.
+void sim_restart(void) __attribute__((noreturn));
+
+#endif // ESP_SYSTEM_H
@@ -0,0 +1,30 @@
+#ifndef ESP_TASK_WDT_H
+#define ESP_TASK_WDT_H
+
+// Host stand-in for esp_task_wdt.h. Subscribed tasks are checked on the
+// virtual clock; a missed reset is logged and counted instead of panicking.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+typedef struct {
+    uint32_t timeout_ms;
+    uint32_t idle_core_mask;
+    bool trigger_panic;
+} esp_task_wdt_config_t;
+
+esp_err_t esp_task_wdt_init(const esp_task_wdt_config_t *config);
+esp_err_t esp_task_wdt_reconfigure(const esp_task_wdt_config_t *config);
+esp_err_t esp_task_wdt_deinit(void);
+esp_err_t esp_task_wdt_add(TaskHandle_t task_handle);
+esp_err_t esp_task_wdt_delete(TaskHandle_t task_handle);
+esp_err_t esp_task_wdt_reset(void);
+
+// Simulation: wdt.* lines for the run report
+void sim_task_wdt_report(FILE *out);
+
+#endif // ESP_TASK_WDT_H
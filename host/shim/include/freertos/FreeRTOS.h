@@ -0,0 +1,74 @@
+#ifndef FREERTOS_H
+#define FREERTOS_H
+
+// Host stand-in for the ESP-IDF FreeRTOS headers. Only the subset the
+// firmware uses is provided; semantics follow the FreeRTOS reference, timing
+// follows the simulation's virtual clock (see host/shim/sim_kernel.h).
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "esp_err.h"
+#include "esp_bit_defs.h"
+
+typedef int32_t BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;         // ESP-IDF counts stacks in bytes
+
+// Buffers for the xCreateStatic() calls. The sim backs every kernel object
+// with its own host allocation and leaves these untouched, so they only
+// need to exist with a plausible size.
+typedef struct { uint8_t opaque[352]; } StaticTask_t;
+typedef struct { uint8_t opaque[84]; } StaticQueue_t;
+typedef StaticQueue_t StaticSemaphore_t;
+typedef struct { uint8_t opaque[32]; } StaticEventGroup_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define errQUEUE_FULL  0
+#define errQUEUE_EMPTY 0
+
+#define configTICK_RATE_HZ       100
+#define configMAX_PRIORITIES     25
+#define configMINIMAL_STACK_SIZE 768
+#define portTICK_PERIOD_MS       (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY            ((TickType_t)0xffffffffUL)
+#define portNUM_PROCESSORS       2
+
+#define pdMS_TO_TICKS(xTimeInMs) \
+    ((TickType_t)(((uint64_t)(xTimeInMs) * (uint64_t)configTICK_RATE_HZ) / 1000ULL))
+#define pdTICKS_TO_MS(xTicks) \
+    ((uint32_t)(((uint64_t)(xTicks) * 1000ULL) / (uint64_t)configTICK_RATE_HZ))
+
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+typedef struct {
+    pthread_mutex_t mutex;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP }
+
+void sim_port_enter_critical(portMUX_TYPE *mux);
+void sim_port_exit_critical(portMUX_TYPE *mux);
+
+#define portENTER_CRITICAL(mux)     sim_port_enter_critical(mux)
+#define portEXIT_CRITICAL(mux)      sim_port_exit_critical(mux)
+#define portENTER_CRITICAL_ISR(mux) sim_port_enter_critical(mux)
+#define portEXIT_CRITICAL_ISR(mux)  sim_port_exit_critical(mux)
+#define taskENTER_CRITICAL(mux)     sim_port_enter_critical(mux)
+#define taskEXIT_CRITICAL(mux)      sim_port_exit_critical(mux)
+#define taskENTER_CRITICAL_ISR(mux) sim_port_enter_critical(mux)
+#define taskEXIT_CRITICAL_ISR(mux)  sim_port_exit_critical(mux)
+
+#define portYIELD_FROM_ISR(...) do { } while (0)
+#define portYIELD()             do { } while (0)
+#define taskYIELD()             do { } while (0)
+
+#define configASSERT(x) do { if (!(x)) { sim_assert_failed(#x, __FILE__, __LINE__); } } while (0)
+void sim_assert_failed(const char *expr, const char *file, int line);
+
+#endif // FREERTOS_H
@@ -0,0 +1,40 @@
+#ifndef FREERTOS_QUEUE_H
+#define FREERTOS_QUEUE_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_queue *QueueHandle_t;
+
+#define queueQUEUE_TYPE_BASE            0
+#define queueQUEUE_TYPE_MUTEX           1
+#define queueQUEUE_TYPE_BINARY_SEMAPHORE 3
+#define queueQUEUE_TYPE_COUNTING_SEMAPHORE 2
+
+QueueHandle_t xQueueGenericCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t ucQueueType);
+QueueHandle_t xQueueGenericCreateStatic(UBaseType_t uxQueueLength, UBaseType_t uxItemSize,
+                                        uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue,
+                                        uint8_t ucQueueType);
+void vQueueDelete(QueueHandle_t xQueue);
+BaseType_t xQueueGenericSend(QueueHandle_t xQueue, const void *pvItemToQueue,
+                             TickType_t xTicksToWait, BaseType_t xCopyPosition);
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue);
+BaseType_t xQueueReset(QueueHandle_t xQueue);
+
+#define queueSEND_TO_BACK  0
+#define queueSEND_TO_FRONT 1
+#define queueOVERWRITE     2
+
+#define xQueueCreate(len, size) xQueueGenericCreate((len), (size), queueQUEUE_TYPE_BASE)
+#define xQueueCreateStatic(len, size, storage, buf) \
+    xQueueGenericCreateStatic((len), (size), (storage), (buf), queueQUEUE_TYPE_BASE)
+#define xQueueSend(q, item, ticks) xQueueGenericSend((q), (item), (ticks), queueSEND_TO_BACK)
+#define xQueueSendToBack(q, item, ticks) xQueueGenericSend((q), (item), (ticks), queueSEND_TO_BACK)
+#define xQueueSendToFront(q, item, ticks) xQueueGenericSend((q), (item), (ticks), queueSEND_TO_FRONT)
+#define xQueueOverwrite(q, item) xQueueGenericSend((q), (item), 0, queueOVERWRITE)
+#define xQueueSendFromISR(q, item, woken) ((void)(woken), xQueueGenericSend((q), (item), 0, queueSEND_TO_BACK))
+#define xQueueReceiveFromISR(q, buf, woken) ((void)(woken), xQueueReceive((q), (buf), 0))
+
+#endif // FREERTOS_QUEUE_H
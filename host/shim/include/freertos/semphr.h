@@ -0,0 +1,23 @@
+#ifndef FREERTOS_SEMPHR_H
+#define FREERTOS_SEMPHR_H
+
+#include "freertos/queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+QueueHandle_t xQueueCreateCountingSemaphore(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount);
+BaseType_t xQueueSemaphoreTake(QueueHandle_t xQueue, TickType_t xTicksToWait);
+
+#define xSemaphoreCreateBinary() xQueueGenericCreate(1, 0, queueQUEUE_TYPE_BINARY_SEMAPHORE)
+#define xSemaphoreCreateMutex()  xQueueCreateCountingSemaphore(1, 1)
+#define xSemaphoreCreateCounting(max, initial) xQueueCreateCountingSemaphore((max), (initial))
+#define xSemaphoreCreateMutexStatic(buf) ((void)(buf), xQueueCreateCountingSemaphore(1, 1))
+#define xSemaphoreCreateCountingStatic(max, initial, buf) \
+    ((void)(buf), xQueueCreateCountingSemaphore((max), (initial)))
+#define xSemaphoreTake(sem, ticks) xQueueSemaphoreTake((sem), (ticks))
+#define xSemaphoreGive(sem) xQueueGenericSend((sem), NULL, 0, queueSEND_TO_BACK)
+#define xSemaphoreGiveFromISR(sem, woken) ((void)(woken), xQueueGenericSend((sem), NULL, 0, queueSEND_TO_BACK))
+#define xSemaphoreTakeFromISR(sem, woken) ((void)(woken), xQueueSemaphoreTake((sem), 0))
+#define vSemaphoreDelete(sem) vQueueDelete(sem)
+
+#endif // FREERTOS_SEMPHR_H
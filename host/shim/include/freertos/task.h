@@ -0,0 +1,60 @@
+#ifndef FREERTOS_TASK_H
+#define FREERTOS_TASK_H
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName,
+                                   uint32_t usStackDepth, void *pvParameters,
+                                   UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask,
+                                   BaseType_t xCoreID);
+
+static inline BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char *pcName,
+                                     uint32_t usStackDepth, void *pvParameters,
+                                     UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask)
+{
+    return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters,
+                                   uxPriority, pvCreatedTask, tskNO_AFFINITY);
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t pxTaskCode, const char *pcName,
+                                         uint32_t ulStackDepth, void *pvParameters,
+                                         UBaseType_t uxPriority, StackType_t *puxStackBuffer,
+                                         StaticTask_t *pxTaskBuffer, BaseType_t xCoreID);
+
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+void vTaskDelay(TickType_t xTicksToDelay);
+BaseType_t xTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement);
+#define vTaskDelayUntil(prev, inc) ((void)xTaskDelayUntil((prev), (inc)))
+
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char *pcTaskGetName(TaskHandle_t xTaskToQuery);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+BaseType_t xTaskGetCoreID(TaskHandle_t xTask);
+
+BaseType_t xTaskGenericNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue,
+                              eNotifyAction eAction, uint32_t *pulPreviousNotificationValue);
+BaseType_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                           uint32_t *pulNotificationValue, TickType_t xTicksToWait);
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+#define xTaskNotify(task, value, action) xTaskGenericNotify((task), (value), (action), NULL)
+#define xTaskNotifyGive(task)            xTaskGenericNotify((task), 0, eIncrement, NULL)
+#define xTaskNotifyFromISR(task, value, action, woken) \
+    ((void)(woken), xTaskGenericNotify((task), (value), (action), NULL))
+#define vTaskNotifyGiveFromISR(task, woken) \
+    ((void)(woken), (void)xTaskGenericNotify((task), 0, eIncrement, NULL))
+
+#endif // FREERTOS_TASK_H
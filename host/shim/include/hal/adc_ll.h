@@ -0,0 +1,16 @@
+#ifndef HAL_ADC_LL_H
+#define HAL_ADC_LL_H
+
+// Host stand-in for hal/adc_ll.h (only what the firmware calls). The ULP
+// shim samples the plant directly, so the SAR registers are not modelled.
+
+#include "hal/adc_types.h"
+
+static inline void adc_ll_set_atten(adc_unit_t adc_n, adc_channel_t channel, adc_atten_t atten)
+{
+    (void)adc_n;
+    (void)channel;
+    (void)atten;
+}
+
+#endif // HAL_ADC_LL_H
@@ -0,0 +1,12 @@
+#ifndef LWIP_SOCKETS_H
+#define LWIP_SOCKETS_H
+
+// Host stand-in for lwip/sockets.h: the BSD socket API lwIP mirrors.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif // LWIP_SOCKETS_H
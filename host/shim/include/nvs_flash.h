@@ -0,0 +1,16 @@
+#ifndef NVS_FLASH_H
+#define NVS_FLASH_H
+
+#include <stdio.h>
+#include "esp_err.h"
+
+esp_err_t nvs_flash_init(void);
+esp_err_t nvs_flash_erase(void);
+esp_err_t nvs_flash_deinit(void);
+
+// Host only: back the partition with this file (NULL = memory only)
+void sim_nvs_set_file(const char *path);
+// Host only: write statistics as key=value lines for the run report
+void sim_nvs_report(FILE *out);
+
+#endif // NVS_FLASH_H
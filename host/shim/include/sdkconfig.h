@@ -0,0 +1,12 @@
+#ifndef SDKCONFIG_H
+#define SDKCONFIG_H
+
+// Host build "sdkconfig": the simulator is its own target with the ESP32
+// defaults the firmware relies on.
+
+#define CONFIG_IDF_TARGET       "linux"
+#define CONFIG_IDF_TARGET_LINUX 1
+#define CONFIG_FREERTOS_HZ      100
+#define CONFIG_HEAP_USE_HOOKS   1       // host/sim/sim_heap.c calls them
+
+#endif // SDKCONFIG_H
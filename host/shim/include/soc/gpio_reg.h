@@ -0,0 +1,14 @@
+#ifndef SOC_GPIO_REG_H
+#define SOC_GPIO_REG_H
+
+// ESP32 GPIO output registers (same addresses as the real soc/gpio_reg.h)
+
+#define DR_REG_GPIO_BASE    0x3ff44000
+#define GPIO_OUT_REG        (DR_REG_GPIO_BASE + 0x0004)
+#define GPIO_OUT_W1TS_REG   (DR_REG_GPIO_BASE + 0x0008)   // pins 0-31: write 1 to set
+#define GPIO_OUT_W1TC_REG   (DR_REG_GPIO_BASE + 0x000c)   // pins 0-31: write 1 to clear
+#define GPIO_OUT1_REG       (DR_REG_GPIO_BASE + 0x0010)
+#define GPIO_OUT1_W1TS_REG  (DR_REG_GPIO_BASE + 0x0014)   // pins 32-39
+#define GPIO_OUT1_W1TC_REG  (DR_REG_GPIO_BASE + 0x0018)
+
+#endif // SOC_GPIO_REG_H
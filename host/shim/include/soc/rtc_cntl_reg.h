@@ -0,0 +1,10 @@
+#ifndef SOC_RTC_CNTL_REG_H
+#define SOC_RTC_CNTL_REG_H
+
+// ESP32 RTC controller status bit the ULP polls before I_WAKE
+
+#define DR_REG_RTCCNTL_BASE             0x3ff48000
+#define RTC_CNTL_LOW_POWER_ST_REG       (DR_REG_RTCCNTL_BASE + 0x00c0)
+#define RTC_CNTL_RDY_FOR_WAKEUP_S       19
+
+#endif // SOC_RTC_CNTL_REG_H
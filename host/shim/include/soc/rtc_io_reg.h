@@ -0,0 +1,10 @@
+#ifndef SOC_RTC_IO_REG_H
+#define SOC_RTC_IO_REG_H
+
+// ESP32 RTC IO input register (same address and field as the real header)
+
+#define DR_REG_RTCIO_BASE       0x3ff48400
+#define RTC_GPIO_IN_REG         (DR_REG_RTCIO_BASE + 0x0024)
+#define RTC_GPIO_IN_NEXT_S      14      // bit 14 + n: level of RTC GPIO n
+
+#endif // SOC_RTC_IO_REG_H
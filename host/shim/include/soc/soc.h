@@ -0,0 +1,16 @@
+#ifndef SOC_SOC_H
+#define SOC_SOC_H
+
+// Host stand-in for soc/soc.h register access. Writes to the GPIO output
+// set/clear registers are decoded by the GPIO shim; other addresses are
+// ignored and read back as 0.
+
+#include <stdint.h>
+
+void sim_reg_write(uint32_t addr, uint32_t value);
+uint32_t sim_reg_read(uint32_t addr);
+
+#define REG_WRITE(_r, _v) sim_reg_write((uint32_t)(_r), (uint32_t)(_v))
+#define REG_READ(_r)      sim_reg_read((uint32_t)(_r))
+
+#endif // SOC_SOC_H
@@ -0,0 +1,25 @@
+#ifndef SOC_SOC_CAPS_H
+#define SOC_SOC_CAPS_H
+
+// Host stand-in for soc/soc_caps.h. The simulated ADC mirrors the ESP32
+// digital controller (TYPE1 results, 2 bytes each, 4-byte frame alignment)
+// but accepts rates down to 100 Hz so fast-forward runs stay cheap; the real
+// ESP32 DMA path bottoms out at 20 kHz.
+
+#define SOC_ADC_PERIPH_NUM                  (2)
+#define SOC_ADC_CHANNEL_NUM(unit)           ((unit) == 0 ? 8 : 10)
+#define SOC_ADC_MAX_CHANNEL_NUM             (10)
+#define SOC_ADC_DIGI_CONTROLLER_NUM         (2)
+#define SOC_ADC_PATT_LEN_MAX                (16)
+#define SOC_ADC_DIGI_MIN_BITWIDTH           (9)
+#define SOC_ADC_DIGI_MAX_BITWIDTH           (12)
+#define SOC_ADC_DIGI_RESULT_BYTES           (2)
+#define SOC_ADC_DIGI_DATA_BYTES_PER_CONV    (4)
+#define SOC_ADC_SAMPLE_FREQ_THRES_HIGH      (2 * 1000 * 1000)
+#define SOC_ADC_SAMPLE_FREQ_THRES_LOW       (100)
+#define SOC_ADC_RTC_MAX_BITWIDTH            (12)
+
+#define SOC_GPIO_PIN_COUNT                  (40)
+#define SOC_CPU_CORES_NUM                   (2)
+
+#endif // SOC_SOC_CAPS_H
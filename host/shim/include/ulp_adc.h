@@ -0,0 +1,27 @@
+#ifndef ULP_ADC_H
+#define ULP_ADC_H
+
+// Host stand-in for ulp_adc.h: hands an ADC1 channel to the ULP. The ULP
+// shim samples the plant directly, so this only records the configuration.
+
+#include "esp_err.h"
+#include "hal/adc_types.h"
+
+typedef enum {
+    ADC_ULP_MODE_DISABLE,
+    ADC_ULP_MODE_FSM,
+    ADC_ULP_MODE_RISCV,
+} ulp_adc_mode_t;
+
+typedef struct {
+    adc_unit_t adc_n;
+    adc_channel_t channel;
+    adc_atten_t atten;
+    adc_bitwidth_t width;
+    ulp_adc_mode_t ulp_mode;
+} ulp_adc_cfg_t;
+
+esp_err_t ulp_adc_init(const ulp_adc_cfg_t *cfg);
+esp_err_t ulp_adc_deinit(void);
+
+#endif // ULP_ADC_H
@@ -0,0 +1,98 @@
+// LEDC driver shim: channels latch a duty and report it to the plant as a
+// fraction of the period on their pin (sim_hal_pwm_changed).
+
+#include "driver/ledc.h"
+#include "sim_hal.h"
+#include "sim_kernel.h"
+
+#include <stdbool.h>
+
+typedef struct {
+    bool configured;
+    int gpio;
+    ledc_timer_t timer;
+    uint32_t duty;          // set, not yet latched
+    uint32_t duty_applied;
+    bool stopped;           // ledc_stop: idle level until the next ledc_update_duty
+} channel_t;
+
+static uint32_t s_timer_bits[LEDC_TIMER_MAX];
+static channel_t s_channels[LEDC_CHANNEL_MAX];
+
+__attribute__((weak)) void sim_hal_pwm_changed(int gpio, double duty, uint64_t now_us)
+{
+    (void)gpio;
+    (void)duty;
+    (void)now_us;
+}
+
+static void latch(channel_t *ch)
+{
+    ch->duty_applied = ch->duty;
+    ch->stopped = false;
+    uint32_t max = (1U << s_timer_bits[ch->timer]) - 1;
+    double duty = max ? (double)ch->duty_applied / (double)max : 0.0;
+    sim_hal_pwm_changed(ch->gpio, duty > 1.0 ? 1.0 : duty, sim_now_us());
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    if (timer_conf == NULL || timer_conf->timer_num >= LEDC_TIMER_MAX || timer_conf->freq_hz == 0 ||
+        timer_conf->duty_resolution < LEDC_TIMER_1_BIT || timer_conf->duty_resolution >= LEDC_TIMER_BIT_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_timer_bits[timer_conf->timer_num] = timer_conf->duty_resolution;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if (ledc_conf == NULL || ledc_conf->channel >= LEDC_CHANNEL_MAX || ledc_conf->timer_sel >= LEDC_TIMER_MAX ||
+        s_timer_bits[ledc_conf->timer_sel] == 0 || ledc_conf->gpio_num < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    channel_t *ch = &s_channels[ledc_conf->channel];
+    ch->configured = true;
+    ch->gpio = ledc_conf->gpio_num;
+    ch->timer = ledc_conf->timer_sel;
+    ch->duty = ledc_conf->duty;
+    latch(ch);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    if (channel >= LEDC_CHANNEL_MAX || !s_channels[channel].configured) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_channels[channel].duty = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    if (channel >= LEDC_CHANNEL_MAX || !s_channels[channel].configured) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_channels[channel].stopped || s_channels[channel].duty != s_channels[channel].duty_applied) {
+        latch(&s_channels[channel]);
+    }
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    return channel < LEDC_CHANNEL_MAX ? s_channels[channel].duty_applied : 0;
+}
+
+esp_err_t ledc_stop(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t idle_level)
+{
+    if (channel >= LEDC_CHANNEL_MAX || !s_channels[channel].configured) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    // The duty stays set; the output holds the idle level until an update
+    channel_t *ch = &s_channels[channel];
+    ch->stopped = true;
+    sim_hal_pwm_changed(ch->gpio, idle_level ? 1.0 : 0.0, sim_now_us());
+    return ESP_OK;
+}
@@ -0,0 +1,337 @@
+// NVS flash partition stand-in: a small in-memory key/value table, optionally
+// persisted to a file on every nvs_commit(). Keeps write statistics in the
+// same 32-byte entry units real NVS pages are made of, so batching changes
+// show up in the run report.
+
+#include "nvs_flash.h"
+#include "nvs.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NVS_SIM_MAX_ENTRIES  96
+#define NVS_SIM_MAX_HANDLES  8
+#define NVS_SIM_MAX_BLOB     4000     // one blob per 4 KB page is plenty here
+#define NVS_ENTRY_BYTES      32
+#define NVS_FILE_MAGIC       "NVS1"
+
+typedef enum { TYPE_U32 = 1, TYPE_BLOB = 2 } entry_type_t;
+
+typedef struct {
+    bool used;
+    char ns[NVS_KEY_NAME_MAX_SIZE];
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    entry_type_t type;
+    size_t len;
+    uint8_t *data;
+} entry_t;
+
+typedef struct {
+    bool open;
+    bool writable;
+    char ns[NVS_KEY_NAME_MAX_SIZE];
+} handle_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static entry_t s_entries[NVS_SIM_MAX_ENTRIES];
+static handle_t s_handles[NVS_SIM_MAX_HANDLES];
+static bool s_initialized = false;
+static const char *s_path = NULL;
+
+static uint64_t s_sets = 0;
+static uint64_t s_commits = 0;
+static uint64_t s_bytes_written = 0;
+static uint64_t s_entries_written = 0;
+
+static void clear_entries(void)
+{
+    for (int i = 0; i < NVS_SIM_MAX_ENTRIES; i++) {
+        free(s_entries[i].data);
+        memset(&s_entries[i], 0, sizeof(s_entries[i]));
+    }
+}
+
+static entry_t *find(const char *ns, const char *key)
+{
+    for (int i = 0; i < NVS_SIM_MAX_ENTRIES; i++) {
+        entry_t *e = &s_entries[i];
+        if (e->used && strcmp(e->ns, ns) == 0 && strcmp(e->key, key) == 0) {
+            return e;
+        }
+    }
+    return NULL;
+}
+
+static void load_file(void)
+{
+    FILE *f = s_path ? fopen(s_path, "rb") : NULL;
+    if (f == NULL) {
+        return;   // first run: empty partition
+    }
+    char magic[4];
+    if (fread(magic, 1, 4, f) != 4 || memcmp(magic, NVS_FILE_MAGIC, 4) != 0) {
+        fprintf(stderr, "%s: not an NVS image, starting empty\n", s_path);
+        fclose(f);
+        return;
+    }
+    for (int i = 0; i < NVS_SIM_MAX_ENTRIES; i++) {
+        entry_t *e = &s_entries[i];
+        uint8_t type;
+        uint32_t len;
+        if (fread(e->ns, 1, sizeof(e->ns), f) != sizeof(e->ns) ||
+            fread(e->key, 1, sizeof(e->key), f) != sizeof(e->key) ||
+            fread(&type, 1, 1, f) != 1 || fread(&len, 1, 4, f) != 4 || len > NVS_SIM_MAX_BLOB) {
+            memset(e, 0, sizeof(*e));
+            break;
+        }
+        e->data = malloc(len ? len : 1);
+        if (e->data == NULL || fread(e->data, 1, len, f) != len) {
+            free(e->data);
+            memset(e, 0, sizeof(*e));
+            break;
+        }
+        e->ns[sizeof(e->ns) - 1] = '\0';
+        e->key[sizeof(e->key) - 1] = '\0';
+        e->type = (entry_type_t)type;
+        e->len = len;
+        e->used = true;
+    }
+    fclose(f);
+}
+
+static void save_file(void)
+{
+    if (s_path == NULL) {
+        return;
+    }
+    FILE *f = fopen(s_path, "wb");
+    if (f == NULL) {
+        perror(s_path);
+        return;
+    }
+    fwrite(NVS_FILE_MAGIC, 1, 4, f);
+    for (int i = 0; i < NVS_SIM_MAX_ENTRIES; i++) {
+        entry_t *e = &s_entries[i];
+        if (!e->used) {
+            continue;
+        }
+        uint8_t type = (uint8_t)e->type;
+        uint32_t len = (uint32_t)e->len;
+        fwrite(e->ns, 1, sizeof(e->ns), f);
+        fwrite(e->key, 1, sizeof(e->key), f);
+        fwrite(&type, 1, 1, f);
+        fwrite(&len, 1, 4, f);
+        fwrite(e->data, 1, len, f);
+    }
+    fclose(f);
+}
+
+void sim_nvs_set_file(const char *path)
+{
+    s_path = path;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    pthread_mutex_lock(&s_lock);
+    if (!s_initialized) {
+        load_file();
+        s_initialized = true;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    pthread_mutex_lock(&s_lock);
+    clear_entries();
+    s_initialized = false;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_deinit(void)
+{
+    return ESP_OK;
+}
+
+static handle_t *get_handle(nvs_handle_t h)
+{
+    if (h == 0 || h > NVS_SIM_MAX_HANDLES || !s_handles[h - 1].open) {
+        return NULL;
+    }
+    return &s_handles[h - 1];
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (namespace_name == NULL || strlen(namespace_name) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+    esp_err_t err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    pthread_mutex_lock(&s_lock);
+    if (!s_initialized) {
+        err = ESP_ERR_NVS_NOT_INITIALIZED;
+    } else {
+        for (int i = 0; i < NVS_SIM_MAX_HANDLES; i++) {
+            if (!s_handles[i].open) {
+                s_handles[i].open = true;
+                s_handles[i].writable = open_mode == NVS_READWRITE;
+                strcpy(s_handles[i].ns, namespace_name);
+                *out_handle = (nvs_handle_t)(i + 1);
+                err = ESP_OK;
+                break;
+            }
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&s_lock);
+    handle_t *h = get_handle(handle);
+    if (h) {
+        h->open = false;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    pthread_mutex_lock(&s_lock);
+    esp_err_t err = get_handle(handle) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+    if (err == ESP_OK) {
+        s_commits++;
+        save_file();
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+static esp_err_t set_value(nvs_handle_t handle, const char *key, entry_type_t type,
+                           const void *value, size_t len)
+{
+    if (key == NULL || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_NVS_INVALID_NAME;
+    }
+    if (len > NVS_SIM_MAX_BLOB) {
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    esp_err_t err = ESP_OK;
+    pthread_mutex_lock(&s_lock);
+    handle_t *h = get_handle(handle);
+    entry_t *e = h ? find(h->ns, key) : NULL;
+    if (h == NULL) {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    } else if (!h->writable) {
+        err = ESP_ERR_NVS_READ_ONLY;
+    } else if (e && e->type == type && e->len == len && memcmp(e->data, value, len) == 0) {
+        // Unchanged: real NVS skips the write too
+    } else {
+        if (e == NULL) {
+            for (int i = 0; i < NVS_SIM_MAX_ENTRIES && e == NULL; i++) {
+                if (!s_entries[i].used) {
+                    e = &s_entries[i];
+                }
+            }
+        }
+        uint8_t *data = e ? malloc(len ? len : 1) : NULL;
+        if (data == NULL) {
+            err = ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        } else {
+            memcpy(data, value, len);
+            free(e->data);
+            strcpy(e->ns, h->ns);
+            strcpy(e->key, key);
+            e->type = type;
+            e->len = len;
+            e->data = data;
+            e->used = true;
+            s_sets++;
+            s_bytes_written += len;
+            // Blobs: a data header + payload entries + the blob index entry
+            s_entries_written += type == TYPE_U32 ? 1 : 2 + (len + NVS_ENTRY_BYTES - 1) / NVS_ENTRY_BYTES;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+static esp_err_t get_value(nvs_handle_t handle, const char *key, entry_type_t type,
+                           void *out, size_t *len)
+{
+    esp_err_t err = ESP_OK;
+    pthread_mutex_lock(&s_lock);
+    handle_t *h = get_handle(handle);
+    entry_t *e = h ? find(h->ns, key) : NULL;
+    if (h == NULL) {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    } else if (e == NULL) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else if (e->type != type) {
+        err = ESP_ERR_NVS_TYPE_MISMATCH;
+    } else if (out == NULL) {
+        *len = e->len;
+    } else if (*len < e->len) {
+        *len = e->len;
+        err = ESP_ERR_NVS_INVALID_LENGTH;
+    } else {
+        memcpy(out, e->data, e->len);
+        *len = e->len;
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    esp_err_t err = ESP_OK;
+    pthread_mutex_lock(&s_lock);
+    handle_t *h = get_handle(handle);
+    entry_t *e = h ? find(h->ns, key) : NULL;
+    if (h == NULL) {
+        err = ESP_ERR_NVS_INVALID_HANDLE;
+    } else if (e == NULL) {
+        err = ESP_ERR_NVS_NOT_FOUND;
+    } else {
+        free(e->data);
+        memset(e, 0, sizeof(*e));
+    }
+    pthread_mutex_unlock(&s_lock);
+    return err;
+}
+
+esp_err_t nvs_set_u32(nvs_handle_t handle, const char *key, uint32_t value)
+{
+    return set_value(handle, key, TYPE_U32, &value, sizeof(value));
+}
+
+esp_err_t nvs_get_u32(nvs_handle_t handle, const char *key, uint32_t *out_value)
+{
+    size_t len = sizeof(*out_value);
+    return get_value(handle, key, TYPE_U32, out_value, &len);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    return set_value(handle, key, TYPE_BLOB, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return get_value(handle, key, TYPE_BLOB, out_value, length);
+}
+
+void sim_nvs_report(FILE *out)
+{
+    pthread_mutex_lock(&s_lock);
+    fprintf(out, "nvs.sets=%llu\nnvs.commits=%llu\nnvs.bytes_written=%llu\nnvs.entries_written=%llu\n",
+            (unsigned long long)s_sets, (unsigned long long)s_commits,
+            (unsigned long long)s_bytes_written, (unsigned long long)s_entries_written);
+    pthread_mutex_unlock(&s_lock);
+}
@@ -0,0 +1,349 @@
+// PCNT driver shim: units count the flow meter pulses the plant reports
+// (sim_hal_pulse_count) and a "pcnt" task runs the watch point callbacks at
+// the virtual instant the plant predicts the count gets there.
+
+#include "driver/pulse_cnt.h"
+#include "freertos/FreeRTOS.h"
+#include "sim_hal.h"
+#include "sim_kernel.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define PCNT_UNITS      8       // SOC_PCNT_UNITS_PER_GROUP on the ESP32
+#define PCNT_WATCH_MAX  5       // two thresholds, both limits and zero
+
+struct pcnt_chan_t {
+    struct pcnt_unit_t *unit;
+};
+
+struct pcnt_unit_t {
+    bool used;
+    bool enabled;
+    bool running;
+    bool accum;
+    int high_limit;
+    int pin;                    // edge input of the channel, -1 = none yet
+    int watch[PCNT_WATCH_MAX];
+    int watch_count;
+    pcnt_watch_cb_t on_reach;
+    void *ctx;
+    uint64_t base;              // plant pulse count at the last clear
+    uint64_t held;              // count while stopped
+    uint64_t seen;              // count up to which callbacks have run
+    struct pcnt_chan_t chan;
+};
+
+static struct pcnt_unit_t s_units[PCNT_UNITS];
+static bool s_task_started;
+static uint32_t s_gen;          // bumped on every change the task must see; under sim_lock()
+
+__attribute__((weak)) uint64_t sim_hal_pulse_count(int gpio)
+{
+    (void)gpio;
+    return 0;
+}
+
+__attribute__((weak)) uint64_t sim_hal_pulse_due_us(int gpio, uint64_t count)
+{
+    (void)gpio;
+    (void)count;
+    return SIM_FOREVER;
+}
+
+void sim_pcnt_inputs_changed(void)
+{
+    sim_lock();
+    s_gen++;
+    sim_wake_all_locked(&s_gen);
+    sim_unlock();
+}
+
+// Count since the last clear, as the driver (accumulating) reports it
+static uint64_t unit_raw(const struct pcnt_unit_t *u, uint64_t pulses)
+{
+    return u->running ? pulses - u->base : u->held;
+}
+
+// Next count past `seen` at which watch point w fires: the hardware counter
+// restarts from 0 at the high limit, so a point fires once per lap
+static uint64_t next_crossing(const struct pcnt_unit_t *u, int w, uint64_t seen)
+{
+    uint64_t lim = (uint64_t)u->high_limit;
+    if (seen < (uint64_t)w) {
+        return (uint64_t)w;
+    }
+    return ((seen - (uint64_t)w) / lim + 1) * lim + (uint64_t)w;
+}
+
+static void pcnt_task(void *arg)
+{
+    (void)arg;
+    while (1) {
+        sim_lock();
+        uint32_t gen = s_gen;
+        sim_unlock();
+
+        uint64_t due = SIM_FOREVER;
+        for (int i = 0; i < PCNT_UNITS; i++) {
+            sim_lock();
+            struct pcnt_unit_t u = s_units[i];
+            sim_unlock();
+            if (!u.used || !u.enabled || !u.running || u.on_reach == NULL || u.pin < 0) {
+                continue;
+            }
+            uint64_t raw = unit_raw(&u, sim_hal_pulse_count(u.pin));
+            while (1) {
+                // Lowest watch point still ahead of the count
+                uint64_t next = UINT64_MAX;
+                int value = 0;
+                for (int w = 0; w < u.watch_count; w++) {
+                    if (u.watch[w] <= 0) {
+                        continue;   // the meters count up only
+                    }
+                    uint64_t c = next_crossing(&u, u.watch[w], u.seen);
+                    if (c < next) {
+                        next = c;
+                        value = u.watch[w];
+                    }
+                }
+                if (next == UINT64_MAX) {
+                    break;
+                }
+                if (next > raw) {
+                    uint64_t t = sim_hal_pulse_due_us(u.pin, u.base + next);
+                    due = t < due ? t : due;
+                    break;
+                }
+                // Passed: run the callback unless the unit was cleared meanwhile
+                sim_lock();
+                bool current = s_units[i].base == u.base && s_units[i].seen == u.seen;
+                if (current) {
+                    s_units[i].seen = next;
+                }
+                sim_unlock();
+                if (!current) {
+                    due = 0;
+                    break;
+                }
+                u.seen = next;
+                pcnt_watch_event_data_t edata = {
+                    .watch_point_value = value,
+                    .zero_cross_mode = PCNT_UNIT_ZERO_CROSS_INVALID,
+                };
+                u.on_reach(&s_units[i], &edata, u.ctx);
+            }
+        }
+
+        sim_lock();
+        while (s_gen == gen && sim_now_us_locked() < due) {
+            sim_block_locked(&s_gen, due);
+        }
+        sim_unlock();
+    }
+}
+
+static void changed_locked(void)
+{
+    s_gen++;
+    sim_wake_all_locked(&s_gen);
+}
+
+esp_err_t pcnt_new_unit(const pcnt_unit_config_t *config, pcnt_unit_handle_t *ret_unit)
+{
+    if (config == NULL || ret_unit == NULL || config->low_limit >= 0 || config->high_limit <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    struct pcnt_unit_t *u = NULL;
+    for (int i = 0; i < PCNT_UNITS && u == NULL; i++) {
+        if (!s_units[i].used) {
+            u = &s_units[i];
+        }
+    }
+    bool spawn = u != NULL && !s_task_started;
+    if (u != NULL) {
+        memset(u, 0, sizeof(*u));
+        u->used = true;
+        u->accum = config->flags.accum_count;
+        u->high_limit = config->high_limit;
+        u->pin = -1;
+        s_task_started = true;
+    }
+    sim_unlock();
+    if (u == NULL) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (spawn) {
+        sim_task_spawn("pcnt", pcnt_task, NULL, 2048, configMAX_PRIORITIES - 1, tskNO_AFFINITY);
+    }
+    *ret_unit = u;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_del_unit(pcnt_unit_handle_t unit)
+{
+    sim_lock();
+    unit->used = false;
+    changed_locked();
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t unit, const pcnt_glitch_filter_config_t *config)
+{
+    (void)unit;
+    (void)config;   // the plant's pulses are clean
+    return ESP_OK;
+}
+
+static esp_err_t set_flag(pcnt_unit_handle_t unit, bool *flag, bool on)
+{
+    uint64_t pulses = unit->pin >= 0 ? sim_hal_pulse_count(unit->pin) : 0;
+    sim_lock();
+    if (flag == &unit->running && on != unit->running) {
+        // Stopped, the count holds; started again, it goes on from there
+        if (on) {
+            unit->base = pulses - unit->held;
+        } else {
+            unit->held = pulses - unit->base;
+        }
+    }
+    *flag = on;
+    changed_locked();
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_enable(pcnt_unit_handle_t unit)
+{
+    return set_flag(unit, &unit->enabled, true);
+}
+
+esp_err_t pcnt_unit_disable(pcnt_unit_handle_t unit)
+{
+    return set_flag(unit, &unit->enabled, false);
+}
+
+esp_err_t pcnt_unit_start(pcnt_unit_handle_t unit)
+{
+    return set_flag(unit, &unit->running, true);
+}
+
+esp_err_t pcnt_unit_stop(pcnt_unit_handle_t unit)
+{
+    return set_flag(unit, &unit->running, false);
+}
+
+esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t unit)
+{
+    uint64_t pulses = unit->pin >= 0 ? sim_hal_pulse_count(unit->pin) : 0;
+    sim_lock();
+    unit->base = pulses;
+    unit->held = 0;
+    unit->seen = 0;
+    changed_locked();
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_get_count(pcnt_unit_handle_t unit, int *value)
+{
+    if (value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t pulses = unit->pin >= 0 ? sim_hal_pulse_count(unit->pin) : 0;
+    sim_lock();
+    uint64_t raw = unit_raw(unit, pulses);
+    *value = (int)(unit->accum ? raw : raw % (uint64_t)unit->high_limit);
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_register_event_callbacks(pcnt_unit_handle_t unit, const pcnt_event_callbacks_t *cbs,
+                                             void *user_data)
+{
+    if (cbs == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    unit->on_reach = cbs->on_reach;
+    unit->ctx = user_data;
+    changed_locked();
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_add_watch_point(pcnt_unit_handle_t unit, int watch_point)
+{
+    if (watch_point > unit->high_limit) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sim_lock();
+    esp_err_t err = ESP_OK;
+    for (int w = 0; w < unit->watch_count; w++) {
+        if (unit->watch[w] == watch_point) {
+            err = ESP_ERR_INVALID_STATE;
+        }
+    }
+    if (err == ESP_OK && unit->watch_count == PCNT_WATCH_MAX) {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    if (err == ESP_OK) {
+        unit->watch[unit->watch_count++] = watch_point;
+        changed_locked();
+    }
+    sim_unlock();
+    return err;
+}
+
+esp_err_t pcnt_unit_remove_watch_point(pcnt_unit_handle_t unit, int watch_point)
+{
+    sim_lock();
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    for (int w = 0; w < unit->watch_count; w++) {
+        if (unit->watch[w] == watch_point) {
+            unit->watch[w] = unit->watch[--unit->watch_count];
+            err = ESP_OK;
+            break;
+        }
+    }
+    changed_locked();
+    sim_unlock();
+    return err;
+}
+
+esp_err_t pcnt_new_channel(pcnt_unit_handle_t unit, const pcnt_chan_config_t *config,
+                           pcnt_channel_handle_t *ret_chan)
+{
+    if (config == NULL || ret_chan == NULL || config->edge_gpio_num < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t pulses = sim_hal_pulse_count(config->edge_gpio_num);
+    sim_lock();
+    unit->pin = config->edge_gpio_num;
+    unit->base = pulses;
+    unit->chan.unit = unit;
+    changed_locked();
+    sim_unlock();
+    *ret_chan = &unit->chan;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_del_channel(pcnt_channel_handle_t chan)
+{
+    sim_lock();
+    chan->unit->pin = -1;
+    changed_locked();
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t chan, pcnt_channel_edge_action_t pos_act,
+                                       pcnt_channel_edge_action_t neg_act)
+{
+    (void)chan;
+    // One edge per pulse: the plant's count is of rising edges
+    return pos_act == PCNT_CHANNEL_EDGE_ACTION_INCREASE && neg_act == PCNT_CHANNEL_EDGE_ACTION_HOLD
+               ? ESP_OK : ESP_ERR_NOT_SUPPORTED;
+}
@@ -0,0 +1,39 @@
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+// Hooks between the driver shims and the simulated plant. The shims provide
+// weak defaults (inputs read 0, outputs ignored); host/sim overrides them.
+
+#include <stddef.h>
+#include <stdint.h>
+
+int sim_hal_read_input(int gpio);
+// Fill out[0..n) with consecutive conversions of one ADC channel, as the
+// continuous ADC engine samples them at the current virtual time.
+void sim_hal_fill_adc(int unit, int channel, uint16_t *out, size_t n);
+void sim_hal_output_changed(int gpio, int level, uint64_t now_us);
+
+// LEDC shim -> plant: the duty (fraction of the period high) on a PWM pin
+// changed; called without holding sim_lock()
+void sim_hal_pwm_changed(int gpio, double duty, uint64_t now_us);
+
+// Latched output level of a pin, as last driven by the firmware.
+int sim_hal_output_level(int gpio);
+
+// Earliest virtual time an input level may change (SIM_FOREVER = not until
+// an output changes). The GPIO shim re-checks its interrupt pins then.
+uint64_t sim_hal_next_input_change_us(void);
+// Plant -> GPIO shim: the prediction above may have moved (e.g. a pump
+// started); call without holding sim_lock().
+void sim_gpio_inputs_changed(void);
+
+// Flow meter pulses on a pin: how many the plant has produced since boot,
+// and the earliest virtual time the total reaches count with the outputs as
+// they are (SIM_FOREVER = not while nothing flows through the meter)
+uint64_t sim_hal_pulse_count(int gpio);
+uint64_t sim_hal_pulse_due_us(int gpio, uint64_t count);
+// Plant -> PCNT shim: a pump started or stopped, so the predictions above
+// moved; call without holding sim_lock()
+void sim_pcnt_inputs_changed(void);
+
+#endif // SIM_HAL_H
@@ -0,0 +1,272 @@
+#include "sim_kernel.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static sim_task_t *s_tasks = NULL;
+static int s_counted = 0;
+static int s_blocked = 0;
+
+static double s_speed = 0.0;        // 0 = fast-forward
+static uint64_t s_now_us = 0;        // fast-forward virtual time
+static uint64_t s_base_real_ns = 0;  // paced mode origin
+
+static __thread sim_task_t *tls_self = NULL;
+
+static uint64_t real_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void sim_kernel_init(double speed)
+{
+    s_speed = speed > 0 ? speed : 0.0;
+    s_base_real_ns = real_ns();
+    s_now_us = 0;
+}
+
+double sim_kernel_speed(void)
+{
+    return s_speed;
+}
+
+void sim_lock(void)
+{
+    pthread_mutex_lock(&s_lock);
+}
+
+void sim_unlock(void)
+{
+    pthread_mutex_unlock(&s_lock);
+}
+
+uint64_t sim_now_us_locked(void)
+{
+    if (s_speed > 0) {
+        uint64_t elapsed_ns = real_ns() - s_base_real_ns;
+        uint64_t now = (uint64_t)((double)elapsed_ns * s_speed / 1000.0);
+        // Never let paced time run behind a fast-forward step taken earlier
+        if (now > s_now_us) {
+            s_now_us = now;
+        }
+    }
+    return s_now_us;
+}
+
+uint64_t sim_now_us(void)
+{
+    sim_lock();
+    uint64_t now = sim_now_us_locked();
+    sim_unlock();
+    return now;
+}
+
+static sim_task_t *task_alloc(const char *name, bool counted)
+{
+    sim_task_t *t = calloc(1, sizeof(*t));
+    if (t == NULL) {
+        abort();
+    }
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&t->cv, &attr);
+    pthread_condattr_destroy(&attr);
+    snprintf(t->name, sizeof(t->name), "%s", name ? name : "?");
+    t->counted = counted;
+    t->core_id = -1;
+    t->next = s_tasks;
+    s_tasks = t;
+    if (counted) {
+        s_counted++;
+    }
+    return t;
+}
+
+sim_task_t *sim_self(void)
+{
+    if (tls_self == NULL) {
+        sim_lock();
+        tls_self = task_alloc("ext", false);
+        tls_self->thread = pthread_self();
+        sim_unlock();
+    }
+    return tls_self;
+}
+
+sim_task_t *sim_self_known(void)
+{
+    return tls_self;
+}
+
+static __thread bool tls_untracked = false;
+
+void sim_heap_untracked(bool on)
+{
+    tls_untracked = on;
+}
+
+bool sim_heap_is_untracked(void)
+{
+    return tls_untracked;
+}
+
+static void unblock(sim_task_t *t, bool timed_out)
+{
+    t->blocked = false;
+    t->timed_out = timed_out;
+    t->waiting_on = NULL;
+    if (t->counted) {
+        s_blocked--;
+    }
+    pthread_cond_signal(&t->cv);
+}
+
+// Fast-forward: when no counted task can run, jump to the next deadline.
+static void advance_if_idle(void)
+{
+    if (s_speed > 0) {
+        return;
+    }
+    while (s_counted > 0 && s_blocked == s_counted) {
+        uint64_t next = SIM_FOREVER;
+        for (sim_task_t *t = s_tasks; t; t = t->next) {
+            if (t->blocked && t->wake_at_us < next) {
+                next = t->wake_at_us;
+            }
+        }
+        if (next == SIM_FOREVER) {
+            return;
+        }
+        if (next > s_now_us) {
+            s_now_us = next;
+        }
+        for (sim_task_t *t = s_tasks; t; t = t->next) {
+            if (t->blocked && t->wake_at_us <= s_now_us) {
+                unblock(t, true);
+            }
+        }
+    }
+}
+
+bool sim_block_locked(const void *obj, uint64_t deadline_us)
+{
+    sim_task_t *t = tls_self;
+    if (t == NULL) {
+        sim_unlock();
+        t = sim_self();
+        sim_lock();
+    }
+    if (deadline_us != SIM_FOREVER && deadline_us <= sim_now_us_locked()) {
+        return false;
+    }
+
+    t->blocked = true;
+    t->timed_out = false;
+    t->waiting_on = obj;
+    t->wake_at_us = deadline_us;
+    if (t->counted) {
+        s_blocked++;
+    }
+    advance_if_idle();
+
+    while (t->blocked) {
+        if (s_speed == 0 || deadline_us == SIM_FOREVER) {
+            pthread_cond_wait(&t->cv, &s_lock);
+            continue;
+        }
+        uint64_t real_deadline = s_base_real_ns + (uint64_t)((double)deadline_us * 1000.0 / s_speed);
+        struct timespec ts = {
+            .tv_sec = (time_t)(real_deadline / 1000000000ull),
+            .tv_nsec = (long)(real_deadline % 1000000000ull),
+        };
+        pthread_cond_timedwait(&t->cv, &s_lock, &ts);
+        if (t->blocked && sim_now_us_locked() >= deadline_us) {
+            unblock(t, true);
+        }
+    }
+    return !t->timed_out;
+}
+
+void sim_wake_locked(sim_task_t *task)
+{
+    if (task && task->blocked) {
+        unblock(task, false);
+    }
+}
+
+void sim_wake_all_locked(const void *obj)
+{
+    for (sim_task_t *t = s_tasks; t; t = t->next) {
+        if (t->blocked && t->waiting_on == obj) {
+            unblock(t, false);
+        }
+    }
+}
+
+static void *task_trampoline(void *param)
+{
+    sim_task_t *t = param;
+    tls_self = t;
+    t->fn(t->arg);
+    // FreeRTOS tasks must not return; treat it like vTaskDelete(NULL)
+    sim_task_exit();
+    return NULL;
+}
+
+sim_task_t *sim_task_spawn(const char *name, void (*fn)(void *), void *arg,
+                           uint32_t stack_depth, int priority, int core_id)
+{
+    sim_lock();
+    sim_task_t *t = task_alloc(name, true);
+    t->fn = fn;
+    t->arg = arg;
+    t->priority = priority;
+    t->core_id = core_id;
+    t->stack_depth = stack_depth;
+    sim_unlock();
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&t->thread, &attr, task_trampoline, t) != 0) {
+        perror("pthread_create");
+        abort();
+    }
+    pthread_attr_destroy(&attr);
+    return t;
+}
+
+void sim_task_exit(void)
+{
+    sim_task_t *self = sim_self();
+    sim_lock();
+    for (sim_task_t **pp = &s_tasks; *pp; pp = &(*pp)->next) {
+        if (*pp == self) {
+            *pp = self->next;
+            break;
+        }
+    }
+    if (self->counted) {
+        s_counted--;
+    }
+    advance_if_idle();
+    sim_unlock();
+    tls_self = NULL;
+    // The record is intentionally leaked: other tasks may still hold the handle
+    pthread_exit(NULL);
+}
+
+void sim_attach_main(const char *name)
+{
+    sim_lock();
+    sim_task_t *t = task_alloc(name, true);
+    t->thread = pthread_self();
+    tls_self = t;
+    sim_unlock();
+}
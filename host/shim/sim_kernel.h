@@ -0,0 +1,81 @@
+#ifndef SIM_KERNEL_H
+#define SIM_KERNEL_H
+
+// Host simulation kernel shared by the FreeRTOS / esp_timer / driver shims.
+//
+// Every FreeRTOS task is a pthread. All blocking primitives funnel through
+// sim_block() under one global lock, which lets the virtual clock run in two
+// modes:
+//   - fast-forward (speed == 0): when every task is blocked, time jumps to the
+//     earliest deadline, so weeks of control cycles replay in seconds and the
+//     result is reproducible run to run.
+//   - paced (speed > 0): virtual time follows the wall clock times `speed`, so
+//     the dashboard and HTTP API behave like a live board.
+//
+// Threads that were not created through xTaskCreate (the HTTP listener, the
+// process main thread before sim start) are "uncounted": they may block on
+// primitives, but the clock never waits for them.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define SIM_FOREVER UINT64_MAX
+
+typedef struct sim_task sim_task_t;
+
+struct sim_task {
+    pthread_t thread;
+    pthread_cond_t cv;
+    char name[16];
+    void (*fn)(void *);
+    void *arg;
+    int priority;
+    int core_id;
+    uint32_t stack_depth;
+    bool counted;
+    bool blocked;
+    bool timed_out;
+    const void *waiting_on;
+    uint64_t wake_at_us;
+    uint32_t notify_value;
+    bool notify_pending;
+    sim_task_t *next;
+};
+
+void sim_kernel_init(double speed);
+double sim_kernel_speed(void);
+
+// Global kernel lock. Every shim that touches shared kernel objects holds it.
+void sim_lock(void);
+void sim_unlock(void);
+
+uint64_t sim_now_us(void);
+uint64_t sim_now_us_locked(void);
+
+// Current thread's task record (creates an uncounted record for foreign
+// threads on first use).
+sim_task_t *sim_self(void);
+// The same without creating one: NULL for threads that are no task (yet)
+sim_task_t *sim_self_known(void);
+// Simulated hardware allocating on the calling task's behalf (the ULP's
+// thread): keep it out of the firmware's heap accounting (sim/sim_heap.c)
+void sim_heap_untracked(bool on);
+bool sim_heap_is_untracked(void);
+
+// Block the calling task until sim_wake*/timeout. Must hold sim_lock().
+// Returns true if woken, false if the deadline passed.
+bool sim_block_locked(const void *obj, uint64_t deadline_us);
+
+// Wake one task / every task blocked on obj. Must hold sim_lock().
+void sim_wake_locked(sim_task_t *task);
+void sim_wake_all_locked(const void *obj);
+
+sim_task_t *sim_task_spawn(const char *name, void (*fn)(void *), void *arg,
+                           uint32_t stack_depth, int priority, int core_id);
+void sim_task_exit(void);
+
+// Register the calling thread as a counted task (used by the sim main thread).
+void sim_attach_main(const char *name);
+
+#endif // SIM_KERNEL_H
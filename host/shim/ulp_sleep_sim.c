@@ -0,0 +1,354 @@
+// ULP coprocessor and light sleep on the virtual clock.
+//
+// The ULP timer is a "ulp" task that runs the loaded program once per wakeup
+// period. The interpreter covers the FSM instructions the firmware uses;
+// I_ADC and RTC GPIO reads go to the plant hooks like the main-core drivers.
+// I_WAKE ends a pending esp_light_sleep_start() with ESP_SLEEP_WAKEUP_ULP.
+
+#include "esp32/ulp.h"
+#include "ulp_adc.h"
+#include "esp_sleep.h"
+#include "driver/rtc_io.h"
+#include "soc/rtc_io_reg.h"
+#include "soc/rtc_cntl_reg.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "sim_hal.h"
+#include "sim_kernel.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#define ULP_PROGRAM_MAX   512
+#define ULP_LABELS_MAX    64
+#define ULP_STEPS_MAX     100000     // runaway guard per run
+
+uint32_t sim_rtc_slow_mem[SIM_RTC_SLOW_MEM_WORDS];
+
+static ulp_insn_t s_program[ULP_PROGRAM_MAX];
+static size_t s_program_len = 0;
+static uint32_t s_load_addr = 0;
+static uint32_t s_entry = 0;
+
+static bool s_task_started = false;
+static bool s_timer_running = false;
+static uint64_t s_period_us = 10000;    // IDF default: 10 ms
+static uint64_t s_next_run_us = 0;
+
+static bool s_sleeping = false;
+static bool s_ulp_wakeup = false;
+static uint64_t s_timer_wakeup_us = 0;  // 0 = disabled
+static esp_sleep_wakeup_cause_t s_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+static bool s_adc_claimed = false;       // ulp_adc_init() owns ADC1 until deinit
+
+// ESP32 RTC GPIO number -> GPIO number
+static const int8_t rtcio_gpio[] = { 36, 37, 38, 39, 34, 35, 25, 26, 33, 32, 4, 0, 2, 15, 13, 12, 14, 27 };
+#define RTCIO_COUNT ((int)sizeof(rtcio_gpio))
+
+/* ------------------------------------------------------------- loader */
+
+esp_err_t ulp_process_macros_and_load(uint32_t load_addr, const ulp_insn_t *program, size_t *psize)
+{
+    uint32_t label_num[ULP_LABELS_MAX];
+    uint32_t label_addr[ULP_LABELS_MAX];
+    int labels = 0;
+    size_t n = 0;
+
+    // First pass: drop label pseudo-instructions and note their addresses
+    for (size_t i = 0; i < *psize; i++) {
+        if (program[i].op == SIM_ULP_LABEL) {
+            for (int l = 0; l < labels; l++) {
+                if (label_num[l] == program[i].imm) {
+                    return ESP_ERR_ULP_DUPLICATE_LABEL;
+                }
+            }
+            if (labels == ULP_LABELS_MAX) {
+                return ESP_ERR_ULP_SIZE_TOO_BIG;
+            }
+            label_num[labels] = program[i].imm;
+            label_addr[labels++] = (uint32_t)n;
+            continue;
+        }
+        if (n == ULP_PROGRAM_MAX || load_addr + n >= SIM_RTC_SLOW_MEM_WORDS) {
+            return ESP_ERR_ULP_SIZE_TOO_BIG;
+        }
+        s_program[n++] = program[i];
+    }
+
+    // Second pass: branch targets become program indexes
+    for (size_t i = 0; i < n; i++) {
+        ulp_insn_t *in = &s_program[i];
+        if (in->op != SIM_ULP_BL && in->op != SIM_ULP_BGE && in->op != SIM_ULP_BX) {
+            continue;
+        }
+        int l = 0;
+        while (l < labels && label_num[l] != in->a) {
+            l++;
+        }
+        if (l == labels) {
+            return ESP_ERR_ULP_UNDEFINED_LABEL;
+        }
+        // Relative branches reach +-127 words on the chip; M_BX is absolute
+        if (in->op != SIM_ULP_BX && (label_addr[l] > i + 127 || label_addr[l] + 127 < i)) {
+            return ESP_ERR_ULP_BRANCH_OUT_OF_RANGE;
+        }
+        in->c = 0;
+        in->b = 0;
+        in->a = 0;
+        in->imm = (in->op == SIM_ULP_BX) ? label_addr[l] : (label_addr[l] << 16) | (in->imm & 0xffff);
+    }
+    s_load_addr = load_addr;
+    s_program_len = n;
+    *psize = n;
+    return ESP_OK;
+}
+
+/* --------------------------------------------------------- interpreter */
+
+static uint16_t read_rtc_field(uint32_t reg, int lo, int hi)
+{
+    if (reg == RTC_CNTL_LOW_POWER_ST_REG && lo == RTC_CNTL_RDY_FOR_WAKEUP_S) {
+        return 1;
+    }
+    if (reg == RTC_GPIO_IN_REG) {
+        uint16_t v = 0;
+        for (int bit = hi; bit >= lo; bit--) {
+            int rtcio = bit - RTC_GPIO_IN_NEXT_S;
+            int level = rtcio >= 0 && rtcio < RTCIO_COUNT ? sim_hal_read_input(rtcio_gpio[rtcio]) : 0;
+            v = (uint16_t)((v << 1) | (level & 1));
+        }
+        return v;
+    }
+    return 0;
+}
+
+// Runs the program once; returns true if it executed I_WAKE, *end if I_END
+static bool run_program(bool *end)
+{
+    uint16_t r[4] = { 0 };
+    bool wake = false;
+    size_t pc = s_entry >= s_load_addr ? s_entry - s_load_addr : 0;
+    for (int steps = 0; pc < s_program_len && steps < ULP_STEPS_MAX; steps++) {
+        const ulp_insn_t *in = &s_program[pc++];
+        switch (in->op) {
+        case SIM_ULP_MOVI: r[in->a] = (uint16_t)in->imm; break;
+        case SIM_ULP_MOVR: r[in->a] = r[in->b]; break;
+        case SIM_ULP_ADDR: r[in->a] = (uint16_t)(r[in->b] + r[in->c]); break;
+        case SIM_ULP_ADDI: r[in->a] = (uint16_t)(r[in->b] + in->imm); break;
+        case SIM_ULP_SUBR: r[in->a] = (uint16_t)(r[in->b] - r[in->c]); break;
+        case SIM_ULP_SUBI: r[in->a] = (uint16_t)(r[in->b] - in->imm); break;
+        case SIM_ULP_RSHI: r[in->a] = (uint16_t)(r[in->b] >> in->imm); break;
+        case SIM_ULP_LD:
+            r[in->a] = (uint16_t)sim_rtc_slow_mem[(r[in->b] + in->imm) % SIM_RTC_SLOW_MEM_WORDS];
+            break;
+        case SIM_ULP_ST:
+            sim_rtc_slow_mem[(r[in->b] + in->imm) % SIM_RTC_SLOW_MEM_WORDS] = r[in->a];
+            break;
+        case SIM_ULP_ADC: {
+            uint16_t raw;
+            sim_hal_fill_adc(in->b, in->c, &raw, 1);
+            r[in->a] = raw;
+            break;
+        }
+        case SIM_ULP_RD_REG:
+            r[0] = read_rtc_field(in->imm, in->b, in->c);
+            break;
+        case SIM_ULP_BL:
+            pc = r[0] < (in->imm & 0xffff) ? in->imm >> 16 : pc;
+            break;
+        case SIM_ULP_BGE:
+            pc = r[0] >= (in->imm & 0xffff) ? in->imm >> 16 : pc;
+            break;
+        case SIM_ULP_BX: pc = in->imm; break;
+        case SIM_ULP_WAKE: wake = true; break;
+        case SIM_ULP_END: *end = true; break;
+        case SIM_ULP_HALT: return wake;
+        }
+    }
+    return wake;
+}
+
+static void ulp_task(void *arg)
+{
+    sim_lock();
+    for (;;) {
+        while (!s_timer_running) {
+            sim_block_locked(&s_timer_running, SIM_FOREVER);
+        }
+        if (sim_now_us_locked() < s_next_run_us) {
+            sim_block_locked(&s_timer_running, s_next_run_us);
+            continue;   // re-check: the timer may have been stopped meanwhile
+        }
+        s_next_run_us = sim_now_us_locked() + s_period_us;
+        sim_unlock();
+        bool end = false;
+        bool wake = run_program(&end);
+        sim_lock();
+        if (end) {
+            s_timer_running = false;
+        }
+        if (wake && s_sleeping && s_ulp_wakeup && s_cause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+            s_cause = ESP_SLEEP_WAKEUP_ULP;
+            sim_wake_all_locked(&s_sleeping);
+        }
+    }
+}
+
+esp_err_t ulp_run(uint32_t entry_point)
+{
+    sim_lock();
+    s_entry = entry_point;
+    s_timer_running = true;
+    s_next_run_us = sim_now_us_locked();
+    bool spawn = !s_task_started;
+    s_task_started = true;
+    sim_wake_all_locked(&s_timer_running);
+    sim_unlock();
+    if (spawn) {
+        sim_heap_untracked(true);   // the coprocessor is hardware, not a heap user
+        sim_task_spawn("ulp", ulp_task, NULL, 2048, configMAX_PRIORITIES - 1, tskNO_AFFINITY);
+        sim_heap_untracked(false);
+    }
+    return ESP_OK;
+}
+
+esp_err_t ulp_set_wakeup_period(size_t period_index, uint32_t period_us)
+{
+    if (period_index != 0) {
+        return ESP_ERR_INVALID_ARG;    // only timer 0 is used by ulp_run
+    }
+    sim_lock();
+    s_period_us = period_us;
+    sim_unlock();
+    return ESP_OK;
+}
+
+void ulp_timer_stop(void)
+{
+    sim_lock();
+    s_timer_running = false;
+    sim_wake_all_locked(&s_timer_running);
+    sim_unlock();
+}
+
+void ulp_timer_resume(void)
+{
+    sim_lock();
+    s_timer_running = true;
+    s_next_run_us = sim_now_us_locked() + s_period_us;
+    sim_wake_all_locked(&s_timer_running);
+    sim_unlock();
+}
+
+esp_err_t ulp_adc_init(const ulp_adc_cfg_t *cfg)
+{
+    if (!cfg || cfg->adc_n != ADC_UNIT_1 || cfg->ulp_mode != ADC_ULP_MODE_FSM) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // As on the chip: the unit is claimed once, a second init finds it in use
+    sim_lock();
+    bool claimed = s_adc_claimed;
+    s_adc_claimed = true;
+    sim_unlock();
+    return claimed ? ESP_ERR_NOT_FOUND : ESP_OK;
+}
+
+esp_err_t ulp_adc_deinit(void)
+{
+    sim_lock();
+    s_adc_claimed = false;
+    sim_unlock();
+    return ESP_OK;
+}
+
+/* -------------------------------------------------------------- rtc io */
+
+int rtc_io_number_get(gpio_num_t gpio_num)
+{
+    for (int i = 0; i < RTCIO_COUNT; i++) {
+        if (rtcio_gpio[i] == gpio_num) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool rtc_gpio_is_valid_gpio(gpio_num_t gpio_num)
+{
+    return rtc_io_number_get(gpio_num) >= 0;
+}
+
+esp_err_t rtc_gpio_init(gpio_num_t gpio_num)
+{
+    return rtc_gpio_is_valid_gpio(gpio_num) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rtc_gpio_deinit(gpio_num_t gpio_num)
+{
+    return rtc_gpio_is_valid_gpio(gpio_num) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio_num, rtc_gpio_mode_t mode)
+{
+    return rtc_gpio_is_valid_gpio(gpio_num) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+/* --------------------------------------------------------------- sleep */
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+    sim_lock();
+    s_timer_wakeup_us = time_in_us;
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ulp_wakeup(void)
+{
+    sim_lock();
+    s_ulp_wakeup = true;
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source)
+{
+    sim_lock();
+    if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_TIMER) {
+        s_timer_wakeup_us = 0;
+    }
+    if (source == ESP_SLEEP_WAKEUP_ALL || source == ESP_SLEEP_WAKEUP_ULP) {
+        s_ulp_wakeup = false;
+    }
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start(void)
+{
+    sim_lock();
+    if (s_timer_wakeup_us == 0 && !s_ulp_wakeup) {
+        sim_unlock();
+        return ESP_ERR_INVALID_STATE;   // would never wake up
+    }
+    uint64_t deadline = s_timer_wakeup_us ? sim_now_us_locked() + s_timer_wakeup_us : SIM_FOREVER;
+    s_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+    s_sleeping = true;
+    while (s_cause == ESP_SLEEP_WAKEUP_UNDEFINED) {
+        sim_block_locked(&s_sleeping, deadline);
+        if (s_cause == ESP_SLEEP_WAKEUP_UNDEFINED && sim_now_us_locked() >= deadline) {
+            s_cause = ESP_SLEEP_WAKEUP_TIMER;
+        }
+    }
+    s_sleeping = false;
+    sim_unlock();
+    return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    sim_lock();
+    esp_sleep_wakeup_cause_t cause = s_cause;
+    sim_unlock();
+    return cause;
+}
@@ -0,0 +1,32 @@
+#ifndef SIM_H
+#define SIM_H
+
+// Simulated greenhouse plant and run report for the host build.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct {
+    const char *trace_path;   // CSV trace to replay (NULL = closed-loop model)
+    uint64_t duration_us;     // 0 = trace length, or forever without a trace
+    double speed;             // 0 = fast-forward, otherwise wall-clock multiplier
+    uint16_t http_port;
+    uint32_t seed;
+    const char *events_path;  // optional CSV log of relay transitions
+    bool wifi_down;           // start with the simulated AP unreachable
+    bool low_power;           // firmware low-power mode (ULP + light sleep)
+    double water_start_l;     // model tank contents at boot, < 0 = full
+    double fert_start_l;
+    double pump_wear_pct;     // pumps deliver this much less than nominal
+} sim_options_t;
+
+// Loads the trace / seeds the model. Returns false on a bad trace file.
+bool sim_plant_init(const sim_options_t *opt);
+
+// Virtual time at which the loaded trace ends (0 without a trace).
+uint64_t sim_plant_trace_end_us(void);
+
+void sim_plant_report(FILE *out, uint64_t now_us, double wall_s);
+
+#endif // SIM_H
@@ -0,0 +1,71 @@
+// The allocator hooks ESP-IDF calls with CONFIG_HEAP_USE_HOOKS, on the host:
+// glibc's malloc family is wrapped and every call made by a firmware task
+// is passed to esp_heap_trace_*_hook(), where components/mem counts it.
+// Threads that are no task (the HTTP sockets, the plant, libc internals)
+// are left out, as the ESP32's lwIP and WiFi heaps would be, and so is
+// simulated hardware (sim_heap_untracked()).
+
+#include "sim_kernel.h"
+#include "esp_heap_caps.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+// A hook that allocates itself must not recurse
+static __thread bool in_hook;
+
+static bool hooked(void)
+{
+    return !in_hook && sim_self_known() != NULL && !sim_heap_is_untracked();
+}
+
+static void after_alloc(void *ptr, size_t size)
+{
+    if (esp_heap_trace_alloc_hook && hooked()) {
+        in_hook = true;
+        esp_heap_trace_alloc_hook(ptr, size, MALLOC_CAP_8BIT);
+        in_hook = false;
+    }
+}
+
+static void before_free(void *ptr)
+{
+    if (esp_heap_trace_free_hook && ptr && hooked()) {
+        in_hook = true;
+        esp_heap_trace_free_hook(ptr);
+        in_hook = false;
+    }
+}
+
+void *malloc(size_t size)
+{
+    void *p = __libc_malloc(size);
+    after_alloc(p, size);
+    return p;
+}
+
+void *calloc(size_t n, size_t size)
+{
+    void *p = __libc_calloc(n, size);
+    after_alloc(p, n * size);
+    return p;
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    before_free(ptr);
+    void *p = __libc_realloc(ptr, size);
+    after_alloc(p, size);
+    return p;
+}
+
+void free(void *ptr)
+{
+    before_free(ptr);
+    __libc_free(ptr);
+}
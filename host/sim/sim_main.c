@@ -0,0 +1,250 @@
+// Host entry point: boots the unmodified firmware (app_main) against the
+// shims and the simulated plant, runs for the requested virtual duration and
+// prints a key=value report that later changes can be benchmarked against.
+
+#include "sim.h"
+#include "sim_kernel.h"
+#include "esp_http_server.h"
+#include "esp_log.h"
+#include "esp_netif_sntp.h"
+#include "esp_ota_ops.h"
+#include "esp_system.h"
+#include "esp_task_wdt.h"
+#include "esp_wifi.h"
+#include "nvs_flash.h"
+#include "mem.h"
+#include "metrics.h"
+#include "power.h"
+#include "rt.h"
+#include "telemetry.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+extern void app_main(void);
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -t, --trace FILE       replay t_s,soil_raw,water_full,fert_full CSV (default: plant model)\n"
+            "  -d, --duration SECS    virtual run time (default: trace length, or forever)\n"
+            "  -D, --days N           virtual run time in days\n"
+            "  -s, --speed X          0 = fast-forward (default), 1 = real time, N = N x real time\n"
+            "  -p, --port PORT        HTTP port for the real handlers (default 8080)\n"
+            "  -l, --log-level LVL    none|error|warn|info|debug (default info)\n"
+            "  -e, --events FILE      write relay transitions as CSV\n"
+            "  -r, --seed N           ADC noise seed (default 1)\n"
+            "  -w, --wifi-down        start with the access point unreachable\n"
+            "  -n, --nvs FILE         keep the NVS partition in FILE (settings and event log survive runs)\n"
+            "  -L, --low-power        run the firmware in low-power mode (ULP sampling, light sleep)\n"
+            "  -R, --realtime         deterministic task layout and control task watchdog\n"
+            "  -T, --telemetry H:P    publish fleet telemetry to the UDP collector at H:P\n"
+            "  -k, --tanks W,F        model tank litres at boot (default full: 50,10)\n"
+            "  -W, --pump-wear PCT    pumps deliver PCT%% less than nominal (2 and 0.5 L/min)\n"
+            "  -C, --clock EPOCH      SNTP time at boot in UTC seconds, 0 = no time server\n"
+            "                         (default %d, 2026-01-01)\n"
+            "  -F, --firmware FILE    running app image in ota_0 (default: synthetic)\n"
+            "  -U, --ota-out FILE     after an OTA update, write the new image (ota_1) to FILE\n"
+            "  -V, --ota-pending      boot the running image on trial, as after an update\n",
+            argv0, SIM_SNTP_DEFAULT_EPOCH);
+}
+
+static esp_log_level_t parse_level(const char *s)
+{
+    static const char *names[] = { "none", "error", "warn", "info", "debug", "verbose" };
+    for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++) {
+        if (strcmp(s, names[i]) == 0) {
+            return (esp_log_level_t)i;
+        }
+    }
+    fprintf(stderr, "unknown log level '%s'\n", s);
+    exit(2);
+}
+
+static void sim_power_report(FILE *out)
+{
+    power_stats_t p;
+    power_get_stats(&p);
+    fprintf(out, "power.mode=%s\n", p.low_power ? "low_power" : "always_on");
+    fprintf(out, "power.sleep_s=%.3f\npower.sleep_pct=%.1f\n", p.sleep_ms / 1000.0,
+            p.uptime_ms ? 100.0 * (double)p.sleep_ms / (double)p.uptime_ms : 0.0);
+    fprintf(out, "power.sleeps=%u\npower.wakes_ulp=%u\npower.wakes_timer=%u\n",
+            p.sleeps, p.wakes_ulp, p.wakes_timer);
+    fprintf(out, "power.avg_current_ma=%.2f\npower.energy_mwh_per_day=%u\n",
+            p.avg_current_ua / 1000.0, p.energy_mwh_per_day);
+    fprintf(out, "power.wake_to_pump_n=%u\npower.wake_to_pump_avg_ms=%.3f\npower.wake_to_pump_max_ms=%.3f\n",
+            p.wake_to_pump_count, p.wake_to_pump_avg_us / 1000.0, p.wake_to_pump_max_us / 1000.0);
+}
+
+// Virtual ms from boot to each milestone, -1 = never reached
+static void sim_boot_report(FILE *out)
+{
+    for (int m = 0; m < METRIC_BOOT_COUNT; m++) {
+        fprintf(out, "boot.%s_ms=%ld\n", metrics_boot_name((metric_boot_t)m),
+                (long)metrics_boot_ms((metric_boot_t)m));
+    }
+}
+
+// Task stacks by origin and the allocations each task kind made after boot
+static void sim_mem_report(FILE *out)
+{
+    mem_report_t m;
+    mem_get_report(&m);
+    fprintf(out, "mem.static_alloc=%d\nmem.stack_static=%u\nmem.stack_heap=%u\nmem.violations=%u\n",
+            m.static_alloc, m.stack_static, m.stack_heap, m.violations);
+    for (int k = 0; k < MEM_KINDS; k++) {
+        fprintf(out, "mem.%s.allocs=%u\nmem.%s.bytes=%u\n", mem_kind_name(k), m.kinds[k].allocs,
+                mem_kind_name(k), m.kinds[k].bytes);
+    }
+}
+
+static double wall_seconds(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double s_wall_start;
+
+static void sim_report(void)
+{
+    fflush(stdout);
+    sim_plant_report(stdout, sim_now_us(), wall_seconds() - s_wall_start);
+    sim_nvs_report(stdout);
+    sim_power_report(stdout);
+    sim_boot_report(stdout);
+    sim_task_wdt_report(stdout);
+    sim_ota_report(stdout);
+    sim_mem_report(stdout);
+    fflush(stdout);
+}
+
+// esp_restart(): the run ends where the device would reboot
+void sim_restart(void)
+{
+    fprintf(stdout, "sim.restart_s=%.3f\n", sim_now_us() / 1e6);
+    sim_report();
+    _exit(0);
+}
+
+int main(int argc, char **argv)
+{
+    sim_options_t opt = { .http_port = 8080, .seed = 1, .water_start_l = -1, .fert_start_l = -1 };
+    esp_log_level_t level = ESP_LOG_INFO;
+
+    static const struct option long_opts[] = {
+        { "trace", required_argument, NULL, 't' },
+        { "duration", required_argument, NULL, 'd' },
+        { "days", required_argument, NULL, 'D' },
+        { "speed", required_argument, NULL, 's' },
+        { "port", required_argument, NULL, 'p' },
+        { "log-level", required_argument, NULL, 'l' },
+        { "events", required_argument, NULL, 'e' },
+        { "seed", required_argument, NULL, 'r' },
+        { "wifi-down", no_argument, NULL, 'w' },
+        { "nvs", required_argument, NULL, 'n' },
+        { "low-power", no_argument, NULL, 'L' },
+        { "realtime", no_argument, NULL, 'R' },
+        { "telemetry", required_argument, NULL, 'T' },
+        { "tanks", required_argument, NULL, 'k' },
+        { "pump-wear", required_argument, NULL, 'W' },
+        { "clock", required_argument, NULL, 'C' },
+        { "firmware", required_argument, NULL, 'F' },
+        { "ota-out", required_argument, NULL, 'U' },
+        { "ota-pending", no_argument, NULL, 'V' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "t:d:D:s:p:l:e:r:wn:LRT:k:W:C:F:U:Vh", long_opts, NULL)) != -1) {
+        switch (c) {
+        case 't': opt.trace_path = optarg; break;
+        case 'd': opt.duration_us = (uint64_t)(atof(optarg) * 1e6); break;
+        case 'D': opt.duration_us = (uint64_t)(atof(optarg) * 86400e6); break;
+        case 's': opt.speed = atof(optarg); break;
+        case 'p': opt.http_port = (uint16_t)atoi(optarg); break;
+        case 'l': level = parse_level(optarg); break;
+        case 'e': opt.events_path = optarg; break;
+        case 'r': opt.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'w': opt.wifi_down = true; break;
+        case 'n': sim_nvs_set_file(optarg); break;
+        case 'L': opt.low_power = true; break;
+        case 'R': rt_set_deterministic(true); break;
+        case 'T': {
+            char *colon = strrchr(optarg, ':');
+            if (colon == NULL) {
+                fprintf(stderr, "--telemetry expects HOST:PORT\n");
+                return 2;
+            }
+            *colon = '\0';
+            telemetry_set_target(optarg, (uint16_t)atoi(colon + 1));
+            break;
+        }
+        case 'k':
+            if (sscanf(optarg, "%lf,%lf", &opt.water_start_l, &opt.fert_start_l) != 2) {
+                fprintf(stderr, "--tanks expects WATER_L,FERT_L\n");
+                return 2;
+            }
+            break;
+        case 'W':
+            opt.pump_wear_pct = atof(optarg);
+            if (opt.pump_wear_pct < 0 || opt.pump_wear_pct >= 100) {
+                fprintf(stderr, "--pump-wear expects a percentage below 100\n");
+                return 2;
+            }
+            break;
+        case 'C': sim_sntp_set_epoch(strtoll(optarg, NULL, 0)); break;
+        case 'F':
+            if (!sim_ota_load_firmware(optarg)) {
+                return 1;
+            }
+            break;
+        case 'U': sim_ota_set_output(optarg); break;
+        case 'V': sim_ota_set_pending_verify(true); break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+    esp_log_level_set("*", level);
+    sim_kernel_init(opt.speed);
+    sim_httpd_set_port_override(opt.http_port);
+    if (opt.wifi_down) {
+        sim_wifi_set_ap_available(false);
+    }
+    power_set_low_power(opt.low_power);
+    if (!sim_plant_init(&opt)) {
+        return 1;
+    }
+    if (opt.duration_us == 0) {
+        opt.duration_us = sim_plant_trace_end_us();
+    }
+
+    sim_attach_main("main");
+    s_wall_start = wall_seconds();
+    app_main();
+
+    // app_main returned like on the device; this task now just waits out the run
+    if (opt.duration_us == 0) {
+        while (1) {
+            vTaskDelay(portMAX_DELAY);
+        }
+    }
+    while (sim_now_us() < opt.duration_us) {
+        uint64_t left_ms = (opt.duration_us - sim_now_us() + 999) / 1000;
+        vTaskDelay(pdMS_TO_TICKS(left_ms) ? pdMS_TO_TICKS(left_ms) : 1);
+    }
+    sim_report();
+    // Firmware tasks never return; end the process from here
+    _exit(0);
+}
@@ -0,0 +1,624 @@
+// Greenhouse plant behind the HAL hooks: either replays a recorded trace
+// (open loop) or runs a small closed-loop soil / tank model driven by the
+// relay outputs. Also keeps the per-relay statistics for the run report and,
+// for the model, how long the soil was past zone 1's threshold before pump 1
+// started (detection latency: check interval, filter lag or ULP period),
+// and how long a pump kept running after its tank's float switch dropped.
+// It also tells the GPIO shim when a tank switch will next change, so the
+// firmware's edge interrupts fire at the right virtual instant, and is the
+// pulse source of the flow meters (FLOW_METER_TABLE), predicting for the
+// PCNT shim when a meter's count reaches a watch point. The fertilizer pump
+// can also run on PWM (FERT_PWM_PIN), with the flow of a DC pump's duty.
+
+#include "sim.h"
+#include "sim_hal.h"
+#include "sim_kernel.h"
+#include "sensors.h"
+#include "flow.h"
+#include "system_state.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define US_PER_S   1000000ULL
+#define US_PER_H   (3600ULL * US_PER_S)
+
+// Closed-loop model parameters (ADC raw: higher = drier)
+#define SOIL_START_RAW        2650.0
+#define SOIL_MIN_RAW          1200.0
+#define SOIL_MAX_RAW          3600.0
+#define SOIL_DRY_PER_HOUR     60.0     // mean drying rate, peaks mid-afternoon
+#define SOIL_WET_PER_SEC      12.0     // while the water pump runs
+#define SOIL_FERT_WET_PER_SEC 2.0
+#define ADC_NOISE_RAW         6
+
+#define WATER_TANK_L          50.0
+#define FERT_TANK_L           10.0
+#define WATER_FLOW_LPS        (2.0 / 60.0)
+#define FERT_FLOW_LPS         (0.5 / 60.0)
+#define TANK_SENSOR_MIN_L     0.5      // float switch sits just above the outlet
+#define TANK_REFILL_PERIOD_US (24 * US_PER_H)
+#define PUMP_STALL_DUTY       0.2      // on PWM: no flow below, then linear up to full
+
+typedef struct {
+    uint64_t t_us;
+    int soil;
+    bool water;
+    bool fert;
+} trace_row_t;
+
+typedef struct {
+    int gpio;
+    const char *name;
+    double flow_lps;        // nominal, less --pump-wear
+    double *tank_l;         // model tank it draws from
+    int pwm_gpio;           // MOSFET input in parallel with the relay, -1 = none
+    bool relay_on;
+    double pwm;             // duty on pwm_gpio
+    bool on;                // running: relay closed or a PWM duty
+    uint64_t on_since_us;
+    uint64_t on_total_us;
+    uint32_t starts;
+    double litres;          // pumped so far (trace mode: up to rate_since_us)
+    uint64_t rate_since_us; // trace mode: last change of the flow
+} relay_stat_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static trace_row_t *s_trace = NULL;
+static size_t s_trace_len = 0;
+static size_t s_trace_pos = 0;
+
+static double s_soil = SOIL_START_RAW;
+static double s_water_l = WATER_TANK_L;
+static double s_fert_l = FERT_TANK_L;
+static double s_water_used_l = 0;
+static double s_fert_used_l = 0;
+static uint64_t s_model_t_us = 0;
+static double s_water_dry_s = 0;       // pump on with the switch reading empty
+static double s_fert_dry_s = 0;
+
+static uint32_t s_rng = 1;
+static uint64_t s_adc_reads = 0;
+static double s_soil_sum = 0;
+static int s_soil_lo = 4095;
+static int s_soil_hi = 0;
+
+static FILE *s_events = NULL;
+
+static uint64_t s_dry_since_us = 0;    // model soil crossed the threshold (0 = not dry)
+static uint32_t s_dry_to_pump_n = 0;
+static uint64_t s_dry_to_pump_sum_us = 0;
+static uint64_t s_dry_to_pump_max_us = 0;
+
+// Fertilizer per litre of water while the fertilizer pump runs on PWM
+static double s_mix_s = 0;
+static double s_mix_water_l = 0;
+static double s_mix_fert_l = 0;
+static double s_mix_lo = INFINITY;
+static double s_mix_hi = 0;
+
+static relay_stat_t s_relays[] = {
+    { .gpio = RELAY_PUMP1, .name = "pump1", .flow_lps = WATER_FLOW_LPS, .tank_l = &s_water_l, .pwm_gpio = -1 },
+    { .gpio = RELAY_PUMP2, .name = "pump2", .flow_lps = FERT_FLOW_LPS, .tank_l = &s_fert_l,
+      .pwm_gpio = FERT_PWM_PIN },
+};
+#define RELAY_COUNT (sizeof(s_relays) / sizeof(s_relays[0]))
+
+static uint32_t xorshift32(void)
+{
+    uint32_t x = s_rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    s_rng = x;
+    return x;
+}
+
+static relay_stat_t *relay_for(int gpio)
+{
+    for (size_t i = 0; i < RELAY_COUNT; i++) {
+        if (s_relays[i].gpio == gpio) {
+            return &s_relays[i];
+        }
+    }
+    return NULL;
+}
+
+static relay_stat_t *relay_for_pwm(int gpio)
+{
+    for (size_t i = 0; i < RELAY_COUNT; i++) {
+        if (s_relays[i].pwm_gpio == gpio) {
+            return &s_relays[i];
+        }
+    }
+    return NULL;
+}
+
+// Flow of a pump as its outputs are: full with the relay closed, or what
+// its PWM duty gives
+static double relay_lps(const relay_stat_t *r)
+{
+    if (r->relay_on) {
+        return r->flow_lps;
+    }
+    return r->pwm > PUMP_STALL_DUTY ? r->flow_lps * ((r->pwm - PUMP_STALL_DUTY) / (1.0 - PUMP_STALL_DUTY)) : 0.0;
+}
+
+/* --------------------------------------------------------------- trace */
+
+static bool load_trace(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+    size_t cap = 256;
+    s_trace = malloc(cap * sizeof(*s_trace));
+    char line[256];
+    unsigned lineno = 0;
+    while (s_trace && fgets(line, sizeof(line), f)) {
+        lineno++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == 't') {
+            continue;  // comment, blank or header row
+        }
+        double t_s;
+        int soil, water, fert;
+        if (sscanf(line, "%lf,%d,%d,%d", &t_s, &soil, &water, &fert) != 4) {
+            fprintf(stderr, "%s:%u: expected t_s,soil_raw,water_full,fert_full\n", path, lineno);
+            fclose(f);
+            return false;
+        }
+        if (s_trace_len == cap) {
+            cap *= 2;
+            trace_row_t *grown = realloc(s_trace, cap * sizeof(*s_trace));
+            if (grown == NULL) {
+                break;
+            }
+            s_trace = grown;
+        }
+        uint64_t t_us = (uint64_t)(t_s * US_PER_S);
+        if (s_trace_len > 0 && t_us < s_trace[s_trace_len - 1].t_us) {
+            fprintf(stderr, "%s:%u: timestamps must not decrease\n", path, lineno);
+            fclose(f);
+            return false;
+        }
+        s_trace[s_trace_len++] = (trace_row_t){ t_us, soil, water != 0, fert != 0 };
+    }
+    fclose(f);
+    if (s_trace_len == 0) {
+        fprintf(stderr, "%s: no samples\n", path);
+        return false;
+    }
+    return true;
+}
+
+// Step-hold lookup; time only moves forward so the cursor is amortised O(1)
+static const trace_row_t *trace_at(uint64_t now_us)
+{
+    while (s_trace_pos + 1 < s_trace_len && s_trace[s_trace_pos + 1].t_us <= now_us) {
+        s_trace_pos++;
+    }
+    return &s_trace[s_trace_pos];
+}
+
+// First row after the current one where a tank switch changes
+static uint64_t trace_next_tank_change(uint64_t now_us)
+{
+    const trace_row_t *row = trace_at(now_us);
+    for (size_t i = s_trace_pos + 1; i < s_trace_len; i++) {
+        if (s_trace[i].water != row->water || s_trace[i].fert != row->fert) {
+            return s_trace[i].t_us;
+        }
+    }
+    return SIM_FOREVER;
+}
+
+/* --------------------------------------------------------------- model */
+
+// Seconds of a dt-long pumping step spent below the float switch
+static double dry_seconds(double level_l, double flow_lps, double dt)
+{
+    if (level_l <= TANK_SENSOR_MIN_L) {
+        return dt;
+    }
+    double wet_s = (level_l - TANK_SENSOR_MIN_L) / flow_lps;
+    return wet_s < dt ? dt - wet_s : 0.0;
+}
+
+static double diurnal_factor(uint64_t t_us)
+{
+    double hour = fmod((double)t_us / (double)US_PER_H, 24.0);
+    double f = 1.0 + 0.8 * sin(2.0 * M_PI * (hour - 9.0) / 24.0);
+    return f < 0.2 ? 0.2 : f;
+}
+
+static void model_advance(uint64_t now_us)
+{
+    if (s_trace || now_us <= s_model_t_us) {
+        return;
+    }
+    while (s_model_t_us < now_us) {
+        // Integrate in steps no longer than a minute and never across a refill
+        uint64_t next_refill = (s_model_t_us / TANK_REFILL_PERIOD_US + 1) * TANK_REFILL_PERIOD_US;
+        uint64_t step_end = s_model_t_us + 60 * US_PER_S;
+        if (step_end > now_us) {
+            step_end = now_us;
+        }
+        if (step_end > next_refill) {
+            step_end = next_refill;
+        }
+        double dt = (double)(step_end - s_model_t_us) / (double)US_PER_S;
+        uint64_t mid = s_model_t_us + (step_end - s_model_t_us) / 2;
+
+        s_soil += SOIL_DRY_PER_HOUR * diurnal_factor(mid) * dt / 3600.0;
+        double water_lps = relay_lps(&s_relays[0]);
+        double fert_lps = relay_lps(&s_relays[1]);
+        if (water_lps > 0) {
+            s_water_dry_s += dry_seconds(s_water_l, water_lps, dt);
+        }
+        if (fert_lps > 0) {
+            s_fert_dry_s += dry_seconds(s_fert_l, fert_lps, dt);
+        }
+        double water_v = 0, fert_v = 0;
+        if (water_lps > 0 && s_water_l > 0) {
+            water_v = water_lps * dt;
+            water_v = water_v > s_water_l ? s_water_l : water_v;
+            s_water_l -= water_v;
+            s_water_used_l += water_v;
+            s_relays[0].litres += water_v;
+            s_soil -= SOIL_WET_PER_SEC * dt;
+        }
+        if (fert_lps > 0 && s_fert_l > 0) {
+            fert_v = fert_lps * dt;
+            fert_v = fert_v > s_fert_l ? s_fert_l : fert_v;
+            s_fert_l -= fert_v;
+            s_fert_used_l += fert_v;
+            s_relays[1].litres += fert_v;
+            s_soil -= SOIL_FERT_WET_PER_SEC * dt * (fert_lps / s_relays[1].flow_lps);
+        }
+        if (s_relays[1].pwm > 0 && water_v > 0) {
+            double ml_l = fert_v / water_v * 1000.0;
+            s_mix_s += dt;
+            s_mix_water_l += water_v;
+            s_mix_fert_l += fert_v;
+            s_mix_lo = ml_l < s_mix_lo ? ml_l : s_mix_lo;
+            s_mix_hi = ml_l > s_mix_hi ? ml_l : s_mix_hi;
+        }
+        s_soil = s_soil < SOIL_MIN_RAW ? SOIL_MIN_RAW : (s_soil > SOIL_MAX_RAW ? SOIL_MAX_RAW : s_soil);
+        if (s_dry_since_us == 0 && !s_relays[0].on) {
+            system_state_t st;
+            system_state_read(&st);
+            if (st.zone_count > 0 && s_soil > st.zone_threshold[0]) {
+                s_dry_since_us = step_end;
+            }
+        }
+
+        s_model_t_us = step_end;
+        if (s_model_t_us == next_refill) {
+            s_water_l = WATER_TANK_L;
+            s_fert_l = FERT_TANK_L;
+        }
+    }
+}
+
+/* ------------------------------------------------------------ HAL hooks */
+
+int sim_hal_read_input(int gpio)
+{
+    uint64_t now = sim_now_us();
+    int level = 0;
+    pthread_mutex_lock(&s_lock);
+    if (s_trace) {
+        const trace_row_t *row = trace_at(now);
+        level = gpio == WATER_LEVEL1 ? row->water : (gpio == WATER_LEVEL2 ? row->fert : 0);
+    } else {
+        model_advance(now);
+        if (gpio == WATER_LEVEL1) {
+            level = s_water_l > TANK_SENSOR_MIN_L;
+        } else if (gpio == WATER_LEVEL2) {
+            level = s_fert_l > TANK_SENSOR_MIN_L;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return level;
+}
+
+// Time until a pumped tank's level passes the switch, rounded up so the
+// switch has dropped when the GPIO shim looks
+static uint64_t drain_us(double level_l, double flow_lps)
+{
+    return (uint64_t)ceil((level_l - TANK_SENSOR_MIN_L) / flow_lps * (double)US_PER_S) + 1;
+}
+
+uint64_t sim_hal_next_input_change_us(void)
+{
+    uint64_t now = sim_now_us();
+    uint64_t next;
+    pthread_mutex_lock(&s_lock);
+    if (s_trace) {
+        next = trace_next_tank_change(now);
+    } else {
+        model_advance(now);
+        // A refill raises an empty switch; a running pump lowers a full one
+        next = SIM_FOREVER;
+        if (s_water_l <= TANK_SENSOR_MIN_L || s_fert_l <= TANK_SENSOR_MIN_L) {
+            next = (s_model_t_us / TANK_REFILL_PERIOD_US + 1) * TANK_REFILL_PERIOD_US;
+        }
+        double water_lps = relay_lps(&s_relays[0]);
+        double fert_lps = relay_lps(&s_relays[1]);
+        if (water_lps > 0 && s_water_l > TANK_SENSOR_MIN_L) {
+            uint64_t t = s_model_t_us + drain_us(s_water_l, water_lps);
+            next = t < next ? t : next;
+        }
+        if (fert_lps > 0 && s_fert_l > TANK_SENSOR_MIN_L) {
+            uint64_t t = s_model_t_us + drain_us(s_fert_l, fert_lps);
+            next = t < next ? t : next;
+        }
+    }
+    pthread_mutex_unlock(&s_lock);
+    return next;
+}
+
+/* ---------------------------------------------------------- flow meters */
+
+static const flow_meter_config_t *meter_on_pin(int gpio)
+{
+    for (int m = 0; m < flow_meter_count(); m++) {
+        if (flow_meter_config(m)->pin == gpio) {
+            return flow_meter_config(m);
+        }
+    }
+    return NULL;
+}
+
+// Litres a pump has moved: the model's (nothing from an empty tank), or in
+// trace mode its flow over time, whatever the tanks
+static double relay_litres(const relay_stat_t *r, uint64_t now_us)
+{
+    if (!s_trace) {
+        return r->litres;
+    }
+    return r->litres + relay_lps(r) * (double)(now_us - r->rate_since_us) / (double)US_PER_S;
+}
+
+static double meter_litres(const flow_meter_config_t *m, uint64_t now_us)
+{
+    double litres = 0;
+    for (size_t i = 0; i < RELAY_COUNT; i++) {
+        if (m->relays & (1ULL << s_relays[i].gpio)) {
+            litres += relay_litres(&s_relays[i], now_us);
+        }
+    }
+    return litres;
+}
+
+static double meter_flow_lps(const flow_meter_config_t *m)
+{
+    double lps = 0;
+    for (size_t i = 0; i < RELAY_COUNT; i++) {
+        relay_stat_t *r = &s_relays[i];
+        if ((m->relays & (1ULL << r->gpio)) && (s_trace || *r->tank_l > 0)) {
+            lps += relay_lps(r);
+        }
+    }
+    return lps;
+}
+
+uint64_t sim_hal_pulse_count(int gpio)
+{
+    const flow_meter_config_t *m = meter_on_pin(gpio);
+    if (m == NULL) {
+        return 0;
+    }
+    uint64_t now = sim_now_us();
+    pthread_mutex_lock(&s_lock);
+    model_advance(now);
+    double pulses = meter_litres(m, now) * m->pulses_per_l;
+    pthread_mutex_unlock(&s_lock);
+    return (uint64_t)floor(pulses);
+}
+
+// Rounded up, so the count has got there when the PCNT shim looks
+uint64_t sim_hal_pulse_due_us(int gpio, uint64_t count)
+{
+    const flow_meter_config_t *m = meter_on_pin(gpio);
+    if (m == NULL) {
+        return SIM_FOREVER;
+    }
+    uint64_t now = sim_now_us();
+    pthread_mutex_lock(&s_lock);
+    model_advance(now);
+    double left_l = (double)count / m->pulses_per_l - meter_litres(m, now);
+    double lps = meter_flow_lps(m);
+    pthread_mutex_unlock(&s_lock);
+    if (left_l <= 0) {
+        return now;
+    }
+    if (lps <= 0) {
+        return SIM_FOREVER;
+    }
+    return now + (uint64_t)ceil(left_l / lps * (double)US_PER_S) + 1;
+}
+
+void sim_hal_fill_adc(int unit, int channel, uint16_t *out, size_t n)
+{
+    if (unit != 0 || channel != SOIL_MOISTURE) {
+        memset(out, 0, n * sizeof(*out));
+        return;
+    }
+    uint64_t now = sim_now_us();
+    pthread_mutex_lock(&s_lock);
+    double soil;
+    if (s_trace) {
+        soil = trace_at(now)->soil;
+    } else {
+        model_advance(now);
+        soil = s_soil;
+    }
+    int base = (int)lround(soil) - ADC_NOISE_RAW;
+    int64_t sum = 0;
+    int lo = s_soil_lo, hi = s_soil_hi;
+    for (size_t i = 0; i < n; i++) {
+        // Uniform noise in [-ADC_NOISE_RAW, ADC_NOISE_RAW] without a divide
+        int raw = base + (int)(((uint64_t)xorshift32() * (2 * ADC_NOISE_RAW + 1)) >> 32);
+        raw = raw < 0 ? 0 : (raw > 4095 ? 4095 : raw);
+        out[i] = (uint16_t)raw;
+        sum += raw;
+        lo = raw < lo ? raw : lo;
+        hi = raw > hi ? raw : hi;
+    }
+    s_soil_sum += (double)sum;
+    s_soil_lo = lo;
+    s_soil_hi = hi;
+    s_adc_reads += n;
+    pthread_mutex_unlock(&s_lock);
+}
+
+// A pump's relay or PWM duty is about to change: in trace mode, book the
+// litres at the old flow
+static void relay_flow_changing(relay_stat_t *r, uint64_t now_us)
+{
+    if (s_trace) {
+        r->litres = relay_litres(r, now_us);
+        r->rate_since_us = now_us;
+    }
+}
+
+// The relay or PWM duty changed: starts, on-time and detection latency
+static void relay_update_running(relay_stat_t *r, uint64_t now_us)
+{
+    bool on = r->relay_on || r->pwm > 0;
+    if (on && !r->on) {
+        r->starts++;
+        r->on_since_us = now_us;
+        if (r == &s_relays[0] && s_dry_since_us) {
+            uint64_t latency = now_us - s_dry_since_us;
+            s_dry_to_pump_n++;
+            s_dry_to_pump_sum_us += latency;
+            s_dry_to_pump_max_us = latency > s_dry_to_pump_max_us ? latency : s_dry_to_pump_max_us;
+            s_dry_since_us = 0;
+        }
+    } else if (!on && r->on) {
+        r->on_total_us += now_us - r->on_since_us;
+    }
+    r->on = on;
+}
+
+void sim_hal_output_changed(int gpio, int level, uint64_t now_us)
+{
+    pthread_mutex_lock(&s_lock);
+    model_advance(now_us);
+    relay_stat_t *r = relay_for(gpio);
+    if (r) {
+        relay_flow_changing(r, now_us);
+        r->relay_on = level == 0;  // active-low relay modules
+        relay_update_running(r, now_us);
+    }
+    if (s_events) {
+        fprintf(s_events, "%llu,%d,%d\n", (unsigned long long)(now_us / 1000), gpio, level);
+    }
+    pthread_mutex_unlock(&s_lock);
+    if (r) {
+        sim_gpio_inputs_changed();      // a pump start or stop moves the next tank edge
+        sim_pcnt_inputs_changed();      // and the next flow meter watch point
+    }
+}
+
+void sim_hal_pwm_changed(int gpio, double duty, uint64_t now_us)
+{
+    pthread_mutex_lock(&s_lock);
+    model_advance(now_us);
+    relay_stat_t *r = relay_for_pwm(gpio);
+    if (r) {
+        relay_flow_changing(r, now_us);
+        r->pwm = duty;
+        relay_update_running(r, now_us);
+    }
+    pthread_mutex_unlock(&s_lock);
+    if (r) {
+        sim_gpio_inputs_changed();
+        sim_pcnt_inputs_changed();
+    }
+}
+
+/* ----------------------------------------------------------------- API */
+
+bool sim_plant_init(const sim_options_t *opt)
+{
+    s_rng = opt->seed ? opt->seed : 1;
+    if (opt->water_start_l >= 0) {
+        s_water_l = opt->water_start_l < WATER_TANK_L ? opt->water_start_l : WATER_TANK_L;
+    }
+    if (opt->fert_start_l >= 0) {
+        s_fert_l = opt->fert_start_l < FERT_TANK_L ? opt->fert_start_l : FERT_TANK_L;
+    }
+    for (size_t i = 0; i < RELAY_COUNT; i++) {
+        s_relays[i].flow_lps *= 1.0 - opt->pump_wear_pct / 100.0;
+    }
+    if (opt->trace_path && !load_trace(opt->trace_path)) {
+        return false;
+    }
+    if (opt->events_path) {
+        s_events = fopen(opt->events_path, "w");
+        if (s_events == NULL) {
+            perror(opt->events_path);
+            return false;
+        }
+        fprintf(s_events, "t_ms,gpio,level\n");
+    }
+    return true;
+}
+
+uint64_t sim_plant_trace_end_us(void)
+{
+    return s_trace ? s_trace[s_trace_len - 1].t_us : 0;
+}
+
+void sim_plant_report(FILE *out, uint64_t now_us, double wall_s)
+{
+    pthread_mutex_lock(&s_lock);
+    model_advance(now_us);
+    double virt_s = (double)now_us / (double)US_PER_S;
+    fprintf(out, "sim.virtual_s=%.3f\n", virt_s);
+    fprintf(out, "sim.wall_s=%.3f\n", wall_s);
+    fprintf(out, "sim.speedup=%.0f\n", wall_s > 0 ? virt_s / wall_s : 0.0);
+    fprintf(out, "sim.mode=%s\n", s_trace ? "trace" : "model");
+    fprintf(out, "adc.samples=%llu\n", (unsigned long long)s_adc_reads);
+    if (s_adc_reads) {
+        fprintf(out, "soil.min=%d\nsoil.mean=%.1f\nsoil.max=%d\n",
+                s_soil_lo, s_soil_sum / (double)s_adc_reads, s_soil_hi);
+    }
+    for (size_t i = 0; i < RELAY_COUNT; i++) {
+        relay_stat_t *r = &s_relays[i];
+        uint64_t on_us = r->on_total_us + (r->on ? now_us - r->on_since_us : 0);
+        fprintf(out, "%s.starts=%u\n%s.on_s=%.3f\n", r->name, r->starts, r->name,
+                (double)on_us / (double)US_PER_S);
+    }
+    system_state_t st;
+    system_state_read(&st);
+    for (int m = 0; m < flow_meter_count() && m < st.meter_count; m++) {
+        const flow_meter_config_t *cfg = flow_meter_config(m);
+        fprintf(out, "flow.%s.litres=%.3f\nflow.%s.last_run_ml=%u\n", cfg->name, meter_litres(cfg, now_us),
+                cfg->name, (unsigned)st.meter_last_ml[m]);
+    }
+    if (!s_trace) {
+        fprintf(out, "water.used_l=%.2f\nfert.used_l=%.2f\n", s_water_used_l, s_fert_used_l);
+        fprintf(out, "water.dry_run_s=%.3f\nfert.dry_run_s=%.3f\n", s_water_dry_s, s_fert_dry_s);
+        fprintf(out, "latency.dry_to_pump_n=%u\nlatency.dry_to_pump_avg_s=%.3f\nlatency.dry_to_pump_max_s=%.3f\n",
+                s_dry_to_pump_n,
+                s_dry_to_pump_n ? (double)s_dry_to_pump_sum_us / s_dry_to_pump_n / US_PER_S : 0.0,
+                (double)s_dry_to_pump_max_us / US_PER_S);
+        if (s_mix_s > 0) {
+            fprintf(out, "mix.s=%.3f\nmix.ml_per_l=%.1f\nmix.ml_per_l_min=%.1f\nmix.ml_per_l_max=%.1f\n", s_mix_s,
+                    s_mix_fert_l / s_mix_water_l * 1000.0, s_mix_lo, s_mix_hi);
+        }
+    }
+    if (s_events) {
+        fflush(s_events);
+    }
+    pthread_mutex_unlock(&s_lock);
+}
@@ -0,0 +1,268 @@
+// Fleet telemetry collector: receives the controllers' UDP datagrams
+// (components/telemetry), tracks every node's sequence numbers and reports
+// throughput and loss. Runs against real devices, the simulator (-T) or
+// telemetry_flood. See docs/HOST_SIMULATION.md.
+//
+//   ./build-host/telemetry_collector -p 9999 -d 30
+
+#include "telemetry_frame.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RX_BATCH        64          // datagrams per recvmmsg()
+#define RX_BUF_BYTES    (8 << 20)   // socket buffer: rides out bursts from thousands of nodes
+#define TABLE_MIN       1024
+
+typedef struct {
+    uint32_t node_id;
+    uint32_t boot_id;
+    uint32_t next_seq;
+    bool used;
+} node_t;
+
+typedef struct {
+    uint64_t packets;
+    uint64_t records;
+    uint64_t bytes;
+    uint64_t lost;          // sequence gaps, less datagrams that turned up late
+    uint64_t late;          // arrived after a later datagram from the same node
+    uint64_t reboots;       // boot_id changed
+    uint64_t bad;           // not a telemetry datagram
+    uint64_t heartbeats;
+} stats_t;
+
+static node_t *table;
+static size_t table_size;
+static size_t node_count;
+static stats_t total;
+static volatile sig_atomic_t stop;
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -p, --port PORT        UDP port to listen on (default %d)\n"
+            "  -d, --duration SECS    stop after SECS (default: until Ctrl-C)\n"
+            "  -i, --interval SECS    progress line every SECS, 0 = none (default 1)\n",
+            argv0, 9999);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void on_signal(int sig)
+{
+    stop = 1;
+}
+
+static size_t slot_of(uint32_t node_id, size_t size)
+{
+    return (size_t)(node_id * 2654435761u) & (size - 1);
+}
+
+static void table_grow(void)
+{
+    size_t size = table_size ? table_size * 2 : TABLE_MIN;
+    node_t *grown = calloc(size, sizeof(node_t));
+    if (grown == NULL) {
+        perror("calloc");
+        exit(1);
+    }
+    for (size_t i = 0; i < table_size; i++) {
+        if (table[i].used) {
+            size_t s = slot_of(table[i].node_id, size);
+            while (grown[s].used) {
+                s = (s + 1) & (size - 1);
+            }
+            grown[s] = table[i];
+        }
+    }
+    free(table);
+    table = grown;
+    table_size = size;
+}
+
+// Linear probing; the table stays under 70 % full
+static node_t *node_lookup(uint32_t node_id, bool *created)
+{
+    if ((node_count + 1) * 10 > table_size * 7) {
+        table_grow();
+    }
+    size_t s = slot_of(node_id, table_size);
+    while (table[s].used && table[s].node_id != node_id) {
+        s = (s + 1) & (table_size - 1);
+    }
+    *created = !table[s].used;
+    if (*created) {
+        table[s] = (node_t){ .node_id = node_id, .used = true };
+        node_count++;
+    }
+    return &table[s];
+}
+
+static void on_datagram(const uint8_t *buf, size_t len)
+{
+    telemetry_header_t h;
+    if (!telemetry_get_header(buf, len, &h)) {
+        total.bad++;
+        return;
+    }
+    total.packets++;
+    total.records += h.count;
+    total.bytes += len;
+    for (int i = 0; i < h.count; i++) {
+        telemetry_record_t r;
+        telemetry_get_record(buf, i, &r);
+        if (r.flags & TELEMETRY_HEARTBEAT) {
+            total.heartbeats++;
+        }
+    }
+
+    bool created;
+    node_t *n = node_lookup(h.node_id, &created);
+    if (created || n->boot_id != h.boot_id) {
+        // New node or new boot: start counting from here
+        if (!created) {
+            total.reboots++;
+        }
+        n->boot_id = h.boot_id;
+        n->next_seq = h.seq + 1;
+    } else if (h.seq >= n->next_seq) {
+        total.lost += h.seq - n->next_seq;
+        n->next_seq = h.seq + 1;
+    } else {
+        // Counted as lost when the later one arrived
+        total.late++;
+        if (total.lost > 0) {
+            total.lost--;
+        }
+    }
+}
+
+static double loss_pct(const stats_t *s)
+{
+    uint64_t expected = s->packets + s->lost;
+    return expected ? 100.0 * (double)s->lost / (double)expected : 0.0;
+}
+
+int main(int argc, char **argv)
+{
+    int port = 9999;
+    double duration_s = 0;
+    double interval_s = 1;
+
+    static const struct option long_opts[] = {
+        { "port", required_argument, NULL, 'p' },
+        { "duration", required_argument, NULL, 'd' },
+        { "interval", required_argument, NULL, 'i' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "p:d:i:h", long_opts, NULL)) != -1) {
+        switch (c) {
+        case 'p': port = atoi(optarg); break;
+        case 'd': duration_s = atof(optarg); break;
+        case 'i': interval_s = atof(optarg); break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    int rcvbuf = RX_BUF_BYTES;
+    setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    struct timeval tv = { .tv_usec = 100000 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons((uint16_t)port),
+        .sin_addr.s_addr = htonl(INADDR_ANY),
+    };
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        perror("bind");
+        return 1;
+    }
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    table_grow();
+    fprintf(stderr, "listening on udp/%d\n", port);
+
+    static uint8_t bufs[RX_BATCH][2048];
+    struct iovec iov[RX_BATCH];
+    struct mmsghdr msgs[RX_BATCH];
+    for (int i = 0; i < RX_BATCH; i++) {
+        iov[i] = (struct iovec){ .iov_base = bufs[i], .iov_len = sizeof(bufs[i]) };
+        msgs[i] = (struct mmsghdr){ .msg_hdr = { .msg_iov = &iov[i], .msg_iovlen = 1 } };
+    }
+
+    double start = 0;           // first and last datagram: idle time is not counted
+    double last_rx = 0;
+    double last_report = 0;
+    stats_t at_report = { 0 };
+    double t0 = now_s();
+    while (!stop) {
+        double t = now_s();
+        if (duration_s > 0 && t - t0 >= duration_s) {
+            break;
+        }
+        if (interval_s > 0 && start > 0 && t - last_report >= interval_s) {
+            double dt = t - last_report;
+            fprintf(stderr, "%7.1fs  nodes=%zu  %.0f pkt/s  %.0f rec/s  %.2f MB/s  loss=%.3f%%  bad=%llu\n",
+                    t - start, node_count, (double)(total.packets - at_report.packets) / dt,
+                    (double)(total.records - at_report.records) / dt,
+                    (double)(total.bytes - at_report.bytes) / dt / 1e6, loss_pct(&total),
+                    (unsigned long long)total.bad);
+            at_report = total;
+            last_report = t;
+        }
+
+        int n = recvmmsg(sock, msgs, RX_BATCH, MSG_WAITFORONE, NULL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                continue;
+            }
+            perror("recvmmsg");
+            return 1;
+        }
+        last_rx = now_s();
+        if (start == 0) {
+            start = last_report = last_rx;
+        }
+        for (int i = 0; i < n; i++) {
+            on_datagram(bufs[i], msgs[i].msg_len);
+        }
+    }
+
+    double elapsed = last_rx - start;
+    printf("collector.elapsed_s=%.3f\n", elapsed);
+    printf("collector.nodes=%zu\n", node_count);
+    printf("collector.packets=%llu\n", (unsigned long long)total.packets);
+    printf("collector.records=%llu\n", (unsigned long long)total.records);
+    printf("collector.heartbeats=%llu\n", (unsigned long long)total.heartbeats);
+    printf("collector.bytes=%llu\n", (unsigned long long)total.bytes);
+    printf("collector.pkts_per_s=%.0f\n", elapsed > 0 ? total.packets / elapsed : 0.0);
+    printf("collector.records_per_s=%.0f\n", elapsed > 0 ? total.records / elapsed : 0.0);
+    printf("collector.mb_per_s=%.3f\n", elapsed > 0 ? total.bytes / elapsed / 1e6 : 0.0);
+    printf("collector.lost=%llu\n", (unsigned long long)total.lost);
+    printf("collector.loss_pct=%.3f\n", loss_pct(&total));
+    printf("collector.late=%llu\n", (unsigned long long)total.late);
+    printf("collector.reboots=%llu\n", (unsigned long long)total.reboots);
+    printf("collector.bad=%llu\n", (unsigned long long)total.bad);
+    return 0;
+}
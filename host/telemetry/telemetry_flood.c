@@ -0,0 +1,210 @@
+// Fleet telemetry load generator: plays thousands of controllers sending
+// the firmware's datagram format over UDP, so the collector can be sized
+// and its loss accounting checked (--drop skips sequence numbers on
+// purpose). See docs/HOST_SIMULATION.md.
+//
+//   ./build-host/telemetry_flood -n 5000 -r 10 -d 10 --drop 1
+
+#include "telemetry_frame.h"
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define TX_BATCH    64          // datagrams per sendmmsg()
+
+typedef struct {
+    uint32_t node_id;
+    uint32_t boot_id;
+    uint32_t seq;
+    uint16_t version;
+    uint16_t soil;
+} node_t;
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -t, --target HOST:PORT collector address (default 127.0.0.1:9999)\n"
+            "  -n, --nodes N          simulated controllers (default 1000)\n"
+            "  -r, --rate R           datagrams per second per node (default 1)\n"
+            "  -b, --records N        records per datagram, 1-%d (default 8)\n"
+            "  -d, --duration SECS    run time (default 10)\n"
+            "  -x, --drop PCT         skip this %% of datagrams (sequence still advances)\n"
+            "  -s, --seed N           random seed (default 1)\n",
+            argv0, TELEMETRY_MAX_RECORDS);
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static size_t build_datagram(uint8_t *buf, node_t *n, int records, uint32_t t_ms)
+{
+    telemetry_header_t h = {
+        .count = (uint8_t)records,
+        .node_id = n->node_id,
+        .boot_id = n->boot_id,
+        .seq = n->seq,
+        .sent_ms = t_ms,
+    };
+    telemetry_put_header(buf, &h);
+    for (int i = 0; i < records; i++) {
+        // Soil drifts; every other record is a heartbeat
+        n->soil = (uint16_t)(n->soil + rand() % 21 - 10);
+        bool heartbeat = i & 1;
+        if (!heartbeat) {
+            n->version++;
+        }
+        telemetry_record_t r = {
+            .t_ms = t_ms,
+            .soil = n->soil,
+            .threshold = 2000,
+            .zone_count = 1,
+            .flags = TELEMETRY_AUTO | (heartbeat ? TELEMETRY_HEARTBEAT : 0),
+            .version = n->version,
+        };
+        telemetry_put_record(buf + TELEMETRY_HEADER_BYTES + i * TELEMETRY_RECORD_BYTES, &r);
+    }
+    return TELEMETRY_HEADER_BYTES + (size_t)records * TELEMETRY_RECORD_BYTES;
+}
+
+int main(int argc, char **argv)
+{
+    const char *target = "127.0.0.1:9999";
+    int nodes = 1000;
+    double rate = 1;
+    int records = 8;
+    double duration_s = 10;
+    double drop_pct = 0;
+    unsigned seed = 1;
+
+    static const struct option long_opts[] = {
+        { "target", required_argument, NULL, 't' },
+        { "nodes", required_argument, NULL, 'n' },
+        { "rate", required_argument, NULL, 'r' },
+        { "records", required_argument, NULL, 'b' },
+        { "duration", required_argument, NULL, 'd' },
+        { "drop", required_argument, NULL, 'x' },
+        { "seed", required_argument, NULL, 's' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    int c;
+    while ((c = getopt_long(argc, argv, "t:n:r:b:d:x:s:h", long_opts, NULL)) != -1) {
+        switch (c) {
+        case 't': target = optarg; break;
+        case 'n': nodes = atoi(optarg); break;
+        case 'r': rate = atof(optarg); break;
+        case 'b': records = atoi(optarg); break;
+        case 'd': duration_s = atof(optarg); break;
+        case 'x': drop_pct = atof(optarg); break;
+        case 's': seed = (unsigned)strtoul(optarg, NULL, 0); break;
+        default:
+            usage(argv[0]);
+            return c == 'h' ? 0 : 2;
+        }
+    }
+    if (nodes < 1 || rate <= 0 || records < 1 || records > TELEMETRY_MAX_RECORDS) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    char host[64];
+    snprintf(host, sizeof(host), "%s", target);
+    char *colon = strrchr(host, ':');
+    struct sockaddr_in dest = { .sin_family = AF_INET };
+    if (colon == NULL || (*colon = '\0', inet_pton(AF_INET, host, &dest.sin_addr)) != 1) {
+        fprintf(stderr, "bad target '%s' (IPv4 HOST:PORT)\n", target);
+        return 2;
+    }
+    dest.sin_port = htons((uint16_t)atoi(colon + 1));
+
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (connect(sock, (struct sockaddr *)&dest, sizeof(dest)) < 0) {
+        perror("connect");
+        return 1;
+    }
+
+    srand(seed);
+    node_t *fleet = calloc((size_t)nodes, sizeof(node_t));
+    for (int i = 0; i < nodes; i++) {
+        fleet[i] = (node_t){
+            .node_id = 0x00100000u + (uint32_t)i,
+            .boot_id = (uint32_t)rand(),
+            .soil = (uint16_t)(1500 + rand() % 1000),
+        };
+    }
+
+    static uint8_t bufs[TX_BATCH][TELEMETRY_HEADER_BYTES + TELEMETRY_MAX_RECORDS * TELEMETRY_RECORD_BYTES];
+    struct iovec iov[TX_BATCH];
+    struct mmsghdr msgs[TX_BATCH];
+
+    // Paced: datagram k is due at k / (nodes * rate) seconds, nodes in turn
+    double total_rate = nodes * rate;
+    uint64_t due_total = (uint64_t)(total_rate * duration_s);
+    uint64_t done = 0, sent = 0, dropped = 0, errors = 0;
+    int next = 0;
+    double start = now_s();
+    while (done < due_total) {
+        double t = now_s() - start;
+        uint64_t due = (uint64_t)(t * total_rate);
+        if (due > due_total) {
+            due = due_total;
+        }
+        if (due <= done) {
+            usleep(200);
+            continue;
+        }
+        while (done < due) {
+            int n = 0;
+            while (n < TX_BATCH && done < due) {
+                node_t *node = &fleet[next];
+                next = (next + 1) % nodes;
+                done++;
+                if (drop_pct > 0 && rand() < drop_pct / 100.0 * ((double)RAND_MAX + 1)) {
+                    node->seq++;
+                    dropped++;
+                    continue;
+                }
+                size_t len = build_datagram(bufs[n], node, records, (uint32_t)(t * 1000));
+                node->seq++;
+                iov[n] = (struct iovec){ .iov_base = bufs[n], .iov_len = len };
+                msgs[n] = (struct mmsghdr){ .msg_hdr = { .msg_iov = &iov[n], .msg_iovlen = 1 } };
+                n++;
+            }
+            int off = 0;
+            while (off < n) {
+                int r = sendmmsg(sock, msgs + off, (unsigned)(n - off), 0);
+                if (r <= 0) {
+                    errors += (uint64_t)(n - off);  // e.g. ECONNREFUSED: no collector listening
+                    break;
+                }
+                off += r;
+                sent += (uint64_t)r;
+            }
+        }
+    }
+    double elapsed = now_s() - start;
+
+    // A node's trailing drops leave no gap the collector can see
+    printf("flood.nodes=%d\n", nodes);
+    printf("flood.elapsed_s=%.3f\n", elapsed);
+    printf("flood.sent=%llu\n", (unsigned long long)sent);
+    printf("flood.dropped=%llu\n", (unsigned long long)dropped);
+    printf("flood.send_errors=%llu\n", (unsigned long long)errors);
+    printf("flood.pkts_per_s=%.0f\n", elapsed > 0 ? sent / elapsed : 0.0);
+    printf("flood.records_per_s=%.0f\n", elapsed > 0 ? sent * records / elapsed : 0.0);
+    printf("flood.drop_pct=%.3f\n", done ? 100.0 * (double)dropped / (double)done : 0.0);
+    free(fleet);
+    return 0;
+}
@@ -4,28 +4,32 @@
 #include "nvs_flash.h"
 #include "esp_log.h"
 
+#include "system_state.h"
+#include "history.h"
+#include "storage.h"
 #include "sensors.h"
 #include "irrigation_control.h"
+#include "schedule.h"
 #include "wifi_config.h"
 #include "web_server.h"
+#include "telemetry.h"
+#include "metrics.h"
+#include "dlog.h"
+#include "rt.h"
+#include "microbench.h"
+#include "ota.h"
+#include "mem.h"
 
 static const char *TAG = "MAIN";
 
-// Global shared state variables
-int soil_dry_threshold = 2800;
-int pump_duration_ms = 3000;
-int fertilizer_duration_ms = 1500;
-int check_interval_ms = 5000;
-
-bool auto_mode = true;
-bool pump1_manual = false;
-bool pump2_manual = false;
-
-int current_soil_moisture = 0;
-bool current_water_tank_full = false;
-bool current_fertilizer_tank_full = false;
-bool pump1_running = false;
-bool pump2_running = false;
+// Default settings and mode (changed at runtime from the dashboard and saved to NVS)
+static const system_state_t default_state = {
+    .soil_dry_threshold = 2800,
+    .pump_duration_ms = 3000,
+    .fertilizer_duration_ms = 1500,
+    .check_interval_ms = 5000,
+    .auto_mode = true,
+};
 
 void app_main(void)
 {
@@ -40,28 +44,60 @@ void app_main(void)
         ret = nvs_flash_init();
     }
     ESP_ERROR_CHECK(ret);
+
+    // Hot-path microbenchmarks, on a quiet CPU before any task exists
+    if (MICROBENCH_AT_BOOT) {
+        microbench_run();
+    }
+
+    // Printer for the control task's deferred log lines
+    dlog_init();
+    
+    // Saved settings override the defaults; shared state must exist before any task reads it
+    system_state_t initial = default_state;
+    irrigation_init_zones(&initial);
+    storage_load_settings(&initial);
+    system_state_init(&initial);
+    history_init();
+    storage_init();
     
     // Initialize hardware
     ESP_LOGI(TAG, "📡 Initializing hardware...");
     init_gpio();
     init_adc();
     
-    // Initialize WiFi
+    // Calendar rules (saved in NVS); uptime clock until SNTP syncs
+    schedule_init(irrigation_schedule_due);
+    
+    // Start irrigation control first: it needs no network, so a dead
+    // access point never delays (or stops) watering
+    TaskHandle_t irrigation_handle = NULL;
+    rt_task_create(irrigation_task, "irrigation_task", NULL, RT_TASK_CONTROL, &irrigation_handle);
+    metrics_watch_task(irrigation_handle);
+    ESP_LOGI(TAG, "🚀 Irrigation control is running");
+    
+    // Initialize WiFi (returns at once; connects and reconnects in the background)
     ESP_LOGI(TAG, "📶 Connecting to WiFi...");
     wifi_init_sta();
+    schedule_sntp_start();
     
-    // Start web server
+    // Start web server (listens before the IP arrives)
     ESP_LOGI(TAG, "🌐 Starting web server...");
     start_webserver();
     
+    // Fleet telemetry (only when a collector is configured)
+    telemetry_start();
+    
+    // A freshly updated image is on trial until control and WiFi are up
+    ota_boot_check();
+    
+    // Boot is over: log the memory budget; from here on the control path
+    // must not touch the heap
+    mem_boot_done();
+    
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "✅ System initialized successfully!");
     ESP_LOGI(TAG, "📱 Access dashboard at: http://<ESP32_IP_ADDRESS>");
     ESP_LOGI(TAG, "   (Check serial monitor for IP address)");
     ESP_LOGI(TAG, "");
-    
-    // Start irrigation control task
-    xTaskCreate(irrigation_task, "irrigation_task", 4096, NULL, 5, NULL);
-    
-    ESP_LOGI(TAG, "🚀 Irrigation system is now running!");
 }
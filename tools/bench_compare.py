@@ -0,0 +1,76 @@
+#!/usr/bin/env python3
+"""
+Microbenchmark Comparison
+Compares bench.<case>.<unit>=N lines (host/bench/firmware_bench output, or a
+board's serial log with MICROBENCH_AT_BOOT) against a baseline and flags
+regressions:
+
+- time per op (ns_per_op, cycles_per_op) more than --tolerance percent slower
+- any allocation per op where the baseline had fewer
+
+    python3 tools/bench_compare.py host/bench/baseline.txt /tmp/bench.txt
+
+Exit status 1 on a regression unless --warn-only. Host timings depend on
+the machine; regenerate the baseline on yours (cmake target bench_baseline)
+before relying on the ns figures. Allocation counts hold everywhere.
+"""
+
+import argparse
+import re
+import sys
+
+LINE = re.compile(r'\bbench\.([\w.]+)\.(\w+_per_op)=([0-9.]+)')
+TIME_UNITS = ('ns_per_op', 'cycles_per_op')
+
+
+def load(path):
+    values = {}
+    with open(path, errors='replace') as f:
+        for line in f:
+            if line.lstrip().startswith('#'):
+                continue
+            m = LINE.search(line)
+            if m:
+                values[(m.group(1), m.group(2))] = float(m.group(3))
+    return values
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Flag microbenchmark regressions')
+    parser.add_argument('baseline', help='baseline bench.* lines')
+    parser.add_argument('current', help='new bench.* lines (or a serial log)')
+    parser.add_argument('-t', '--tolerance', type=float, default=25.0,
+                        help='allowed slowdown in percent (default 25)')
+    parser.add_argument('--warn-only', action='store_true', help='report, but exit 0')
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+    if not cur:
+        print(f'no bench.* lines in {args.current}', file=sys.stderr)
+        return 1
+
+    regressions = 0
+    print(f'{"case":<28} {"unit":<14} {"baseline":>10} {"current":>10} {"change":>8}')
+    for key in sorted(cur):
+        name, unit = key
+        now = cur[key]
+        if key not in base:
+            print(f'{name:<28} {unit:<14} {"-":>10} {now:>10.2f}      new')
+            continue
+        was = base[key]
+        change = (now - was) / was * 100 if was else (0.0 if now == was else float('inf'))
+        if unit in TIME_UNITS:
+            bad = change > args.tolerance
+        else:
+            bad = now > was
+        flag = '  REGRESSION' if bad else ''
+        regressions += bad
+        print(f'{name:<28} {unit:<14} {was:>10.2f} {now:>10.2f} {change:>+7.1f}%{flag}')
+    if regressions:
+        print(f'{regressions} regression(s) against {args.baseline}', file=sys.stderr)
+    return 1 if regressions and not args.warn_only else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
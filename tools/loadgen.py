@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+"""
+HTTP Load Generator
+Drives the irrigation web server with several concurrent dashboard-like
+clients and reports throughput and latency percentiles.
+
+Each client is one thread with its own keep-alive connection (reopened
+after errors or when the server drops it) issuing a seeded random mix of
+the dashboard's requests back to back. The same seed, client count and
+duration replay the same request sequence, so runs before and after a
+change can be compared.
+
+    python3 tools/loadgen.py --url http://127.0.0.1:8080 --clients 8 --duration 20
+
+With --bench the firmware's control-loop benchmark (/api/bench) runs for
+the same duration and its period and jitter are printed after the load;
+--clients 0 --bench gives the idle baseline to compare against.
+"""
+
+import argparse
+import http.client
+import json
+import random
+import sys
+import threading
+import time
+from urllib.parse import urlsplit
+
+# path -> weight; roughly what an open dashboard asks for
+DEFAULT_MIX = {
+    '/api/data': 60,
+    '/api/metrics': 10,
+    '/api/history?from=-3600&points=60': 10,
+    '/api/log?limit=50': 10,
+    '/': 10,
+}
+
+
+class ClientStats:
+    def __init__(self):
+        self.latencies = {}     # path -> [seconds]
+        self.status = {}        # status code -> count
+        self.errors = 0
+        self.connects = 0
+
+
+def parse_mix(text):
+    """'/api/data=60,/=10' -> {'/api/data': 60, '/': 10}"""
+    mix = {}
+    for item in text.split(','):
+        path, _, weight = item.rpartition('=')
+        mix[path] = int(weight)
+    return mix
+
+
+def run_client(index, args, mix, deadline, stats):
+    rng = random.Random(args.seed * 1000 + index)
+    paths = list(mix)
+    weights = [mix[p] for p in paths]
+    url = urlsplit(args.url)
+    conn = None
+    while time.monotonic() < deadline:
+        path = rng.choices(paths, weights)[0]
+        if conn is None:
+            conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=args.timeout)
+            stats.connects += 1
+        headers = {'Connection': 'close'} if args.close else {}
+        start = time.monotonic()
+        try:
+            conn.request('GET', path, headers=headers)
+            resp = conn.getresponse()
+            resp.read()
+        except (OSError, http.client.HTTPException):
+            stats.errors += 1
+            conn.close()
+            conn = None
+            continue
+        elapsed = time.monotonic() - start
+        stats.latencies.setdefault(path, []).append(elapsed)
+        stats.status[resp.status] = stats.status.get(resp.status, 0) + 1
+        # The server does not echo Connection: close, so do not wait to be told
+        if args.close or resp.will_close:
+            conn.close()
+            conn = None
+    if conn is not None:
+        conn.close()
+
+
+def bench_request(args, method, body=None):
+    url = urlsplit(args.url)
+    conn = http.client.HTTPConnection(url.hostname, url.port or 80, timeout=args.timeout)
+    try:
+        conn.request(method, '/api/bench', body=body,
+                     headers={'Content-Type': 'application/json'} if body else {})
+        resp = conn.getresponse()
+        return resp.status, json.loads(resp.read() or b'{}')
+    finally:
+        conn.close()
+
+
+def bench_start(args):
+    seconds = max(1, int(round(args.duration)))
+    status, reply = bench_request(args, 'POST', json.dumps(
+        {'period_ms': args.bench_period, 'seconds': seconds}))
+    if status != 200:
+        print(f'bench not started: {status} {reply}', file=sys.stderr)
+        return False
+    return True
+
+
+def bench_report(args):
+    # The benchmark ends on the server's clock; wait for its last cycles
+    for _ in range(50):
+        status, r = bench_request(args, 'GET')
+        if status != 200 or not r.get('running'):
+            break
+        time.sleep(0.2)
+    if status != 200:
+        print(f'bench result: {status}', file=sys.stderr)
+        return
+    p, j = r['period_us'], r['jitter_us']
+    print(f'bench period_ms={r["period_ms"]} cycles={r["cycles"]} missed={r["missed"]} '
+          f'deterministic={"yes" if r["deterministic"] else "no"}')
+    print(f'bench period_us min={p["min"]} avg={p["avg"]} max={p["max"]}')
+    print(f'bench jitter_us avg={j["avg"]} p50={j["p50"]} p99={j["p99"]} '
+          f'p99.9={j["p999"]} max={j["max"]}')
+
+
+def percentile(sorted_values, pct):
+    if not sorted_values:
+        return 0.0
+    k = min(len(sorted_values) - 1, int(round(pct / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[k]
+
+
+def summary(values):
+    values = sorted(values)
+    return (len(values), percentile(values, 50) * 1000, percentile(values, 90) * 1000,
+            percentile(values, 99) * 1000, (values[-1] if values else 0.0) * 1000)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Load-test the irrigation web server')
+    parser.add_argument('--url', default='http://127.0.0.1:8080', help='server base URL')
+    parser.add_argument('-c', '--clients', type=int, default=8, help='concurrent clients')
+    parser.add_argument('-d', '--duration', type=float, default=20.0, help='seconds to run')
+    parser.add_argument('--seed', type=int, default=1, help='request mix seed')
+    parser.add_argument('--mix', type=parse_mix, default=DEFAULT_MIX,
+                        help='path=weight,... (default: dashboard mix)')
+    parser.add_argument('--close', action='store_true', help='new connection per request')
+    parser.add_argument('--timeout', type=float, default=10.0, help='per-request timeout, s')
+    parser.add_argument('--bench', action='store_true',
+                        help='run the control-loop benchmark during the load')
+    parser.add_argument('--bench-period', type=int, default=10, help='benchmark period, ms')
+    args = parser.parse_args()
+
+    if args.bench and not bench_start(args):
+        return 1
+
+    stats = [ClientStats() for _ in range(args.clients)]
+    deadline = time.monotonic() + args.duration
+    threads = [threading.Thread(target=run_client, args=(i, args, args.mix, deadline, stats[i]))
+               for i in range(args.clients)]
+    started = time.monotonic()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    wall = time.monotonic() - started
+
+    by_path, status = {}, {}
+    errors = connects = 0
+    for s in stats:
+        for path, lat in s.latencies.items():
+            by_path.setdefault(path, []).extend(lat)
+        for code, n in s.status.items():
+            status[code] = status.get(code, 0) + n
+        errors += s.errors
+        connects += s.connects
+    everything = [x for lat in by_path.values() for x in lat]
+    per_client = [sum(len(l) for l in s.latencies.values()) for s in stats]
+
+    print(f'clients={args.clients} duration_s={wall:.1f} seed={args.seed} '
+          f'keepalive={"no" if args.close else "yes"}')
+    n, p50, p90, p99, worst = summary(everything)
+    print(f'requests={n} req_per_s={n / wall:.1f} errors={errors} connects={connects}')
+    print(f'latency_ms p50={p50:.1f} p90={p90:.1f} p99={p99:.1f} max={worst:.1f}')
+    print('status ' + ' '.join(f'{code}={status[code]}' for code in sorted(status)))
+    if per_client:
+        print(f'per_client min={min(per_client)} max={max(per_client)}')
+    print(f'{"path":<40} {"n":>6} {"p50":>8} {"p90":>8} {"p99":>8} {"max":>8}')
+    for path in sorted(by_path):
+        n, p50, p90, p99, worst = summary(by_path[path])
+        print(f'{path:<40} {n:>6} {p50:>8.1f} {p90:>8.1f} {p99:>8.1f} {worst:>8.1f}')
+    if args.bench:
+        bench_report(args)
+    # Errors are expected past WEB_MAX_SOCKETS clients (LRU purge), not a failure
+    return 0 if everything or args.clients == 0 else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
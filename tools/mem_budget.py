@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+Memory Budget
+Build-time RAM report for the firmware: the static RAM (.data + .bss) each
+component library takes, and the task stacks from the layout table in
+components/rt/rt.h, on the heap or (static build) in rt's static pool.
+
+    python3 tools/mem_budget.py build-host/lib*.a
+    python3 tools/mem_budget.py --nm xtensa-esp32-elf-nm --static build/esp-idf/*/lib*.a
+
+The board build and the host build (FW_STATIC_ALLOC=ON for --static) both
+run it after linking. At run time the firmware logs the same stack table
+with high-water marks (components/mem), and /api/metrics carries it.
+Exit status 1 if --limit is given and the total is above it.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+RT_H = os.path.join(os.path.dirname(__file__), '..', 'components', 'rt', 'rt.h')
+DEFINE = re.compile(r'^#define\s+(RT_STACK_\w+|RT_HTTP_WORKERS)\s+(\d+)')
+# Stack sizes in rt.h, and how many tasks use each
+STACKS = [
+    ('control', 'RT_STACK_CONTROL', 1),
+    ('sensing', 'RT_STACK_SENSING', 1),
+    ('httpd', 'RT_STACK_HTTPD', 1),
+    ('http_worker', 'RT_STACK_HTTP_WORKER', 'RT_HTTP_WORKERS'),
+    ('telemetry', 'RT_STACK_TELEMETRY', 1),
+    ('storage', 'RT_STACK_STORAGE', 1),
+    ('log', 'RT_STACK_LOG', 1),
+]
+RAM_TYPES = set('bBdDcCsSgG')      # bss, data, common, small data/bss
+
+
+def load_rt(path):
+    values = {}
+    with open(path) as f:
+        for line in f:
+            m = DEFINE.match(line)
+            if m:
+                values[m.group(1)] = int(m.group(2))
+    return values
+
+
+def lib_symbols(nm, lib):
+    """(size, name) of every RAM symbol in a static library"""
+    out = subprocess.run([nm, '-S', '--size-sort', lib], capture_output=True, text=True)
+    if out.returncode != 0:
+        print(f'{nm} failed on {lib}: {out.stderr.strip()}', file=sys.stderr)
+        return []
+    syms = []
+    for line in out.stdout.splitlines():
+        parts = line.split()
+        if len(parts) == 4 and parts[2] in RAM_TYPES:
+            syms.append((int(parts[1], 16), parts[3]))
+    return syms
+
+
+def component_name(lib):
+    name = os.path.basename(lib)
+    if name.startswith('lib'):
+        name = name[3:]
+    return name.rsplit('.', 1)[0]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Per-component static RAM and task stack budget')
+    parser.add_argument('libs', nargs='+', help='component libraries (lib<name>.a)')
+    parser.add_argument('--nm', default='nm', help='nm for the target (default nm)')
+    parser.add_argument('--rt-h', default=RT_H, help='task layout header (default components/rt/rt.h)')
+    parser.add_argument('--static', action='store_true', help='the RT_STATIC_ALLOC build')
+    parser.add_argument('--top', type=int, default=5, help='largest symbols to list (default 5)')
+    parser.add_argument('--limit', type=int, help='fail above this many bytes in total')
+    args = parser.parse_args()
+
+    rows = []
+    top = []
+    for lib in sorted(args.libs):
+        syms = lib_symbols(args.nm, lib)
+        name = component_name(lib)
+        rows.append((name, sum(s for s, _ in syms)))
+        top.extend((s, f'{name}:{sym}') for s, sym in syms)
+    static_ram = sum(b for _, b in rows)
+
+    print(f'{"component":<16} {"static RAM":>10}')
+    for name, size in sorted(rows, key=lambda r: -r[1]):
+        if size:
+            print(f'{name:<16} {size:>10}')
+    print(f'{"total":<16} {static_ram:>10}')
+
+    if args.top > 0 and top:
+        print(f'\nlargest symbols')
+        for size, sym in sorted(top, reverse=True)[:args.top]:
+            print(f'  {size:>8}  {sym}')
+
+    rt = load_rt(args.rt_h)
+    print(f'\n{"task":<16} {"stack":>6} {"x":>3} {"total":>8}  from')
+    stacks_static = stacks_heap = 0
+    for name, key, count in STACKS:
+        n = rt.get(count, 0) if isinstance(count, str) else count
+        size = rt.get(key, 0)
+        # esp_http_server makes its own task, always on the heap
+        static = args.static and name != 'httpd'
+        if static:
+            stacks_static += size * n
+        else:
+            stacks_heap += size * n
+        print(f'{name:<16} {size:>6} {n:>3} {size * n:>8}  {"static" if static else "heap"}')
+    print(f'{"stacks":<16} {"":>6} {"":>3} {stacks_static + stacks_heap:>8}  '
+          f'{stacks_static} static, {stacks_heap} heap')
+    # The static pool is .bss in librt.a, already counted above
+    total = static_ram + stacks_heap
+    print(f'\nRAM budget: {total} bytes ({static_ram} static + {stacks_heap} stacks on the heap)')
+
+    if args.limit is not None and total > args.limit:
+        print(f'over the limit of {args.limit} bytes', file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,337 @@
+#!/usr/bin/env python3
+"""
+Firmware Delta Tool
+Builds the compressed deltas POST /api/ota takes (format in
+components/ota/ota_delta.h), checks them and pushes them to a board.
+
+A delta is made against the exact image the board runs (build/*.bin of
+that release): unchanged code becomes COPY ops, code that only moved and
+had its addresses shifted becomes ADD ops whose difference bytes are
+mostly zero, the rest is INSERTed. The op stream is then LZ-compressed
+with a 4 KB window, which is all the decoder keeps in RAM.
+
+    python3 tools/ota_delta.py make old.bin new.bin -o update.ird
+    python3 tools/ota_delta.py apply old.bin update.ird -o check.bin
+    python3 tools/ota_delta.py push update.ird --url http://192.168.1.50
+    python3 tools/ota_delta.py status --url http://192.168.1.50
+
+make --full builds a delta with no source, for a board whose image is not
+at hand (it is as big as the LZ-compressed image).
+"""
+
+import argparse
+import hashlib
+import http.client
+import json
+import struct
+import sys
+from urllib.parse import urlsplit
+
+MAGIC = b'IRD1'
+VERSION = 1
+FLAG_LZ = 0x01
+HEADER = struct.Struct('<4sBBHII32s32s')     # 80 bytes
+
+OP_END, OP_COPY, OP_INSERT, OP_ADD = 0, 1, 2, 3
+
+LZ_WINDOW = 4096
+LZ_MIN = 3
+LZ_MAX = 0x7f + LZ_MIN
+LZ_LITERALS = 0x80
+LZ_CHAIN = 32           # candidates tried per position
+
+BLOCK = 16              # source index granularity
+STRIDE = 4              # source positions indexed
+APPROX_SLACK = 32       # mismatches beyond the best score that end an ADD
+
+
+def varint(n):
+    out = bytearray()
+    while True:
+        b = n & 0x7f
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return out
+
+
+def common_prefix(a, ai, b, bi, limit):
+    """Length of the common run of a[ai:] and b[bi:], at most limit."""
+    n = 0
+    while n + 64 <= limit and a[ai + n:ai + n + 64] == b[bi + n:bi + n + 64]:
+        n += 64
+    while n < limit and a[ai + n] == b[bi + n]:
+        n += 1
+    return n
+
+
+# ---------------------------------------------------------------- delta
+
+def diff_ops(src, tgt):
+    """COPY/ADD/INSERT ops turning src into tgt."""
+    index = {}
+    for i in range(0, len(src) - BLOCK + 1, STRIDE):
+        index.setdefault(src[i:i + BLOCK], i)
+
+    ops = bytearray()
+    lit_start = 0
+    j = 0
+
+    def insert(end):
+        if end > lit_start:
+            ops.append(OP_INSERT)
+            ops.extend(varint(end - lit_start))
+            ops.extend(tgt[lit_start:end])
+
+    while j + BLOCK <= len(tgt):
+        s = index.get(tgt[j:j + BLOCK])
+        if s is None:
+            j += 1
+            continue
+        # Grow backwards into the bytes not covered yet
+        while j > lit_start and s > 0 and tgt[j - 1] == src[s - 1]:
+            j -= 1
+            s -= 1
+        exact = common_prefix(src, s, tgt, j, min(len(src) - s, len(tgt) - j))
+        # Then forwards while matches outnumber mismatches (bsdiff's rule)
+        score = best = extra = 0
+        n = exact
+        while s + n < len(src) and j + n < len(tgt):
+            score += 1 if src[s + n] == tgt[j + n] else -1
+            n += 1
+            if score > best:
+                best, extra = score, n - exact
+            elif score < best - APPROX_SLACK:
+                break
+        length = exact + extra
+        insert(j)
+        if extra == 0:
+            ops.append(OP_COPY)
+            ops.extend(varint(s))
+            ops.extend(varint(length))
+        else:
+            ops.append(OP_ADD)
+            ops.extend(varint(s))
+            ops.extend(varint(length))
+            ops.extend((tgt[j + k] - src[s + k]) & 0xff for k in range(length))
+        j += length
+        lit_start = j
+    insert(len(tgt))
+    ops.append(OP_END)
+    return bytes(ops)
+
+
+def apply_ops(src, ops):
+    out = bytearray()
+    i = 0
+
+    def number():
+        nonlocal i
+        n = shift = 0
+        while True:
+            b = ops[i]
+            i += 1
+            n |= (b & 0x7f) << shift
+            shift += 7
+            if not b & 0x80:
+                return n
+
+    while True:
+        op = ops[i]
+        i += 1
+        if op == OP_END:
+            if i != len(ops):
+                raise ValueError('data after the end')
+            return bytes(out)
+        if op == OP_INSERT:
+            n = number()
+            out.extend(ops[i:i + n])
+            i += n
+            continue
+        off = number()
+        n = number()
+        if off + n > len(src):
+            raise ValueError('reference past the source image')
+        if op == OP_COPY:
+            out.extend(src[off:off + n])
+        elif op == OP_ADD:
+            out.extend((src[off + k] + ops[i + k]) & 0xff for k in range(n))
+            i += n
+        else:
+            raise ValueError(f'unknown op {op}')
+
+
+# ------------------------------------------------------------------- LZ
+
+def lz_compress(data):
+    out = bytearray()
+    lit = bytearray()
+    chains = {}
+
+    def flush():
+        for k in range(0, len(lit), LZ_LITERALS):
+            chunk = lit[k:k + LZ_LITERALS]
+            out.append(len(chunk) - 1)
+            out.extend(chunk)
+        lit.clear()
+
+    def remember(pos):
+        if pos + LZ_MIN <= len(data):
+            chain = chains.setdefault(data[pos:pos + LZ_MIN], [])
+            chain.append(pos)
+            if len(chain) > 2 * LZ_CHAIN:
+                del chain[:LZ_CHAIN]
+
+    i = 0
+    while i < len(data):
+        best_len = best_dist = 0
+        limit = min(LZ_MAX, len(data) - i)
+        for p in reversed(chains.get(data[i:i + LZ_MIN], ())[-LZ_CHAIN:]):
+            if i - p > LZ_WINDOW:
+                break
+            n = common_prefix(data, p, data, i, limit)
+            if n > best_len:
+                best_len, best_dist = n, i - p
+                if n == limit:
+                    break
+        if best_len >= LZ_MIN:
+            flush()
+            out.append(0x80 | (best_len - LZ_MIN))
+            out.extend(struct.pack('<H', best_dist - 1))
+            for k in range(i, i + best_len):
+                remember(k)
+            i += best_len
+        else:
+            lit.append(data[i])
+            remember(i)
+            i += 1
+    flush()
+    return bytes(out)
+
+
+def lz_decompress(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        t = data[i]
+        i += 1
+        if t < 0x80:
+            out.extend(data[i:i + t + 1])
+            i += t + 1
+        else:
+            dist = struct.unpack_from('<H', data, i)[0] + 1
+            i += 2
+            if dist > LZ_WINDOW or dist > len(out):
+                raise ValueError('LZ distance past the window')
+            for _ in range((t & 0x7f) + LZ_MIN):
+                out.append(out[-dist])
+    return bytes(out)
+
+
+# ------------------------------------------------------------- commands
+
+def read(path):
+    with open(path, 'rb') as f:
+        return f.read()
+
+
+def cmd_make(args):
+    src = b'' if args.full else read(args.old)
+    tgt = read(args.new)
+    ops = diff_ops(src, tgt)
+    body = ops if args.no_lz else lz_compress(ops)
+    header = HEADER.pack(MAGIC, VERSION, 0 if args.no_lz else FLAG_LZ, 0, len(src), len(tgt),
+                         hashlib.sha256(src).digest(), hashlib.sha256(tgt).digest())
+    with open(args.output, 'wb') as f:
+        f.write(header + body)
+    size = HEADER.size + len(body)
+    print(f'{args.output}: {size} bytes for a {len(tgt)} byte image '
+          f'({100.0 * size / max(len(tgt), 1):.1f}%), ops {len(ops)} bytes')
+    return 0
+
+
+def cmd_apply(args):
+    patch = read(args.patch)
+    magic, version, flags, _, src_size, tgt_size, src_sha, tgt_sha = HEADER.unpack_from(patch)
+    if magic != MAGIC or version != VERSION:
+        print('not a version 1 firmware delta', file=sys.stderr)
+        return 1
+    src = read(args.old)[:src_size] if src_size else b''
+    if len(src) != src_size or hashlib.sha256(src).digest() != src_sha:
+        print('made against a different image', file=sys.stderr)
+        return 1
+    body = patch[HEADER.size:]
+    image = apply_ops(src, lz_decompress(body) if flags & FLAG_LZ else body)
+    if len(image) != tgt_size or hashlib.sha256(image).digest() != tgt_sha:
+        print('image checksum mismatch', file=sys.stderr)
+        return 1
+    with open(args.output, 'wb') as f:
+        f.write(image)
+    print(f'{args.output}: {len(image)} bytes, checksum ok')
+    return 0
+
+
+def request(url, method, path, body=None, timeout=60.0):
+    parts = urlsplit(url)
+    conn = http.client.HTTPConnection(parts.hostname, parts.port or 80, timeout=timeout)
+    headers = {'Content-Type': 'application/octet-stream'} if body is not None else {}
+    conn.request(method, path, body=body, headers=headers)
+    resp = conn.getresponse()
+    text = resp.read().decode(errors='replace')
+    conn.close()
+    return resp.status, text
+
+
+def cmd_push(args):
+    patch = read(args.patch)
+    status, text = request(args.url, 'POST', '/api/ota', patch, args.timeout)
+    print(f'POST /api/ota ({len(patch)} bytes): {status} {text}')
+    return 0 if status == 200 else 1
+
+
+def cmd_status(args):
+    status, text = request(args.url, 'GET', '/api/ota', timeout=args.timeout)
+    if status != 200:
+        print(f'GET /api/ota: {status} {text}', file=sys.stderr)
+        return 1
+    print(json.dumps(json.loads(text), indent=2))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Make, check and push firmware deltas')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('make', help='delta from the running image to a new one')
+    p.add_argument('old', nargs='?', help='image the board runs now')
+    p.add_argument('new', help='image to update to')
+    p.add_argument('-o', '--output', required=True, help='delta file')
+    p.add_argument('--full', action='store_true', help='no source image: the whole new image')
+    p.add_argument('--no-lz', action='store_true', help='leave the op stream uncompressed')
+    p.set_defaults(func=cmd_make)
+
+    p = sub.add_parser('apply', help='rebuild the new image as the board would')
+    p.add_argument('old', help='image the delta was made against')
+    p.add_argument('patch', help='delta file')
+    p.add_argument('-o', '--output', required=True, help='rebuilt image')
+    p.set_defaults(func=cmd_apply)
+
+    for name, func, text in (('push', cmd_push, 'upload a delta; the board restarts into it'),
+                             ('status', cmd_status, "the board's partitions and update progress")):
+        p = sub.add_parser(name, help=text)
+        if name == 'push':
+            p.add_argument('patch', help='delta file')
+        p.add_argument('--url', default='http://127.0.0.1:8080', help='board base URL')
+        p.add_argument('--timeout', type=float, default=60.0, help='seconds')
+        p.set_defaults(func=func)
+
+    args = parser.parse_args()
+    if args.command == 'make' and not args.full and args.old is None:
+        parser.error('make needs OLD NEW, or --full NEW')
+    return args.func(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -4,7 +4,266 @@
 // Auto-generated from dashboard.html
 // DO NOT EDIT THIS FILE MANUALLY - Edit dashboard.html instead
 
-static const char* dashboard_html = 
-"<!DOCTYPE html>\n<html>\n<head>\n    <meta charset='UTF-8'>\n    <meta name='viewport' content='width=device-width,initial-scale=1'>\n    <title>Smart Irrigation Dashboard</title>\n    <style>\n        * {\n            margin: 0;\n            padding: 0;\n            box-sizing: border-box;\n        }\n        \n        body {\n            font-family: 'Segoe UI', Arial, sans-serif;\n            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);\n            min-height: 100vh;\n            padding: 20px;\n        }\n        \n        h1 {\n            text-align: center;\n            color: #fff;\n            font-size: 2.5em;\n            margin-bottom: 30px;\n            text-shadow: 2px 2px 4px rgba(0,0,0,0.3);\n        }\n        \n        h2 {\n            color: #4CAF50;\n            border-bottom: 3px solid #4CAF50;\n            padding-bottom: 10px;\n            margin-bottom: 20px;\n        }\n        \n        .container {\n            max-width: 1200px;\n            margin: 0 auto;\n        }\n        \n        .card {\n            background: #fff;\n            border-radius: 15px;\n            padding: 25px;\n            margin: 20px 0;\n            box-shadow: 0 10px 30px rgba(0,0,0,0.3);\n        }\n        \n        .sensor-grid {\n            display: grid;\n            grid-template-columns: repeat(auto-fit, minmax(250px, 1fr));\n            gap: 20px;\n        }\n        \n        .sensor {\n            background: linear-gradient(135deg, #667eea 0%, #764ba2 100%);\n            padding: 20px;\n            border-radius: 12px;\n            text-align: center;\n            color: #fff;\n            box-shadow: 0 5px 15px rgba(0,0,0,0.2);\n        }\n        \n        .sensor h3 {\n            margin-top: 0;\n            font-size: 1.2em;\n            opacity: 0.9;\n        }\n        \n        .value {\n            font-size: 3em;\n            font-weight: bold;\n            margin: 15px 0;\n        }\n        \n        .status {\n            padding: 10px 20px;\n            border-radius: 25px;\n            font-weight: bold;\n            display: inline-block;\n            margin-top: 10px;\n        }\n        \n        .status.ok {\n            background: #4CAF50;\n        }\n        \n        .status.warning {\n            background: #ff9800;\n        }\n        \n        .status.error {\n            background: #f44336;\n        }\n        \n        button {\n            padding: 15px 30px;\n            margin: 8px;\n            border: none;\n            border-radius: 8px;\n            cursor: pointer;\n            font-size: 16px;\n            font-weight: bold;\n            transition: all 0.3s;\n            box-shadow: 0 4px 6px rgba(0,0,0,0.1);\n        }\n        \n        button:hover {\n            transform: translateY(-2px);\n            box-shadow: 0 6px 12px rgba(0,0,0,0.15);\n        }\n        \n        .btn-primary {\n            background: #4CAF50;\n            color: #fff;\n        }\n        \n        .btn-primary:hover {\n            background: #45a049;\n        }\n        \n        .btn-danger {\n            background: #f44336;\n            color: #fff;\n        }\n        \n        .btn-danger:hover {\n            background: #da190b;\n        }\n        \n        .btn-secondary {\n            background: #2196F3;\n            color: #fff;\n        }\n        \n        .btn-secondary:hover {\n            background: #0b7dda;\n        }\n        \n        .control-group {\n            margin: 20px 0;\n        }\n        \n        label {\n            display: block;\n            margin: 15px 0 8px;\n            font-weight: 600;\n            color: #333;\n        }\n        \n        input[type='number'], input[type='text'] {\n            width: 100%;\n            padding: 12px;\n            border: 2px solid #ddd;\n            border-radius: 8px;\n            font-size: 16px;\n            transition: border 0.3s;\n        }\n        \n        input:focus {\n            outline: none;\n            border-color: #667eea;\n        }\n        \n        .pump-control {\n            display: flex;\n            justify-content: space-around;\n            flex-wrap: wrap;\n            gap: 20px;\n        }\n        \n        .pump-item {\n            flex: 1;\n            min-width: 250px;\n            text-align: center;\n        }\n        \n        .switch {\n            position: relative;\n            display: inline-block;\n            width: 60px;\n            height: 34px;\n        }\n        \n        .switch input {\n            opacity: 0;\n            width: 0;\n            height: 0;\n        }\n        \n        .slider {\n            position: absolute;\n            cursor: pointer;\n            top: 0;\n            left: 0;\n            right: 0;\n            bottom: 0;\n            background-color: #ccc;\n            transition: .4s;\n            border-radius: 34px;\n        }\n        \n        .slider:before {\n            position: absolute;\n            content: '';\n            height: 26px;\n            width: 26px;\n            left: 4px;\n            bottom: 4px;\n            background-color: white;\n            transition: .4s;\n            border-radius: 50%;\n        }\n        \n        input:checked + .slider {\n            background-color: #4CAF50;\n        }\n        \n        input:checked + .slider:before {\n            transform: translateX(26px);\n        }\n        \n        @media (max-width: 768px) {\n            .sensor-grid {\n                grid-template-columns: 1fr;\n            }\n            .pump-control {\n                flex-direction: column;\n            }\n        }\n    </style>\n</head>\n<body>\n    <div class='container'>\n        <h1>🌱 Smart Irrigation System</h1>\n        \n        <!-- Real-Time Monitoring -->\n        <div class='card'>\n            <h2>📊 Real-Time Monitoring</h2>\n            <div class='sensor-grid'>\n                <div class='sensor'>\n                    <h3>💧 Soil Moisture</h3>\n                    <div class='value' id='soilValue'>--</div>\n                    <div class='status' id='soilStatus'>Loading...</div>\n                </div>\n                <div class='sensor'>\n                    <h3>🚰 Water Tank</h3>\n                    <div class='value' id='waterTank'>--</div>\n                    <div class='status' id='waterStatus'>Loading...</div>\n                </div>\n                <div class='sensor'>\n                    <h3>🧪 Fertilizer Tank</h3>\n                    <div class='value' id='fertTank'>--</div>\n                    <div class='status' id='fertStatus'>Loading...</div>\n                </div>\n            </div>\n        </div>\n        \n        <!-- Control Panel -->\n        <div class='card'>\n            <h2>🎛️ Control Panel</h2>\n            <div class='control-group' style='text-align:center'>\n                <label style='display:inline-flex;align-items:center;gap:10px;font-size:1.2em'>\n                    <span>Automatic Mode:</span>\n                    <label class='switch'>\n                        <input type='checkbox' id='autoMode' onchange='toggleAuto()' checked>\n                        <span class='slider'></span>\n                    </label>\n                </label>\n            </div>\n            \n            <div class='pump-control'>\n                <div class='pump-item'>\n                    <h3>💧 Water Pump</h3>\n                    <button class='btn-primary' onclick='controlPump(1, true)'>▶ Turn ON</button>\n                    <button class='btn-danger' onclick='controlPump(1, false)'>⏹ Turn OFF</button>\n                    <div style='margin-top:15px'>\n                        <span style='font-weight:bold'>Status:</span>\n                        <span class='status' id='pump1Status' style='margin-left:10px'>OFF</span>\n                    </div>\n                </div>\n                \n                <div class='pump-item'>\n                    <h3>🧪 Fertilizer Pump</h3>\n                    <button class='btn-primary' onclick='controlPump(2, true)'>▶ Turn ON</button>\n                    <button class='btn-danger' onclick='controlPump(2, false)'>⏹ Turn OFF</button>\n                    <div style='margin-top:15px'>\n                        <span style='font-weight:bold'>Status:</span>\n                        <span class='status' id='pump2Status' style='margin-left:10px'>OFF</span>\n                    </div>\n                </div>\n            </div>\n        </div>\n        \n        <!-- System Settings -->\n        <div class='card'>\n            <h2>⚙️ System Settings</h2>\n            <div class='control-group'>\n                <label>🌡️ Soil Moisture Threshold (ADC Value):</label>\n                <input type='number' id='threshold' placeholder='2800'>\n            </div>\n            <div class='control-group'>\n                <label>⏱️ Water Pump Duration (milliseconds):</label>\n                <input type='number' id='pumpDuration' placeholder='3000'>\n            </div>\n            <div class='control-group'>\n                <label>⏱️ Fertilizer Pump Duration (milliseconds):</label>\n                <input type='number' id='fertDuration' placeholder='1500'>\n            </div>\n            <div class='control-group'>\n                <label>🔄 Check Interval (milliseconds):</label>\n                <input type='number' id='interval' placeholder='5000'>\n            </div>\n            <div style='text-align:center'>\n                <button class='btn-secondary' onclick='saveSettings()'>💾 Save Settings</button>\n            </div>\n        </div>\n    </div>\n    \n    <script>\n        // Fetch sensor data from ESP32\n        function fetchData() {\n            fetch('/api/data')\n                .then(r => r.json())\n                .then(d => updateUI(d))\n                .catch(e => console.error('Fetch error:', e));\n        }\n        \n        // Update UI with sensor data\n        function updateUI(d) {\n            document.getElementById('soilValue').textContent = d.soil_moisture;\n            const isDry = d.soil_moisture > d.threshold;\n            document.getElementById('soilStatus').textContent = isDry ? 'DRY' : 'OK';\n            document.getElementById('soilStatus').className = 'status ' + (isDry ? 'warning' : 'ok');\n            \n            document.getElementById('waterTank').textContent = d.water_tank ? 'FULL' : 'EMPTY';\n            document.getElementById('waterStatus').className = 'status ' + (d.water_tank ? 'ok' : 'error');\n            \n            document.getElementById('fertTank').textContent = d.fert_tank ? 'FULL' : 'EMPTY';\n            document.getElementById('fertStatus').className = 'status ' + (d.fert_tank ? 'ok' : 'error');\n            \n            document.getElementById('pump1Status').textContent = d.pump1 ? 'ON' : 'OFF';\n            document.getElementById('pump1Status').className = 'status ' + (d.pump1 ? 'ok' : '');\n            \n            document.getElementById('pump2Status').textContent = d.pump2 ? 'ON' : 'OFF';\n            document.getElementById('pump2Status').className = 'status ' + (d.pump2 ? 'ok' : '');\n            \n            document.getElementById('autoMode').checked = d.auto_mode;\n            document.getElementById('threshold').placeholder = d.threshold;\n            document.getElementById('pumpDuration').placeholder = d.pump_duration;\n            document.getElementById('fertDuration').placeholder = d.fert_duration;\n            document.getElementById('interval').placeholder = d.interval;\n        }\n        \n        // Toggle automatic mode\n        function toggleAuto() {\n            fetch('/api/auto', {\n                method: 'POST',\n                headers: {'Content-Type': 'application/json'},\n                body: JSON.stringify({enabled: document.getElementById('autoMode').checked})\n            })\n            .then(r => r.json())\n            .then(d => console.log('Auto mode:', d));\n        }\n        \n        // Control pump manually\n        function controlPump(pump, state) {\n            fetch('/api/pump', {\n                method: 'POST',\n                headers: {'Content-Type': 'application/json'},\n                body: JSON.stringify({pump: pump, state: state})\n            })\n            .then(r => r.json())\n            .then(d => console.log('Pump:', d));\n        }\n        \n        // Save system settings\n        function saveSettings() {\n            const s = {\n                threshold: parseInt(document.getElementById('threshold').value) || 2800,\n                pump_duration: parseInt(document.getElementById('pumpDuration').value) || 3000,\n                fert_duration: parseInt(document.getElementById('fertDuration').value) || 1500,\n                interval: parseInt(document.getElementById('interval').value) || 5000\n            };\n            fetch('/api/settings', {\n                method: 'POST',\n                headers: {'Content-Type': 'application/json'},\n                body: JSON.stringify(s)\n            })\n            .then(r => r.json())\n            .then(d => {\n                alert('✅ Settings saved successfully!');\n                console.log(d);\n            });\n        }\n        \n        // Start polling for data every 2 seconds\n        fetchData();\n        setInterval(fetchData, 2000);\n    </script>\n</body>\n</html>\n";
+#include <stdint.h>
+
+// Original 20377 bytes, minified 12534 bytes, gzip 4037 bytes
+#define DASHBOARD_HTML_GZ_LEN 4037
+#define DASHBOARD_ETAG "\"0cf9834b6c8c6c41\""
+
+static const uint8_t dashboard_html_gz[DASHBOARD_HTML_GZ_LEN] = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xcd, 0x5b, 0x5b, 0x8f, 0xdb, 0xc6,
+    0x15, 0x7e, 0xd7, 0xaf, 0x18, 0x3b, 0x4d, 0x48, 0xc6, 0x12, 0x57, 0xa2, 0x76, 0x15, 0x9b, 0xda,
+    0xdd, 0xd6, 0x5d, 0x7b, 0x1b, 0xb7, 0x4e, 0x6c, 0x78, 0xd7, 0x4d, 0x53, 0xc3, 0x48, 0x46, 0xe4,
+    0x48, 0x9a, 0x98, 0x22, 0x05, 0x92, 0x5a, 0xed, 0xae, 0x22, 0xa0, 0x0f, 0x2d, 0x50, 0x14, 0x41,
+    0x03, 0x34, 0x45, 0x81, 0x5e, 0x80, 0xa2, 0x4f, 0x01, 0xfa, 0xd4, 0xbe, 0xf4, 0xf2, 0xd2, 0x02,
+    0xfd, 0x29, 0xfe, 0x03, 0xed, 0x4f, 0xe8, 0x39, 0x67, 0x86, 0x57, 0x69, 0xb5, 0x72, 0xdc, 0xa2,
+    0x45, 0x92, 0x15, 0x39, 0x73, 0xe6, 0xcc, 0x77, 0x2e, 0x73, 0x2e, 0x23, 0x65, 0xff, 0xc6, 0xbd,
+    0x47, 0x47, 0xa7, 0x1f, 0x3e, 0xbe, 0xcf, 0xc6, 0xe9, 0x24, 0x38, 0x64, 0xfb, 0xd9, 0x87, 0xe0,
+    0x3e, 0x7c, 0x4c, 0x44, 0xca, 0x99, 0x37, 0xe6, 0x71, 0x22, 0xd2, 0x03, 0xe3, 0xe9, 0xe9, 0x71,
+    0xeb, 0xb6, 0x91, 0x0d, 0x87, 0x7c, 0x22, 0x0e, 0x8c, 0x33, 0x29, 0xe6, 0xd3, 0x28, 0x4e, 0x0d,
+    0xe6, 0x45, 0x61, 0x2a, 0x42, 0x20, 0x9b, 0x4b, 0x3f, 0x1d, 0x1f, 0xf8, 0xe2, 0x4c, 0x7a, 0xa2,
+    0x45, 0x2f, 0x4d, 0x19, 0xca, 0x54, 0xf2, 0xa0, 0x95, 0x78, 0x3c, 0x10, 0x07, 0x1d, 0xe4, 0x91,
+    0xca, 0x34, 0x10, 0x87, 0x27, 0x13, 0x1e, 0xa7, 0xec, 0x41, 0x1c, 0xcb, 0x11, 0x4f, 0x65, 0x14,
+    0xb2, 0x7b, 0x3c, 0x19, 0x0f, 0x22, 0x1e, 0xfb, 0xfb, 0x3b, 0x8a, 0x82, 0xed, 0x27, 0xe9, 0x05,
+    0x7c, 0xbe, 0xbd, 0x00, 0xd2, 0x91, 0x0c, 0xdd, 0x76, 0x7f, 0xca, 0x7d, 0x5f, 0x86, 0x23, 0x78,
+    0x1a, 0x44, 0xe7, 0xad, 0x44, 0x5e, 0xe2, 0xcb, 0x20, 0x8a, 0x7d, 0x11, 0xb7, 0x60, 0x64, 0x39,
+    0x88, 0xfc, 0x8b, 0xc5, 0x10, 0xe0, 0xb4, 0x86, 0x7c, 0x22, 0x83, 0x0b, 0xd7, 0x38, 0x11, 0xa3,
+    0x48, 0xb0, 0xa7, 0x0f, 0x8c, 0xe6, 0xdd, 0x18, 0x70, 0x34, 0x13, 0x1e, 0x26, 0xad, 0x44, 0xc4,
+    0x72, 0xd8, 0x1f, 0x70, 0xef, 0xc5, 0x28, 0x8e, 0x66, 0xa1, 0xef, 0x06, 0x32, 0x14, 0x3c, 0x6e,
+    0x8d, 0x62, 0xee, 0x4b, 0x90, 0xc4, 0xec, 0x74, 0xf7, 0x7c, 0x31, 0x6a, 0xbe, 0xd1, 0xeb, 0xbd,
+    0x23, 0x04, 0x67, 0xed, 0x37, 0x9b, 0x6f, 0xbc, 0xd3, 0xdb, 0x1d, 0x70, 0x87, 0x75, 0xda, 0xed,
+    0x37, 0xad, 0xfe, 0x44, 0x86, 0xad, 0xb1, 0x90, 0xa3, 0x71, 0xea, 0xc2, 0xc0, 0xd9, 0x38, 0x07,
+    0xe6, 0xb4, 0xa7, 0xe7, 0xcb, 0x71, 0x67, 0x91, 0x8a, 0xf3, 0xb4, 0xc5, 0x03, 0x39, 0x0a, 0x5d,
+    0x0f, 0x18, 0x8a, 0xb8, 0xef, 0x45, 0x41, 0x14, 0xbb, 0x6f, 0x0c, 0x87, 0xc3, 0x3e, 0x01, 0x04,
+    0xf0, 0xc2, 0x75, 0xec, 0x3d, 0x31, 0xe9, 0x2b, 0xf1, 0x40, 0x80, 0x34, 0x8d, 0x26, 0x6e, 0x17,
+    0x58, 0xf4, 0x69, 0x7d, 0x32, 0xe6, 0x7e, 0x34, 0x77, 0x9d, 0xe9, 0x39, 0xc3, 0xff, 0x76, 0xe1,
+    0xbf, 0x78, 0x34, 0xe0, 0x66, 0xbb, 0x49, 0xff, 0xd8, 0x5d, 0x6b, 0x39, 0x76, 0x16, 0x9a, 0xf1,
+    0xee, 0xd1, 0xdd, 0xe3, 0x3d, 0xd4, 0x8b, 0x56, 0x86, 0xe2, 0x05, 0x4b, 0x92, 0x28, 0x90, 0x3e,
+    0xcb, 0xe6, 0x35, 0xd0, 0x8c, 0xa0, 0x83, 0x9b, 0x55, 0xf7, 0x27, 0x11, 0x6c, 0xb4, 0x29, 0x07,
+    0xad, 0xc4, 0xa0, 0xfc, 0x73, 0x65, 0x4b, 0xb7, 0xe3, 0xb4, 0x0b, 0x72, 0xb7, 0xcd, 0xf8, 0x2c,
+    0x8d, 0x80, 0x12, 0x4c, 0xb6, 0x28, 0xe9, 0x92, 0x44, 0xd4, 0x30, 0x50, 0x9f, 0xb3, 0xc4, 0xed,
+    0xec, 0xc1, 0xb2, 0x5c, 0x45, 0x7b, 0x05, 0x0f, 0xdc, 0x8b, 0x69, 0x63, 0x2a, 0x61, 0xdb, 0x0c,
+    0x21, 0x31, 0x54, 0xc2, 0x8a, 0xb0, 0x76, 0x22, 0xc2, 0x24, 0x42, 0x33, 0x49, 0x7f, 0xe1, 0xcb,
+    0x64, 0x1a, 0xf0, 0x0b, 0x17, 0x5f, 0xfa, 0xf8, 0xa7, 0x95, 0x8a, 0x09, 0x8c, 0xa4, 0xa2, 0x05,
+    0x1a, 0x99, 0x4d, 0xc2, 0xc4, 0x8d, 0xc5, 0x54, 0xf0, 0xd4, 0x44, 0x98, 0xad, 0xa1, 0x4c, 0x9b,
+    0x60, 0x35, 0x10, 0xc6, 0x74, 0xf6, 0x80, 0x79, 0xb3, 0x33, 0x8c, 0x2d, 0xab, 0x3f, 0xe2, 0x53,
+    0x2d, 0xb0, 0xe2, 0xbd, 0x78, 0x0d, 0xa7, 0x28, 0xfb, 0x40, 0x5d, 0x01, 0x4e, 0x66, 0xd3, 0xab,
+    0x7c, 0xa2, 0xa2, 0x02, 0xd0, 0x10, 0x43, 0x9d, 0x55, 0x35, 0xe0, 0xe4, 0x1a, 0x60, 0xe3, 0xae,
+    0x3e, 0x13, 0xad, 0x34, 0x9a, 0xc2, 0x69, 0x28, 0x3c, 0xaa, 0x63, 0x3b, 0xe0, 0x51, 0xd1, 0x94,
+    0x7b, 0x32, 0xbd, 0x70, 0xdb, 0xf6, 0x9d, 0xa5, 0x7d, 0xc6, 0x83, 0x99, 0x58, 0x14, 0x24, 0x5d,
+    0x20, 0xa0, 0xb7, 0xb9, 0xf2, 0xe0, 0x41, 0x14, 0xf8, 0x99, 0x41, 0x68, 0xd7, 0x36, 0xec, 0x93,
+    0xf2, 0x74, 0x96, 0x2c, 0x32, 0x91, 0xc8, 0x26, 0x6b, 0xe4, 0x22, 0x5b, 0xae, 0xf0, 0xca, 0x4c,
+    0x23, 0x43, 0x54, 0x61, 0x6b, 0x10, 0x44, 0xde, 0x8b, 0x7e, 0x09, 0x6f, 0x47, 0x29, 0x9c, 0xb6,
+    0xb0, 0xa3, 0x17, 0x15, 0xe7, 0x51, 0x6e, 0x9a, 0xcf, 0xce, 0x79, 0x1c, 0x02, 0x80, 0x9a, 0x7f,
+    0xdd, 0xb9, 0xdd, 0x2e, 0x48, 0x44, 0x1c, 0x57, 0xed, 0xf6, 0xc6, 0x70, 0x77, 0xb7, 0xdb, 0xed,
+    0x2d, 0x07, 0x33, 0xf0, 0xe7, 0xb0, 0x90, 0x61, 0x4f, 0xfb, 0x55, 0x26, 0xeb, 0xed, 0x5c, 0x1c,
+    0x37, 0x8c, 0x42, 0x51, 0x13, 0x0d, 0x67, 0xbd, 0x59, 0x0c, 0xda, 0x76, 0xa7, 0x91, 0x24, 0x73,
+    0x95, 0xb4, 0xdc, 0x5b, 0x27, 0x77, 0x1a, 0x43, 0x70, 0x91, 0x18, 0xcc, 0x5c, 0x1e, 0x04, 0x0c,
+    0x7c, 0x36, 0xa9, 0xda, 0x15, 0x4f, 0x70, 0xaf, 0x6e, 0xd6, 0x8e, 0xa5, 0x91, 0xba, 0xe3, 0xe8,
+    0x0c, 0xce, 0x1b, 0x71, 0x19, 0x46, 0xf1, 0xc4, 0xa5, 0x27, 0xf4, 0xe8, 0x0f, 0xcd, 0x16, 0x38,
+    0x90, 0x55, 0x65, 0x86, 0x8c, 0xd0, 0xaf, 0x6a, 0xdc, 0xf6, 0xc0, 0x4b, 0x06, 0x69, 0xd8, 0x9a,
+    0xc6, 0x12, 0xe4, 0xbc, 0x58, 0xa3, 0xdc, 0x92, 0xdb, 0x55, 0x48, 0xf5, 0xfe, 0x95, 0x05, 0x7b,
+    0xbc, 0xbd, 0x7b, 0x47, 0x51, 0xf9, 0x3c, 0x1c, 0x89, 0x75, 0x8a, 0x5e, 0xe1, 0xa7, 0x28, 0xd7,
+    0xb0, 0xf3, 0x79, 0xe7, 0x4e, 0x7b, 0xa0, 0x88, 0x12, 0x01, 0x21, 0xc6, 0xaf, 0x23, 0x74, 0x3a,
+    0x77, 0x7a, 0xc7, 0xdd, 0x15, 0x8e, 0x39, 0xf1, 0x1a, 0xa6, 0xed, 0xc1, 0x3b, 0xbe, 0xcf, 0x55,
+    0xc4, 0x8a, 0xa3, 0xa0, 0x85, 0xe3, 0xd3, 0x45, 0x25, 0xc0, 0x2c, 0x03, 0x3e, 0x10, 0x41, 0x1e,
+    0x32, 0xca, 0x0e, 0xa9, 0x3d, 0x9e, 0xdd, 0xae, 0x19, 0xb4, 0xd7, 0xce, 0xf5, 0xd4, 0xed, 0x76,
+    0x97, 0x32, 0x9c, 0xce, 0xd2, 0x67, 0xe9, 0xc5, 0x14, 0x12, 0x5f, 0x38, 0x9b, 0x0c, 0x44, 0x6c,
+    0x3c, 0x6f, 0x96, 0x07, 0xf1, 0x70, 0x1b, 0xcf, 0x17, 0x3a, 0x50, 0x42, 0x3c, 0xc8, 0xc3, 0x01,
+    0x9d, 0x7d, 0xed, 0x67, 0x4e, 0x11, 0x8f, 0x7d, 0xdf, 0x5f, 0xe3, 0x71, 0x35, 0x17, 0x2b, 0x79,
+    0x94, 0xa2, 0x25, 0xa7, 0x52, 0x68, 0xdc, 0x61, 0xe4, 0xc1, 0x11, 0x8d, 0x66, 0x29, 0x9e, 0xb2,
+    0x8a, 0x0b, 0x6b, 0xe0, 0x2a, 0x50, 0x2d, 0xed, 0xe9, 0x6c, 0x32, 0x6d, 0x69, 0xf5, 0xe4, 0x4a,
+    0x18, 0x06, 0xe2, 0xbc, 0xff, 0xc9, 0x2c, 0x49, 0xe5, 0xf0, 0xa2, 0xa5, 0x33, 0xb8, 0x9b, 0x40,
+    0xdc, 0x10, 0x2d, 0x4e, 0x9a, 0xed, 0x23, 0x45, 0x6b, 0x1e, 0x43, 0x84, 0xc4, 0x3f, 0xa5, 0x50,
+    0x49, 0xfc, 0x24, 0x84, 0xdb, 0x05, 0x92, 0xb8, 0x1d, 0x4a, 0x87, 0x4a, 0x72, 0x8a, 0xad, 0xab,
+    0x91, 0x0e, 0x0e, 0xeb, 0x5c, 0xa6, 0xde, 0x78, 0x31, 0x8d, 0xb4, 0x38, 0xb1, 0x00, 0xc7, 0x96,
+    0x67, 0x62, 0x7d, 0xb0, 0x50, 0xcc, 0x7a, 0xc8, 0x4b, 0xa7, 0xd9, 0xee, 0x2e, 0xc5, 0x0c, 0xe2,
+    0xc2, 0x48, 0xfe, 0x45, 0x1e, 0xe4, 0x34, 0x79, 0x3b, 0xa3, 0xc5, 0xd8, 0x00, 0x3a, 0x06, 0x3f,
+    0xc9, 0xb7, 0xe3, 0x03, 0x50, 0xfb, 0x2c, 0x15, 0xf5, 0x23, 0xad, 0xc2, 0x67, 0x20, 0x86, 0xb0,
+    0xaa, 0x1f, 0xab, 0xd5, 0x7d, 0x9d, 0x08, 0xdb, 0xa5, 0x0a, 0x21, 0x53, 0xa9, 0xe7, 0x79, 0x65,
+    0xa3, 0xd8, 0xbb, 0x49, 0xcd, 0x88, 0x1a, 0x27, 0x6d, 0xef, 0x0e, 0x04, 0x9c, 0x63, 0xb1, 0x0e,
+    0x85, 0xd6, 0xb7, 0x61, 0x64, 0x98, 0x1d, 0x34, 0xb7, 0xd6, 0x21, 0x3e, 0x12, 0xa4, 0x5d, 0xf2,
+    0x1c, 0x02, 0x43, 0x8f, 0x75, 0x38, 0xf3, 0x31, 0x58, 0x61, 0x33, 0x9e, 0xbd, 0xf6, 0x9b, 0xda,
+    0x5d, 0xbc, 0xb1, 0xf0, 0x5e, 0x08, 0x9f, 0xdd, 0x62, 0x99, 0x76, 0x56, 0xc5, 0xd3, 0xd1, 0xf7,
+    0x8a, 0x05, 0x99, 0x3c, 0x6b, 0x22, 0xd4, 0xf7, 0x4c, 0x44, 0x6d, 0x2d, 0xbf, 0x31, 0x11, 0xbe,
+    0xe4, 0xcc, 0x2c, 0x8a, 0x86, 0x77, 0x7a, 0xe0, 0xd7, 0xd6, 0xa2, 0x92, 0xbb, 0xd7, 0xa7, 0x6b,
+    0xc8, 0xc8, 0x35, 0x5f, 0x25, 0x0f, 0xf4, 0x65, 0x2c, 0x3c, 0x92, 0x4e, 0x11, 0x2e, 0x97, 0xfb,
+    0x3b, 0xaa, 0x30, 0x64, 0xfb, 0x3b, 0xba, 0x5a, 0xc5, 0xba, 0x0f, 0x3e, 0x7c, 0x79, 0xc6, 0xbc,
+    0x80, 0x27, 0xc9, 0x81, 0x91, 0xd7, 0x2f, 0x58, 0x71, 0x8e, 0x3b, 0x87, 0xff, 0xfa, 0xed, 0x67,
+    0x7f, 0x64, 0x2b, 0x35, 0xe7, 0xc9, 0x45, 0x02, 0x30, 0x80, 0x4d, 0xa7, 0xb6, 0x1a, 0x6a, 0x1a,
+    0x5a, 0xe8, 0xc0, 0xc2, 0x2f, 0x7e, 0xc2, 0x9e, 0x08, 0x28, 0x61, 0x4f, 0xe5, 0x44, 0xb0, 0xf7,
+    0x22, 0x28, 0x68, 0xa3, 0x18, 0x0e, 0x36, 0xac, 0x72, 0xaa, 0xab, 0x4a, 0x22, 0x1a, 0xeb, 0x66,
+    0x88, 0x63, 0x17, 0x38, 0xfe, 0xec, 0x4b, 0x76, 0x12, 0xc9, 0x00, 0x98, 0xc9, 0x24, 0x9d, 0xc5,
+    0x02, 0x58, 0x75, 0xab, 0x0b, 0x28, 0x67, 0x1b, 0x4c, 0xfa, 0xb0, 0x16, 0x28, 0xbf, 0x4b, 0xaf,
+    0x87, 0xad, 0xd6, 0xfe, 0x0e, 0x10, 0xd5, 0x78, 0x53, 0x1a, 0x2c, 0x68, 0x4f, 0xd4, 0xfb, 0xe1,
+    0xc3, 0x88, 0x63, 0xfc, 0xb1, 0x6d, 0x3b, 0x5b, 0xb4, 0x66, 0x6d, 0x15, 0xd7, 0xaf, 0xfe, 0xc0,
+    0x3e, 0x00, 0x8b, 0xc4, 0xec, 0x94, 0x87, 0x2f, 0x36, 0x82, 0x9a, 0x23, 0x19, 0x52, 0x6d, 0x01,
+    0x8a, 0x68, 0x5f, 0x03, 0xd5, 0x97, 0xbf, 0x67, 0xc7, 0x22, 0x4e, 0x65, 0x00, 0x61, 0x71, 0x0b,
+    0x68, 0x43, 0xa0, 0xdd, 0x12, 0x19, 0x92, 0x5e, 0x0b, 0xec, 0x4a, 0x98, 0x55, 0x27, 0xf9, 0x31,
+    0x3b, 0x8d, 0x45, 0xe8, 0x27, 0x25, 0xb7, 0x20, 0x2f, 0x55, 0xa9, 0xa1, 0x12, 0x0d, 0x71, 0x51,
+    0x22, 0x02, 0xf0, 0x6a, 0x42, 0x31, 0x06, 0x27, 0x88, 0xe2, 0x8b, 0x27, 0x98, 0x35, 0x0d, 0x16,
+    0x85, 0xd0, 0x75, 0xc1, 0x13, 0xa2, 0x83, 0x58, 0xf7, 0xae, 0x9a, 0x34, 0x2d, 0x5c, 0x14, 0x4d,
+    0xc9, 0x6b, 0x49, 0xd8, 0x03, 0xa3, 0x0b, 0x39, 0x0a, 0x70, 0xf3, 0x24, 0x65, 0xe3, 0x68, 0x16,
+    0xef, 0xef, 0xa8, 0xe9, 0x15, 0x3a, 0xa7, 0x53, 0x10, 0xf6, 0x88, 0x34, 0xb9, 0x92, 0xf6, 0x76,
+    0x6f, 0x17, 0x68, 0x99, 0x42, 0x27, 0x7c, 0xb5, 0xc8, 0xd9, 0xbd, 0x66, 0x15, 0x70, 0xbf, 0x0f,
+    0x69, 0xf9, 0x22, 0x1d, 0x83, 0x06, 0x19, 0x02, 0x16, 0x7e, 0x89, 0x78, 0x47, 0xb1, 0x2b, 0x94,
+    0xe8, 0xf1, 0xf0, 0x8c, 0x27, 0x65, 0xe1, 0x8f, 0xa0, 0xd3, 0x84, 0x4e, 0x52, 0x35, 0x90, 0x46,
+    0xa7, 0x83, 0x20, 0x54, 0x64, 0x04, 0xfc, 0x3d, 0x44, 0xa4, 0x74, 0x59, 0xca, 0xaf, 0xe5, 0x82,
+    0x12, 0x72, 0xb8, 0x71, 0xb8, 0xbf, 0xa3, 0xf8, 0x5e, 0xa3, 0xfd, 0x7e, 0x9e, 0x1d, 0x7b, 0xa0,
+    0x53, 0x3a, 0x87, 0x13, 0x7d, 0x0e, 0x99, 0x49, 0xa9, 0x94, 0x71, 0x10, 0x86, 0x8f, 0x44, 0x93,
+    0x0d, 0x38, 0x54, 0x18, 0x0c, 0xd2, 0xdb, 0xcb, 0x1f, 0x7c, 0x01, 0x21, 0xcd, 0x62, 0xff, 0xf8,
+    0x33, 0x1b, 0x80, 0xc8, 0x30, 0x11, 0x27, 0x2e, 0x23, 0xcf, 0x66, 0x18, 0xb2, 0x58, 0x3c, 0x0b,
+    0x59, 0x8a, 0x01, 0x62, 0x4b, 0x7f, 0xf9, 0xe9, 0xaf, 0xff, 0xf9, 0x97, 0xcf, 0xd9, 0x91, 0x0a,
+    0x74, 0xec, 0x31, 0x0f, 0x45, 0xb0, 0x1a, 0x50, 0x2a, 0x25, 0x8d, 0xb1, 0xd1, 0x9f, 0xa8, 0xc2,
+    0xc9, 0x28, 0x6a, 0x39, 0x95, 0x52, 0x3d, 0x2d, 0xa0, 0xac, 0x9d, 0x64, 0x8a, 0xc0, 0x8c, 0x4e,
+    0x0d, 0x60, 0xad, 0x7d, 0x20, 0xff, 0x9c, 0xf2, 0xf0, 0xf0, 0x2e, 0x74, 0x4e, 0x13, 0x88, 0x94,
+    0x1e, 0x44, 0x2a, 0x5f, 0xb8, 0x60, 0x48, 0x1c, 0xcd, 0x36, 0xcb, 0x0e, 0x14, 0xe5, 0x64, 0x5c,
+    0x43, 0x69, 0x83, 0xa9, 0x7a, 0x88, 0x92, 0x07, 0xd4, 0xab, 0xea, 0xa0, 0x61, 0x0b, 0x86, 0x2c,
+    0xca, 0xee, 0x9d, 0x46, 0xa3, 0x51, 0x20, 0x70, 0x0b, 0x70, 0x6e, 0xa6, 0x93, 0x8d, 0xde, 0x39,
+    0xe7, 0x4d, 0x79, 0x07, 0x4d, 0xab, 0x77, 0xde, 0xa1, 0xad, 0x2b, 0x0f, 0x2b, 0x7a, 0x2e, 0xa7,
+    0x10, 0x63, 0xcd, 0x14, 0xea, 0xa0, 0x1c, 0x8a, 0x55, 0xc8, 0x7b, 0x0c, 0x53, 0x3a, 0xae, 0xa8,
+    0x72, 0x3c, 0x5b, 0x53, 0xaa, 0x90, 0x09, 0x7e, 0x20, 0xbd, 0x17, 0xb9, 0x69, 0x70, 0x95, 0xd9,
+    0x69, 0xb2, 0x34, 0x9e, 0x09, 0x38, 0xa2, 0x2f, 0x7f, 0xf1, 0x27, 0x76, 0x3a, 0x8b, 0x43, 0xf6,
+    0xe8, 0xfd, 0xfd, 0x1d, 0xc5, 0x66, 0x2d, 0x3f, 0x55, 0x21, 0x5f, 0xcd, 0x6e, 0xc8, 0x83, 0x84,
+    0xf8, 0x7d, 0xfe, 0x57, 0xcd, 0xef, 0xf8, 0xb8, 0xc4, 0xb0, 0xe4, 0xde, 0x2b, 0xa7, 0x40, 0x2b,
+    0x50, 0x4f, 0xd7, 0x7b, 0x14, 0xe3, 0x50, 0xc5, 0xbb, 0xc2, 0x96, 0x15, 0x75, 0x97, 0x62, 0x23,
+    0xaa, 0xaa, 0xa3, 0x83, 0x63, 0x6d, 0x33, 0xaa, 0x4d, 0xd0, 0x71, 0x8c, 0x43, 0xc2, 0x95, 0xd9,
+    0xe6, 0x2a, 0xc7, 0x5f, 0xd5, 0x7a, 0x35, 0xa4, 0xbf, 0x86, 0xea, 0x9d, 0xff, 0xac, 0xea, 0x9d,
+    0xff, 0x1b, 0xd5, 0x3b, 0xaf, 0xa1, 0xfa, 0xcd, 0x11, 0x88, 0xb6, 0xb8, 0x84, 0x6e, 0x21, 0x39,
+    0xa2, 0xd7, 0x5a, 0xcc, 0xc0, 0x3e, 0x22, 0x8f, 0x52, 0x9f, 0xfd, 0x9d, 0x7d, 0x1f, 0x29, 0x75,
+    0x68, 0x4a, 0xf9, 0x20, 0x10, 0x6b, 0x42, 0xf1, 0x6a, 0x8c, 0x2d, 0x1a, 0x91, 0x80, 0x4f, 0x13,
+    0xe1, 0x66, 0x0f, 0x74, 0xff, 0xa7, 0x8b, 0xb6, 0x34, 0x3e, 0x84, 0xe7, 0x43, 0xdc, 0x60, 0x7f,
+    0x07, 0x1e, 0xf0, 0xa5, 0xa8, 0x88, 0xf4, 0xc0, 0xe9, 0x38, 0x16, 0xc9, 0x18, 0xd4, 0x97, 0x8f,
+    0xdc, 0x9b, 0xc5, 0xaa, 0x78, 0x33, 0x27, 0x89, 0x95, 0x8f, 0x2a, 0x75, 0x15, 0x7c, 0x78, 0x38,
+    0xe3, 0x81, 0x7a, 0xdd, 0x81, 0x8d, 0x18, 0x3e, 0xea, 0x6d, 0xb1, 0x58, 0xcc, 0x95, 0xf0, 0x24,
+    0x9a, 0x27, 0x18, 0x5f, 0x52, 0x5d, 0x42, 0xee, 0x90, 0x8c, 0xd7, 0xc5, 0xef, 0x97, 0xbf, 0xfa,
+    0x25, 0x86, 0x6f, 0x55, 0x3e, 0xb2, 0x13, 0x91, 0xa6, 0x90, 0xf8, 0x92, 0x6b, 0x03, 0x78, 0xb6,
+    0xe9, 0x09, 0xe5, 0xc3, 0x6f, 0x55, 0xa2, 0x7a, 0x5d, 0xff, 0x2a, 0xbe, 0x91, 0x09, 0x72, 0x1d,
+    0x30, 0x48, 0x47, 0xa5, 0x70, 0xc5, 0x72, 0x55, 0xf0, 0xe9, 0x34, 0xb8, 0x60, 0x69, 0xe4, 0x16,
+    0x71, 0xb1, 0x54, 0x60, 0x24, 0x1a, 0xdf, 0xf7, 0x89, 0xf5, 0x6a, 0xee, 0xbe, 0x1b, 0x04, 0xec,
+    0x52, 0x99, 0x59, 0xe7, 0xec, 0xd5, 0x94, 0x7d, 0xa5, 0x50, 0x65, 0xa8, 0xbf, 0x23, 0xa5, 0x94,
+    0x2b, 0xdb, 0x12, 0x76, 0xf3, 0xee, 0xbd, 0x23, 0x46, 0x85, 0xac, 0x55, 0x82, 0x59, 0xce, 0x19,
+    0xba, 0xb1, 0x26, 0xcc, 0x69, 0xb6, 0xce, 0x60, 0xa0, 0x16, 0x4f, 0xe0, 0xa3, 0x88, 0xa1, 0x18,
+    0xb8, 0x8d, 0xb5, 0xcc, 0x2b, 0xc0, 0x7a, 0xf9, 0xf9, 0x1f, 0x11, 0xd5, 0x3a, 0xad, 0x99, 0x13,
+    0x19, 0x04, 0x52, 0xdd, 0x2d, 0x24, 0xdb, 0x80, 0xc2, 0x83, 0x99, 0xad, 0xae, 0xe1, 0xea, 0xb6,
+    0xbf, 0x1a, 0xae, 0x5a, 0x18, 0x7c, 0x0d, 0x70, 0x58, 0xcc, 0x5e, 0x01, 0xae, 0xb3, 0xf7, 0x8a,
+    0xe0, 0xfe, 0xf5, 0xdb, 0x9f, 0xff, 0x90, 0x1d, 0x61, 0x4a, 0x66, 0x0f, 0xf0, 0x3c, 0x83, 0xaf,
+    0xbc, 0x3a, 0x20, 0xa9, 0x57, 0xd6, 0xc0, 0xec, 0xad, 0x6a, 0x6a, 0x53, 0x61, 0xb3, 0x1a, 0xc1,
+    0xf3, 0xcb, 0xa0, 0x52, 0x10, 0x4f, 0xa0, 0x64, 0xcb, 0x8e, 0x21, 0xd6, 0xca, 0x90, 0xd8, 0xff,
+    0xc6, 0x4e, 0x60, 0xb0, 0x74, 0x38, 0xf3, 0x18, 0xbe, 0x36, 0x4c, 0x26, 0x5e, 0x2c, 0xa7, 0xe9,
+    0x61, 0x20, 0x52, 0x86, 0xb1, 0x58, 0xb0, 0x03, 0xb6, 0x58, 0xf6, 0x1b, 0xf8, 0x3e, 0x85, 0xe0,
+    0x85, 0xcd, 0x5f, 0x0c, 0x63, 0xe1, 0x2c, 0x08, 0xfa, 0x8d, 0xe1, 0x2c, 0xf4, 0x8a, 0x83, 0xf7,
+    0x74, 0xea, 0xc3, 0x02, 0xd3, 0xb7, 0xd8, 0xa2, 0x01, 0xd0, 0xa0, 0x62, 0xa6, 0xd3, 0x04, 0xd4,
+    0x8f, 0x06, 0x9f, 0xc0, 0x29, 0xb2, 0x01, 0x3a, 0x08, 0x65, 0x12, 0x5f, 0x5b, 0xcd, 0x7d, 0xfa,
+    0x29, 0xb0, 0x6f, 0x32, 0x5f, 0xbd, 0x5a, 0xfd, 0xc6, 0x1a, 0x52, 0x98, 0x86, 0x89, 0xf2, 0xaa,
+    0x03, 0xc5, 0xb9, 0xdf, 0x98, 0xd1, 0x96, 0x4f, 0x1f, 0x28, 0x42, 0xa0, 0x5a, 0x16, 0x98, 0xa8,
+    0x6f, 0xb8, 0xc7, 0x53, 0x6e, 0x22, 0x20, 0x7a, 0x33, 0x8d, 0x1d, 0x3e, 0x95, 0x3b, 0xb0, 0x86,
+    0x1b, 0x56, 0xc3, 0x86, 0x50, 0x18, 0x9a, 0x20, 0xcd, 0x21, 0x8b, 0xed, 0x4f, 0x92, 0x28, 0x34,
+    0xad, 0x6c, 0xd0, 0xc7, 0xc1, 0xaa, 0x50, 0x30, 0xe5, 0x71, 0xe4, 0x21, 0x70, 0x0e, 0xe5, 0x8b,
+    0x02, 0xa1, 0x6e, 0x5d, 0x4d, 0xe3, 0x18, 0xb9, 0x33, 0x7a, 0x71, 0x8d, 0x26, 0x13, 0x56, 0x15,
+    0x0a, 0xa0, 0x8b, 0xd3, 0xc7, 0xa0, 0x3e, 0xb0, 0x00, 0xa1, 0x91, 0x43, 0x66, 0xde, 0xc8, 0xf5,
+    0x99, 0xe3, 0x53, 0x68, 0xfb, 0x8d, 0xb2, 0xa6, 0x21, 0x6a, 0x65, 0xbe, 0x67, 0xe6, 0x44, 0x4d,
+    0xe6, 0x80, 0xfb, 0xd0, 0x26, 0x95, 0x6d, 0xa2, 0x69, 0x79, 0x17, 0x2f, 0x10, 0x3c, 0xce, 0x17,
+    0x17, 0xdb, 0x55, 0x37, 0x50, 0xa6, 0xac, 0xa3, 0x7d, 0x28, 0xcf, 0x44, 0x01, 0x75, 0x2e, 0x43,
+    0x3f, 0x9a, 0xdb, 0xd0, 0xdd, 0x84, 0xe9, 0x09, 0xf4, 0x40, 0x9e, 0xc0, 0xa9, 0xaa, 0x58, 0xfd,
+    0x46, 0x2c, 0x20, 0xd6, 0x85, 0xc8, 0x4b, 0x99, 0x9f, 0x2c, 0x15, 0x8a, 0x39, 0x2b, 0xad, 0xd3,
+    0x26, 0x10, 0x38, 0x92, 0x18, 0xb0, 0x48, 0x24, 0x76, 0x14, 0x46, 0x53, 0x11, 0x02, 0x2d, 0x6c,
+    0x08, 0xba, 0xad, 0x88, 0xa1, 0x09, 0x26, 0x22, 0x49, 0xa0, 0x15, 0x01, 0x1a, 0x51, 0x37, 0xcd,
+    0xb7, 0x4f, 0x1e, 0xbd, 0x6f, 0x4f, 0xf1, 0x1b, 0x3a, 0x53, 0xd8, 0x68, 0x5a, 0x2b, 0x5b, 0x44,
+    0xf6, 0x28, 0xb1, 0xad, 0xa2, 0x2d, 0x49, 0x9c, 0xbb, 0x11, 0xf9, 0xae, 0x1f, 0x79, 0xb3, 0x09,
+    0xc0, 0xb3, 0x47, 0x22, 0xbd, 0x1f, 0x08, 0x7c, 0xfc, 0xe6, 0xc5, 0x03, 0xdf, 0x2c, 0x5d, 0x41,
+    0x58, 0x36, 0x1e, 0xd2, 0x23, 0x75, 0x7d, 0x05, 0x3b, 0xf8, 0x36, 0xce, 0x7d, 0x94, 0x35, 0x50,
+    0x7d, 0xad, 0x00, 0x99, 0xdc, 0x8b, 0x2f, 0x56, 0xa7, 0xd9, 0x21, 0x8c, 0xe4, 0x91, 0xbd, 0xbf,
+    0x79, 0x43, 0x5d, 0x00, 0xd5, 0x77, 0x54, 0xac, 0xbf, 0xce, 0x8c, 0x7b, 0x4f, 0x3e, 0x34, 0x98,
+    0xcb, 0x8c, 0x47, 0xdf, 0x31, 0xb6, 0xe5, 0x44, 0x41, 0xe4, 0x7d, 0x3e, 0x41, 0x75, 0xea, 0x8a,
+    0x8b, 0x19, 0xec, 0x16, 0x33, 0x73, 0xa6, 0xfa, 0xfb, 0x06, 0x62, 0x1c, 0xbd, 0x40, 0x33, 0x5d,
+    0xc9, 0xb9, 0xb8, 0x02, 0x59, 0x55, 0x0a, 0xcd, 0x7d, 0x94, 0xc2, 0x24, 0x32, 0x3d, 0x7e, 0xfa,
+    0xf0, 0x21, 0x71, 0xbc, 0xff, 0xde, 0xe3, 0xd3, 0x0f, 0x8d, 0xeb, 0x78, 0x5e, 0x0f, 0xb7, 0xbe,
+    0x01, 0x20, 0x45, 0xf6, 0x64, 0xf6, 0x8d, 0x98, 0xf3, 0xbb, 0x91, 0x55, 0xc8, 0x38, 0xf5, 0x15,
+    0x10, 0x97, 0xae, 0x50, 0x36, 0x02, 0xae, 0xb0, 0xdf, 0x1a, 0x6f, 0xb9, 0x09, 0x59, 0x85, 0x4c,
+    0xb3, 0xc8, 0xef, 0xd1, 0xfb, 0xca, 0x13, 0x8e, 0x8f, 0x8d, 0xad, 0x99, 0x6d, 0xc0, 0x9a, 0xf3,
+    0xd5, 0x38, 0xaf, 0x85, 0xe8, 0x6c, 0x84, 0xe8, 0xbc, 0x1a, 0x44, 0x67, 0x5b, 0x88, 0xce, 0xb6,
+    0x10, 0xf3, 0xee, 0x1b, 0x58, 0xea, 0x3b, 0x5d, 0xc4, 0x86, 0xc3, 0x70, 0x34, 0x7d, 0xb1, 0x61,
+    0x69, 0x51, 0x86, 0x59, 0x76, 0x29, 0x8b, 0xd3, 0xfa, 0x6d, 0x0e, 0x72, 0xa5, 0x62, 0x5a, 0x65,
+    0x81, 0xd3, 0x1f, 0xf9, 0x7a, 0xfe, 0x1a, 0x2f, 0xdb, 0xc0, 0x86, 0x9c, 0x6b, 0x0b, 0x36, 0x79,
+    0x45, 0xb2, 0xca, 0x22, 0x9b, 0xca, 0x52, 0x2b, 0xb5, 0x3d, 0x66, 0x91, 0x9e, 0x57, 0x82, 0xa6,
+    0x22, 0xb8, 0x2c, 0x72, 0x3e, 0xc6, 0xf1, 0x4b, 0xf6, 0xd6, 0x5b, 0xec, 0xd2, 0xc6, 0x1f, 0x48,
+    0x80, 0x71, 0xd4, 0x83, 0x1d, 0x88, 0x70, 0x94, 0x8e, 0xc1, 0x4a, 0xed, 0x0d, 0xd0, 0x8a, 0x86,
+    0xcc, 0xb2, 0xa9, 0x1c, 0xb2, 0x75, 0x43, 0x80, 0x99, 0x04, 0xe2, 0x26, 0xf9, 0x23, 0x99, 0x9a,
+    0x1a, 0x84, 0x6b, 0x38, 0x95, 0x1b, 0x8c, 0x2d, 0xf9, 0x29, 0x21, 0x62, 0x68, 0x87, 0x50, 0x1f,
+    0x9b, 0x98, 0x53, 0xcb, 0x04, 0x2a, 0xc1, 0x04, 0x89, 0xf4, 0xe0, 0x54, 0x32, 0xf0, 0x63, 0x11,
+    0x66, 0x92, 0xde, 0x38, 0x80, 0x3d, 0x50, 0x31, 0x34, 0x2b, 0x43, 0xc8, 0x47, 0xef, 0x9e, 0xbe,
+    0xf7, 0x10, 0xbd, 0x38, 0xdf, 0x48, 0xb7, 0x27, 0x1b, 0xb6, 0xaa, 0x74, 0x2d, 0x58, 0x07, 0xd1,
+    0x8a, 0x6c, 0x8f, 0x03, 0xd6, 0xe9, 0x37, 0xb4, 0x82, 0x87, 0x51, 0x7c, 0x9f, 0x43, 0x81, 0x62,
+    0xe2, 0x5b, 0x93, 0x49, 0xca, 0x7a, 0x99, 0x59, 0x52, 0xb4, 0xaf, 0x06, 0x92, 0x80, 0x9f, 0x00,
+    0x7a, 0x4c, 0x82, 0x69, 0x5c, 0x05, 0xb6, 0x9f, 0xfa, 0xd8, 0x05, 0xc2, 0x9f, 0x6b, 0x1e, 0x4a,
+    0x4d, 0xfb, 0x4d, 0x75, 0x26, 0x6f, 0x66, 0xd7, 0x53, 0x44, 0x04, 0x07, 0xb4, 0xf1, 0x31, 0x51,
+    0x56, 0x2a, 0xd7, 0x9b, 0xa5, 0xbb, 0x8c, 0x9b, 0x79, 0xdd, 0x7a, 0x53, 0xd7, 0xdf, 0x28, 0xa3,
+    0xf9, 0xb5, 0x85, 0x84, 0xc3, 0xdd, 0x59, 0xea, 0x2b, 0x8d, 0x9b, 0x78, 0xa5, 0x91, 0x57, 0xad,
+    0x1f, 0x13, 0xdb, 0x55, 0x96, 0xea, 0x3a, 0xe3, 0x5a, 0x8e, 0xea, 0x56, 0xe3, 0x26, 0xde, 0x6a,
+    0xe4, 0x2c, 0x09, 0xee, 0xc7, 0xa4, 0x0a, 0x4f, 0x04, 0x41, 0xf2, 0xac, 0xfd, 0xbc, 0x16, 0xbf,
+    0x50, 0x9f, 0xb9, 0xe2, 0xb9, 0xef, 0x9b, 0x58, 0xd3, 0x3c, 0xa2, 0x16, 0x31, 0xd3, 0x35, 0xf2,
+    0xa7, 0xa2, 0x4f, 0x9d, 0x11, 0x28, 0x3b, 0x4c, 0x2c, 0x99, 0x25, 0xac, 0x6e, 0xf7, 0xe1, 0x63,
+    0x9f, 0x85, 0xf0, 0x71, 0xeb, 0x56, 0x71, 0x4e, 0xbc, 0xcc, 0x1e, 0x99, 0xdb, 0x3c, 0x93, 0xcf,
+    0x15, 0x80, 0xcc, 0x37, 0x7c, 0xaa, 0x1d, 0x2e, 0xa9, 0x76, 0x80, 0x49, 0xf0, 0xd6, 0xcb, 0x22,
+    0xd8, 0xc0, 0x00, 0xd0, 0x3d, 0xeb, 0xd4, 0xb1, 0x16, 0xe4, 0x18, 0x20, 0x55, 0x36, 0x67, 0x26,
+    0x14, 0x09, 0x56, 0x1e, 0x20, 0xbd, 0x67, 0xce, 0xea, 0xaa, 0x3a, 0xe3, 0xee, 0x2a, 0x49, 0x16,
+    0x59, 0x14, 0x85, 0x72, 0x5f, 0x9c, 0xf1, 0x9e, 0xed, 0x3e, 0xb7, 0x87, 0x32, 0x4e, 0xd2, 0x23,
+    0x14, 0x05, 0x4b, 0xf5, 0xda, 0x5a, 0xf3, 0xd2, 0xa6, 0x65, 0xb5, 0x0c, 0x60, 0x21, 0xc6, 0x4b,
+    0x7b, 0x42, 0x97, 0x14, 0x7a, 0x1a, 0xaf, 0x96, 0xd5, 0x40, 0x8e, 0x17, 0xd8, 0x5d, 0x99, 0x02,
+    0x4a, 0x8c, 0x4b, 0x29, 0xa0, 0x52, 0x15, 0x97, 0x2f, 0x58, 0x6b, 0x8d, 0x00, 0x86, 0x7e, 0x28,
+    0xd7, 0x17, 0x8d, 0x89, 0x48, 0xc7, 0x91, 0x0f, 0xab, 0x1f, 0x3f, 0x3a, 0x39, 0x35, 0x9a, 0x0d,
+    0xbc, 0x23, 0x11, 0x78, 0xb5, 0xbd, 0x30, 0xb4, 0x14, 0xad, 0x53, 0x68, 0xec, 0x0c, 0xa0, 0xc0,
+    0xd2, 0x53, 0x7a, 0xa4, 0x88, 0x1d, 0x6c, 0x1a, 0x8c, 0x65, 0xb3, 0x81, 0x97, 0x26, 0x2e, 0xa3,
+    0x42, 0x34, 0x49, 0xf1, 0x4b, 0x31, 0x39, 0xbc, 0x30, 0x17, 0x22, 0xc4, 0x3b, 0x14, 0xe0, 0xfa,
+    0x0a, 0x19, 0x69, 0x69, 0x81, 0x0b, 0x5d, 0xdb, 0x99, 0x64, 0xdd, 0x47, 0x10, 0x8d, 0x4c, 0x03,
+    0x25, 0x63, 0x98, 0xbf, 0xb0, 0xf3, 0xf0, 0x6b, 0x9d, 0x47, 0xf9, 0x56, 0x0f, 0xb3, 0x4c, 0x53,
+    0x75, 0x75, 0x75, 0x45, 0xe0, 0xd4, 0x7f, 0x4f, 0x11, 0xc8, 0xdd, 0x65, 0xa5, 0xed, 0x5d, 0xf5,
+    0xf1, 0x15, 0x84, 0x45, 0x41, 0x36, 0xc8, 0x49, 0xc7, 0x1d, 0x83, 0xf3, 0xff, 0x44, 0x4e, 0xdc,
+    0xd8, 0x65, 0xa5, 0xed, 0xbf, 0xba, 0x9c, 0x28, 0xc8, 0x3a, 0x39, 0xab, 0x0d, 0x7e, 0x1e, 0x4c,
+    0x30, 0x59, 0x2d, 0x1a, 0xf9, 0x19, 0x06, 0x65, 0x63, 0x3f, 0x04, 0xad, 0x9f, 0xb9, 0x55, 0x49,
+    0x43, 0x77, 0x60, 0x16, 0x36, 0xe3, 0x78, 0xaf, 0xd4, 0x6c, 0x54, 0xea, 0x91, 0x6d, 0x98, 0xd5,
+    0xea, 0x9b, 0x82, 0x1f, 0xde, 0x07, 0x35, 0x1b, 0x95, 0xc2, 0x64, 0x1b, 0x7e, 0xb5, 0x42, 0xa7,
+    0xe0, 0x87, 0x57, 0x38, 0xcd, 0x46, 0x56, 0xa5, 0x6c, 0xc3, 0xaa, 0x54, 0xec, 0x14, 0x6c, 0xf0,
+    0xf2, 0xa5, 0xb1, 0xec, 0x97, 0xae, 0x29, 0x40, 0x81, 0xd7, 0xf3, 0xaa, 0xe6, 0x62, 0xcd, 0x4f,
+    0x55, 0x00, 0xc4, 0xe3, 0x90, 0xb5, 0xa9, 0x2f, 0xb6, 0x35, 0x47, 0xfc, 0x20, 0xf3, 0x95, 0x5c,
+    0x30, 0xe3, 0xf1, 0x5f, 0x73, 0xc3, 0x64, 0x2b, 0x6f, 0x5b, 0x34, 0x78, 0x00, 0x4a, 0x36, 0x8d,
+    0x97, 0xbf, 0xf9, 0x51, 0x7e, 0x39, 0x44, 0xee, 0xe5, 0xb3, 0x64, 0xe6, 0x79, 0xd0, 0x6f, 0x0f,
+    0x67, 0x41, 0x70, 0x71, 0x83, 0x32, 0x46, 0xc9, 0x35, 0xfd, 0x22, 0xcb, 0x55, 0x6e, 0x5a, 0xf2,
+    0x6f, 0x68, 0x73, 0xa7, 0x8c, 0x31, 0x27, 0x6f, 0xa5, 0xd7, 0xca, 0x57, 0xbf, 0x85, 0x5e, 0xcb,
+    0x6a, 0xd3, 0x24, 0x5f, 0xa7, 0x5f, 0xac, 0x24, 0x07, 0x1d, 0xa7, 0x4d, 0xf1, 0x5f, 0xed, 0x01,
+    0xd1, 0xff, 0xad, 0x61, 0x1c, 0x4d, 0x0e, 0x5a, 0x38, 0xa8, 0xc6, 0x28, 0x15, 0x6c, 0xd4, 0xc3,
+    0x18, 0x07, 0xfd, 0x98, 0xcf, 0x33, 0xe8, 0xe3, 0xcd, 0x97, 0x3c, 0x9a, 0xec, 0xea, 0x6b, 0x9e,
+    0x2a, 0xaf, 0x4a, 0xa6, 0xbf, 0x4e, 0x74, 0xf5, 0xc5, 0xaf, 0x95, 0x79, 0xe4, 0x08, 0xd3, 0x2a,
+    0xd2, 0x92, 0x17, 0x9c, 0x83, 0x99, 0x1c, 0xbf, 0x98, 0xc5, 0x12, 0x7b, 0x6c, 0x67, 0x35, 0x60,
+    0xbf, 0x31, 0xb2, 0xe9, 0xa6, 0xe7, 0x09, 0x94, 0x27, 0x66, 0xbb, 0xc9, 0xe0, 0x5f, 0xcf, 0x56,
+    0x3f, 0x3b, 0x86, 0x07, 0xf5, 0xf5, 0x71, 0xbe, 0x16, 0xab, 0x03, 0x5a, 0x4e, 0x37, 0x12, 0xfc,
+    0x6c, 0x04, 0x99, 0x3b, 0x80, 0x13, 0x62, 0x9e, 0xa1, 0xc4, 0x67, 0xaa, 0x68, 0x05, 0xc3, 0x6b,
+    0xb7, 0xbe, 0x11, 0xe2, 0x71, 0xb9, 0x81, 0xc4, 0x7a, 0x3b, 0x2a, 0x68, 0xf3, 0x8b, 0x1e, 0x2c,
+    0x72, 0x82, 0x08, 0x18, 0xbe, 0xc7, 0xd3, 0xb1, 0x3d, 0x91, 0xa1, 0x69, 0xdb, 0xb6, 0x66, 0x0e,
+    0x6f, 0x57, 0x31, 0xb7, 0xd4, 0x8d, 0xe2, 0x58, 0xe6, 0x2b, 0xf9, 0x79, 0x79, 0x25, 0x3f, 0xdf,
+    0xb0, 0x12, 0x71, 0xc1, 0xca, 0x16, 0x6e, 0xbc, 0x0f, 0x47, 0x19, 0x11, 0xc1, 0xfb, 0xad, 0x03,
+    0xe6, 0xec, 0x01, 0xdf, 0x88, 0xb5, 0xd4, 0x53, 0x76, 0x0d, 0x35, 0x27, 0x65, 0x92, 0x42, 0xd8,
+    0x0e, 0xd4, 0x61, 0x7a, 0x18, 0x8b, 0x2b, 0xe2, 0x9e, 0xe9, 0x08, 0x38, 0x76, 0xda, 0xf0, 0x07,
+    0xf6, 0x44, 0xde, 0x16, 0x10, 0x67, 0xfb, 0x58, 0xec, 0x6d, 0x66, 0x96, 0xe8, 0x9c, 0x76, 0xae,
+    0xd0, 0x29, 0x80, 0x2d, 0x4b, 0xd1, 0x69, 0x32, 0x12, 0x84, 0xba, 0xe7, 0x8f, 0xb0, 0x67, 0x22,
+    0x15, 0x07, 0x27, 0xd8, 0x7d, 0x60, 0xf9, 0x42, 0xbf, 0x53, 0xec, 0x76, 0x9b, 0x10, 0xca, 0x9a,
+    0xce, 0x6e, 0x17, 0x7f, 0xd3, 0xbb, 0x67, 0x41, 0x43, 0x90, 0x2f, 0x29, 0x0a, 0xf9, 0xa4, 0x5e,
+    0xc5, 0x0f, 0xb0, 0xe2, 0x4f, 0x00, 0x18, 0xed, 0xfa, 0x76, 0x01, 0xfd, 0x6d, 0xfc, 0x45, 0x5c,
+    0xb6, 0x15, 0x39, 0x82, 0x84, 0xb1, 0x79, 0xb3, 0x2c, 0xdc, 0x00, 0xfc, 0xa1, 0x0c, 0x73, 0x8e,
+    0x02, 0x5b, 0x4d, 0x18, 0xd7, 0x47, 0x7a, 0x1d, 0xd0, 0x4e, 0xdb, 0x69, 0x76, 0x9c, 0x5e, 0xd3,
+    0xe9, 0xee, 0xe2, 0x6f, 0x6f, 0x09, 0xe9, 0x08, 0xa3, 0x4d, 0xf4, 0x42, 0xe4, 0x94, 0xfa, 0x07,
+    0xc0, 0x34, 0x85, 0x5f, 0xb5, 0x7f, 0x40, 0xba, 0x06, 0x2b, 0xe0, 0xc0, 0x40, 0x8c, 0x64, 0xf8,
+    0x18, 0xf6, 0xc5, 0x7e, 0xa3, 0xec, 0x77, 0x99, 0x94, 0x67, 0x85, 0x94, 0x68, 0x5a, 0xb0, 0x49,
+    0x66, 0xec, 0x8a, 0xab, 0xad, 0xca, 0x06, 0xa7, 0x2c, 0xf7, 0x17, 0x28, 0x02, 0x41, 0x94, 0x79,
+    0x55, 0xc2, 0x82, 0x40, 0x62, 0x95, 0x68, 0x81, 0xc0, 0xf5, 0x35, 0x96, 0x95, 0x81, 0x3e, 0x8d,
+    0x14, 0x5f, 0x88, 0x20, 0x73, 0xd0, 0xb0, 0x83, 0xcb, 0xcf, 0xac, 0x5c, 0x35, 0x4a, 0x64, 0x73,
+    0x55, 0x4d, 0xf8, 0xc3, 0x48, 0x92, 0x1c, 0xbf, 0xe9, 0xc4, 0x81, 0x0e, 0xfe, 0xbe, 0xb5, 0xf8,
+    0x81, 0xbd, 0x91, 0xad, 0x38, 0xc5, 0x83, 0x3c, 0x96, 0x4d, 0xb6, 0xdb, 0x64, 0x9d, 0x9e, 0x55,
+    0x19, 0x0e, 0x22, 0x1a, 0x2e, 0x59, 0x6b, 0x97, 0x62, 0x4b, 0xe9, 0x2e, 0x56, 0xc7, 0xc3, 0x3c,
+    0xce, 0x62, 0x47, 0x52, 0xbb, 0x1a, 0xd6, 0x73, 0x4d, 0xd6, 0x6b, 0xd3, 0xf5, 0x30, 0x34, 0x64,
+    0xea, 0x3a, 0x9f, 0x41, 0xb7, 0xa3, 0xbf, 0xd8, 0xa3, 0xff, 0xbf, 0xe1, 0xdf, 0xb5, 0x29, 0x3b,
+    0x5d, 0xf6, 0x30, 0x00, 0x00,
+};
 
 #endif // DASHBOARD_H
@@ -2,13 +2,73 @@
 """
 HTML to C Header Converter
 Converts dashboard.html to dashboard.h for embedding in ESP32 firmware
+
+The page is minified, gzip-compressed and emitted as a byte array together
+with a content hash. The web server sends the bytes as-is with
+Content-Encoding: gzip and uses the hash as the ETag.
 """
 
+import gzip
+import hashlib
+import re
 import sys
 import os
 
+
+def minify_css(css):
+    """Drop comments and the whitespace CSS does not need"""
+    css = re.sub(r'/\*.*?\*/', '', css, flags=re.S)
+    css = re.sub(r'\s+', ' ', css)
+    css = re.sub(r'\s*([{};,])\s*', r'\1', css)
+    css = re.sub(r':\s+', ':', css)
+    css = css.replace(';}', '}')
+    return css.strip()
+
+
+def minify_js(js):
+    """Conservative: trim lines and drop blank/comment-only lines.
+    Newlines are kept so automatic semicolon insertion still works."""
+    lines = []
+    for line in js.splitlines():
+        line = line.strip()
+        if not line or line.startswith('//'):
+            continue
+        lines.append(line)
+    return '\n'.join(lines)
+
+
+def minify_html(html):
+    """Minify markup, inline <style> and inline <script> separately"""
+    out = []
+    pos = 0
+    block = re.compile(r'(<style[^>]*>)(.*?)(</style>)|(<script[^>]*>)(.*?)(</script>)', re.S | re.I)
+    for m in block.finditer(html):
+        out.append(minify_markup(html[pos:m.start()]))
+        if m.group(1):
+            out.append(m.group(1) + minify_css(m.group(2)) + m.group(3))
+        else:
+            out.append(m.group(4) + minify_js(m.group(5)) + m.group(6))
+        pos = m.end()
+    out.append(minify_markup(html[pos:]))
+    return ''.join(out).strip()
+
+
+def minify_markup(markup):
+    """Remove comments; any whitespace run renders as one space anyway"""
+    markup = re.sub(r'<!--.*?-->', '', markup, flags=re.S)
+    markup = re.sub(r'\s+', ' ', markup)
+    return markup
+
+
+def c_byte_array(data, per_line=16):
+    rows = []
+    for i in range(0, len(data), per_line):
+        rows.append('    ' + ', '.join(f'0x{b:02x}' for b in data[i:i + per_line]) + ',')
+    return '\n'.join(rows)
+
+
 def html_to_c_header(html_file, header_file):
-    """Convert HTML file to C header with string constant"""
+    """Convert HTML file to C header with a gzip byte array"""
     
     # Read HTML file
     try:
@@ -18,14 +78,10 @@ def html_to_c_header(html_file, header_file):
         print(f"Error reading {html_file}: {e}")
         sys.exit(1)
     
-    # Minify HTML (optional - remove for readability)
-    # For now, keep it readable but you can add minification
-    
-    # Escape special characters for C string
-    html_escaped = html_content.replace('\\', '\\\\')  # Backslash
-    html_escaped = html_escaped.replace('"', '\\"')     # Double quote
-    html_escaped = html_escaped.replace('\n', '\\n')    # Newline
-    html_escaped = html_escaped.replace('\r', '')       # Remove carriage return
+    minified = minify_html(html_content.replace('\r', '')).encode('utf-8')
+    # mtime=0 keeps the output (and the ETag) identical for identical input
+    compressed = gzip.compress(minified, compresslevel=9, mtime=0)
+    digest = hashlib.sha256(compressed).hexdigest()[:16]
     
     # Generate C header content
     header_content = f"""#ifndef DASHBOARD_H
@@ -34,8 +90,15 @@ def html_to_c_header(html_file, header_file):
 // Auto-generated from dashboard.html
 // DO NOT EDIT THIS FILE MANUALLY - Edit dashboard.html instead
 
-static const char* dashboard_html = 
-"{html_escaped}";
+#include <stdint.h>
+
+// Original {len(html_content)} bytes, minified {len(minified)} bytes, gzip {len(compressed)} bytes
+#define DASHBOARD_HTML_GZ_LEN {len(compressed)}
+#define DASHBOARD_ETAG "\\"{digest}\\""
+
+static const uint8_t dashboard_html_gz[DASHBOARD_HTML_GZ_LEN] = {{
+{c_byte_array(compressed)}
+}};
 
 #endif // DASHBOARD_H
 """
@@ -46,7 +109,9 @@ static const char* dashboard_html =
             f.write(header_content)
         print(f"✅ Successfully converted {html_file} to {header_file}")
         print(f"   HTML size: {len(html_content)} bytes")
-        print(f"   Header size: {len(header_content)} bytes")
+        print(f"   Minified:  {len(minified)} bytes")
+        print(f"   Gzipped:   {len(compressed)} bytes (flash)")
+        print(f"   ETag:      \"{digest}\"")
     except Exception as e:
         print(f"Error writing {header_file}: {e}")
         sys.exit(1)